@@ -19,23 +19,36 @@
 
 #include <zxing/BinaryBitmap.h>
 
-#include "zxing/Binarizer.h"         // for Binarizer
-#include "zxing/LuminanceSource.h"   // for LuminanceSource
-#include "zxing/common/BitArray.h"   // for BitArray
-#include "zxing/common/BitMatrix.h"  // for BitMatrix
-#include "zxing/common/Counted.h"    // for Ref
+#include "zxing/Binarizer.h"                          // for Binarizer
+#include "zxing/LuminanceSource.h"                    // for LuminanceSource
+#include "zxing/common/BitArray.h"                    // for BitArray
+#include "zxing/common/BitMatrix.h"                   // for BitMatrix
+#include "zxing/common/Counted.h"                     // for Ref
+#include "zxing/common/CroppedLuminanceSource.h"      // for CroppedLuminanceSource
+#include "zxing/common/DownscaledLuminanceSource.h"   // for DownscaledLuminanceSource
 
 namespace pping {
 
-    BinaryBitmap::BinaryBitmap(Ref<Binarizer> binarizer) : binarizer_(binarizer) {
+    BinaryBitmap::BinaryBitmap(Ref<Binarizer> binarizer) : binarizer_(binarizer), matrix_() {
+
+    }
+
+    BinaryBitmap::BinaryBitmap(Ref<Binarizer> binarizer, Ref<BitMatrix> matrix) :
+        binarizer_(binarizer), matrix_(matrix) {
 
     }
 
     FallibleRef<BitArray > BinaryBitmap::getBlackRow(int y, Ref<BitArray> row) const MB_NOEXCEPT_EXCEPT_BADALLOC {
+        if (!matrix_.empty()) {
+            return matrix_->getRow(y, row);
+        }
         return binarizer_->getBlackRow(y, row);
     }
 
     FallibleRef<BitMatrix> BinaryBitmap::getBlackMatrix() const MB_NOEXCEPT_EXCEPT_BADALLOC {
+        if (!matrix_.empty()) {
+            return matrix_;
+        }
         return binarizer_->getBlackMatrix();
     }
 
@@ -58,4 +71,28 @@ namespace pping {
     Ref<BinaryBitmap> BinaryBitmap::rotateCounterClockwise() {
       return Ref<BinaryBitmap> (new BinaryBitmap(binarizer_->createBinarizer(getLuminanceSource()->rotateCounterClockwise())));
     }
+
+    Ref<BinaryBitmap> BinaryBitmap::downscale(int factor) MB_NOEXCEPT_EXCEPT_BADALLOC {
+      Ref<LuminanceSource> source(new DownscaledLuminanceSource(getLuminanceSource(), factor));
+      return Ref<BinaryBitmap> (new BinaryBitmap(binarizer_->createBinarizer(source)));
+    }
+
+    Ref<BinaryBitmap> BinaryBitmap::copy() const MB_NOEXCEPT_EXCEPT_BADALLOC {
+      // Reading rows of a crop only reads the shared matrix
+      return Ref<BinaryBitmap> (new BinaryBitmap(binarizer_->createBinarizer(getLuminanceSource()), matrix_));
+    }
+
+    bool BinaryBitmap::isCropSupported() const {
+      return true;
+    }
+
+    Ref<BinaryBitmap> BinaryBitmap::crop(int left, int top, int width, int height) MB_NOEXCEPT_EXCEPT_BADALLOC {
+      Ref<LuminanceSource> source(new CroppedLuminanceSource(getLuminanceSource(), left, top, width, height));
+      Ref<BitMatrix> matrix;
+      auto const blackMatrix(getBlackMatrix());
+      if (blackMatrix) {
+        matrix = (*blackMatrix)->crop((size_t)left, (size_t)top, (size_t)width, (size_t)height);
+      }
+      return Ref<BinaryBitmap> (new BinaryBitmap(binarizer_->createBinarizer(source), matrix));
+    }
 }
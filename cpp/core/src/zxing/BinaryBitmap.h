@@ -32,7 +32,11 @@ class LuminanceSource;
     class BinaryBitmap : public Counted {
     private:
         Ref<Binarizer> binarizer_;
+        // For a crop, the view of the rectangle of its parent's black matrix
+        Ref<BitMatrix> matrix_;
 //		int cached_y_;
+
+        BinaryBitmap(Ref<Binarizer> binarizer, Ref<BitMatrix> matrix);
         
     public:
         BinaryBitmap(Ref<Binarizer> binarizer);
@@ -49,7 +53,27 @@ class LuminanceSource;
         bool isRotateSupported() const;
         Ref<BinaryBitmap> rotateCounterClockwise();
 
+        /**
+         * Returns a bitmap over a coarse copy of the luminance source, reduced by
+         * factor in both directions and binarized the same way as this one.
+         */
+        Ref<BinaryBitmap> downscale(int factor) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+        /**
+         * Returns a bitmap over the same luminance source with a new binarizer of
+         * the same kind. Binarizers cache what they computed, so threads reading
+         * rows at the same time need one each.
+         */
+        Ref<BinaryBitmap> copy() const MB_NOEXCEPT_EXCEPT_BADALLOC;
+
         bool isCropSupported() const;
+        /**
+         * Returns a bitmap of the width by height rectangle at (left, top).
+         * Its black matrix and rows are a view of this bitmap's black matrix,
+         * binarized once for every crop, rather than a binarization of their
+         * own; only if this bitmap cannot be binarized is the crop binarized
+         * on its own. Its luminance source reads this bitmap's on demand.
+         */
         Ref<BinaryBitmap> crop(int left, int top, int width, int height) MB_NOEXCEPT_EXCEPT_BADALLOC;
 
     };
@@ -0,0 +1,89 @@
+// -*- mode:c++; tab-width:2; indent-tabs-mode:nil; c-basic-offset:2 -*-
+/*
+ *  DecodeContext.cpp
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/DecodeContext.h>
+
+#include "zxing/BinaryBitmap.h"      // for BinaryBitmap
+#include "zxing/LuminanceSource.h"   // for LuminanceSource
+#include "zxing/common/BitMatrix.h"  // for BitMatrix
+#include "zxing/common/Counted.h"    // for Ref
+
+namespace pping {
+
+  DecodeContext::DecodeContext(Ref<BinaryBitmap> image) noexcept :
+      image_(image), blackMatrixRead_(false), blackMatrix_(), blackMatrixFailure_(), luminances_(), downscaled_() {
+  }
+
+  void DecodeContext::readBlackMatrix() MB_NOEXCEPT_EXCEPT_BADALLOC {
+    auto const blackMatrix(image_->getBlackMatrix());
+    if (blackMatrix) {
+      blackMatrix_ = *blackMatrix;
+    } else {
+      blackMatrixFailure_ = blackMatrix.error();
+    }
+    blackMatrixRead_ = true;
+  }
+
+  void DecodeContext::readLuminances() MB_NOEXCEPT_EXCEPT_BADALLOC {
+    luminances_.reset(image_->getLuminanceSource()->getMatrix());
+  }
+
+  FallibleRef<BitMatrix> DecodeContext::getBlackMatrix() MB_NOEXCEPT_EXCEPT_BADALLOC {
+#ifndef NO_THREADS
+    std::call_once(blackMatrixOnce_, &DecodeContext::readBlackMatrix, this);
+#else
+    if (!blackMatrixRead_) {
+      readBlackMatrix();
+    }
+#endif
+    if (blackMatrix_.empty())
+      return blackMatrixFailure_;
+    return blackMatrix_;
+  }
+
+  unsigned char const* DecodeContext::getLuminances() MB_NOEXCEPT_EXCEPT_BADALLOC {
+#ifndef NO_THREADS
+    std::call_once(luminancesOnce_, &DecodeContext::readLuminances, this);
+#else
+    if (!luminances_) {
+      readLuminances();
+    }
+#endif
+    return luminances_.get();
+  }
+
+  Ref<DecodeContext> DecodeContext::getDownscaled(int factor) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    if (factor <= 1) {
+      return Ref<DecodeContext>(this);
+    }
+#ifndef NO_THREADS
+    std::lock_guard<std::mutex> lock(downscaledMutex_);
+#endif
+    for (size_t i = 0; i < downscaled_.size(); i++) {
+      if (downscaled_[i].first == factor) {
+        return downscaled_[i].second;
+      }
+    }
+    Ref<DecodeContext> downscaled(new DecodeContext(image_->downscale(factor)));
+    downscaled_.push_back(std::make_pair(factor, downscaled));
+    return downscaled;
+  }
+
+}
@@ -0,0 +1,83 @@
+// -*- mode:c++; tab-width:2; indent-tabs-mode:nil; c-basic-offset:2 -*-
+#pragma once
+
+/*
+ *  DecodeContext.h
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/common/Counted.h>  // for Ref, Counted
+#include "zxing/common/Error.hpp"
+
+#include <memory>                  // for unique_ptr
+#include <utility>                 // for pair
+#include <vector>                  // for vector
+#ifndef NO_THREADS
+#include <mutex>                   // for mutex, once_flag
+#endif
+
+namespace pping {
+
+class BinaryBitmap;
+class BitMatrix;
+
+/**
+ * What the readers derive from one frame, each computed the first time a
+ * reader asks for it and then shared by all readers decoding the frame:
+ * the black matrix, the luminances and the downscaled copies of the image.
+ * Create one per frame and pass it to every reader, see Reader::decode and
+ * MultipleBarcodeReader::decodeMultiple. Readers on different threads may
+ * share a context.
+ */
+class DecodeContext : public Counted {
+private:
+  Ref<BinaryBitmap> image_;
+
+  bool blackMatrixRead_;
+  Ref<BitMatrix> blackMatrix_;
+  Failure blackMatrixFailure_;
+  std::unique_ptr<unsigned char[]> luminances_;
+  // Downscaled contexts by factor
+  std::vector<std::pair<int, Ref<DecodeContext> > > downscaled_;
+#ifndef NO_THREADS
+  std::once_flag blackMatrixOnce_;
+  std::once_flag luminancesOnce_;
+  std::mutex downscaledMutex_;
+#endif
+
+  void readBlackMatrix() MB_NOEXCEPT_EXCEPT_BADALLOC;
+  void readLuminances() MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+public:
+  explicit DecodeContext(Ref<BinaryBitmap> image) noexcept;
+
+  Ref<BinaryBitmap> const& getImage() const noexcept { return image_; }
+
+  /** BinaryBitmap::getBlackMatrix, binarized once; a failure is kept too. */
+  FallibleRef<BitMatrix> getBlackMatrix() MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+  /** The luminances of the whole image row after row, read once. */
+  unsigned char const* getLuminances() MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+  /**
+   * The context of the image reduced by factor in both directions, see
+   * BinaryBitmap::downscale. Each factor is downscaled once.
+   */
+  Ref<DecodeContext> getDownscaled(int factor) MB_NOEXCEPT_EXCEPT_BADALLOC;
+};
+
+}
@@ -21,6 +21,7 @@
 #include <zxing/common/IllegalArgumentException.h>  // for IllegalArgumentException
 
 #include "zxing/BarcodeFormat.h"                    // for BarcodeFormat, BarcodeFormat::AZTEC_BARCODE, BarcodeFormat::CODE_128, BarcodeFormat::CODE_39, BarcodeFo...
+#include "zxing/ResultPoint.h"                      // for ResultPoint
 #include "zxing/ResultPointCallback.h"              // for ResultPointCallback
 
 #include <Utils/Macros.h>
@@ -60,10 +61,14 @@ const DecodeHints DecodeHints::DEFAULT_HINT(
 
 DecodeHints::DecodeHints() {
   hints = 0;
+  consensusRows = 0;
+  deadline = std::chrono::steady_clock::time_point::max();
 }
 
 DecodeHints::DecodeHints(DecodeHintType init) {
   hints = init;
+  consensusRows = 0;
+  deadline = std::chrono::steady_clock::time_point::max();
 }
 
 void DecodeHints::addFormat(BarcodeFormat toadd) noexcept {
@@ -114,6 +119,66 @@ bool DecodeHints::getTryHarder() const {
   return (hints & TRYHARDER_HINT) != 0;
 }
 
+void DecodeHints::setGreyscaleSampling(bool toset) {
+  if (toset) {
+    hints |= GREYSCALE_SAMPLING_HINT;
+  } else {
+    hints &= ~GREYSCALE_SAMPLING_HINT;
+  }
+}
+
+bool DecodeHints::getGreyscaleSampling() const {
+  return (hints & GREYSCALE_SAMPLING_HINT) != 0;
+}
+
+void DecodeHints::setGreyscaleOneD(bool toset) {
+  if (toset) {
+    hints |= GREYSCALE_ONED_HINT;
+  } else {
+    hints &= ~GREYSCALE_ONED_HINT;
+  }
+}
+
+bool DecodeHints::getGreyscaleOneD() const {
+  return (hints & GREYSCALE_ONED_HINT) != 0;
+}
+
+void DecodeHints::setConcurrentReaders(bool toset) {
+  if (toset) {
+    hints |= CONCURRENT_READERS_HINT;
+  } else {
+    hints &= ~CONCURRENT_READERS_HINT;
+  }
+}
+
+bool DecodeHints::getConcurrentReaders() const {
+  return (hints & CONCURRENT_READERS_HINT) != 0;
+}
+
+void DecodeHints::setConsensusRows(int rows) {
+  consensusRows = rows;
+}
+
+int DecodeHints::getConsensusRows() const {
+  return consensusRows;
+}
+
+void DecodeHints::setCancellationToken(Ref<CancellationToken> const& token) {
+    cancellationToken = token;
+}
+
+Ref<CancellationToken> const& DecodeHints::getCancellationToken() const {
+    return cancellationToken;
+}
+
+void DecodeHints::setDeadline(std::chrono::steady_clock::time_point time) {
+    deadline = time;
+}
+
+std::chrono::steady_clock::time_point DecodeHints::getDeadline() const {
+    return deadline;
+}
+
 void DecodeHints::setResultPointCallback(Ref<ResultPointCallback> const& _callback) {
     callback = _callback;
 }
@@ -122,4 +187,12 @@ Ref<ResultPointCallback> DecodeHints::getResultPointCallback() const {
     return callback;
 }
 
+void DecodeHints::setTrackedResultPoints(std::vector<Ref<ResultPoint> > const& points) {
+    trackedPoints = points;
+}
+
+std::vector<Ref<ResultPoint> > const& DecodeHints::getTrackedResultPoints() const {
+    return trackedPoints;
+}
+
 } /* namespace */
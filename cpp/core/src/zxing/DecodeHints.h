@@ -18,10 +18,15 @@
  * limitations under the License.
  */
 
-#include <zxing/BarcodeFormat.h>        // for BarcodeFormat, BarcodeFormat::AZTEC_BARCODE, BarcodeFormat::CODE_128, BarcodeFormat::CODE_39, BarcodeFormat::Barcod...
-#include <zxing/ResultPointCallback.h>  // for ResultPointCallback
+#include <zxing/BarcodeFormat.h>             // for BarcodeFormat, BarcodeFormat::AZTEC_BARCODE, BarcodeFormat::CODE_128, BarcodeFormat::CODE_39, BarcodeFormat::Barcod...
+#include <zxing/ResultPoint.h>               // for ResultPoint
+#include <zxing/ResultPointCallback.h>       // for ResultPointCallback
 
-#include "zxing/common/Counted.h"       // for Ref
+#include "zxing/common/CancellationToken.h"  // for CancellationToken
+#include "zxing/common/Counted.h"            // for Ref
+
+#include <chrono>                            // for steady_clock
+#include <vector>                            // for vector
 
 namespace pping {
 
@@ -35,6 +40,14 @@ class DecodeHints {
 
   Ref<ResultPointCallback> callback;
 
+  std::vector<Ref<ResultPoint> > trackedPoints;
+
+  int consensusRows;
+
+  Ref<CancellationToken> cancellationToken;
+
+  std::chrono::steady_clock::time_point deadline;
+
  public:
 
   static const DecodeHintType BARCODEFORMAT_QR_CODE_HINT = 1 << static_cast<int>(BarcodeFormat::QR_CODE);
@@ -47,6 +60,9 @@ class DecodeHints {
   static const DecodeHintType BARCODEFORMAT_CODE_39_HINT = 1 << static_cast<int>(BarcodeFormat::CODE_39);
   static const DecodeHintType BARCODEFORMAT_ITF_HINT = 1 << static_cast<int>(BarcodeFormat::ITF);
   static const DecodeHintType BARCODEFORMAT_AZTEC_HINT = 1 << static_cast<int>(BarcodeFormat::AZTEC_BARCODE);
+  static const DecodeHintType GREYSCALE_ONED_HINT = 1 << 27;
+  static const DecodeHintType CONCURRENT_READERS_HINT = 1 << 28;
+  static const DecodeHintType GREYSCALE_SAMPLING_HINT = 1 << 29;
   static const DecodeHintType CHARACTER_SET = 1 << 30;
   static const DecodeHintType TRYHARDER_HINT = static_cast< DecodeHintType >( 1 << 31 );
 
@@ -62,9 +78,78 @@ class DecodeHints {
   void setTryHarder(bool toset);
   bool getTryHarder() const;
 
+  /**
+   * QR codes: locate the finder patterns on a downscaled binarization and
+   * threshold each module from the greyscale samples at its centre, instead of
+   * binarizing the whole image at full resolution. Data Matrix and Aztec
+   * codes: keep the greyscale samples of the modules as well. Either way, the
+   * decoder retries on the samples when error correction fails.
+   */
+  void setGreyscaleSampling(bool toset);
+  bool getGreyscaleSampling() const;
+
+  /**
+   * 1D barcodes only: measure the bars of each scanned row from the edges of
+   * its luminance profile, to sub-pixel precision, instead of binarizing the
+   * row. This keeps blurred narrow bars apart, so fewer rows are needed, but
+   * a few sharp codes that read when binarized do not.
+   */
+  void setGreyscaleOneD(bool toset);
+  bool getGreyscaleOneD() const;
+
+  /**
+   * 1D barcodes: instead of returning the first row that decodes, take a
+   * majority vote on each character over the rows read so far, and return as
+   * soon as every character was read the same way on at least this many more
+   * rows than any other way. Rows with a wrong UPC/EAN checksum still vote,
+   * the checksum is checked on the voted text. 0, the default, turns voting
+   * off.
+   */
+  void setConsensusRows(int rows);
+  int getConsensusRows() const;
+
+  /**
+   * MultiFormatReader: run the readers of the different formats at once, each
+   * on a thread of its own, on one shared binarization of the image. The
+   * first reader to decode cancels the others. Saves most on images with no
+   * code in them, which otherwise pay for every reader one after the other.
+   * A result point callback is then called from several threads.
+   */
+  void setConcurrentReaders(bool toset);
+  bool getConcurrentReaders() const;
+
+  /**
+   * Lets the caller, or MultiFormatReader with concurrent readers, stop a
+   * decode half way. Readers poll it in their scan loops and fail with a
+   * TimeoutException once it is cancelled.
+   */
+  void setCancellationToken(Ref<CancellationToken> const&);
+  Ref<CancellationToken> const& getCancellationToken() const;
+
+  /**
+   * The time by which a decode has to give up, polled like the cancellation
+   * token. There is none by default.
+   */
+  void setDeadline(std::chrono::steady_clock::time_point);
+  std::chrono::steady_clock::time_point getDeadline() const;
+
+  /** Whether the cancellation token was cancelled or the deadline passed. */
+  bool isCancelled() const noexcept {
+    return (!cancellationToken.empty() && cancellationToken->isCancelled()) ||
+           (deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= deadline);
+  }
+
   void setResultPointCallback(Ref<ResultPointCallback> const&);
   Ref<ResultPointCallback> getResultPointCallback() const;
 
+  /**
+   * QR codes only: the result points of the code found in the previous video
+   * frame. The detector first looks for the finder patterns in small windows
+   * around them, and only scans the whole image if that fails.
+   */
+  void setTrackedResultPoints(std::vector<Ref<ResultPoint> > const&);
+  std::vector<Ref<ResultPoint> > const& getTrackedResultPoints() const;
+
 };
 
 }
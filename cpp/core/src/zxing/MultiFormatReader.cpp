@@ -28,23 +28,53 @@
 
 #include "zxing/BarcodeFormat.h"                    // for BarcodeFormat::AZTEC_BARCODE, BarcodeFormat::CODE_128, BarcodeFormat::CODE_39, BarcodeFormat::BarcodeFo...
 #include "zxing/BinaryBitmap.h"                     // for BinaryBitmap
+#include "zxing/DecodeContext.h"                    // for DecodeContext
 #include "zxing/DecodeHints.h"                      // for DecodeHints, DecodeHints::DEFAULT_HINT
 #include "zxing/Reader.h"                           // for Reader
 #include "zxing/Result.h"                           // for Result
+#include "zxing/TimeoutException.h"                 // for TimeoutException
+#include "zxing/common/CancellationToken.h"         // for CancellationToken
+#ifndef NO_THREADS
+#include "zxing/common/Threads.h"                   // for runOnThreads
+#endif
 
 namespace pping {
-  MultiFormatReader::MultiFormatReader() {
+  namespace {
+    const BarcodeFormat READER_FORMATS[] = {
+      BarcodeFormat::QR_CODE, BarcodeFormat::DATA_MATRIX, BarcodeFormat::UPC_E, BarcodeFormat::UPC_A,
+      BarcodeFormat::EAN_8, BarcodeFormat::EAN_13, BarcodeFormat::CODE_128, BarcodeFormat::CODE_39,
+      BarcodeFormat::ITF, BarcodeFormat::AZTEC_BARCODE
+    };
+
+    // The hints the choice and set up of the readers depend on
+    DecodeHintType readersKey(DecodeHints const& hints) {
+      DecodeHintType key = hints.getTryHarder() ? DecodeHints::TRYHARDER_HINT : 0;
+      for (BarcodeFormat format : READER_FORMATS) {
+        if (hints.containsFormat(format)) {
+          key |= 1u << static_cast<int>(format);
+        }
+      }
+      return key;
+    }
+  }
+
+  MultiFormatReader::MultiFormatReader() : readersKey_(0) {
 
   }
   
   FallibleRef<Result> MultiFormatReader::decode(Ref<BinaryBitmap> image) MB_NOEXCEPT_EXCEPT_BADALLOC {
     setHints(DecodeHints::DEFAULT_HINT);
-    return decodeInternal(image);
+    return decodeInternal(Ref<DecodeContext>(new DecodeContext(image)));
   }
 
   FallibleRef<Result> MultiFormatReader::decode(Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
     setHints(hints);
-    return decodeInternal(image);
+    return decodeInternal(Ref<DecodeContext>(new DecodeContext(image)));
+  }
+
+  FallibleRef<Result> MultiFormatReader::decode(Ref<DecodeContext> context, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    setHints(hints);
+    return decodeInternal(context);
   }
 
   FallibleRef<Result> MultiFormatReader::decodeWithState(Ref<BinaryBitmap> image) MB_NOEXCEPT_EXCEPT_BADALLOC {
@@ -52,11 +82,16 @@ namespace pping {
     if (readers_.size() == 0) {
       setHints(DecodeHints::DEFAULT_HINT);
     }
-    return decodeInternal(image);
+    return decodeInternal(Ref<DecodeContext>(new DecodeContext(image)));
   }
 
   void MultiFormatReader::setHints(DecodeHints hints) {
     hints_ = hints;
+    DecodeHintType key = readersKey(hints);
+    if (!readers_.empty() && key == readersKey_) {
+      return;
+    }
+    readersKey_ = key;
     readers_.clear();
     bool tryHarder = hints.getTryHarder();
 
@@ -85,14 +120,88 @@ namespace pping {
     }
   }
 
-  FallibleRef<Result> MultiFormatReader::decodeInternal(Ref<BinaryBitmap> image) MB_NOEXCEPT_EXCEPT_BADALLOC {
-    for ( auto const & pReader : readers_ ) {
-        auto result( pReader->decode(image, hints_) );
-        if (result)
-            return result;
+  Fallible<std::vector<Ref<Result> > > MultiFormatReader::decodeAllFormats(Ref<BinaryBitmap> image,
+      DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    return decodeAllFormats(Ref<DecodeContext>(new DecodeContext(image)), hints);
+  }
+
+  Fallible<std::vector<Ref<Result> > > MultiFormatReader::decodeAllFormats(Ref<DecodeContext> context,
+      DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    setHints(hints);
+    std::vector<Ref<Result> > decoded;
+#ifndef NO_THREADS
+    if (hints_.getConcurrentReaders() && readers_.size() > 1) {
+      decoded = decodeConcurrently(context, false);
+    } else
+#endif
+    {
+      for ( auto const & pReader : readers_ ) {
+          if (hints_.isCancelled())
+              break;
+          auto result( pReader->decode(context, hints_) );
+          if (result)
+              decoded.push_back(*result);
+      }
+    }
+    std::vector<Ref<Result> > results;
+    for (auto const & result : decoded) {
+      if (!result.empty())
+        results.push_back(result);
+    }
+    if (results.empty() && hints_.isCancelled())
+      return failure<TimeoutException>("Decoding timed out");
+    if (results.empty())
+      return failure<ReaderException>("No code detected");
+    return results;
+  }
+
+  FallibleRef<Result> MultiFormatReader::decodeInternal(Ref<DecodeContext> context) MB_NOEXCEPT_EXCEPT_BADALLOC {
+#ifndef NO_THREADS
+    if (hints_.getConcurrentReaders() && readers_.size() > 1) {
+      // Of the readers that decoded before they were cancelled, the one that comes first
+      for (auto const & result : decodeConcurrently(context, true)) {
+        if (!result.empty())
+          return result;
+      }
+    } else
+#endif
+    {
+      for ( auto const & pReader : readers_ ) {
+          if (hints_.isCancelled())
+              break;
+          auto result( pReader->decode(context, hints_) );
+          if (result)
+              return result;
+      }
     }
+    if (hints_.isCancelled())
+      return failure<TimeoutException>("Decoding timed out");
     return failure<ReaderException>("No code detected");
   }
+
+#ifndef NO_THREADS
+  std::vector<Ref<Result> > MultiFormatReader::decodeConcurrently(Ref<DecodeContext> context,
+      bool firstOnly) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    // Cancelled by the first result as well as by the caller's token and deadline
+    DecodeHints hints(hints_);
+    Ref<CancellationToken> token(new CancellationToken(hints_.getCancellationToken()));
+    if (firstOnly) {
+      hints.setCancellationToken(token);
+    }
+
+    // Each reader is used by one thread only, and writes only its own slot
+    std::vector<Ref<Result> > results(readers_.size());
+    auto decode = [&](size_t i) {
+      auto result( readers_[i]->decode(context, hints) );
+      if (result) {
+        results[i] = *result;
+        token->cancel();
+      }
+    };
+    runOnThreads(readers_.size(), decode);
+    return results;
+  }
+#endif
   
   MultiFormatReader::~MultiFormatReader() {
 
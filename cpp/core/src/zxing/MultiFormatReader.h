@@ -29,22 +29,48 @@
 
 namespace pping {
 class BinaryBitmap;
+class DecodeContext;
 class Result;
 
   class MultiFormatReader : public Reader {
     
   private:
-    FallibleRef<Result> decodeInternal(Ref<BinaryBitmap> image) MB_NOEXCEPT_EXCEPT_BADALLOC;
+    // Every reader decodes from the same context, so none derives a product of the image again
+    FallibleRef<Result> decodeInternal(Ref<DecodeContext> context) MB_NOEXCEPT_EXCEPT_BADALLOC;
+#ifndef NO_THREADS
+    /**
+     * Runs each reader on a thread of its own and returns what each decoded,
+     * in the order of readers_. With firstOnly the first reader to decode
+     * cancels the others.
+     */
+    std::vector<Ref<Result> > decodeConcurrently(Ref<DecodeContext> context, bool firstOnly) MB_NOEXCEPT_EXCEPT_BADALLOC;
+#endif
   
     std::vector<Ref<Reader> > readers_;
     DecodeHints hints_;
+    // The hints readers_ were built for: the formats and whether to try harder
+    DecodeHintType readersKey_;
 
   public:
     MultiFormatReader();
     
     FallibleRef<Result> decode(Ref<BinaryBitmap> image) MB_NOEXCEPT_EXCEPT_BADALLOC;
     FallibleRef<Result> decode(Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
+    FallibleRef<Result> decode(Ref<DecodeContext> context, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
     FallibleRef<Result> decodeWithState(Ref<BinaryBitmap> image) MB_NOEXCEPT_EXCEPT_BADALLOC;
+    /**
+     * Lets every reader the hints allow decode the image, instead of stopping
+     * at the first that does, and returns their results, one per format
+     * family. The readers run at once if the hints ask for concurrent
+     * readers.
+     */
+    Fallible<std::vector<Ref<Result> > > decodeAllFormats(Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
+    Fallible<std::vector<Ref<Result> > > decodeAllFormats(Ref<DecodeContext> context, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
+    /**
+     * Sets the hints passed on to the readers. The readers themselves are kept
+     * and only built again when the formats or the try harder hint change,
+     * so decoding frame after frame with the same hints allocates none.
+     */
     void setHints(DecodeHints hints);
     ~MultiFormatReader();
   };
@@ -20,9 +20,10 @@
 
 #include <zxing/Reader.h>
 
-#include "zxing/BinaryBitmap.h"  // for BinaryBitmap
-#include "zxing/DecodeHints.h"   // for DecodeHints, DecodeHints::DEFAULT_HINT
-#include "zxing/Result.h"        // for Result
+#include "zxing/BinaryBitmap.h"   // for BinaryBitmap
+#include "zxing/DecodeContext.h"  // for DecodeContext
+#include "zxing/DecodeHints.h"    // for DecodeHints, DecodeHints::DEFAULT_HINT
+#include "zxing/Result.h"         // for Result
 
 namespace pping {
 
@@ -30,4 +31,8 @@ FallibleRef<Result> Reader::decode(Ref<BinaryBitmap> image) MB_NOEXCEPT_EXCEPT_B
   return decode(image, DecodeHints::DEFAULT_HINT);
 }
 
+FallibleRef<Result> Reader::decode(Ref<DecodeContext> context, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  return decode(context->getImage(), hints);
+}
+
 }
@@ -27,6 +27,7 @@
 namespace pping {
 
 class BinaryBitmap;
+class DecodeContext;
 class Result;
 
  class Reader : public Counted {
@@ -36,6 +37,12 @@ class Result;
   public:
    virtual FallibleRef<Result> decode(Ref<BinaryBitmap> image) MB_NOEXCEPT_EXCEPT_BADALLOC;
    virtual FallibleRef<Result> decode(Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC = 0;
+   /**
+    * Decodes the image of context, taking what other readers already derived
+    * from it from there. Readers that derive nothing shareable leave this to
+    * decode(image, hints).
+    */
+   virtual FallibleRef<Result> decode(Ref<DecodeContext> context, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
 };
 
 }
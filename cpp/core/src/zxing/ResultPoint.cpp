@@ -35,14 +35,6 @@ ResultPoint::ResultPoint(float x, float y) : posX_(x), posY_(y) {}
   
 ResultPoint::~ResultPoint() {}
 
-float ResultPoint::getX() const {
-  return posX_;
-}
-    
-float ResultPoint::getY() const {
-  return posY_;
-}
-
 bool ResultPoint::equals(Ref<ResultPoint> other) {
   return posX_ == other->getX() && posY_ == other->getY();
 }
@@ -35,8 +35,8 @@ public:
   ResultPoint(float x, float y);
   virtual ~ResultPoint();
 
-  virtual float getX() const;
-  virtual float getY() const;
+  float getX() const { return posX_; }
+  float getY() const { return posY_; }
 
   bool equals(Ref<ResultPoint> other);
 
@@ -0,0 +1,36 @@
+// -*- mode:c++; tab-width:2; indent-tabs-mode:nil; c-basic-offset:2 -*-
+
+#pragma once
+
+/*
+ * Copyright 2011 ZXing authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/ReaderException.h>  // for ReaderException
+
+namespace pping {
+
+  /**
+   * A decode that stopped before it finished, because the deadline in its
+   * hints passed or their cancellation token was cancelled. Where failures
+   * carry no exception, DecodeHints::isCancelled tells the two apart.
+   */
+  class TimeoutException : public ReaderException {
+  public:
+    TimeoutException(const char *msg);
+    ~TimeoutException() throw();
+  };
+
+}
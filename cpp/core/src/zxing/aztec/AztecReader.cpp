@@ -20,41 +20,76 @@
  */
 
 #include <zxing/aztec/AztecReader.h>
-#include <zxing/aztec/detector/ZxingAztecDetector.h>    // for Detector
-#include <vector>                                       // for allocator, vector
-
-#include "zxing/BarcodeFormat.h"                        // for BarcodeFormat::AZTEC_BARCODE
-#include "zxing/BinaryBitmap.h"                         // for BinaryBitmap
-#include "zxing/DecodeHints.h"                          // for DecodeHints
-#include "zxing/Result.h"                               // for Result
-#include "zxing/ResultPoint.h"                          // for ResultPoint
-#include "zxing/aztec/AztecDetectorResult.h"            // for AztecDetectorResult
-#include "zxing/aztec/decoder/Decoder.h"                // for Decoder
-#include "zxing/common/BitMatrix.h"                     // for BitMatrix
-#include "zxing/common/DecoderResult.h"                 // for DecoderResult
-#include "zxing/common/Str.h"                           // for String
+#include <zxing/aztec/detector/ZxingAztecBullseyeFinder.h>  // for BullseyeFinder
+#include <zxing/aztec/detector/ZxingAztecDetector.h>        // for Detector, Point
+#include <vector>                                           // for allocator, vector
+
+#include "zxing/BarcodeFormat.h"                            // for BarcodeFormat::AZTEC_BARCODE
+#include "zxing/BinaryBitmap.h"                             // for BinaryBitmap
+#include "zxing/DecodeContext.h"                            // for DecodeContext
+#include "zxing/DecodeHints.h"                              // for DecodeHints
+#include "zxing/LuminanceSource.h"                          // for LuminanceSource
+#include "zxing/Result.h"                                   // for Result
+#include "zxing/ResultPoint.h"                              // for ResultPoint
+#include "zxing/TimeoutException.h"                         // for TimeoutException
+#include "zxing/aztec/AztecDetectorResult.h"                // for AztecDetectorResult
+#include "zxing/aztec/decoder/Decoder.h"                    // for Decoder
+#include "zxing/common/BitMatrix.h"                         // for BitMatrix
+#include "zxing/common/DecoderResult.h"                     // for DecoderResult
+#include "zxing/common/Str.h"                               // for String
 
 namespace pping {
   namespace aztec {
 
+    namespace {
+      // Most bull's eyes found by BullseyeFinder that are tried before the centre one
+      const int MAX_CANDIDATES = 4;
+    }
+
     AztecReader::AztecReader() : decoder_() {
       // nothing
     }
 
     FallibleRef<Result> AztecReader::decode(Ref<pping::BinaryBitmap> image) MB_NOEXCEPT_EXCEPT_BADALLOC {
-      auto const blackMatrix(image->getBlackMatrix());
+      return decode(Ref<DecodeContext>(new DecodeContext(image)), DecodeHints());
+    }
+
+    FallibleRef<Result> AztecReader::decode(Ref<DecodeContext> context, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+      auto const blackMatrix(context->getBlackMatrix());
       if (!blackMatrix)
           return blackMatrix.error();
-      Detector detector(*blackMatrix);
-
-
+      // With greyscale sampling, keep the luminance of each module for the
+      // decoder to fall back on
+      Detector detector(*blackMatrix, hints.getGreyscaleSampling() ? context->getImage()->getLuminanceSource()
+                                                                   : Ref<LuminanceSource>());
+
+      // Bull's eyes anywhere in the image first, then the one around the centre
+      BullseyeFinder finder(*blackMatrix);
+      std::vector<Point> centers(finder.find(MAX_CANDIDATES));
+      for (size_t i = 0; i < centers.size(); i++) {
+        if (hints.isCancelled())
+          return failure<TimeoutException>("Decoding timed out");
+        auto const detectorResult(detector.detect(centers[i]));
+        if (!detectorResult)
+          continue;
+        auto const result(decode(*detectorResult));
+        if (result)
+          return result;
+      }
+
+      if (hints.isCancelled())
+        return failure<TimeoutException>("Decoding timed out");
       auto const detectorResult(detector.detect());
       if(!detectorResult)
           return detectorResult.error();
 
-      std::vector<Ref<ResultPoint> > points(detectorResult.result()->getPoints());
+      return decode(*detectorResult);
+    }
+
+    FallibleRef<Result> AztecReader::decode(Ref<AztecDetectorResult> detectorResult) MB_NOEXCEPT_EXCEPT_BADALLOC {
+      std::vector<Ref<ResultPoint> > points(detectorResult->getPoints());
 
-      auto const getDecoderResult(decoder_.decode(*detectorResult));
+      auto const getDecoderResult(decoder_.decode(detectorResult));
       if(!getDecoderResult)
           return getDecoderResult.error();
 
@@ -28,7 +28,11 @@
 
 namespace pping {
 class BinaryBitmap;
+class DecodeContext;
 class Result;
+namespace aztec {
+class AztecDetectorResult;
+}  // namespace aztec
 }  // namespace pping
 
 #pragma once
@@ -39,14 +43,17 @@ namespace pping {
         class AztecReader : public Reader {
         private:
             Decoder decoder_;
-            
+
         protected:
             Decoder &getDecoder();
             
         public:
             AztecReader();
+            /** Decodes a symbol the detector already located, see MultiFormatMultipleBarcodeReader. */
+            FallibleRef<Result> decode(Ref<AztecDetectorResult> detectorResult) MB_NOEXCEPT_EXCEPT_BADALLOC;
             virtual FallibleRef<Result> decode(Ref<BinaryBitmap> image) MB_NOEXCEPT_EXCEPT_BADALLOC override;
             virtual FallibleRef<Result> decode(Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC override;
+            virtual FallibleRef<Result> decode(Ref<DecodeContext> context, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC override;
             virtual ~AztecReader();
         };
         
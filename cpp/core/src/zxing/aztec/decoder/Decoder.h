@@ -21,11 +21,16 @@
 
 #pragma once
 
+#include <zxing/common/Array.h>
 #include <zxing/common/DecoderResult.h>
 #include <zxing/common/BitMatrix.h>
+#include <zxing/common/ByteMatrix.h>
+#include <zxing/common/Span.h>
 #include <zxing/common/Str.h>
 #include <zxing/aztec/AztecDetectorResult.h>
 
+#include <vector>
+
 namespace pping {
     namespace aztec {
         
@@ -51,15 +56,44 @@ namespace pping {
             Ref<String> getEncodedData(Ref<BitArray> correctedBits,
             						   ArrayRef<unsigned char> mergedRawBytes,
             						   ArrayRef< ArrayRef<unsigned char> > byteSegments);
-            FallibleRef<BitArray> correctBits(Ref<BitArray> rawbits);
-            FallibleRef<BitArray> extractBits(Ref<BitMatrix> matrix) MB_NOEXCEPT_EXCEPT_BADALLOC;
-            static Ref<BitMatrix> removeDashedLines(Ref<BitMatrix> matrix);
+            FallibleRef<DecoderResult> decodeCorrected(Ref<BitArray> correctedBits) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            FallibleRef<BitArray> correctBits(Span<int> dataWords, std::vector<int> const& erasures);
+            /**
+             * Reads and corrects the codewords of matrix. With moduleConfidence,
+             * the codewords read from unreliable modules are erased first.
+             */
+            FallibleRef<BitArray> correctMatrix(Ref<BitMatrix> matrix, Ref<ByteMatrix> moduleConfidence) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            /**
+             * Reads the codewords of the sampled matrix straight into integers
+             * through a table of where the bits of each lie for its size.
+             */
+            Fallible<void> readCodewords(Ref<BitMatrix> matrix, std::vector<int>& dataWords) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            /**
+             * For each codeword, in the order readCodewords returns them, the
+             * lowest confidence of the modules it was read from.
+             */
+            void readCodewordConfidence(ByteMatrix const& moduleConfidence, std::vector<unsigned char>& confidence) MB_NOEXCEPT_EXCEPT_BADALLOC;
             static int readCode(Ref<BitArray> rawbits, int startIndex, int length);
             
             
         public:
             Decoder();
+            /**
+             * If error correction fails and the detector kept the greyscale
+             * samples of the modules, retries on those: first with the
+             * codewords read from unreliable modules erased, then with shifted
+             * thresholds.
+             */
             FallibleRef<DecoderResult> decode(Ref<AztecDetectorResult> detectorResult) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+            /** Side of the sampled matrix, reference grid lines included, as Detector samples it. */
+            static int matrixSize(bool compact, int layers);
+            /**
+             * Where each codeword bit of a symbol of this size lies in its sampled
+             * matrix, as offsets into the matrix bits, the most significant bit of
+             * the first codeword first. Built on first use.
+             */
+            static std::vector<unsigned int> const& getCodewordBits(bool compact, int layers);
         };
         
     }
@@ -19,20 +19,15 @@
  * limitations under the License.
  */
 
-#ifndef NO_ICONV
-#   include "Wrappers/Iconv.hpp"                            // for iconv, iconv_close, iconv_open, iconv_t
-#   ifdef __APPLE__
-#       include <TargetConditionals.h>
-#   endif
-#endif
-
-
 #include "zxing/aztec/AztecDetectorResult.h"                // for AztecDetectorResult
 #include "zxing/common/Array.h"                             // for ArrayRef, Array
 #include "zxing/common/BitArray.h"                          // for BitArray
 #include "zxing/common/BitMatrix.h"                         // for BitMatrix
+#include "zxing/common/ByteMatrix.h"                        // for ByteMatrix
 #include "zxing/common/Counted.h"                           // for Ref
 #include "zxing/common/DecoderResult.h"                     // for DecoderResult, SegmentsMetadata::TEXT_DATA, SegmentsMetadata::BYTE_DATA
+#include "zxing/common/ModuleSamples.h"                     // for ModuleSamples
+#include "zxing/common/Span.h"                              // for Span
 #include "zxing/common/Str.h"                               // for String
 #include "zxing/aztec/decoder/Decoder.h"                    // for Decoder, Decoder::Table, Decoder::Table::BINARY, Decoder::Table::UPPER, Decoder::Table::DIGIT, Decoder::Table::LOWER, Decoder::Ta...
 #include "zxing/common/IllegalArgumentException.h"          // for IllegalArgumentException
@@ -42,10 +37,16 @@
 #include "zxing/FormatException.h"                          // for FormatException
 
 #include <boost/assert.hpp>
-#include <iterator>                                         // for __bit_reference
+#include <algorithm>                                        // for min
+#include <functional>                                       // for ref
+#include <limits>                                           // for numeric_limits
 #include <stddef.h>                                         // for size_t
+#include <stdlib.h>                                         // for abs
 #include <string>                                           // for string
-#include <vector>                                           // for vector, allocator, vector<>::reference
+#include <vector>                                           // for vector, allocator
+#ifndef NO_THREADS
+#include <mutex>                                            // for once_flag, call_once
+#endif
 
 using pping::aztec::Decoder;
 using pping::DecoderResult;
@@ -54,6 +55,7 @@ using pping::BitArray;
 using pping::BitMatrix;
 using pping::Ref;
 using pping::ArrayRef;
+using pping::Span;
 
 using std::string;
 
@@ -61,25 +63,16 @@ namespace
 {
 void add( string& result, unsigned char character )
 {
-#ifndef NO_ICONV
-    char    s[] = { static_cast<char>( character & 0xff ) };
-    size_t  sl  = sizeof( s );
-    char    d[ 4 ];
-    char*   ds = d;
-    size_t  dl = sizeof( d );
-    iconv_t ic = iconv_open( "UTF-8", "ISO-8859-1" );
-#if TARGET_OS_IPHONE || defined( __EMSCRIPTEN__ )
-    char * ss = s;
-#else
-    char const* ss = s;
-#endif
-    iconv( ic, &ss, &sl, &ds, &dl );
-    iconv_close( ic );
-    d[ sizeof( d ) - dl ] = 0;
-    result.append( d );
-#else
-    result.push_back( character );
-#endif
+    // Aztec text is ISO-8859-1, whose code points are its byte values
+    if ( character < 0x80 )
+    {
+        result.push_back( static_cast<char>( character ) );
+    }
+    else
+    {
+        result.push_back( static_cast<char>( 0xC0 | ( character >> 6 ) ) );
+        result.push_back( static_cast<char>( 0x80 | ( character & 0x3F ) ) );
+    }
 }
 
 const int NB_BITS_COMPACT[] = {
@@ -124,6 +117,108 @@ const char* PUNCT_TABLE[] = {
 const char* DIGIT_TABLE[] = {
     "CTRL_PS", " ", "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", ",", ".", "CTRL_UL", "CTRL_US"
 };
+
+const int MAX_LAYERS_COMPACT = 4;
+const int MAX_LAYERS         = 32;
+
+/**
+ * Where each codeword bit of one symbol size lies in its sampled matrix, as
+ * offsets into the matrix bits, the most significant bit of the first
+ * codeword first.
+ */
+struct CodewordBits
+{
+    std::vector<unsigned int> offsets;
+#ifndef NO_THREADS
+    std::once_flag built;
+#endif
+};
+
+CodewordBits COMPACT_CODEWORD_BITS[ MAX_LAYERS_COMPACT + 1 ];
+CodewordBits CODEWORD_BITS[ MAX_LAYERS + 1 ];
+
+int codewordSize( int layers )
+{
+    return layers <= 2 ? 6 : layers <= 8 ? 8 : layers <= 22 ? 10 : 12;
+}
+
+void buildCodewordBits( CodewordBits& codewordBits, bool compact, int layers )
+{
+    int width = Decoder::matrixSize( compact, layers );
+
+    // The rows and columns that are not on the reference grid lines of full symbols
+    std::vector<unsigned int> kept;
+    for ( int x = 0; x < width; x++ )
+    {
+        if ( compact || abs( width / 2 - x ) % 16 != 0 )
+        {
+            kept.push_back( (unsigned int) x );
+        }
+    }
+
+    // The layers are read from the outside in, each going around the symbol
+    // two modules deep, a side at a time
+    int nbBits = compact ? NB_BITS_COMPACT[ layers ] : NB_BITS[ layers ];
+    std::vector<unsigned int> rawOffsets( nbBits );
+    int size          = (int) kept.size();
+    int rawbitsOffset = 0;
+    int matrixOffset  = 0;
+    for ( int layer = layers; layer != 0; layer-- )
+    {
+        int flip = 0;
+        for ( int i = 0; i < 2 * size - 4; i++ )
+        {
+            rawOffsets[ rawbitsOffset + i ] =
+                kept[ matrixOffset + flip ] + kept[ matrixOffset + i / 2 ] * width;
+            rawOffsets[ rawbitsOffset + 2 * size - 4 + i ] =
+                kept[ matrixOffset + i / 2 ] + kept[ matrixOffset + size - 1 - flip ] * width;
+            flip = ( flip + 1 ) % 2;
+        }
+
+        flip = 0;
+        for ( int i = 2 * size + 1; i > 5; i-- )
+        {
+            rawOffsets[ rawbitsOffset + 4 * size - 8 + ( 2 * size - i ) + 1 ] =
+                kept[ matrixOffset + size - 1 - flip ] + kept[ matrixOffset + i / 2 - 1 ] * width;
+            rawOffsets[ rawbitsOffset + 6 * size - 12 + ( 2 * size - i ) + 1 ] =
+                kept[ matrixOffset + i / 2 - 1 ] + kept[ matrixOffset + flip ] * width;
+            flip = ( flip + 1 ) % 2;
+        }
+
+        matrixOffset  += 2;
+        rawbitsOffset += 8 * size - 16;
+        size          -= 4;
+    }
+
+    // The codewords are aligned to the end of the bits, the first ones are unused
+    int numCodewords = compact ? NB_DATABLOCK_COMPACT[ layers ] : NB_DATABLOCK[ layers ];
+    codewordBits.offsets.assign( rawOffsets.end() - numCodewords * codewordSize( layers ), rawOffsets.end() );
+}
+
+}
+
+int Decoder::matrixSize( bool compact, int layers )
+{
+    if ( compact )
+    {
+        return 4 * layers + 11;
+    }
+    int baseSize = 4 * layers + 14;
+    return baseSize + 1 + 2 * ( ( baseSize / 2 - 1 ) / 15 );
+}
+
+std::vector<unsigned int> const& Decoder::getCodewordBits( bool compact, int layers )
+{
+    CodewordBits& codewordBits = compact ? COMPACT_CODEWORD_BITS[ layers ] : CODEWORD_BITS[ layers ];
+#ifndef NO_THREADS
+    std::call_once( codewordBits.built, buildCodewordBits, std::ref( codewordBits ), compact, layers );
+#else
+    if ( codewordBits.offsets.empty() )
+    {
+        buildCodewordBits( codewordBits, compact, layers );
+    }
+#endif
+    return codewordBits.offsets;
 }
 
 Decoder::Table Decoder::getTable( char t )
@@ -177,34 +272,38 @@ pping::FallibleRef<DecoderResult> Decoder::decode( Ref<pping::aztec::AztecDetect
 {
     ddata_ = detectorResult;
 
-    // std::printf("getting bits\n");
-
-    Ref<BitMatrix> matrix = detectorResult->getBits();
-
-    if ( !ddata_->isCompact() )
+    auto const bitCorrection( correctMatrix( detectorResult->getBits(), Ref<pping::ByteMatrix>() ) );
+    if ( bitCorrection )
     {
-        // std::printf("removing lines\n");
-        matrix = removeDashedLines( ddata_->getBits() );
+        return decodeCorrected( *bitCorrection );
     }
-
-    // std::printf("extracting bits\n");
-    auto const getRawBits( extractBits( matrix ) );
-    if ( !getRawBits )
+    Ref<pping::ModuleSamples> samples( detectorResult->getModuleSamples() );
+    if ( samples.empty() )
     {
-        return getRawBits.error();
+        return bitCorrection.error();
     }
 
-    auto const rawbits = *getRawBits;
+    // Retry on the samples the bits came from
+    auto const tryCorrectErasures( correctMatrix( samples->threshold( 0 ), samples->getConfidence() ) );
+    if ( tryCorrectErasures )
+    {
+        return decodeCorrected( *tryCorrectErasures );
+    }
 
-    // std::printf("correcting bits\n");
-    auto const bitCorrection( correctBits( rawbits ) );
-    if ( !bitCorrection )
+    for ( int bias : { -pping::ModuleSamples::RETHRESHOLD_BIAS, +pping::ModuleSamples::RETHRESHOLD_BIAS } )
     {
-        return bitCorrection.error();
+        auto const tryRethreshold( correctMatrix( samples->threshold( bias ), Ref<pping::ByteMatrix>() ) );
+        if ( tryRethreshold )
+        {
+            return decodeCorrected( *tryRethreshold );
+        }
     }
 
-    auto const aCorrectedBits( *bitCorrection );
+    return bitCorrection.error();
+}
 
+pping::FallibleRef<DecoderResult> Decoder::decodeCorrected( Ref<pping::BitArray> aCorrectedBits ) MB_NOEXCEPT_EXCEPT_BADALLOC
+{
     // std::printf("decoding bits\n");
     ArrayRef<unsigned char>             mergedRawBytes( (size_t) 0 );
     ArrayRef< ArrayRef<unsigned char> > byteSegments( (size_t) 0 );
@@ -390,84 +489,62 @@ Ref<String> Decoder::getEncodedData(
     return Ref<String>( new String( result ) );
 }
 
-pping::FallibleRef<BitArray> Decoder::correctBits( Ref<pping::BitArray> rawbits )
+pping::FallibleRef<BitArray> Decoder::correctMatrix( Ref<pping::BitMatrix> matrix, Ref<pping::ByteMatrix> moduleConfidence ) MB_NOEXCEPT_EXCEPT_BADALLOC
 {
-    //return rawbits;
-    // std::printf("decoding stuff:%d datablocks in %d layers\n", ddata_->getNBDatablocks(), ddata_->getNBLayers());
-
-    Ref<GenericGF> gf = GenericGF::AZTEC_DATA_6;
-
-    if ( ddata_->getNBLayers() <= 2 )
-    {
-        codewordSize_ = 6;
-        gf            = GenericGF::AZTEC_DATA_6;
-    }
-    else if ( ddata_->getNBLayers() <= 8 )
+    std::vector<int> dataWords;
+    auto const getDataWords( readCodewords( matrix, dataWords ) );
+    if ( !getDataWords )
     {
-        codewordSize_ = 8;
-        gf            = GenericGF::AZTEC_DATA_8;
+        return getDataWords.error();
     }
-    else if ( ddata_->getNBLayers() <= 22 )
-    {
-        codewordSize_ = 10;
-        gf            = GenericGF::AZTEC_DATA_10;
-    }
-    else
+
+    std::vector<int> erasures;
+    if ( moduleConfidence )
     {
-        codewordSize_ = 12;
-        gf            = GenericGF::AZTEC_DATA_12;
+        std::vector<unsigned char> confidence;
+        readCodewordConfidence( *moduleConfidence, confidence );
+        erasures = pping::ModuleSamples::selectErasures( Span<unsigned char const>( confidence ),
+                                                         numCodewords_ - ddata_->getNBDatablocks() );
     }
 
-    int numDataCodewords = ddata_->getNBDatablocks();
-    int numECCodewords;
-    int offset;
+    return correctBits( Span<int>( dataWords ), erasures );
+}
+
+pping::FallibleRef<BitArray> Decoder::correctBits( Span<int> dataWords, std::vector<int> const& erasures )
+{
+    // std::printf("decoding stuff:%d datablocks in %d layers\n", ddata_->getNBDatablocks(), ddata_->getNBLayers());
 
-    if ( ddata_->isCompact() )
+    Ref<GenericGF> gf = GenericGF::AZTEC_DATA_6;
+
+    if ( codewordSize_ == 8 )
     {
-        offset         = NB_BITS_COMPACT[ ddata_->getNBLayers() ] - numCodewords_ * codewordSize_;
-        numECCodewords = NB_DATABLOCK_COMPACT[ ddata_->getNBLayers() ] - numDataCodewords;
+        gf = GenericGF::AZTEC_DATA_8;
     }
-    else
+    else if ( codewordSize_ == 10 )
     {
-        offset         = NB_BITS[ ddata_->getNBLayers() ] - numCodewords_ * codewordSize_;
-        numECCodewords = NB_DATABLOCK[ ddata_->getNBLayers() ] - numDataCodewords;
+        gf = GenericGF::AZTEC_DATA_10;
     }
-
-    ArrayRef<int> dataWords( numCodewords_ );
-
-    for ( int i = 0; i < numCodewords_; i++ )
+    else if ( codewordSize_ == 12 )
     {
-        int flag = 1;
-        for ( int j = 1; j <= codewordSize_; j++ )
-        {
-
-            auto const getRawBits( rawbits->get( codewordSize_ * i + codewordSize_ - j + offset ) );
-            if ( !getRawBits )
-            {
-                return getRawBits.error();
-            }
-
-            if ( *getRawBits )
-            {
-                dataWords[ i ] += flag;
-            }
-            flag <<= 1;
-        }
+        gf = GenericGF::AZTEC_DATA_12;
     }
 
+    int numDataCodewords = ddata_->getNBDatablocks();
+    int numECCodewords   = numCodewords_ - numDataCodewords;
+
     ReedSolomonDecoder rsDecoder( gf );
 
     /* IllegalArgumentException was ignored here, before refactor 2017-07-18
      * This seems counterintuitive when "corrected bits" are used in code
      * afterwards, so return an error no matter how it happens in ReedSolomonDecoder.
      */
-    auto const decoderResult( rsDecoder.decode( dataWords, numECCodewords ) );
+    auto const decoderResult( rsDecoder.decode( dataWords, numECCodewords, erasures ) );
     if ( !decoderResult )
     {
         return decoderResult.error();
     }
 
-    offset            = 0;
+    int offset        = 0;
     invertedBitCount_ = 0;
 
     Ref<BitArray> correctedBits( new BitArray( numDataCodewords * codewordSize_ ) );
@@ -522,114 +599,69 @@ pping::FallibleRef<BitArray> Decoder::correctBits( Ref<pping::BitArray> rawbits
     return correctedBits;
 }
 
-pping::FallibleRef<BitArray> Decoder::extractBits( Ref<pping::BitMatrix> matrix ) MB_NOEXCEPT_EXCEPT_BADALLOC
-#ifdef __clang__
-    __attribute__(( no_sanitize( "unsigned-integer-overflow" ) ))
-#endif
+pping::Fallible<void> Decoder::readCodewords( Ref<pping::BitMatrix> matrix, std::vector<int>& dataWords ) MB_NOEXCEPT_EXCEPT_BADALLOC
 {
-    std::vector<bool> rawbits;
+    bool compact = ddata_->isCompact();
+    int  layers  = ddata_->getNBLayers();
 
-    if ( ddata_->isCompact() )
+    if ( layers < 1 || layers > ( compact ? MAX_LAYERS_COMPACT : MAX_LAYERS ) )
     {
-        if ( ddata_->getNBLayers() > 5 ) //NB_BITS_COMPACT length
-        {
-            return failure<FormatException>( "Data is too long" );
-        }
-        rawbits       = std::vector<bool>( NB_BITS_COMPACT[ ddata_->getNBLayers() ] );
-        numCodewords_ = NB_DATABLOCK_COMPACT[ ddata_->getNBLayers() ];
+        return failure<FormatException>( "Data is too long" );
     }
-    else
+
+    int size = matrixSize( compact, layers );
+    if ( (int) matrix->getWidth() != size || (int) matrix->getHeight() != size )
     {
-        if ( ddata_->getNBLayers() > 33 ) //NB_BITS length
-        {
-            return failure<FormatException>( "Data is too long" );
-        }
-        rawbits       = std::vector<bool>( NB_BITS[ ddata_->getNBLayers() ] );
-        numCodewords_ = NB_DATABLOCK[ ddata_->getNBLayers() ];
+        return failure<FormatException>( "Matrix does not match the layer count" );
     }
 
-    int    layer         = ddata_->getNBLayers();
-    size_t size          = matrix->getHeight();
-    int    rawbitsOffset = 0;
-    int    matrixOffset  = 0;
-
+    codewordSize_ = codewordSize( layers );
+    numCodewords_ = compact ? NB_DATABLOCK_COMPACT[ layers ] : NB_DATABLOCK[ layers ];
 
-    while ( layer != 0 )
+    if ( ddata_->getNBDatablocks() > numCodewords_ )
     {
+        return failure<FormatException>( "More data codewords than the symbol holds" );
+    }
 
-        int flip = 0;
-        for ( size_t i = 0; i < 2 * size - 4; i++ )
-        {
-            rawbits[ rawbitsOffset + i ]                = matrix->get( matrixOffset + flip, matrixOffset + i / 2 );
-            rawbits[ rawbitsOffset + 2 * size - 4 + i ] = matrix->get( matrixOffset + i / 2, matrixOffset + size - 1 - flip );
-            flip                                        = ( flip + 1 ) % 2;
-        }
-
-        flip = 0;
-        for ( size_t i = 2 * size + 1; i > 5; i-- )
-        {
-            rawbits[ rawbitsOffset + 4 * size - 8 + ( 2 * size - i ) + 1 ] =
-                matrix->get( matrixOffset + size - 1 - flip, matrixOffset + i / 2 - 1 );
-            rawbits[ rawbitsOffset + 6 * size - 12 + ( 2 * size - i ) + 1 ] =
-                matrix->get( matrixOffset + i / 2 - 1, matrixOffset + flip );
-            flip = ( flip + 1 ) % 2;
-        }
-
-        matrixOffset  += 2;
-        rawbitsOffset += 8 * (int) size - 16;
-        layer--;
-        size -= 4;
+    const unsigned int bitsPerWord = std::numeric_limits<unsigned int>::digits;
 
-    }
+    std::vector<unsigned int> const& offsets = getCodewordBits( compact, layers );
+    unsigned int const*              bits    = matrix->getBits();
 
-    Ref<BitArray> returnValue( new BitArray( rawbits.size() ) );
-    for ( int i = 0; i < (int) rawbits.size(); i++ )
+    dataWords.resize( (size_t) numCodewords_ );
+    size_t bit = 0;
+    for ( int i = 0; i < numCodewords_; i++ )
     {
-        if ( rawbits[ i ] ) { returnValue->set( i ); }
+        int word = 0;
+        for ( int j = 0; j < codewordSize_; j++ )
+        {
+            unsigned int offset = offsets[ bit++ ];
+            word = ( word << 1 ) | (int) ( ( bits[ offset / bitsPerWord ] >> ( offset % bitsPerWord ) ) & 1 );
+        }
+        dataWords[ i ] = word;
     }
 
-    return returnValue;
-
+    return success();
 }
 
-Ref<BitMatrix> Decoder::removeDashedLines( Ref<pping::BitMatrix> matrix )
-#ifdef __clang__
-    __attribute__(( no_sanitize( "unsigned-integer-overflow" ) ))
-#endif
+void Decoder::readCodewordConfidence( pping::ByteMatrix const& moduleConfidence, std::vector<unsigned char>& confidence ) MB_NOEXCEPT_EXCEPT_BADALLOC
 {
-    size_t         nbDashed = 1 + 2 * ( ( matrix->getWidth() - 1 ) / 2 / 16 );
-    Ref<BitMatrix> newMatrix( new BitMatrix( matrix->getWidth() - nbDashed, matrix->getHeight() - nbDashed ) );
+    size_t size = moduleConfidence.getWidth();
 
-    int nx = 0;
+    std::vector<unsigned int> const& offsets = getCodewordBits( ddata_->isCompact(), ddata_->getNBLayers() );
 
-    for ( int x = 0; x < (int) matrix->getWidth(); x++ )
+    confidence.resize( (size_t) numCodewords_ );
+    size_t bit = 0;
+    for ( int i = 0; i < numCodewords_; i++ )
     {
-
-        if ( ( matrix->getWidth() / 2 - x ) % 16 == 0 )
+        unsigned char weakest = 0xff;
+        for ( int j = 0; j < codewordSize_; j++ )
         {
-            continue;
+            unsigned int offset = offsets[ bit++ ];
+            weakest = std::min( weakest, moduleConfidence.get( offset % size, offset / size ) );
         }
-
-        int ny = 0;
-        for ( int y = 0; y < (int) matrix->getHeight(); y++ )
-        {
-
-            if ( ( matrix->getWidth() / 2 - y ) % 16 == 0 )
-            {
-                continue;
-            }
-
-            if ( matrix->get( x, y ) )
-            {
-                newMatrix->set( nx, ny );
-            }
-            ny++;
-
-        }
-        nx++;
-
+        confidence[ i ] = weakest;
     }
-    return newMatrix;
 }
 
 int Decoder::readCode( Ref<pping::BitArray> rawbits, int startIndex, int length )
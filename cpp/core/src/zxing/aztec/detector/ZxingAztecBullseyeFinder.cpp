@@ -0,0 +1,235 @@
+// -*- mode:c++; tab-width:2; indent-tabs-mode:nil; c-basic-offset:2 -*-
+/*
+ *  BullseyeFinder.cpp
+ *  zxing
+ *
+ *  Copyright 2012 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/aztec/detector/ZxingAztecBullseyeFinder.h>
+
+#include <algorithm>                 // for max, stable_sort
+#include <cmath>                     // for fabs
+
+#include "zxing/common/BitMatrix.h"  // for BitMatrix
+#include "zxing/common/Counted.h"    // for Ref
+
+using pping::aztec::BullseyeFinder;
+using pping::aztec::Point;
+using pping::BitMatrix;
+using pping::Ref;
+
+namespace {
+  // Modules across the largest symbol, for the row skip
+  const int MAX_MODULES = 151;
+  // Modules between the black rings on either side of the centre
+  const int RING_MODULES = 7;
+  // Runs followed each way along a cross check, enough to start a module off the centre
+  const int MAX_CROSS_RUNS = 6;
+  // Modules a cross check walks each way at most
+  const int MAX_CROSS_REACH = 7;
+
+  /**
+   * Checks the runs across a bull's eye offset modules from its centre: a
+   * central run 2 * offset + 1 modules wide, 3 - offset single modules on
+   * either side of it and at least half a module of the black ring beyond
+   * them, 9 - 2 * offset runs in all.
+   */
+  bool foundPatternCross(int const* widths, int offset, float& moduleSize) {
+    int count = 9 - 2 * offset;
+    int total = 0;
+    for (int i = 1; i < count - 1; i++) {
+      total += widths[i];
+    }
+    if (total < RING_MODULES) {
+      return false;
+    }
+    moduleSize = (float)total / (float)RING_MODULES;
+    float maxVariance = moduleSize / 2.0f;
+    for (int i = 1; i < count - 1; i++) {
+      int modules = i == count / 2 ? 2 * offset + 1 : 1;
+      if (std::fabs((float)modules * moduleSize - (float)widths[i]) >= (float)modules * maxVariance) {
+        return false;
+      }
+    }
+    return (float)widths[0] >= maxVariance && (float)widths[count - 1] >= maxVariance;
+  }
+
+  bool similarModuleSize(float moduleSize, float expected) {
+    return moduleSize >= expected / 2.0f && moduleSize <= expected * 2.0f;
+  }
+}
+
+BullseyeFinder::BullseyeFinder(Ref<BitMatrix> image) noexcept : image_(image) {
+}
+
+/**
+ * Looks for the rings of a bull's eye along the line through (x, y) in
+ * direction (dx, dy), centred on the run holding (x, y) or one next to it.
+ * Square rings are as many steps wide along a diagonal as along a side.
+ */
+bool BullseyeFinder::crossCheck(int x, int y, int dx, int dy, float moduleSize, float& offset,
+                                float& crossModuleSize) const {
+  BitMatrix const& image = *image_;
+  int width = (int)image.getWidth();
+  int height = (int)image.getHeight();
+  int limit = (int)((float)MAX_CROSS_REACH * moduleSize) + 1;
+  bool color = image.get((size_t)x, (size_t)y);
+
+  // Where the runs start, relative to (x, y), those before it nearest first
+  int before[MAX_CROSS_RUNS];
+  int after[MAX_CROSS_RUNS];
+  int countBefore = 0;
+  int countAfter = 0;
+  bool current = color;
+  for (int t = 1; countAfter < MAX_CROSS_RUNS; t++) {
+    int px = x + t * dx;
+    int py = y + t * dy;
+    if (t > limit || px < 0 || px >= width || py < 0 || py >= height) {
+      after[countAfter++] = t;
+      break;
+    }
+    if (image.get((size_t)px, (size_t)py) != current) {
+      after[countAfter++] = t;
+      current = !current;
+    }
+  }
+  current = color;
+  for (int t = 1; countBefore < MAX_CROSS_RUNS; t++) {
+    int px = x - t * dx;
+    int py = y - t * dy;
+    if (t > limit || px < 0 || px >= width || py < 0 || py >= height) {
+      before[countBefore++] = 1 - t;
+      break;
+    }
+    if (image.get((size_t)px, (size_t)py) != current) {
+      before[countBefore++] = 1 - t;
+      current = !current;
+    }
+  }
+
+  int edges[2 * MAX_CROSS_RUNS];
+  for (int i = 0; i < countBefore; i++) {
+    edges[i] = before[countBefore - 1 - i];
+  }
+  for (int i = 0; i < countAfter; i++) {
+    edges[countBefore + i] = after[i];
+  }
+  int runs = countBefore + countAfter - 1;
+  int start = countBefore - 1;
+
+  // The run holding (x, y) first, then its neighbours
+  int const tries[] = { start, start - 1, start + 1 };
+  for (int i = 0; i < 3; i++) {
+    int center = tries[i];
+    bool black = ((center - start) % 2 == 0) == color;
+    if (!black || center < 4 || center + 4 >= runs) {
+      continue;
+    }
+    int widths[9];
+    for (int j = 0; j < 9; j++) {
+      widths[j] = edges[center - 3 + j] - edges[center - 4 + j];
+    }
+    if (foundPatternCross(widths, 0, crossModuleSize) && similarModuleSize(crossModuleSize, moduleSize)) {
+      offset = (float)(edges[center] + edges[center + 1] - 1) / 2.0f;
+      return true;
+    }
+  }
+  return false;
+}
+
+void BullseyeFinder::handlePossibleCenter(float x, int y, float moduleSize) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  float offset;
+  float verticalModuleSize;
+  if (!crossCheck((int)x, y, 0, 1, moduleSize, offset, verticalModuleSize)) {
+    return;
+  }
+  float centerY = (float)y + offset;
+  float horizontalModuleSize;
+  if (!crossCheck((int)x, (int)centerY, 1, 0, verticalModuleSize, offset, horizontalModuleSize)) {
+    return;
+  }
+  float centerX = (float)(int)x + offset;
+
+  float diagonalOffset;
+  float diagonalModuleSize;
+  float antiDiagonalModuleSize;
+  if (!crossCheck((int)centerX, (int)centerY, 1, 1, horizontalModuleSize, diagonalOffset, diagonalModuleSize) ||
+      !crossCheck((int)centerX, (int)centerY, 1, -1, horizontalModuleSize, diagonalOffset, antiDiagonalModuleSize)) {
+    return;
+  }
+  float size = (verticalModuleSize + horizontalModuleSize + diagonalModuleSize + antiDiagonalModuleSize) / 4.0f;
+
+  for (size_t i = 0; i < centers_.size(); i++) {
+    Center& center = centers_[i];
+    if (std::fabs(center.x - centerX) <= size && std::fabs(center.y - centerY) <= size &&
+        similarModuleSize(size, center.moduleSize)) {
+      float count = (float)center.count;
+      center.x = (center.x * count + centerX) / (count + 1.0f);
+      center.y = (center.y * count + centerY) / (count + 1.0f);
+      center.moduleSize = (center.moduleSize * count + size) / (count + 1.0f);
+      center.count++;
+      return;
+    }
+  }
+  Center center = { centerX, centerY, size, 1 };
+  centers_.push_back(center);
+}
+
+std::vector<Point> BullseyeFinder::find(int maxCandidates) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  BitMatrix const& image = *image_;
+  int width = (int)image.getWidth();
+  int height = (int)image.getHeight();
+  // The row patterns hold for three modules around the centre
+  int rowSkip = std::max(1, (3 * height) / (4 * MAX_MODULES));
+
+  centers_.clear();
+  std::vector<int> transitions;
+  std::vector<int> edges;
+  for (int y = rowSkip / 2; y < height; y += rowSkip) {
+    // Run i spans edges[i] to edges[i + 1]; even runs are white, the first possibly empty
+    image.getRowTransitions(y, transitions);
+    edges.assign(1, 0);
+    edges.insert(edges.end(), transitions.begin(), transitions.end());
+    edges.push_back(width);
+    int runs = (int)edges.size() - 1;
+
+    for (int center = 1; center < runs; center++) {
+      // A black central run is the centre module, a white one the ring around it
+      int offset = center % 2 == 1 ? 0 : 1;
+      int side = 4 - offset;
+      if (center - side < 1 || center + side >= runs) {
+        continue;
+      }
+      int widths[9];
+      for (int i = 0; i <= 2 * side; i++) {
+        widths[i] = edges[center - side + i + 1] - edges[center - side + i];
+      }
+      float moduleSize;
+      if (foundPatternCross(widths, offset, moduleSize)) {
+        handlePossibleCenter((float)(edges[center] + edges[center + 1] - 1) / 2.0f, y, moduleSize);
+      }
+    }
+  }
+
+  std::stable_sort(centers_.begin(), centers_.end(), [](Center const& a, Center const& b) {
+    return a.count > b.count;
+  });
+  std::vector<Point> result;
+  for (size_t i = 0; i < centers_.size() && (int)i < maxCandidates; i++) {
+    result.push_back(Point((int)(centers_[i].x + 0.5f), (int)(centers_[i].y + 0.5f)));
+  }
+  return result;
+}
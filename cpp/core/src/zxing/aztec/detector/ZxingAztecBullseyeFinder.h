@@ -0,0 +1,66 @@
+// -*- mode:c++; tab-width:2; indent-tabs-mode:nil; c-basic-offset:2 -*-
+/*
+ *  BullseyeFinder.h
+ *  zxing
+ *
+ *  Copyright 2012 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <zxing/aztec/detector/ZxingAztecDetector.h>  // for Point
+#include <zxing/common/BitMatrix.h>                   // for BitMatrix
+#include <zxing/common/Counted.h>                     // for Ref
+#include <vector>                                     // for vector
+
+namespace pping {
+    namespace aztec {
+
+        /**
+         * Finds Aztec bull's eyes anywhere in the image by scanning its rows, as
+         * FinderPatternFinder does for QR finder patterns. A row through the
+         * central module crosses the rings in a 1:1:1:1:1:1:1 pattern between
+         * the black ring around them, and a row one module off the centre in a
+         * 1:1:1:3:1:1:1 one. Each such row is confirmed by the same pattern
+         * vertically and along both diagonals through the centre it gives.
+         */
+        class BullseyeFinder {
+        private:
+            /** A confirmed centre, with the number of rows that found it. */
+            struct Center {
+                float x;
+                float y;
+                float moduleSize;
+                int count;
+            };
+
+            Ref<BitMatrix> image_;
+            std::vector<Center> centers_;
+
+            bool crossCheck(int x, int y, int dx, int dy, float moduleSize, float& offset, float& crossModuleSize) const;
+            void handlePossibleCenter(float x, int y, float moduleSize) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+        public:
+            BullseyeFinder(Ref<BitMatrix> image) noexcept;
+
+            /**
+             * Returns the centres of up to maxCandidates bull's eyes, those found
+             * by the most rows first.
+             */
+            std::vector<Point> find(int maxCandidates) MB_NOEXCEPT_EXCEPT_BADALLOC;
+        };
+
+    }
+}
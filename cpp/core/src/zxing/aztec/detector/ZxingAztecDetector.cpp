@@ -28,6 +28,8 @@
 #include <zxing/common/reedsolomon/GenericGF.h>             // for GenericGF, GenericGF::AZTEC_PARAM
 #include <zxing/common/reedsolomon/ReedSolomonDecoder.h>    // for ReedSolomonDecoder
 #include <zxing/common/reedsolomon/ReedSolomonException.h>  // for ReedSolomonException
+#include <algorithm>                                        // for max
+#include <stdlib.h>                                         // for abs
 #include <vector>                                           // for vector, allocator
 
 #include "zxing/ReaderException.h"                          // for ReaderException
@@ -36,8 +38,12 @@
 #include "zxing/common/Array.h"                             // for ArrayRef, Array
 #include "zxing/common/BitArray.h"                          // for BitArray
 #include "zxing/common/BitMatrix.h"                         // for BitMatrix
+#include "zxing/common/ByteMatrix.h"                        // for ByteMatrix
 #include "zxing/common/Counted.h"                           // for Ref
 #include "zxing/common/Error.hpp"                           // for Fallible
+#include "zxing/common/ModuleSamples.h"                     // for ModuleSamples
+#include "zxing/common/PerspectiveTransform.h"              // for PerspectiveTransform
+#include "zxing/common/ThresholdPlane.h"                    // for ThresholdPlane
 
 #include <Utils/Macros.h>
 
@@ -59,12 +65,23 @@ Detector::Detector(Ref<BitMatrix> image) noexcept:
   nbCenterLayers_(0) {
         
 }
+
+Detector::Detector(Ref<BitMatrix> image, Ref<pping::LuminanceSource> source) noexcept:
+  image_(image),
+  source_(source),
+  nbLayers_(0),
+  nbDataBlocks_(0),
+  nbCenterLayers_(0) {
+
+}
         
 // using namespace std;
 
 pping::FallibleRef<AztecDetectorResult> Detector::detect() MB_NOEXCEPT_EXCEPT_BADALLOC {
-  Ref<Point> pCenter = getMatrixCenter();
+  return detect(getMatrixCenter());
+}
 
+pping::FallibleRef<AztecDetectorResult> Detector::detect(Point pCenter) MB_NOEXCEPT_EXCEPT_BADALLOC {
   auto const tryGetBullEyePoints(getBullEyeCornerPoints(pCenter));
   if(!tryGetBullEyePoints)
       return tryGetBullEyePoints.error();
@@ -81,16 +98,24 @@ pping::FallibleRef<AztecDetectorResult> Detector::detect() MB_NOEXCEPT_EXCEPT_BA
 
   auto const corners = *getCorners;
             
-  auto const bits = sampleGrid(image_, corners[shift_%4], corners[(shift_+3)%4], corners[(shift_+2)%4], corners[(shift_+1)%4]);
+  PerspectiveTransform transform(createTransform(corners[shift_%4], corners[(shift_+3)%4], corners[(shift_+2)%4], corners[(shift_+1)%4]));
+  auto const bits = sampleGrid(image_, transform);
   if(!bits)
       return bits.error();
             
   // std::printf("------------\ndetected: compact:%s, nbDataBlocks:%d, nbLayers:%d\n------------\n",compact_?"YES":"NO", nbDataBlocks_, nbLayers_);
 
-  return new AztecDetectorResult(*bits, corners, compact_, nbDataBlocks_, nbLayers_);
+  Ref<AztecDetectorResult> result(new AztecDetectorResult(*bits, corners, compact_, nbDataBlocks_, nbLayers_));
+  if (source_ != 0) {
+    // Without samples the decoder just cannot retry, so detection stands
+    auto const modules(sampleModules(transform));
+    if (modules)
+      result->setModuleSamples(*modules);
+  }
+  return result;
 }
         
-pping::Fallible<void> Detector::extractParameters(std::vector<Ref<Point> > bullEyeCornerPoints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+pping::Fallible<void> Detector::extractParameters(std::vector<Point> bullEyeCornerPoints) MB_NOEXCEPT_EXCEPT_BADALLOC {
   // get the bits around the bull's eye
   Ref<BitArray> resab = sampleLine(bullEyeCornerPoints[0], bullEyeCornerPoints[1], 2*nbCenterLayers_+1);
   Ref<BitArray> resbc = sampleLine(bullEyeCornerPoints[1], bullEyeCornerPoints[2], 2*nbCenterLayers_+1);
@@ -234,33 +259,33 @@ pping::Fallible<void> Detector::extractParameters(std::vector<Ref<Point> > bullE
   return pping::success();
 }
         
-pping::Fallible<std::vector<Ref<ResultPoint> >> Detector::getMatrixCornerPoints(std::vector<Ref<Point> > bullEyeCornerPoints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+pping::Fallible<std::vector<Ref<ResultPoint> >> Detector::getMatrixCornerPoints(std::vector<Point> bullEyeCornerPoints) MB_NOEXCEPT_EXCEPT_BADALLOC {
   if( nbCenterLayers_ == 0 )
   {
       return failure<ReaderException>("nbCenterLayers == 0");
   }
   float ratio = (float)(2 * nbLayers_ + (nbLayers_ > 4 ? 1 : 0) + (nbLayers_ - 4) / 8) / (2.0f * (float)nbCenterLayers_);
             
-  int dx = bullEyeCornerPoints[0]->x - bullEyeCornerPoints[2]->x;
+  int dx = bullEyeCornerPoints[0].x - bullEyeCornerPoints[2].x;
   dx += dx > 0 ? 1 : -1;
-  int dy = bullEyeCornerPoints[0]->y - bullEyeCornerPoints[2]->y;
+  int dy = bullEyeCornerPoints[0].y - bullEyeCornerPoints[2].y;
   dy += dy > 0 ? 1 : -1;
             
-  int targetcx = math_utils::round((float)bullEyeCornerPoints[2]->x - ratio * (float)dx);
-  int targetcy = math_utils::round((float)bullEyeCornerPoints[2]->y - ratio * (float)dy);
+  int targetcx = math_utils::round((float)bullEyeCornerPoints[2].x - ratio * (float)dx);
+  int targetcy = math_utils::round((float)bullEyeCornerPoints[2].y - ratio * (float)dy);
             
-  int targetax = math_utils::round((float)bullEyeCornerPoints[0]->x + ratio * (float)dx);
-  int targetay = math_utils::round((float)bullEyeCornerPoints[0]->y + ratio * (float)dy);
+  int targetax = math_utils::round((float)bullEyeCornerPoints[0].x + ratio * (float)dx);
+  int targetay = math_utils::round((float)bullEyeCornerPoints[0].y + ratio * (float)dy);
             
-  dx = bullEyeCornerPoints[1]->x - bullEyeCornerPoints[3]->x;
+  dx = bullEyeCornerPoints[1].x - bullEyeCornerPoints[3].x;
   dx += dx > 0 ? 1 : -1;
-  dy = bullEyeCornerPoints[1]->y - bullEyeCornerPoints[3]->y;
+  dy = bullEyeCornerPoints[1].y - bullEyeCornerPoints[3].y;
   dy += dy > 0 ? 1 : -1;
             
-  int targetdx = math_utils::round((float)bullEyeCornerPoints[3]->x - ratio * (float)dx);
-  int targetdy = math_utils::round((float)bullEyeCornerPoints[3]->y - ratio * (float)dy);
-  int targetbx = math_utils::round((float)bullEyeCornerPoints[1]->x + ratio * (float)dx);
-  int targetby = math_utils::round((float)bullEyeCornerPoints[1]->y + ratio * (float)dy);
+  int targetdx = math_utils::round((float)bullEyeCornerPoints[3].x - ratio * (float)dx);
+  int targetdy = math_utils::round((float)bullEyeCornerPoints[3].y - ratio * (float)dy);
+  int targetbx = math_utils::round((float)bullEyeCornerPoints[1].x + ratio * (float)dx);
+  int targetby = math_utils::round((float)bullEyeCornerPoints[1].y + ratio * (float)dy);
 
   if (!isValid(targetax, targetay) ||
       !isValid(targetbx, targetby) ||
@@ -329,19 +354,19 @@ pping::Fallible<void> Detector::correctParameterData(Ref<pping::BitArray> parame
   return pping::success();
 }
         
-pping::Fallible<std::vector<Ref<Point>>> Detector::getBullEyeCornerPoints(Ref<pping::aztec::Point> pCenter) MB_NOEXCEPT_EXCEPT_BADALLOC {
-  Ref<Point> pina = pCenter;
-  Ref<Point> pinb = pCenter;
-  Ref<Point> pinc = pCenter;
-  Ref<Point> pind = pCenter;
+pping::Fallible<std::vector<Point>> Detector::getBullEyeCornerPoints(Point pCenter) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  Point pina = pCenter;
+  Point pinb = pCenter;
+  Point pinc = pCenter;
+  Point pind = pCenter;
             
   bool color = true;
             
   for (nbCenterLayers_ = 1; nbCenterLayers_ < 9; nbCenterLayers_++) {
-    Ref<Point> pouta = getFirstDifferent(pina, color, 1, -1);
-    Ref<Point> poutb = getFirstDifferent(pinb, color, 1, 1);
-    Ref<Point> poutc = getFirstDifferent(pinc, color, -1, 1);
-    Ref<Point> poutd = getFirstDifferent(pind, color, -1, -1);
+    Point pouta = getFirstDifferent(pina, color, 1, -1);
+    Point poutb = getFirstDifferent(pinb, color, 1, 1);
+    Point poutc = getFirstDifferent(pinc, color, -1, 1);
+    Point poutd = getFirstDifferent(pind, color, -1, -1);
             
     //d    a
     //
@@ -377,21 +402,21 @@ pping::Fallible<std::vector<Ref<Point>>> Detector::getBullEyeCornerPoints(Ref<pp
    * NESTO CUDNO ??
    */
 
-  int dx = pina->x - pind->x;
-  int dy = pina->y - pinc->y;
+  int dx = pina.x - pind.x;
+  int dy = pina.y - pinc.y;
             
-  int targetcx = math_utils::round((float)pinc->x - ratio * (float)dx);
-  int targetcy = math_utils::round((float)pinc->y - ratio * (float)dy);
-  int targetax = math_utils::round((float)pina->x + ratio * (float)dx);
-  int targetay = math_utils::round((float)pina->y + ratio * (float)dy);
+  int targetcx = math_utils::round((float)pinc.x - ratio * (float)dx);
+  int targetcy = math_utils::round((float)pinc.y - ratio * (float)dy);
+  int targetax = math_utils::round((float)pina.x + ratio * (float)dx);
+  int targetay = math_utils::round((float)pina.y + ratio * (float)dy);
             
-  dx = pinb->x - pind->x;
-  dy = pinb->y - pind->y;
+  dx = pinb.x - pind.x;
+  dy = pinb.y - pind.y;
             
-  int targetdx = math_utils::round((float)pind->x - ratio * (float)dx);
-  int targetdy = math_utils::round((float)pind->y - ratio * (float)dy);
-  int targetbx = math_utils::round((float)pinb->x + ratio * (float)dx);
-  int targetby = math_utils::round((float)pinb->y + ratio * (float)dy);
+  int targetdx = math_utils::round((float)pind.x - ratio * (float)dx);
+  int targetdy = math_utils::round((float)pind.y - ratio * (float)dy);
+  int targetbx = math_utils::round((float)pinb.x + ratio * (float)dx);
+  int targetby = math_utils::round((float)pinb.y + ratio * (float)dy);
             
   if (!isValid(targetax, targetay) ||
       !isValid(targetbx, targetby) ||
@@ -400,17 +425,17 @@ pping::Fallible<std::vector<Ref<Point>>> Detector::getBullEyeCornerPoints(Ref<pp
       return failure<ReaderException>("Bullseye extends over image bounds");
   }
             
-  std::vector<Ref<Point> > returnValue;
-  returnValue.push_back(Ref<Point>(new Point(targetax, targetay)));
-  returnValue.push_back(Ref<Point>(new Point(targetbx, targetby)));
-  returnValue.push_back(Ref<Point>(new Point(targetcx, targetcy)));
-  returnValue.push_back(Ref<Point>(new Point(targetdx, targetdy)));
+  std::vector<Point> returnValue;
+  returnValue.push_back(Point(targetax, targetay));
+  returnValue.push_back(Point(targetbx, targetby));
+  returnValue.push_back(Point(targetcx, targetcy));
+  returnValue.push_back(Point(targetdx, targetdy));
             
   return returnValue;
             
 }
         
-Ref<Point> Detector::getMatrixCenter() MB_NOEXCEPT_EXCEPT_BADALLOC {
+Point Detector::getMatrixCenter() MB_NOEXCEPT_EXCEPT_BADALLOC {
   Ref<ResultPoint> pointA, pointB, pointC, pointD;
   bool fallback = false;
 
@@ -442,10 +467,10 @@ Ref<Point> Detector::getMatrixCenter() MB_NOEXCEPT_EXCEPT_BADALLOC {
       int cx = (int)image_->getWidth() / 2;
       int cy = (int)image_->getHeight() / 2;
 
-      pointA = getFirstDifferent(Ref<Point>(new Point(cx+15/2, cy-15/2)), false,  1, -1)->toResultPoint();
-      pointB = getFirstDifferent(Ref<Point>(new Point(cx+15/2, cy+15/2)), false,  1,  1)->toResultPoint();
-      pointC = getFirstDifferent(Ref<Point>(new Point(cx-15/2, cy+15/2)), false, -1,  1)->toResultPoint();
-      pointD = getFirstDifferent(Ref<Point>(new Point(cx-15/2, cy-15/2)), false, -1, -1)->toResultPoint();
+      pointA = getFirstDifferent(Point(cx+15/2, cy-15/2), false,  1, -1).toResultPoint();
+      pointB = getFirstDifferent(Point(cx+15/2, cy+15/2), false,  1,  1).toResultPoint();
+      pointC = getFirstDifferent(Point(cx-15/2, cy+15/2), false, -1,  1).toResultPoint();
+      pointD = getFirstDifferent(Point(cx-15/2, cy-15/2), false, -1, -1).toResultPoint();
   }
 
   int cx = math_utils::round((pointA->getX() + pointD->getX() + pointB->getX() + pointC->getX()) / 4);
@@ -477,56 +502,93 @@ Ref<Point> Detector::getMatrixCenter() MB_NOEXCEPT_EXCEPT_BADALLOC {
 
   if( fallback )
   {
-      pointA = getFirstDifferent(Ref<Point>(new Point(cx+15/2, cy-15/2)), false,  1, -1)->toResultPoint();
-      pointB = getFirstDifferent(Ref<Point>(new Point(cx+15/2, cy+15/2)), false,  1,  1)->toResultPoint();
-      pointC = getFirstDifferent(Ref<Point>(new Point(cx-15/2, cy+15/2)), false, -1, -1)->toResultPoint();
-      pointD = getFirstDifferent(Ref<Point>(new Point(cx-15/2, cy-15/2)), false, -1, -1)->toResultPoint();
+      pointA = getFirstDifferent(Point(cx+15/2, cy-15/2), false,  1, -1).toResultPoint();
+      pointB = getFirstDifferent(Point(cx+15/2, cy+15/2), false,  1,  1).toResultPoint();
+      pointC = getFirstDifferent(Point(cx-15/2, cy+15/2), false, -1, -1).toResultPoint();
+      pointD = getFirstDifferent(Point(cx-15/2, cy-15/2), false, -1, -1).toResultPoint();
 
   }
             
   cx = math_utils::round((pointA->getX() + pointD->getX() + pointB->getX() + pointC->getX()) / 4);
   cy = math_utils::round((pointA->getY() + pointD->getY() + pointB->getY() + pointC->getY()) / 4);
             
-  return Ref<Point>(new Point(cx, cy));
+  return Point(cx, cy);
             
 }
         
-pping::FallibleRef<BitMatrix> Detector::sampleGrid(Ref<pping::BitMatrix> image,
-                                    Ref<pping::ResultPoint> topLeft,
-                                    Ref<pping::ResultPoint> bottomLeft,
-                                    Ref<pping::ResultPoint> bottomRight,
-                                    Ref<pping::ResultPoint> topRight) {
-  int dimension;
+int Detector::getDimension() const noexcept {
   if (compact_) {
-    dimension = 4 * nbLayers_+11;
-  } else {
-    if (nbLayers_ <= 4) {
-      dimension = 4 * nbLayers_ + 15;
-    } else {
-      dimension = 4 * nbLayers_ + 2 * ((nbLayers_-4)/8 + 1) + 15;
+    return 4 * nbLayers_+11;
+  }
+  // A reference grid line every 16 modules out from the centre, both ways
+  int baseDimension = 4 * nbLayers_ + 14;
+  return baseDimension + 1 + 2 * ((baseDimension / 2 - 1) / 15);
+}
+
+pping::PerspectiveTransform Detector::createTransform(Ref<pping::ResultPoint> topLeft,
+                                                      Ref<pping::ResultPoint> bottomLeft,
+                                                      Ref<pping::ResultPoint> bottomRight,
+                                                      Ref<pping::ResultPoint> topRight) const {
+  float dimension = (float)getDimension();
+  return PerspectiveTransform::quadrilateralToQuadrilateral(0.5f,
+                                                                   0.5f,
+                                                                   dimension - 0.5f,
+                                                                   0.5f,
+                                                                   dimension - 0.5f,
+                                                                   dimension - 0.5f,
+                                                                   0.5f,
+                                                                   dimension - 0.5f,
+                                                                   topLeft->getX(),
+                                                                   topLeft->getY(),
+                                                                   topRight->getX(),
+                                                                   topRight->getY(),
+                                                                   bottomRight->getX(),
+                                                                   bottomRight->getY(),
+                                                                   bottomLeft->getX(),
+                                                                   bottomLeft->getY());
+}
+
+pping::FallibleRef<BitMatrix> Detector::sampleGrid(Ref<pping::BitMatrix> image,
+                                                   pping::PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  GridSampler &sampler = GridSampler::getInstance();
+  return sampler.sampleGrid(image, getDimension(), transform);
+}
+
+pping::FallibleRef<pping::ModuleSamples> Detector::sampleModules(pping::PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  int dimension = getDimension();
+  GridSampler &sampler = GridSampler::getInstance();
+  auto const trySampling(sampler.sampleGrid(source_, dimension, transform));
+  if (!trySampling)
+    return trySampling.error();
+  Ref<ByteMatrix> samples(*trySampling);
+
+  // The rings of the bull's eye alternate from the black centre out to the
+  // last black ring; every module and its neighbour one ring further out
+  // make a black and white pair
+  int center = dimension / 2;
+  int lastRing = compact_ ? 4 : 6;
+  ThresholdPlane plane;
+  for (int y = center - lastRing + 1; y < center + lastRing; y++) {
+    for (int x = center - lastRing + 1; x < center + lastRing; x++) {
+      int ring = std::max(abs(x - center), abs(y - center));
+      int const neighbours[4][2] = { { x - 1, y }, { x + 1, y }, { x, y - 1 }, { x, y + 1 } };
+      for (auto const & neighbour : neighbours) {
+        int nx = neighbour[0];
+        int ny = neighbour[1];
+        if (std::max(abs(nx - center), abs(ny - center)) != ring + 1) {
+          continue;
+        }
+        int sample = samples->get(x, y);
+        int outer = samples->get(nx, ny);
+        bool black = (ring & 1) == 0;
+        plane.addPair((x + nx) / 2.0, (y + ny) / 2.0, black ? sample : outer, black ? outer : sample, 2);
+      }
     }
   }
-            
-  GridSampler sampler = GridSampler::getInstance();
-            
-  return sampler.sampleGrid(image,
-                            dimension,
-                            0.5f,
-                            0.5f,
-                            (float)dimension - 0.5f,
-                            0.5f,
-                            (float)dimension - 0.5f,
-                            (float)dimension - 0.5f,
-                            0.5f,
-                            (float)dimension - 0.5f,
-                            topLeft->getX(),
-                            topLeft->getY(),
-                            topRight->getX(),
-                            topRight->getY(),
-                            bottomRight->getX(),
-                            bottomRight->getY(),
-                            bottomLeft->getX(),
-                            bottomLeft->getY());
+  if (!plane.solve())
+    return failure<ReaderException>("Bull's eye has too little contrast");
+
+  return new ModuleSamples(samples, plane.thresholds(dimension, dimension));
 }
         
 void Detector::getParameters(Ref<pping::BitArray> parameterData) noexcept {
@@ -564,18 +626,18 @@ void Detector::getParameters(Ref<pping::BitArray> parameterData) noexcept {
   nbDataBlocks_ ++;
 }
         
-Ref<BitArray> Detector::sampleLine(Ref<pping::aztec::Point> p1, Ref<pping::aztec::Point> p2, int size) MB_NOEXCEPT_EXCEPT_BADALLOC {
+Ref<BitArray> Detector::sampleLine(Point p1, Point p2, int size) MB_NOEXCEPT_EXCEPT_BADALLOC {
   MB_ASSERTM( size > 1, "%s", "Can't sample line if size <= 1" );
 
   Ref<BitArray> res(new BitArray(size));
             
   float d = distance(p1, p2);
   float moduleSize = d / (float)(size-1);
-  float dx = moduleSize * (float)(p2->x - p1->x)/d;
-  float dy = moduleSize * (float)(p2->y - p1->y)/d;
+  float dx = moduleSize * (float)(p2.x - p1.x)/d;
+  float dy = moduleSize * (float)(p2.y - p1.y)/d;
             
-  float px = (float)p1->x;
-  float py = (float)p1->y;
+  float px = (float)p1.x;
+  float py = (float)p1.y;
             
   for (int i = 0; i < size; i++) {
     if (image_->get(math_utils::round(px), math_utils::round(py))) res->set(i);
@@ -589,16 +651,16 @@ Ref<BitArray> Detector::sampleLine(Ref<pping::aztec::Point> p1, Ref<pping::aztec
 /*
  * Checks if most pixels of rectangle defined by given points is mostly black or mostly white
  */
-bool Detector::isWhiteOrBlackRectangle(Ref<pping::aztec::Point> p1,
-                                       Ref<pping::aztec::Point> p2,
-                                       Ref<pping::aztec::Point> p3,
-                                       Ref<pping::aztec::Point> p4) {
+bool Detector::isWhiteOrBlackRectangle(Point p1,
+                                       Point p2,
+                                       Point p3,
+                                       Point p4) {
   int corr = 3;
             
-  p1 = new Point(p1->x - corr, p1->y + corr);
-  p2 = new Point(p2->x - corr, p2->y - corr);
-  p3 = new Point(p3->x + corr, p3->y - corr);
-  p4 = new Point(p4->x + corr, p4->y + corr);
+  p1 = Point(p1.x - corr, p1.y + corr);
+  p2 = Point(p2.x - corr, p2.y - corr);
+  p3 = Point(p3.x + corr, p3.y - corr);
+  p4 = Point(p4.x + corr, p4.y + corr);
             
   int cInit = getColor(p4, p1);
             
@@ -630,20 +692,20 @@ bool Detector::isWhiteOrBlackRectangle(Ref<pping::aztec::Point> p1,
 /*
  * Checks if line given with p1 and p2 is mostly white or mostly black
  */
-int Detector::getColor(Ref<pping::aztec::Point> p1, Ref<pping::aztec::Point> p2) {
+int Detector::getColor(Point p1, Point p2) {
   float d = distance(p1, p2);
 
   MB_ASSERTM( std::abs(d) >= 1e-5f, "%s", "Distance between points ~= 0" );
             
-  float dx = (float)(p2->x - p1->x) / d;
-  float dy = (float)(p2->y - p1->y) / d;
+  float dx = (float)(p2.x - p1.x) / d;
+  float dy = (float)(p2.y - p1.y) / d;
             
   int error = 0;
             
-  float px = (float)p1->x;
-  float py = (float)p1->y;
+  float px = (float)p1.x;
+  float py = (float)p1.y;
             
-  bool colorModel = image_->get(p1->x, p1->y);
+  bool colorModel = image_->get(p1.x, p1.y);
             
   const int intD = static_cast<int>(d);
   for (int i = 0; i < intD; i++) {
@@ -668,9 +730,9 @@ int Detector::getColor(Ref<pping::aztec::Point> p1, Ref<pping::aztec::Point> p2)
   }
 }
         
-Ref<Point> Detector::getFirstDifferent(Ref<pping::aztec::Point> init, bool color, int dx, int dy) {
-  int x = init->x + dx;
-  int y = init->y + dy;
+Point Detector::getFirstDifferent(Point init, bool color, int dx, int dy) {
+  int x = init.x + dx;
+  int y = init.y + dy;
             
   while (isValid(x, y) && image_->get(x, y) == color) {
     x += dx;
@@ -692,13 +754,13 @@ Ref<Point> Detector::getFirstDifferent(Ref<pping::aztec::Point> init, bool color
             
   y -= dy;
             
-  return Ref<Point>(new Point(x, y));
+  return Point(x, y);
 }
         
 bool Detector::isValid(int x, int y) {
   return x >= 0 && x < (int)image_->getWidth() && y > 0 && y < (int)image_->getHeight();
 }
         
-float Detector::distance(Ref<pping::aztec::Point> a, Ref<pping::aztec::Point> b) {
-  return sqrtf((float)((a->x - b->x) * (a->x - b->x) + (a->y - b->y) * (a->y - b->y)));
+float Detector::distance(Point a, Point b) {
+  return sqrtf((float)((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y)));
 }
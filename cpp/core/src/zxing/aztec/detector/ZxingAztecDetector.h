@@ -19,24 +19,27 @@
  * limitations under the License.
  */
 
-
-
+#pragma once
 
 #include <zxing/common/BitArray.h>
 #include <zxing/ResultPoint.h>
 #include <zxing/common/BitMatrix.h>
+#include <zxing/common/ModuleSamples.h>
+#include <zxing/common/PerspectiveTransform.h>
 #include <zxing/DecodeHints.h>
+#include <zxing/LuminanceSource.h>
 #include <zxing/aztec/AztecDetectorResult.h>
 
 namespace pping {
     namespace aztec {
         
-        class Point : public Counted {
+        /** A pixel of the image, held and passed by value. */
+        class Point {
         public:
             int x;
             int y;
             
-            Ref<ResultPoint> toResultPoint() { 
+            Ref<ResultPoint> toResultPoint() const { 
                 return Ref<ResultPoint>(new ResultPoint((float)x, (float)y));
             }
             
@@ -48,6 +51,7 @@ namespace pping {
             
         private:
             Ref<BitMatrix> image_;
+            Ref<LuminanceSource> source_;
             
             bool compact_;
             int nbLayers_;
@@ -55,30 +59,44 @@ namespace pping {
             int nbCenterLayers_;
             int shift_;
             
-            Fallible<void> extractParameters(std::vector<Ref<Point> > bullEyeCornerPoints) MB_NOEXCEPT_EXCEPT_BADALLOC;
-            Fallible<std::vector<Ref<ResultPoint>>> getMatrixCornerPoints(std::vector<Ref<Point> > bullEyeCornerPoints) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            Fallible<void> extractParameters(std::vector<Point> bullEyeCornerPoints) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            Fallible<std::vector<Ref<ResultPoint>>> getMatrixCornerPoints(std::vector<Point> bullEyeCornerPoints) MB_NOEXCEPT_EXCEPT_BADALLOC;
             static Fallible<void> correctParameterData(Ref<BitArray> parameterData, bool compact) MB_NOEXCEPT_EXCEPT_BADALLOC;
-            Fallible<std::vector<Ref<Point>>> getBullEyeCornerPoints(Ref<Point> pCenter) MB_NOEXCEPT_EXCEPT_BADALLOC;
-            Ref<Point> getMatrixCenter() MB_NOEXCEPT_EXCEPT_BADALLOC;
-            FallibleRef<BitMatrix> sampleGrid(Ref<BitMatrix> image,
-                                      Ref<ResultPoint> topLeft,
-                                      Ref<ResultPoint> bottomLeft,
-                                      Ref<ResultPoint> bottomRight,
-                                      Ref<ResultPoint> topRight);
+            Fallible<std::vector<Point>> getBullEyeCornerPoints(Point pCenter) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            Point getMatrixCenter() MB_NOEXCEPT_EXCEPT_BADALLOC;
+            int getDimension() const noexcept;
+            PerspectiveTransform createTransform(Ref<ResultPoint> topLeft,
+                                                 Ref<ResultPoint> bottomLeft,
+                                                 Ref<ResultPoint> bottomRight,
+                                                 Ref<ResultPoint> topRight) const;
+            FallibleRef<BitMatrix> sampleGrid(Ref<BitMatrix> image, PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            /**
+             * Samples the greyscale of every module from source_ and thresholds
+             * each against a plane fitted to the rings of the bull's eye.
+             */
+            FallibleRef<ModuleSamples> sampleModules(PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC;
             void getParameters(Ref<BitArray> parameterData) noexcept;
-            Ref<BitArray> sampleLine(Ref<Point> p1, Ref<Point> p2, int size) MB_NOEXCEPT_EXCEPT_BADALLOC;
-            bool isWhiteOrBlackRectangle(Ref<Point> p1,
-                                         Ref<Point> p2,
-                                         Ref<Point> p3,
-                                         Ref<Point> p4);
-            int getColor(Ref<Point> p1, Ref<Point> p2);
-            Ref<Point> getFirstDifferent(Ref<Point> init, bool color, int dx, int dy);
+            Ref<BitArray> sampleLine(Point p1, Point p2, int size) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            bool isWhiteOrBlackRectangle(Point p1,
+                                         Point p2,
+                                         Point p3,
+                                         Point p4);
+            int getColor(Point p1, Point p2);
+            Point getFirstDifferent(Point init, bool color, int dx, int dy);
             bool isValid(int x, int y);
-            static float distance(Ref<Point> a, Ref<Point> b);
+            static float distance(Point a, Point b);
             
         public:
             Detector(Ref<BitMatrix> image) noexcept;
+            /**
+             * Also keeps the greyscale samples of the modules of every symbol it
+             * detects in the AztecDetectorResult, for Decoder to retry with.
+             * source is the luminance image was binarized from.
+             */
+            Detector(Ref<BitMatrix> image, Ref<LuminanceSource> source) noexcept;
             FallibleRef<AztecDetectorResult> detect() MB_NOEXCEPT_EXCEPT_BADALLOC;
+            /** Detects the symbol around the bull's eye centred at center. */
+            FallibleRef<AztecDetectorResult> detect(Point center) MB_NOEXCEPT_EXCEPT_BADALLOC;
         };
         
     }
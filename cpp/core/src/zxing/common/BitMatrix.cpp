@@ -17,13 +17,15 @@
 
 #include <zxing/common/BitMatrix.h>
 #include <zxing/common/IllegalArgumentException.h>  // for IllegalArgumentException
-#include <algorithm>                                // for fill
+#include <algorithm>                                // for fill, min
 #include <string>                                   // for allocator, basic_string
 #include <vector>                                   // for vector
 
 #include "zxing/common/BitArray.h"                  // for BitArray
 #include "zxing/common/Counted.h"                   // for Ref
 
+#include <Utils/Macros.h>
+
 
 using pping::BitMatrix;
 using pping::BitArray;
@@ -41,31 +43,54 @@ namespace {
 }
 
 BitMatrix::BitMatrix(size_t dimension) :
-  width_(dimension), height_(dimension), words_(0), bits_(NULL) {
+  width_(dimension), height_(dimension), words_(0), bits_(NULL), rowBits_(dimension), origin_(0), owner_() {
   words_ = wordsForSize(width_, height_, bitsPerWord, logBits);
   bits_ = new unsigned int[words_];
   clear();
 }
 
 BitMatrix::BitMatrix(size_t width, size_t height) :
-  width_(width), height_(height), words_(0), bits_(NULL) {
+  width_(width), height_(height), words_(0), bits_(NULL), rowBits_(width), origin_(0), owner_() {
   words_ = wordsForSize(width_, height_, bitsPerWord, logBits);
   bits_ = new unsigned int[words_];
   clear();
 }
 
+BitMatrix::BitMatrix(Ref<BitMatrix> const& owner, size_t origin, size_t rowBits, size_t width, size_t height) noexcept :
+  width_(width), height_(height), words_(0), bits_(owner->bits_), rowBits_(rowBits), origin_(origin), owner_(owner) {
+}
+
 BitMatrix::~BitMatrix() {
-  delete[] bits_;
+  if (owner_.empty()) {
+    delete[] bits_;
+  }
 }
 
+Ref<BitMatrix> BitMatrix::crop(size_t left, size_t top, size_t width, size_t height) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  MB_ASSERTM(left + width <= width_ && top + height <= height_, "%s", "Crop does not fit the matrix.");
+  // A crop of a crop views the bits of the original
+  Ref<BitMatrix> owner(owner_.empty() ? Ref<BitMatrix>(this) : owner_);
+  return Ref<BitMatrix>(new BitMatrix(owner, origin_ + left + rowBits_ * top, rowBits_, width, height));
+}
 
 void BitMatrix::flip(size_t x, size_t y) {
-  size_t offset = x + width_ * y;
+  size_t offset = origin_ + x + rowBits_ * y;
   bits_[offset >> logBits] ^= static_cast< unsigned int >( 1 << (offset & bitsMask));
 }
 
 void BitMatrix::clear() {
-  std::fill(bits_, bits_+words_, 0);
+  if (owner_.empty()) {
+    std::fill(bits_, bits_+words_, 0);
+    return;
+  }
+  // Only the bits inside the crop
+  for (size_t y = 0; y < height_; y++) {
+    size_t yOffset = origin_ + rowBits_ * y;
+    for (size_t x = 0; x < width_; x++) {
+      size_t offset = x + yOffset;
+      bits_[offset >> logBits] &= ~static_cast< unsigned int >( 1 << (offset & bitsMask) );
+    }
+  }
 }
 
 bool BitMatrix::isRegionValid(size_t right, size_t bottom, size_t width, size_t height)
@@ -85,7 +110,7 @@ pping::Fallible<void> BitMatrix::setRegion(size_t left, size_t top, size_t width
           return failure<IllegalArgumentException>("height and width must be at least 1, top + height and left + width must be <= matrix dimension");
 
   for (size_t y = top; y < bottom; y++) {
-    size_t yOffset = width_ * y;
+    size_t yOffset = origin_ + rowBits_ * y;
     for (size_t x = left; x < right; x++) {
       size_t offset = x + yOffset;
       bits_[offset >> logBits] |= static_cast< unsigned int >( 1 << (offset & bitsMask) );
@@ -100,33 +125,65 @@ Ref<BitArray> BitMatrix::getRow(int y, Ref<BitArray> row) {
   } else {
     row->clear();
   }
-  size_t start = y * width_;
-  size_t end = start + width_ - 1; // end is inclusive
-  size_t firstWord = start >> logBits;
-  size_t lastWord = end >> logBits;
-  size_t bitOffset = start & bitsMask;
-  for (size_t i = firstWord; i <= lastWord; i++) {
-    size_t firstBit = i > firstWord ? 0 : start & bitsMask;
-    size_t lastBit = i < lastWord ? bitsPerWord - 1 : end & bitsMask;
-    unsigned int mask;
-    if (firstBit == 0 && lastBit == logBits) {
-      mask = std::numeric_limits<unsigned int>::max();
-    } else {
-      mask = 0;
-      for (size_t j = firstBit; j <= lastBit; j++) {
-        mask |= 1 << j;
-      }
+  // A word of the row at a time, made of the end of one word of bits_ and the start of the next
+  size_t start = origin_ + (size_t)y * rowBits_;
+  for (size_t x = 0; x < width_; x += bitsPerWord) {
+    size_t offset = start + x;
+    size_t shift = offset & bitsMask;
+    size_t count = std::min((size_t)bitsPerWord, width_ - x);
+    unsigned int word = bits_[offset >> logBits] >> shift;
+    if (shift + count > bitsPerWord) {
+      word |= bits_[(offset >> logBits) + 1] << (bitsPerWord - shift);
     }
-    row->setBulk((i - firstWord) << logBits, (bits_[i] & mask) >> bitOffset);
-    if (firstBit == 0 && bitOffset != 0) {
-      unsigned int prevBulk = row->getBitArray()[i - firstWord - 1];
-      prevBulk |= (bits_[i] & mask) << (bitsPerWord - bitOffset);
-      row->setBulk((i - firstWord - 1) << logBits, prevBulk);
+    if (count < bitsPerWord) {
+      word &= (1u << count) - 1;
     }
+    row->setBulk(x, word);
   }
   return row;
 }
 
+namespace {
+  // Position of the lowest set bit of a nonzero word, by a de Bruijn sequence
+  int trailingZeros(unsigned int word) {
+    static const int POSITIONS[32] = {
+      0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+      31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+    };
+    return POSITIONS[((word & (0u - word)) * 0x077CB531u) >> 27];
+  }
+}
+
+void BitMatrix::getRowTransitions(int y, std::vector<int>& transitions) const {
+  transitions.clear();
+  int width = (int)width_;
+  size_t rowOffset = origin_ + (size_t)y * rowBits_;
+  bool black = false;
+  for (int x = 0; x < width;) {
+    // The bits left in the current word, set where the current run ends
+    size_t offset = rowOffset + (size_t)x;
+    int shift = (int)(offset & bitsMask);
+    int available = std::min((int)bitsPerWord - shift, width - x);
+    unsigned int word = bits_[offset >> logBits] >> shift;
+    if (black) {
+      word = ~word;
+    }
+    if (available < (int)bitsPerWord) {
+      word &= (1u << available) - 1;
+    }
+    if (word == 0) {
+      x += available;
+      continue;
+    }
+    x += trailingZeros(word);
+    transitions.push_back(x);
+    black = !black;
+  }
+  if (black) {
+    transitions.push_back(width);
+  }
+}
+
 size_t BitMatrix::getWidth() const {
   return width_;
 }
@@ -26,6 +26,7 @@
 #include <zxing/common/Error.hpp>
 #include <limits>                  // for numeric_limits, numeric_limits<>::digits
 #include <cstddef>                // for size_t
+#include <vector>                  // for vector
 
 namespace pping {
 
@@ -37,6 +38,10 @@ private:
   size_t height_;
   size_t words_;
   unsigned int* bits_;
+  // Bits from one row to the next and the bit of (0, 0); a crop shares the bits of owner_
+  size_t rowBits_;
+  size_t origin_;
+  Ref<BitMatrix> owner_;
 
 #define ZX_LOG_DIGITS(digits) \
     ((digits == 8) ? 3 : \
@@ -58,12 +63,12 @@ public:
   ~BitMatrix();
 
   bool get(size_t x, size_t y) const {
-    size_t offset = x + width_ * y;
+    size_t offset = origin_ + x + rowBits_ * y;
     return ((bits_[offset >> logBits] >> (offset & bitsMask)) & 0x01) != 0;
   }
 
   void set(size_t x, size_t y) {
-    size_t offset = x + width_ * y;
+    size_t offset = origin_ + x + rowBits_ * y;
     bits_[offset >> logBits] |= static_cast< unsigned int >( 1 << (offset & bitsMask) );
   }
 
@@ -73,16 +78,32 @@ public:
 
   Ref<BitArray> getRow(int y, Ref<BitArray> row);
 
+  /**
+   * Replaces transitions with the columns where the colour of row y changes,
+   * a word at a time: each black run starts at an even index and ends, one
+   * past its last pixel, at the odd index after it.
+   */
+  void getRowTransitions(int y, std::vector<int>& transitions) const;
+
+  /**
+   * A view of the width by height rectangle at (left, top), sharing the bits
+   * of this matrix instead of copying them. Setting a bit in one sets it in
+   * the other.
+   */
+  Ref<BitMatrix> crop(size_t left, size_t top, size_t width, size_t height) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
   size_t getDimension() const;
   size_t getWidth() const;
   size_t getHeight() const;
 
+  /** The rows one after the other, without padding. Not for crops. */
   unsigned int* getBits() const;
 
   friend mb::stringstreamlite& operator<<(mb::stringstreamlite &out, const BitMatrix &bm);
   const char *description();
 
 private:
+  BitMatrix(Ref<BitMatrix> const& owner, size_t origin, size_t rowBits, size_t width, size_t height) noexcept;
   BitMatrix(const BitMatrix&);
   BitMatrix& operator =(const BitMatrix&);
 
@@ -0,0 +1,75 @@
+// -*- mode:c++; tab-width:2; indent-tabs-mode:nil; c-basic-offset:2 -*-
+#pragma once
+
+/*
+ *  ByteMatrix.h
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/common/Counted.h>  // for Counted
+
+#include <cstddef>                 // for size_t
+#include <vector>                  // for vector
+
+namespace pping {
+
+/**
+ * A matrix of 8-bit luminance values, one per sampled module. Produced by
+ * the greyscale variant of GridSampler so that thresholding can be deferred
+ * until the position of every module is known.
+ */
+class ByteMatrix : public Counted {
+private:
+  size_t width_;
+  size_t height_;
+  std::vector<unsigned char> bytes_;
+
+public:
+  explicit ByteMatrix(size_t dimension) :
+      width_(dimension), height_(dimension), bytes_(dimension * dimension, 0) {
+  }
+
+  ByteMatrix(size_t width, size_t height) :
+      width_(width), height_(height), bytes_(width * height, 0) {
+  }
+
+  unsigned char get(size_t x, size_t y) const {
+    return bytes_[x + width_ * y];
+  }
+
+  void set(size_t x, size_t y, unsigned char value) {
+    bytes_[x + width_ * y] = value;
+  }
+
+  size_t getWidth() const {
+    return width_;
+  }
+
+  size_t getHeight() const {
+    return height_;
+  }
+
+  size_t getDimension() const {
+    return width_;
+  }
+
+private:
+  ByteMatrix(const ByteMatrix&);
+  ByteMatrix& operator =(const ByteMatrix&);
+};
+
+}
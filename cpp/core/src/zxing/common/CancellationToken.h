@@ -0,0 +1,71 @@
+// -*- mode:c++; tab-width:2; indent-tabs-mode:nil; c-basic-offset:2 -*-
+#pragma once
+
+/*
+ *  CancellationToken.h
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/common/Counted.h>  // for Counted, Ref
+
+#ifndef NO_THREADS
+#include <atomic>                  // for atomic
+#endif
+
+namespace pping {
+
+/**
+ * Asks the readers holding it to give up. Readers only look at it between
+ * the rows or candidates they scan, so a cancelled reader returns soon but
+ * not at once, with a TimeoutException. See DecodeHints::setCancellationToken.
+ * A token made from a parent is also cancelled with it, so part of a decode
+ * can be cancelled on its own without ignoring the caller's token.
+ */
+class CancellationToken : public Counted {
+private:
+  Ref<CancellationToken> parent_;
+#ifndef NO_THREADS
+  std::atomic<bool> cancelled_;
+#else
+  bool cancelled_;
+#endif
+
+public:
+  CancellationToken() noexcept : parent_(), cancelled_(false) {
+  }
+  explicit CancellationToken(Ref<CancellationToken> const& parent) noexcept : parent_(parent), cancelled_(false) {
+  }
+
+  void cancel() noexcept {
+#ifndef NO_THREADS
+    cancelled_.store(true, std::memory_order_relaxed);
+#else
+    cancelled_ = true;
+#endif
+  }
+
+  bool isCancelled() const noexcept {
+#ifndef NO_THREADS
+    bool cancelled = cancelled_.load(std::memory_order_relaxed);
+#else
+    bool cancelled = cancelled_;
+#endif
+    return cancelled || (!parent_.empty() && parent_->isCancelled());
+  }
+};
+
+}
@@ -0,0 +1,39 @@
+// -*- mode:c++; tab-width:2; indent-tabs-mode:nil; c-basic-offset:2 -*-
+#pragma once
+
+/*
+ *  CharacterTables.h
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef NO_ICONV
+
+namespace pping {
+namespace common {
+
+/**
+ * Unicode code points of the double byte character sets that StringUtils
+ * decodes itself when built without iconv, indexed by 94 * row + cell with
+ * both counted from zero. Unassigned cells are zero.
+ */
+extern const unsigned short JIS_X_0208[94 * 94];
+extern const unsigned short GB_2312[87 * 94];
+
+}
+}
+
+#endif
@@ -26,13 +26,22 @@
 #include <cstdint>
 #include <limits>
 #include <string>
+#ifndef NO_THREADS
+#include <atomic>
+#endif
 
 namespace pping {
 
 /* base class for reference-counted objects */
 class Counted {
 private:
+#ifdef NO_THREADS
   std::uint_fast16_t references_;
+#else
+  // Shared objects such as QR versions and Galois fields are referenced from
+  // several threads at once when QRCodeMultiReader decodes in parallel
+  std::atomic<std::uint_fast16_t> references_;
+#endif
   template< typename T > friend void intrusive_ptr_add_ref( T* ) noexcept;
   template< typename T > friend void intrusive_ptr_release( T* ) noexcept;
 protected:
@@ -59,7 +68,7 @@ public:
     cout << "retaining " << typeid(*this).name() << " " << this <<
          " @ " << count_;
 #endif
-    BOOST_ASSERT( references_ < std::numeric_limits<decltype( references_ )>::max() );
+    BOOST_ASSERT( references_ < std::numeric_limits<std::uint_fast16_t>::max() );
     ++references_;
 #ifdef DEBUG_COUNTING
     cout << "->" << count_ << "\n";
@@ -89,7 +98,7 @@ public:
 
 template< typename T >
 void intrusive_ptr_add_ref( T* x ) noexcept {
-    BOOST_ASSERT( x->references_ < std::numeric_limits<decltype( x->references_ )>::max() );
+    BOOST_ASSERT( x->references_ < std::numeric_limits<std::uint_fast16_t>::max() );
     ++x->references_;
 }
 
@@ -0,0 +1,68 @@
+/*
+ *  CroppedLuminanceSource.cpp
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>                               // for memcpy, NULL
+#include <zxing/common/CroppedLuminanceSource.h>
+
+#include "zxing/LuminanceSource.h"                // for LuminanceSource
+
+#include <vector>                                 // for vector
+
+#include <boost/assert.hpp>
+#include <Utils/Macros.h>
+
+namespace pping {
+
+CroppedLuminanceSource::CroppedLuminanceSource(Ref<LuminanceSource> const& source, int left, int top, int width,
+                                               int height) noexcept :
+    source_(source), left_(left), top_(top), width_(width), height_(height) {
+  MB_ASSERTM(left >= 0 && top >= 0 && width > 0 && height > 0 && left + width <= source->getWidth() &&
+             top + height <= source->getHeight(), "%s", "Crop does not fit the image.");
+}
+
+unsigned char* CroppedLuminanceSource::getRow(int y, unsigned char* row) const MB_NOEXCEPT_EXCEPT_BADALLOC {
+  BOOST_ASSERT_MSG(!(y < 0 || y >= getHeight()), "Requested row is outside the image.");
+
+  if (row == NULL) {
+    row = new unsigned char[width_];
+  }
+  std::vector<unsigned char> sourceRow(source_->getWidth());
+  BOOST_VERIFY(source_->getRow(top_ + y, &sourceRow[0]) == &sourceRow[0]);
+  memcpy(row, &sourceRow[left_], width_);
+  return row;
+}
+
+unsigned char* CroppedLuminanceSource::getMatrix() const MB_NOEXCEPT_EXCEPT_BADALLOC {
+  unsigned char* result = new unsigned char[(size_t)width_ * (size_t)height_];
+  std::vector<unsigned char> sourceRow(source_->getWidth());
+  for (int y = 0; y < height_; y++) {
+    BOOST_VERIFY(source_->getRow(top_ + y, &sourceRow[0]) == &sourceRow[0]);
+    memcpy(result + (size_t)y * (size_t)width_, &sourceRow[left_], width_);
+  }
+  return result;
+}
+
+Ref<LuminanceSource> CroppedLuminanceSource::rotateCounterClockwise() MB_NOEXCEPT_EXCEPT_BADALLOC
+{
+    MB_ASSERTM(false, "%s", "This source doesn't implement rotation");
+
+    return Ref<LuminanceSource>(nullptr);
+}
+
+} // namespace
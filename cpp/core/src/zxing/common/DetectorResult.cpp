@@ -29,7 +29,7 @@
 namespace pping {
 
 DetectorResult::DetectorResult(Ref<BitMatrix> bits, std::vector<Ref<ResultPoint> > points, 
-    pping::Ref<pping::PerspectiveTransform> perspectiveTransform) :
+    PerspectiveTransform const & perspectiveTransform) :
   bits_(bits), points_(points), perspectiveTransform_(perspectiveTransform) {
 }
 
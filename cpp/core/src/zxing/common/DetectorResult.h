@@ -22,6 +22,7 @@
 #include <zxing/ResultPoint.h>                  // for ResultPoint
 #include <zxing/common/BitMatrix.h>             // for BitMatrix
 #include <zxing/common/Counted.h>               // for Ref, Counted
+#include <zxing/common/ModuleSamples.h>         // for ModuleSamples
 #include <zxing/common/PerspectiveTransform.h>  // for PerspectiveTransform
 #include <zxing/common/Error.hpp>
 #include <vector>                               // for vector
@@ -32,17 +33,22 @@ class DetectorResult : public Counted {
 private:
   Ref<BitMatrix> bits_;
   std::vector<Ref<ResultPoint>> points_;
-  pping::Ref<pping::PerspectiveTransform> perspectiveTransform_;
+  PerspectiveTransform perspectiveTransform_;
+  Ref<ModuleSamples> moduleSamples_;
 
 public:
         DetectorResult(Ref<BitMatrix> bits, std::vector<Ref<ResultPoint>> points,
-          pping::Ref<pping::PerspectiveTransform> perspectiveTransform);
+          PerspectiveTransform const & perspectiveTransform);
 
         DetectorResult(Ref<BitMatrix> bits, std::vector<Ref<ResultPoint>> points);
 
   auto const & getBits                () const noexcept { return bits_                ; }
   auto const & getPoints              () const noexcept { return points_              ; }
   auto const & getPerspectiveTransform() const noexcept { return perspectiveTransform_; }
+  /** Greyscale samples bits were thresholded from; empty unless the detector kept them. */
+  auto const & getModuleSamples       () const noexcept { return moduleSamples_       ; }
+
+  void setModuleSamples(Ref<ModuleSamples> moduleSamples) noexcept { moduleSamples_ = moduleSamples; }
 };
 }
 
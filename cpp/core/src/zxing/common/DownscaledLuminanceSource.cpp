@@ -0,0 +1,74 @@
+/*
+ *  DownscaledLuminanceSource.cpp
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>                                  // for memcpy, NULL
+#include <zxing/common/DownscaledLuminanceSource.h>
+
+#include "zxing/LuminanceSource.h"                   // for LuminanceSource
+
+#include <boost/assert.hpp>
+#include <Utils/Macros.h>
+
+namespace pping {
+
+DownscaledLuminanceSource::DownscaledLuminanceSource(Ref<LuminanceSource> const& source, int factor) MB_NOEXCEPT_EXCEPT_BADALLOC :
+    luminances_(), width_(source->getWidth() / factor), height_(source->getHeight() / factor) {
+
+  MB_ASSERTM(factor >= 1 && width_ > 0 && height_ > 0, "%s", "Downscale factor does not fit the image.");
+
+  luminances_.resize((size_t)width_ * (size_t)height_);
+  std::vector<unsigned char> sourceRow(source->getWidth());
+  for (int y = 0; y < height_; y++) {
+    // Sample the middle row of each band of factor rows
+    BOOST_VERIFY(source->getRow(y * factor + (factor >> 1), &sourceRow[0]) == &sourceRow[0]);
+    unsigned char* row = &luminances_[(size_t)y * (size_t)width_];
+    for (int x = 0, offset = 0; x < width_; x++) {
+      int sum = 0;
+      for (int i = 0; i < factor; i++) {
+        sum += sourceRow[offset++];
+      }
+      row[x] = (unsigned char)(sum / factor);
+    }
+  }
+}
+
+unsigned char* DownscaledLuminanceSource::getRow(int y, unsigned char* row) const MB_NOEXCEPT_EXCEPT_BADALLOC {
+  BOOST_ASSERT_MSG(!(y < 0 || y >= getHeight()), "Requested row is outside the image.");
+
+  if (row == NULL) {
+    row = new unsigned char[width_];
+  }
+  memcpy(row, &luminances_[(size_t)y * (size_t)width_], width_);
+  return row;
+}
+
+unsigned char* DownscaledLuminanceSource::getMatrix() const MB_NOEXCEPT_EXCEPT_BADALLOC {
+  unsigned char* result = new unsigned char[luminances_.size()];
+  memcpy(result, &luminances_[0], luminances_.size());
+  return result;
+}
+
+Ref<LuminanceSource> DownscaledLuminanceSource::rotateCounterClockwise() MB_NOEXCEPT_EXCEPT_BADALLOC
+{
+    MB_ASSERTM(false, "%s", "This source doesn't implement rotation");
+
+    return Ref<LuminanceSource>(nullptr);
+}
+
+} // namespace
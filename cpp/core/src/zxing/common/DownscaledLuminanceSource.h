@@ -0,0 +1,64 @@
+#pragma once
+/*
+ *  DownscaledLuminanceSource.h
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/LuminanceSource.h>  // for LuminanceSource
+
+#include "zxing/common/Counted.h"   // for Ref
+
+#include <vector>                   // for vector
+
+namespace pping {
+
+/**
+ * A coarse copy of another luminance source, reduced by an integer factor in
+ * both directions. Only every factor-th row of the original is read, and
+ * each pixel of it is the average of factor horizontally adjacent pixels, so
+ * building it touches a fraction of the original image.
+ */
+class DownscaledLuminanceSource : public LuminanceSource {
+
+ private:
+  std::vector<unsigned char> luminances_;
+  int width_;
+  int height_;
+
+ public:
+  DownscaledLuminanceSource(Ref<LuminanceSource> const& source, int factor) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+  virtual unsigned char* getRow(int y, unsigned char* row) const MB_NOEXCEPT_EXCEPT_BADALLOC override;
+  virtual unsigned char* getMatrix() const MB_NOEXCEPT_EXCEPT_BADALLOC override;
+
+  virtual bool isRotateSupported() const noexcept override {
+    return false;
+  }
+
+  virtual int getWidth() const noexcept override {
+    return width_;
+  }
+
+  virtual int getHeight() const noexcept override {
+    return height_;
+  }
+
+  virtual Ref<LuminanceSource> rotateCounterClockwise() MB_NOEXCEPT_EXCEPT_BADALLOC override;
+
+};
+
+} /* namespace */
@@ -22,9 +22,12 @@
 #include <zxing/ReaderException.h>              // for ReaderException
 #include <zxing/common/GridSampler.h>
 #include <zxing/common/PerspectiveTransform.h>  // for PerspectiveTransform
+#include <algorithm>                            // for max, min
 #include <string>                               // for allocator, basic_string, char_traits
 
+#include "zxing/LuminanceSource.h"              // for LuminanceSource
 #include "zxing/common/BitMatrix.h"             // for BitMatrix
+#include "zxing/common/ByteMatrix.h"            // for ByteMatrix
 #include "zxing/common/Counted.h"               // for Ref
 #include "zxing/common/Error.hpp"
 
@@ -36,7 +39,7 @@ GridSampler GridSampler::gridSampler;
 GridSampler::GridSampler() {
 }
 
-FallibleRef<BitMatrix> GridSampler::sampleGrid(Ref<BitMatrix> image, int dimension, Ref<PerspectiveTransform> transform) MB_NOEXCEPT_EXCEPT_BADALLOC
+FallibleRef<BitMatrix> GridSampler::sampleGrid(Ref<BitMatrix> image, int dimension, PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC
 #if !defined( DEBUG ) && defined( __clang__ )
     /** @note
      * In release mode, ASAN finds container-overflow when accessing first
@@ -55,7 +58,7 @@ FallibleRef<BitMatrix> GridSampler::sampleGrid(Ref<BitMatrix> image, int dimensi
       points[x] = (float)(x >> 1) + 0.5f;
       points[x + 1] = yValue;
     }
-    transform->transformPoints(points);
+    transform.transformPoints(points);
 
     auto const tryCheckAndNudge(checkAndNudgePoints(image, points));
     if(!tryCheckAndNudge)
@@ -74,7 +77,7 @@ FallibleRef<BitMatrix> GridSampler::sampleGrid(Ref<BitMatrix> image, int dimensi
   return bits;
 }
 
-FallibleRef<BitMatrix> GridSampler::sampleGrid(Ref<BitMatrix> image, int dimensionX, int dimensionY, Ref<PerspectiveTransform> transform) MB_NOEXCEPT_EXCEPT_BADALLOC
+FallibleRef<BitMatrix> GridSampler::sampleGrid(Ref<BitMatrix> image, int dimensionX, int dimensionY, PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC
 #if !defined( DEBUG ) && defined( __clang__ )
     /** @note
      * In release mode, ASAN finds container-overflow when accessing first
@@ -93,7 +96,7 @@ FallibleRef<BitMatrix> GridSampler::sampleGrid(Ref<BitMatrix> image, int dimensi
       points[x] = (float)(x >> 1) + 0.5f;
       points[x + 1] = yValue;
     }
-    transform->transformPoints(points);
+    transform.transformPoints(points);
 
     auto const tryCheckAndNudge(checkAndNudgePoints(image, points));
     if(!tryCheckAndNudge)
@@ -111,14 +114,83 @@ FallibleRef<BitMatrix> GridSampler::sampleGrid(Ref<BitMatrix> image, int dimensi
 FallibleRef<BitMatrix> GridSampler::sampleGrid(Ref<BitMatrix> image, int dimension, float p1ToX, float p1ToY, float p2ToX,
                                        float p2ToY, float p3ToX, float p3ToY, float p4ToX, float p4ToY, float p1FromX, float p1FromY, float p2FromX,
                                        float p2FromY, float p3FromX, float p3FromY, float p4FromX, float p4FromY) MB_NOEXCEPT_EXCEPT_BADALLOC {
-  Ref<PerspectiveTransform> transform(PerspectiveTransform::quadrilateralToQuadrilateral(p1ToX, p1ToY, p2ToX, p2ToY,
-                                      p3ToX, p3ToY, p4ToX, p4ToY, p1FromX, p1FromY, p2FromX, p2FromY, p3FromX, p3FromY, p4FromX, p4FromY));
+  PerspectiveTransform transform(PerspectiveTransform::quadrilateralToQuadrilateral(p1ToX, p1ToY, p2ToX, p2ToY,
+                                 p3ToX, p3ToY, p4ToX, p4ToY, p1FromX, p1FromY, p2FromX, p2FromY, p3FromX, p3FromY, p4FromX, p4FromY));
 
   return sampleGrid(image, dimension, transform);
 
 }
 
-Fallible<void> GridSampler::checkAndNudgePoints(Ref<BitMatrix> image, vector<float> &points)
+FallibleRef<ByteMatrix> GridSampler::sampleGrid(Ref<LuminanceSource> source, int dimension, PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  return sampleGrid(source, dimension, dimension, transform);
+}
+
+FallibleRef<ByteMatrix> GridSampler::sampleGrid(Ref<LuminanceSource> source, int dimensionX, int dimensionY, PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  if (dimensionX <= 0 || dimensionY <= 0) {
+    return failure<ReaderException>("Grid has no modules");
+  }
+  int width = source->getWidth();
+  int height = source->getHeight();
+
+  // Transform the whole grid up front; the rows it spans are the only part
+  // of the source that has to be fetched.
+  int max = dimensionX << 1;
+  vector<float> points(max * dimensionY, 0.0f);
+  for (int y = 0, offset = 0; y < dimensionY; y++) {
+    float yValue = (float)y + 0.5f;
+    for (int x = 0; x < max; x += 2, offset += 2) {
+      points[offset] = (float)(x >> 1) + 0.5f;
+      points[offset + 1] = yValue;
+    }
+  }
+  transform.transformPoints(points);
+
+  auto const tryCheckAndNudge(checkAndNudgePoints(width, height, points));
+  if(!tryCheckAndNudge)
+      return tryCheckAndNudge.error();
+
+  int top = height - 1;
+  int bottom = 0;
+  for (size_t offset = 1; offset < points.size(); offset += 2) {
+    int y = (int)points[offset];
+    top = std::min(top, y);
+    bottom = std::max(bottom, y);
+  }
+  // Bilinear interpolation also reads the row below the sample point
+  bottom = std::min(bottom + 1, height - 1);
+
+  vector<unsigned char> luminances((size_t)(bottom - top + 1) * (size_t)width);
+  for (int y = top; y <= bottom; y++) {
+    source->getRow(y, &luminances[(size_t)(y - top) * (size_t)width]);
+  }
+
+  Ref<ByteMatrix> samples(new ByteMatrix(dimensionX, dimensionY));
+  for (int y = 0, offset = 0; y < dimensionY; y++) {
+    for (int x = 0; x < dimensionX; x++, offset += 2) {
+      float imageX = points[offset] - 0.5f;
+      float imageY = points[offset + 1] - 0.5f;
+      int x0 = std::max(0, std::min((int)imageX, width - 1));
+      int y0 = std::max(top, std::min((int)imageY, bottom));
+      int x1 = std::min(x0 + 1, width - 1);
+      int y1 = std::min(y0 + 1, bottom);
+      float fx = std::max(0.0f, std::min(imageX - (float)x0, 1.0f));
+      float fy = std::max(0.0f, std::min(imageY - (float)y0, 1.0f));
+
+      unsigned char const* row0 = &luminances[(size_t)(y0 - top) * (size_t)width];
+      unsigned char const* row1 = &luminances[(size_t)(y1 - top) * (size_t)width];
+      float upper = (float)row0[x0] + fx * ((float)row0[x1] - (float)row0[x0]);
+      float lower = (float)row1[x0] + fx * ((float)row1[x1] - (float)row1[x0]);
+      samples->set(x, y, (unsigned char)(upper + fy * (lower - upper) + 0.5f));
+    }
+  }
+  return samples;
+}
+
+Fallible<void> GridSampler::checkAndNudgePoints(Ref<BitMatrix> image, vector<float> &points) {
+  return checkAndNudgePoints((int)image->getWidth(), (int)image->getHeight(), points);
+}
+
+Fallible<void> GridSampler::checkAndNudgePoints(int width, int height, vector<float> &points)
 #if !defined( DEBUG ) && defined( __clang__ )
     /** @note
      * In release mode, ASAN finds container-overflow when accessing first
@@ -128,9 +200,6 @@ Fallible<void> GridSampler::checkAndNudgePoints(Ref<BitMatrix> image, vector<flo
     __attribute__(( no_sanitize( "address" ) ))
 #endif
 {
-  int width = (int)image->getWidth();
-  int height = (int)image->getHeight();
-
 
   // The Java code assumes that if the start and end points are in bounds, the rest will also be.
   // However, in some unusual cases points in the middle may also be out of bounds.
@@ -26,6 +26,8 @@
 
 namespace pping {
 class BitMatrix;
+class ByteMatrix;
+class LuminanceSource;
 class PerspectiveTransform;
 
 class GridSampler {
@@ -33,13 +35,23 @@ private:
   static GridSampler gridSampler;
   GridSampler();
 
+  static Fallible<void> checkAndNudgePoints(int width, int height, std::vector<float> &points);
+
 public:
-  FallibleRef<BitMatrix> sampleGrid(Ref<BitMatrix> image, int dimension, Ref<PerspectiveTransform> transform) MB_NOEXCEPT_EXCEPT_BADALLOC;
-  FallibleRef<BitMatrix> sampleGrid(Ref<BitMatrix> image, int dimensionX, int dimensionY, Ref<PerspectiveTransform> transform) MB_NOEXCEPT_EXCEPT_BADALLOC;
+  FallibleRef<BitMatrix> sampleGrid(Ref<BitMatrix> image, int dimension, PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC;
+  FallibleRef<BitMatrix> sampleGrid(Ref<BitMatrix> image, int dimensionX, int dimensionY, PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC;
 
   FallibleRef<BitMatrix> sampleGrid(Ref<BitMatrix> image, int dimension, float p1ToX, float p1ToY, float p2ToX, float p2ToY,
                             float p3ToX, float p3ToY, float p4ToX, float p4ToY, float p1FromX, float p1FromY, float p2FromX,
                             float p2FromY, float p3FromX, float p3FromY, float p4FromX, float p4FromY) MB_NOEXCEPT_EXCEPT_BADALLOC;
+  /**
+   * Samples the luminance at the centre of every module without thresholding
+   * it, so no binarization of the source image is required. Only the rows
+   * covered by the transformed grid are read from the source.
+   */
+  FallibleRef<ByteMatrix> sampleGrid(Ref<LuminanceSource> source, int dimension, PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC;
+  FallibleRef<ByteMatrix> sampleGrid(Ref<LuminanceSource> source, int dimensionX, int dimensionY, PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
   static Fallible<void> checkAndNudgePoints(Ref<BitMatrix> image, std::vector<float> &points);
   static GridSampler &getInstance() noexcept;
 };
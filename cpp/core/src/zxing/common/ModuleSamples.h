@@ -0,0 +1,126 @@
+// -*- mode:c++; tab-width:2; indent-tabs-mode:nil; c-basic-offset:2 -*-
+#pragma once
+
+/*
+ *  ModuleSamples.h
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/common/BitMatrix.h>   // for BitMatrix
+#include <zxing/common/ByteMatrix.h>  // for ByteMatrix
+#include <zxing/common/Counted.h>     // for Ref, Counted
+#include <zxing/common/Span.h>        // for Span
+
+#include <algorithm>                  // for stable_sort
+#include <vector>                     // for vector
+
+namespace pping {
+
+/**
+ * The greyscale sample and the threshold used for each module of a sampled
+ * symbol. Kept next to the bits so a decoder whose error correction fails
+ * can threshold the same samples again, or tell which modules were close
+ * to the threshold, without binarizing, detecting and sampling again.
+ */
+class ModuleSamples : public Counted {
+private:
+  Ref<ByteMatrix> samples_;
+  Ref<ByteMatrix> thresholds_;
+
+public:
+  // Codewords read from a module closer than this to its threshold are
+  // treated as erasures when retrying on the samples
+  static constexpr unsigned char ERASURE_CONFIDENCE = 16;
+  // Threshold offsets a decoder retries with, both ways, when erasures do not help
+  static constexpr int RETHRESHOLD_BIAS = 16;
+
+  ModuleSamples(Ref<ByteMatrix> samples, Ref<ByteMatrix> thresholds) :
+      samples_(samples), thresholds_(thresholds) {
+  }
+
+  size_t getDimension() const {
+    return samples_->getDimension();
+  }
+
+  size_t getWidth() const {
+    return samples_->getWidth();
+  }
+
+  size_t getHeight() const {
+    return samples_->getHeight();
+  }
+
+  /** Modules not brighter than their threshold moved by bias are black. */
+  Ref<BitMatrix> threshold(int bias) const {
+    size_t width = getWidth();
+    size_t height = getHeight();
+    Ref<BitMatrix> bits(new BitMatrix(width, height));
+    for (size_t y = 0; y < height; y++) {
+      for (size_t x = 0; x < width; x++) {
+        if ((int)samples_->get(x, y) <= (int)thresholds_->get(x, y) + bias) {
+          bits->set(x, y);
+        }
+      }
+    }
+    return bits;
+  }
+
+  /** Distance of each module from its threshold; small values are unreliable. */
+  Ref<ByteMatrix> getConfidence() const {
+    size_t width = getWidth();
+    size_t height = getHeight();
+    Ref<ByteMatrix> confidence(new ByteMatrix(width, height));
+    for (size_t y = 0; y < height; y++) {
+      for (size_t x = 0; x < width; x++) {
+        int distance = (int)samples_->get(x, y) - (int)thresholds_->get(x, y);
+        confidence->set(x, y, (unsigned char)(distance < 0 ? -distance : distance));
+      }
+    }
+    return confidence;
+  }
+
+  Ref<ByteMatrix> getSamples() const {
+    return samples_;
+  }
+
+  Ref<ByteMatrix> getThresholds() const {
+    return thresholds_;
+  }
+
+  /**
+   * The codewords of a block to erase, given the confidence of each. Leaves
+   * half of the check codewords for errors the samples did not flag.
+   */
+  static std::vector<int> selectErasures(Span<unsigned char const> confidence, int numECCodewords) {
+    std::vector<int> erasures;
+    for (int i = 0; i < (int)confidence.size(); i++) {
+      if (confidence[i] < ERASURE_CONFIDENCE) {
+        erasures.push_back(i);
+      }
+    }
+    size_t maxErasures = (size_t)(numECCodewords / 2);
+    if (erasures.size() > maxErasures) {
+      std::stable_sort(erasures.begin(), erasures.end(), [&confidence](int a, int b) {
+        return confidence[a] < confidence[b];
+      });
+      erasures.resize(maxErasures);
+    }
+    return erasures;
+  }
+};
+
+}
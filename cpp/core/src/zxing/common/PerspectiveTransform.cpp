@@ -21,7 +21,6 @@
 #include <stddef.h>                // for size_t
 #include <zxing/common/PerspectiveTransform.h>
 
-#include "zxing/common/Counted.h"  // for Ref
 #include <Utils/Macros.h>
 
 #include <cmath>
@@ -37,23 +36,25 @@ PerspectiveTransform::PerspectiveTransform(float inA11, float inA21,
   a11(inA11), a12(inA12), a13(inA13), a21(inA21), a22(inA22), a23(inA23),
   a31(inA31), a32(inA32), a33(inA33) {}
 
-Ref<PerspectiveTransform> PerspectiveTransform::quadrilateralToQuadrilateral(float x0, float y0, float x1, float y1,
+PerspectiveTransform::PerspectiveTransform() noexcept :
+  a11(1.0f), a12(0.0f), a13(0.0f), a21(0.0f), a22(1.0f), a23(0.0f),
+  a31(0.0f), a32(0.0f), a33(1.0f) {}
+
+PerspectiveTransform PerspectiveTransform::quadrilateralToQuadrilateral(float x0, float y0, float x1, float y1,
     float x2, float y2, float x3, float y3, float x0p, float y0p, float x1p, float y1p, float x2p, float y2p,
-    float x3p, float y3p) {
-  Ref<PerspectiveTransform> qToS = PerspectiveTransform::quadrilateralToSquare(x0, y0, x1, y1, x2, y2, x3, y3);
-  Ref<PerspectiveTransform> sToQ =
+    float x3p, float y3p) noexcept {
+  PerspectiveTransform qToS = PerspectiveTransform::quadrilateralToSquare(x0, y0, x1, y1, x2, y2, x3, y3);
+  PerspectiveTransform sToQ =
     PerspectiveTransform::squareToQuadrilateral(x0p, y0p, x1p, y1p, x2p, y2p, x3p, y3p);
-  return sToQ->times(qToS);
+  return sToQ.times(qToS);
 }
 
-Ref<PerspectiveTransform> PerspectiveTransform::squareToQuadrilateral(float x0, float y0, float x1, float y1, float x2,
-    float y2, float x3, float y3) {
+PerspectiveTransform PerspectiveTransform::squareToQuadrilateral(float x0, float y0, float x1, float y1, float x2,
+    float y2, float x3, float y3) noexcept {
   float dx3 = x0 - x1 + x2 - x3;
   float dy3 = y0 - y1 + y2 - y3;
   if (dx3 == 0.0f && dy3 == 0.0f) {
-    Ref<PerspectiveTransform> result(new PerspectiveTransform(x1 - x0, x2 - x1, x0, y1 - y0, y2 - y1, y0, 0.0f,
-                                     0.0f, 1.0f));
-    return result;
+    return PerspectiveTransform(x1 - x0, x2 - x1, x0, y1 - y0, y2 - y1, y0, 0.0f, 0.0f, 1.0f);
   } else {
     float dx1 = x1 - x2;
     float dx2 = x3 - x2;
@@ -65,37 +66,37 @@ Ref<PerspectiveTransform> PerspectiveTransform::squareToQuadrilateral(float x0,
 
     float a13 = (dx3 * dy2 - dx2 * dy3) / denominator;
     float a23 = (dx1 * dy3 - dx3 * dy1) / denominator;
-    Ref<PerspectiveTransform> result(new PerspectiveTransform(x1 - x0 + a13 * x1, x3 - x0 + a23 * x3, x0, y1 - y0
-                                     + a13 * y1, y3 - y0 + a23 * y3, y0, a13, a23, 1.0f));
-    return result;
+    return PerspectiveTransform(x1 - x0 + a13 * x1, x3 - x0 + a23 * x3, x0, y1 - y0 + a13 * y1,
+                                y3 - y0 + a23 * y3, y0, a13, a23, 1.0f);
   }
 }
 
-Ref<PerspectiveTransform> PerspectiveTransform::quadrilateralToSquare(float x0, float y0, float x1, float y1, float x2,
-    float y2, float x3, float y3) {
+PerspectiveTransform PerspectiveTransform::quadrilateralToSquare(float x0, float y0, float x1, float y1, float x2,
+    float y2, float x3, float y3) noexcept {
   // Here, the adjoint serves as the inverse:
-  return squareToQuadrilateral(x0, y0, x1, y1, x2, y2, x3, y3)->buildAdjoint();
+  return squareToQuadrilateral(x0, y0, x1, y1, x2, y2, x3, y3).buildAdjoint();
 }
 
-Ref<PerspectiveTransform> PerspectiveTransform::buildAdjoint() {
+PerspectiveTransform PerspectiveTransform::buildAdjoint() const noexcept {
   // Adjoint is the transpose of the cofactor matrix:
-  Ref<PerspectiveTransform> result(new PerspectiveTransform(a22 * a33 - a23 * a32, a23 * a31 - a21 * a33, a21 * a32
-                                   - a22 * a31, a13 * a32 - a12 * a33, a11 * a33 - a13 * a31, a12 * a31 - a11 * a32, a12 * a23 - a13 * a22,
-                                   a13 * a21 - a11 * a23, a11 * a22 - a12 * a21));
-  return result;
+  return PerspectiveTransform(a22 * a33 - a23 * a32, a23 * a31 - a21 * a33, a21 * a32 - a22 * a31,
+                              a13 * a32 - a12 * a33, a11 * a33 - a13 * a31, a12 * a31 - a11 * a32,
+                              a12 * a23 - a13 * a22, a13 * a21 - a11 * a23, a11 * a22 - a12 * a21);
 }
 
-Ref<PerspectiveTransform> PerspectiveTransform::times(Ref<PerspectiveTransform> other) {
-  Ref<PerspectiveTransform> result(new PerspectiveTransform(a11 * other->a11 + a21 * other->a12 + a31 * other->a13,
-                                   a11 * other->a21 + a21 * other->a22 + a31 * other->a23, a11 * other->a31 + a21 * other->a32 + a31
-                                   * other->a33, a12 * other->a11 + a22 * other->a12 + a32 * other->a13, a12 * other->a21 + a22
-                                   * other->a22 + a32 * other->a23, a12 * other->a31 + a22 * other->a32 + a32 * other->a33, a13
-                                   * other->a11 + a23 * other->a12 + a33 * other->a13, a13 * other->a21 + a23 * other->a22 + a33
-                                   * other->a23, a13 * other->a31 + a23 * other->a32 + a33 * other->a33));
-  return result;
+PerspectiveTransform PerspectiveTransform::times(PerspectiveTransform const &other) const noexcept {
+  return PerspectiveTransform(a11 * other.a11 + a21 * other.a12 + a31 * other.a13,
+                              a11 * other.a21 + a21 * other.a22 + a31 * other.a23,
+                              a11 * other.a31 + a21 * other.a32 + a31 * other.a33,
+                              a12 * other.a11 + a22 * other.a12 + a32 * other.a13,
+                              a12 * other.a21 + a22 * other.a22 + a32 * other.a23,
+                              a12 * other.a31 + a22 * other.a32 + a32 * other.a33,
+                              a13 * other.a11 + a23 * other.a12 + a33 * other.a13,
+                              a13 * other.a21 + a23 * other.a22 + a33 * other.a23,
+                              a13 * other.a31 + a23 * other.a32 + a33 * other.a33);
 }
 
-void PerspectiveTransform::transformPoints(vector<float> &points) noexcept
+void PerspectiveTransform::transformPoints(vector<float> &points) const noexcept
 #if !defined( DEBUG ) && defined( __clang__ )
     /** @note
      * In release mode, ASAN finds container-overflow when accessing first
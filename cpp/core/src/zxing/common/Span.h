@@ -0,0 +1,88 @@
+// -*- mode:c++; tab-width:2; indent-tabs-mode:nil; c-basic-offset:2 -*-
+#pragma once
+
+/*
+ *  Span.h
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/common/Array.h>  // for ArrayRef
+
+#include <stddef.h>              // for size_t
+#include <vector>                // for vector
+
+namespace pping {
+
+/**
+ * A view of size elements owned by someone else, usually one buffer shared
+ * by all stages of a decode. Unlike ArrayRef it neither allocates nor
+ * counts references, so handing parts of a buffer from stage to stage
+ * costs nothing; the owner has to outlive the view.
+ */
+template<typename T> class Span {
+private:
+  T* data_;
+  size_t size_;
+
+public:
+  Span() noexcept : data_(0), size_(0) {
+  }
+  Span(T* data, size_t size) noexcept : data_(data), size_(size) {
+  }
+  template<typename U>
+  Span(std::vector<U>& values) noexcept : data_(values.empty() ? 0 : &values[0]), size_(values.size()) {
+  }
+  template<typename U>
+  Span(std::vector<U> const& values) noexcept : data_(values.empty() ? 0 : &values[0]), size_(values.size()) {
+  }
+  template<typename U>
+  Span(ArrayRef<U>& values) noexcept : data_(0), size_(0) {
+    if (values.array_ && values.size() > 0) {
+      data_ = &values[0];
+      size_ = values.size();
+    }
+  }
+  template<typename U>
+  Span(Span<U> const& other) noexcept : data_(other.data()), size_(other.size()) {
+  }
+
+  T& operator[](size_t i) const {
+    return data_[i];
+  }
+  T* data() const {
+    return data_;
+  }
+  size_t size() const {
+    return size_;
+  }
+  bool empty() const {
+    return size_ == 0;
+  }
+  T* begin() const {
+    return data_;
+  }
+  T* end() const {
+    return data_ + size_;
+  }
+
+  /** The count elements from offset on. */
+  Span<T> subspan(size_t offset, size_t count) const {
+    return Span<T>(data_ + offset, count);
+  }
+};
+
+}
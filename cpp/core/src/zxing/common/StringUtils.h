@@ -20,7 +20,9 @@
 
 
 #include <zxing/DecodeHints.h>
+#include <zxing/common/Error.hpp>
 #include <map>
+#include <stddef.h>
 #include <string>
 
 namespace pping {
@@ -47,5 +49,22 @@ public:
   typedef std::map<DecodeHintType, std::string> Hashtable;
 
   static std::string guessEncoding(unsigned char* bytes, int length, Hashtable const& hints);
+
+  /**
+   * Appends length bytes in the given encoding to result as UTF-8.
+   *
+   * ASCII, UTF-8, UTF-16BE, ISO-8859-1, ISO-8859-15 and windows-1252 are
+   * converted by built-in tables. Other encodings go through an iconv
+   * descriptor that is opened once per thread and encoding; when iconv does
+   * not know the encoding, the bytes are appended unconverted. When built
+   * without iconv, Shift_JIS, EUC-JP and GB 2312 are decoded from built-in
+   * tables as well, and whatever cannot be decoded becomes U+FFFD, so the
+   * result is always valid UTF-8.
+   */
+  static Fallible<void> appendAsUtf8(std::string& result, unsigned char const* bytes, size_t length,
+                                     char const* encoding) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+  /** Number of leading bytes below 0x80, checked a machine word at a time. */
+  static size_t countAsciiPrefix(unsigned char const* bytes, size_t length) noexcept;
 };
 
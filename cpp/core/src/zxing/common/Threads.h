@@ -0,0 +1,102 @@
+// -*- mode:c++; tab-width:2; indent-tabs-mode:nil; c-basic-offset:2 -*-
+#pragma once
+
+/*
+ *  Threads.h
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstddef>        // for size_t
+
+#ifndef NO_THREADS
+#include <exception>      // for exception_ptr, current_exception, rethrow_exception
+#include <system_error>   // for system_error
+#include <thread>         // for thread
+#include <vector>         // for vector
+#endif
+
+namespace pping {
+
+#ifndef NO_THREADS
+namespace detail {
+  /** Joins the threads it holds when it goes out of scope, however that happens. */
+  class ThreadJoiner {
+  private:
+    std::vector<std::thread>& threads_;
+
+  public:
+    explicit ThreadJoiner(std::vector<std::thread>& threads) noexcept : threads_(threads) {
+    }
+    ~ThreadJoiner() {
+      for (auto & thread : threads_) {
+        if (thread.joinable()) {
+          thread.join();
+        }
+      }
+    }
+  };
+}
+#endif
+
+/**
+ * Calls work(0) to work(count - 1), work(0) on the calling thread and the
+ * others on threads of their own, and returns once all of them have. Should
+ * a thread fail to start, its part runs on the calling thread instead. What
+ * a part throws, std::bad_alloc in practice, is rethrown here after all of
+ * them are done, the exception of the lowest part first. Without threads
+ * the parts run one after the other.
+ */
+template <typename Work>
+void runOnThreads(size_t count, Work const& work) {
+#ifndef NO_THREADS
+  std::vector<std::exception_ptr> errors(count);
+  auto guarded = [&](size_t i) noexcept {
+    try {
+      work(i);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  };
+  {
+    std::vector<std::thread> threads;
+    detail::ThreadJoiner joiner(threads);
+    threads.reserve(count);
+    size_t started = 1;
+    try {
+      for (; started < count; started++) {
+        threads.emplace_back(guarded, started);
+      }
+    } catch (std::system_error const&) {
+    }
+    guarded(0);
+    for (size_t i = started; i < count; i++) {
+      guarded(i);
+    }
+  }
+  for (auto const & error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+#else
+  for (size_t i = 0; i < count; i++) {
+    work(i);
+  }
+#endif
+}
+
+}
@@ -0,0 +1,121 @@
+// -*- mode:c++; tab-width:2; indent-tabs-mode:nil; c-basic-offset:2 -*-
+#pragma once
+
+/*
+ *  ThresholdPlane.h
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/common/ByteMatrix.h>  // for ByteMatrix
+#include <zxing/common/Counted.h>     // for Ref
+
+#include <algorithm>                  // for max, min
+#include <cmath>                      // for abs
+#include <cstddef>                    // for size_t
+
+namespace pping {
+
+/**
+ * Weighted least-squares fit of threshold(x, y) = a + b * x + c * y over the
+ * modules of a sampled symbol, from the black and white modules of its fixed
+ * patterns. Lets the greyscale samples of every module be thresholded
+ * against the lighting where it lies.
+ */
+class ThresholdPlane {
+private:
+  double s_[3][3];
+  double r_[3];
+  double a_;
+  double b_;
+  double c_;
+
+public:
+  // Same minimal black/white difference the HybridBinarizer accepts in a block
+  static constexpr int MIN_DYNAMIC_RANGE = 24;
+
+  ThresholdPlane() noexcept : s_(), r_(), a_(0.0), b_(0.0), c_(0.0) {}
+
+  void add(double x, double y, double threshold, double weight) noexcept {
+    double const v[3] = { 1.0, x, y };
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++) {
+        s_[i][j] += weight * v[i] * v[j];
+      }
+      r_[i] += weight * v[i] * threshold;
+    }
+  }
+
+  /**
+   * Adds the threshold halfway between a black and a white sample at (x, y),
+   * unless they are too close to tell apart. Returns whether it was added.
+   */
+  bool addPair(double x, double y, int black, int white, double weight) noexcept {
+    if (white - black < MIN_DYNAMIC_RANGE) {
+      return false;
+    }
+    add(x, y, (black + white) >> 1, weight);
+    return true;
+  }
+
+  bool solve() noexcept {
+    if (s_[0][0] <= 0.0) {
+      return false;
+    }
+    double det = determinant(s_[0], s_[1], s_[2]);
+    if (std::abs(det) < 1e-9) {
+      // Degenerate layout; fall back to a flat threshold
+      a_ = r_[0] / s_[0][0];
+      b_ = c_ = 0.0;
+      return true;
+    }
+    double m[3][3];
+    double* solution[3] = { &a_, &b_, &c_ };
+    for (int k = 0; k < 3; k++) {
+      for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+          m[i][j] = j == k ? r_[i] : s_[i][j];
+        }
+      }
+      *solution[k] = determinant(m[0], m[1], m[2]) / det;
+    }
+    return true;
+  }
+
+  int at(int x, int y) const noexcept {
+    return (int)(a_ + b_ * (double)x + c_ * (double)y + 0.5);
+  }
+
+  /** The solved plane at every module of a width by height symbol. */
+  Ref<ByteMatrix> thresholds(size_t width, size_t height) const {
+    Ref<ByteMatrix> thresholds(new ByteMatrix(width, height));
+    for (size_t y = 0; y < height; y++) {
+      for (size_t x = 0; x < width; x++) {
+        thresholds->set(x, y, (unsigned char)std::min(255, std::max(0, at((int)x, (int)y))));
+      }
+    }
+    return thresholds;
+  }
+
+private:
+  static double determinant(double const* r0, double const* r1, double const* r2) noexcept {
+    return r0[0] * (r1[1] * r2[2] - r1[2] * r2[1]) -
+           r0[1] * (r1[0] * r2[2] - r1[2] * r2[0]) +
+           r0[2] * (r1[0] * r2[1] - r1[1] * r2[0]);
+  }
+};
+
+}
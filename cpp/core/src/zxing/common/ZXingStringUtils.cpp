@@ -17,11 +17,27 @@
  */
 
 #include <zxing/DecodeHints.h>         // for DecodeHints, DecodeHints::CHARACTER_SET
+#include <zxing/ReaderException.h>     // for ReaderException
 #include <zxing/common/StringUtils.h>  // for StringUtils, StringUtils::Hashtable
+#include <zxing/common/CharacterTables.h>  // for JIS_X_0208, GB_2312
+#include <stdint.h>                    // for uint64_t
+#include <string.h>                    // for memcpy
 #include <string>                      // for string
 #include <map>                         // for __map_const_iterator, operator!=
 #include <utility>                     // for pair
 
+#ifndef NO_ICONV
+#   include "Wrappers/Iconv.hpp"       // for iconv_close, iconv, iconv_open, iconv_t
+#   ifdef __APPLE__
+#       include <TargetConditionals.h>
+#   endif
+#   if TARGET_OS_IPHONE || defined( __EMSCRIPTEN__ )
+#       define ICONV_CONST
+#   else
+#       define ICONV_CONST const
+#   endif
+#endif
+
 using namespace std;
 using namespace pping;
 using namespace pping::common;
@@ -37,6 +53,320 @@ char const* const StringUtils::UTF8 = "UTF-8";
 char const* const StringUtils::ISO88591 = "ISO8859-1";
 const bool StringUtils::ASSUME_SHIFT_JIS = false;
 
+namespace {
+  enum class BuiltinEncoding { NONE, ASCII, UTF8, UTF16BE, ISO88591, ISO885915, CP1252, SHIFT_JIS, EUC_JP, GB2312, UNSUPPORTED };
+
+  // Code points of windows-1252 bytes 0x80 - 0x9F; zero where undefined
+  const unsigned short CP1252_HIGH[32] = {
+    0x20AC, 0,      0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0,      0x017D, 0,
+    0,      0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0,      0x017E, 0x0178
+  };
+
+  /** Recognizes the encoding names of StringUtils and CharacterSetECI with a built-in converter. */
+  BuiltinEncoding findBuiltinEncoding(char const* encoding) {
+    // Compare upper case letters and digits only, so that ISO8859_1,
+    // ISO-8859-1 and ISO8859-1 all match
+    std::string name;
+    for (char const* c = encoding; *c != '\0'; c++) {
+      if (*c >= 'a' && *c <= 'z') {
+        name.push_back((char)(*c - 'a' + 'A'));
+      } else if ((*c >= 'A' && *c <= 'Z') || (*c >= '0' && *c <= '9')) {
+        name.push_back(*c);
+      }
+    }
+    if (name == "ASCII" || name == "USASCII") {
+      return BuiltinEncoding::ASCII;
+    }
+    if (name == "UTF8") {
+      return BuiltinEncoding::UTF8;
+    }
+    if (name == "UTF16BE" || name == "UNICODEBIGUNMARKED") {
+      return BuiltinEncoding::UTF16BE;
+    }
+    if (name == "ISO88591" || name == "LATIN1") {
+      return BuiltinEncoding::ISO88591;
+    }
+    if (name == "ISO885915" || name == "LATIN9") {
+      return BuiltinEncoding::ISO885915;
+    }
+    if (name == "CP1252" || name == "WINDOWS1252") {
+      return BuiltinEncoding::CP1252;
+    }
+#ifdef NO_ICONV
+    // Without iconv, the double byte encodings QR codes use are decoded from tables too
+    if (name == "SHIFTJIS" || name == "SJIS") {
+      return BuiltinEncoding::SHIFT_JIS;
+    }
+    if (name == "EUCJP") {
+      return BuiltinEncoding::EUC_JP;
+    }
+    if (name == "GBK" || name == "GB2312" || name == "EUCCN" || name == "GB18030") {
+      return BuiltinEncoding::GB2312;
+    }
+#endif
+    return BuiltinEncoding::NONE;
+  }
+
+  void appendCodePoint(string& result, unsigned int codePoint) {
+    if (codePoint < 0x80) {
+      result.push_back((char)codePoint);
+    } else if (codePoint < 0x800) {
+      result.push_back((char)(0xC0 | (codePoint >> 6)));
+      result.push_back((char)(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+      result.push_back((char)(0xE0 | (codePoint >> 12)));
+      result.push_back((char)(0x80 | ((codePoint >> 6) & 0x3F)));
+      result.push_back((char)(0x80 | (codePoint & 0x3F)));
+    } else {
+      result.push_back((char)(0xF0 | (codePoint >> 18)));
+      result.push_back((char)(0x80 | ((codePoint >> 12) & 0x3F)));
+      result.push_back((char)(0x80 | ((codePoint >> 6) & 0x3F)));
+      result.push_back((char)(0x80 | (codePoint & 0x3F)));
+    }
+  }
+
+  /** Length of the well-formed UTF-8 sequence at bytes, or 0 if there is none. */
+  size_t utf8SequenceLength(unsigned char const* bytes, size_t length) {
+    unsigned char lead = bytes[0];
+    size_t sequenceLength;
+    unsigned char min = 0x80;
+    unsigned char max = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+      sequenceLength = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+      sequenceLength = 3;
+      // No overlong forms, no surrogates
+      if (lead == 0xE0) {
+        min = 0xA0;
+      } else if (lead == 0xED) {
+        max = 0x9F;
+      }
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+      sequenceLength = 4;
+      // No overlong forms, nothing above U+10FFFF
+      if (lead == 0xF0) {
+        min = 0x90;
+      } else if (lead == 0xF4) {
+        max = 0x8F;
+      }
+    } else {
+      return 0;
+    }
+    if (sequenceLength > length || bytes[1] < min || bytes[1] > max) {
+      return 0;
+    }
+    for (size_t i = 2; i < sequenceLength; i++) {
+      if ((bytes[i] & 0xC0) != 0x80) {
+        return 0;
+      }
+    }
+    return sequenceLength;
+  }
+
+#ifdef NO_ICONV
+  const unsigned int REPLACEMENT_CHARACTER = 0xFFFD;
+
+  /** Code point at row and cell of a table of 94 cells per row, or U+FFFD if there is none. */
+  unsigned int lookupDoubleByte(unsigned short const* table, int rows, int row, int cell) {
+    if (row < 0 || row >= rows || cell < 0 || cell >= 94 || table[94 * row + cell] == 0) {
+      return REPLACEMENT_CHARACTER;
+    }
+    return table[94 * row + cell];
+  }
+
+  /**
+   * Appends the non-ASCII character at bytes and returns the number of bytes
+   * it took. Characters outside JIS X 0208 and GB 2312, and malformed bytes,
+   * become U+FFFD, so that the result is valid UTF-8 whatever the input.
+   */
+  size_t appendDoubleByte(string& result, unsigned char const* bytes, size_t length, BuiltinEncoding encoding) {
+    unsigned char lead = bytes[0];
+    unsigned char trail = length > 1 ? bytes[1] : 0;
+    switch (encoding) {
+    case BuiltinEncoding::SHIFT_JIS:
+      if (lead >= 0xA1 && lead <= 0xDF) {
+        // Half-width katakana
+        appendCodePoint(result, 0xFF61 + lead - 0xA1);
+        return 1;
+      }
+      if (((lead >= 0x81 && lead <= 0x9F) || (lead >= 0xE0 && lead <= 0xFC)) &&
+          trail >= 0x40 && trail <= 0xFC && trail != 0x7F) {
+        // Each lead byte covers two rows of JIS X 0208
+        int row = (lead - (lead <= 0x9F ? 0x81 : 0xC1)) * 2;
+        int cell;
+        if (trail >= 0x9F) {
+          row++;
+          cell = trail - 0x9F;
+        } else {
+          cell = trail - (trail < 0x7F ? 0x40 : 0x41);
+        }
+        appendCodePoint(result, lookupDoubleByte(JIS_X_0208, 94, row, cell));
+        return 2;
+      }
+      break;
+    case BuiltinEncoding::EUC_JP:
+      if (lead == 0x8E && trail >= 0xA1 && trail <= 0xDF) {
+        appendCodePoint(result, 0xFF61 + trail - 0xA1);
+        return 2;
+      }
+      if (lead == 0x8F && length > 2 && trail >= 0xA1 && trail <= 0xFE && bytes[2] >= 0xA1 && bytes[2] <= 0xFE) {
+        // JIS X 0212 is not among the tables
+        appendCodePoint(result, REPLACEMENT_CHARACTER);
+        return 3;
+      }
+      if (lead >= 0xA1 && lead <= 0xFE && trail >= 0xA1 && trail <= 0xFE) {
+        appendCodePoint(result, lookupDoubleByte(JIS_X_0208, 94, lead - 0xA1, trail - 0xA1));
+        return 2;
+      }
+      break;
+    case BuiltinEncoding::GB2312:
+      if (lead >= 0x81 && lead <= 0xFE) {
+        if (trail >= 0x30 && trail <= 0x39) {
+          // GB18030 four byte sequence
+          if (length > 3 && bytes[2] >= 0x81 && bytes[2] <= 0xFE && bytes[3] >= 0x30 && bytes[3] <= 0x39) {
+            appendCodePoint(result, REPLACEMENT_CHARACTER);
+            return 4;
+          }
+        } else if (trail >= 0x40 && trail <= 0xFE && trail != 0x7F) {
+          // GBK pairs outside GB 2312 fall outside the table
+          appendCodePoint(result, lookupDoubleByte(GB_2312, 87, lead - 0xA1, trail - 0xA1));
+          return 2;
+        }
+      }
+      break;
+    default:
+      break;
+    }
+    appendCodePoint(result, REPLACEMENT_CHARACTER);
+    return 1;
+  }
+#endif
+
+  Fallible<void> appendBuiltin(string& result, unsigned char const* bytes, size_t length, BuiltinEncoding encoding) {
+    if (encoding == BuiltinEncoding::UTF16BE) {
+      if ((length & 1) != 0) {
+        return failure<ReaderException>("Odd number of bytes in UTF-16 text");
+      }
+      for (size_t i = 0; i < length; i += 2) {
+        unsigned int unit = ((unsigned int)bytes[i] << 8) | bytes[i + 1];
+        if (unit >= 0xD800 && unit <= 0xDBFF && i + 3 < length) {
+          unsigned int low = ((unsigned int)bytes[i + 2] << 8) | bytes[i + 3];
+          if (low >= 0xDC00 && low <= 0xDFFF) {
+            appendCodePoint(result, 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00));
+            i += 2;
+            continue;
+          }
+        }
+        if (unit >= 0xD800 && unit <= 0xDFFF) {
+          return failure<ReaderException>("Unpaired surrogate in UTF-16 text");
+        }
+        appendCodePoint(result, unit);
+      }
+      return success();
+    }
+
+    size_t i = 0;
+    while (i < length) {
+      // Copy runs of ASCII, which all of the other encodings share, as they are
+      size_t ascii = StringUtils::countAsciiPrefix(bytes + i, length - i);
+      result.append((char const*)bytes + i, ascii);
+      i += ascii;
+      if (i == length) {
+        break;
+      }
+
+      unsigned char value = bytes[i];
+      switch (encoding) {
+      case BuiltinEncoding::UTF8: {
+        size_t sequenceLength = utf8SequenceLength(bytes + i, length - i);
+        if (sequenceLength == 0) {
+          return failure<ReaderException>("Malformed UTF-8 text");
+        }
+        result.append((char const*)bytes + i, sequenceLength);
+        i += sequenceLength;
+        continue;
+      }
+      case BuiltinEncoding::ISO885915:
+        switch (value) {
+        case 0xA4: appendCodePoint(result, 0x20AC); break;
+        case 0xA6: appendCodePoint(result, 0x0160); break;
+        case 0xA8: appendCodePoint(result, 0x0161); break;
+        case 0xB4: appendCodePoint(result, 0x017D); break;
+        case 0xB8: appendCodePoint(result, 0x017E); break;
+        case 0xBC: appendCodePoint(result, 0x0152); break;
+        case 0xBD: appendCodePoint(result, 0x0153); break;
+        case 0xBE: appendCodePoint(result, 0x0178); break;
+        default: appendCodePoint(result, value); break;
+        }
+        break;
+      case BuiltinEncoding::CP1252:
+        if (value < 0xA0) {
+          if (CP1252_HIGH[value - 0x80] == 0) {
+            return failure<ReaderException>("Byte undefined in windows-1252");
+          }
+          appendCodePoint(result, CP1252_HIGH[value - 0x80]);
+        } else {
+          appendCodePoint(result, value);
+        }
+        break;
+      case BuiltinEncoding::ISO88591:
+        appendCodePoint(result, value);
+        break;
+#ifdef NO_ICONV
+      case BuiltinEncoding::SHIFT_JIS:
+      case BuiltinEncoding::EUC_JP:
+      case BuiltinEncoding::GB2312:
+        i += appendDoubleByte(result, bytes + i, length - i, encoding);
+        continue;
+      case BuiltinEncoding::UNSUPPORTED:
+        appendCodePoint(result, REPLACEMENT_CHARACTER);
+        break;
+#endif
+      default:
+        return failure<ReaderException>("Byte is not ASCII");
+      }
+      i++;
+    }
+    return success();
+  }
+
+#ifndef NO_ICONV
+  /** iconv descriptors to UTF-8, opened on first use and closed with the thread. */
+  class IconvCache {
+  private:
+    std::map<std::string, iconv_t> descriptors_;
+
+  public:
+    ~IconvCache() {
+      for (auto const & descriptor : descriptors_) {
+        if (descriptor.second != (iconv_t)-1) {
+          iconv_close(descriptor.second);
+        }
+      }
+    }
+
+    /** Descriptor in its initial shift state, or (iconv_t)-1 if the encoding is not supported. */
+    iconv_t get(char const* encoding) {
+      auto found(descriptors_.find(encoding));
+      if (found == descriptors_.end()) {
+        found = descriptors_.insert(std::make_pair(std::string(encoding), iconv_open(StringUtils::UTF8, encoding))).first;
+      } else if (found->second != (iconv_t)-1) {
+        iconv(found->second, (ICONV_CONST char **)NULL, NULL, NULL, NULL);
+      }
+      return found->second;
+    }
+  };
+
+  iconv_t getIconvDescriptor(char const* encoding) {
+    // A descriptor keeps conversion state, so threads cannot share one
+    static thread_local IconvCache cache;
+    return cache.get(encoding);
+  }
+#endif
+}
+
 string
 StringUtils::guessEncoding(unsigned char* bytes, int length,
                            Hashtable const& hints) {
@@ -44,6 +374,10 @@ StringUtils::guessEncoding(unsigned char* bytes, int length,
   if (iter != hints.end()) {
     return iter->second;
   }
+  // Plain ASCII is what all of the checks below would settle on last
+  if (countAsciiPrefix(bytes, (size_t)length) == (size_t)length) {
+    return ISO88591;
+  }
   typedef bool boolean;
   // For now, merely tries to distinguish ISO-8859-1, UTF-8 and Shift_JIS,
   // which should be by far the most common encodings.
@@ -199,3 +533,53 @@ StringUtils::guessEncoding(unsigned char* bytes, int length,
   // Otherwise, we take a wild guess with platform encoding
   return PLATFORM_DEFAULT_ENCODING;
 }
+
+size_t StringUtils::countAsciiPrefix(unsigned char const* bytes, size_t length) noexcept {
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes + i, sizeof(word));
+    if ((word & 0x8080808080808080ULL) != 0) {
+      break;
+    }
+  }
+  while (i < length && bytes[i] < 0x80) {
+    i++;
+  }
+  return i;
+}
+
+Fallible<void> StringUtils::appendAsUtf8(string& result, unsigned char const* bytes, size_t length,
+                                         char const* encoding) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  if (length == 0) {
+    return success();
+  }
+
+  BuiltinEncoding builtin = findBuiltinEncoding(encoding);
+  if (builtin != BuiltinEncoding::NONE) {
+    return appendBuiltin(result, bytes, length, builtin);
+  }
+
+#ifndef NO_ICONV
+  iconv_t cd = getIconvDescriptor(encoding);
+  if (cd == (iconv_t)-1) {
+    result.append((const char *)bytes, length);
+    return success();
+  }
+
+  size_t const maxOut = 4 * length + 1;
+  std::string converted(maxOut, '\0');
+  ICONV_CONST char *fromPtr = (ICONV_CONST char *)bytes;
+  size_t nFrom = length;
+  char *toPtr = &converted[0];
+  size_t nTo = maxOut;
+  if (iconv(cd, &fromPtr, &nFrom, &toPtr, &nTo) == (size_t)(-1)) {
+    return failure<ReaderException>("Error converting characters");
+  }
+  result.append(converted, 0, maxOut - nTo);
+  return success();
+#else
+  // No way to convert; keep the ASCII and replace everything else
+  return appendBuiltin(result, bytes, length, BuiltinEncoding::UNSUPPORTED);
+#endif
+}
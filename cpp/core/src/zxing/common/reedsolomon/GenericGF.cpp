@@ -54,7 +54,7 @@ pping::FallibleRef<GenericGF> GenericGF::createGenericGF(int primitive, int size
     auto genericGF(Ref<GenericGF>(new GenericGF(primitive, size, b)));
 
     if (size <= INITIALIZATION_THRESHOLD) {
-        auto const init(genericGF->initialize());
+        auto const init(genericGF->checkInit());
         if(!init)
             return init.error();
     }
@@ -100,11 +100,21 @@ pping::Fallible<void> GenericGF::initialize() MB_NOEXCEPT_EXCEPT_BADALLOC {
 }
   
 pping::Fallible<void> GenericGF::checkInit() MB_NOEXCEPT_EXCEPT_BADALLOC {
+#ifndef NO_THREADS
+  std::call_once(initOnce_, [this]() {
+    auto const init(initialize());
+    if(!init)
+        initFailure_ = init.error();
+  });
+  if (!initialized_)
+      return initFailure_;
+#else
   if (!initialized_) {
     auto const init(initialize());
     if(!init)
         return init.error();
   }
+#endif
   return success();
 }
   
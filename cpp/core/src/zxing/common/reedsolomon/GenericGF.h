@@ -23,6 +23,9 @@
 
 #include <zxing/common/Counted.h>                    // for Ref, Counted
 #include <vector>                                    // for vector
+#ifndef NO_THREADS
+#include <mutex>                                     // for once_flag
+#endif
 
 #include "zxing/common/reedsolomon/GenericGFPoly.h"  // for GenericGFPoly
 #include "zxing/common/Error.hpp"
@@ -40,6 +43,11 @@ namespace pping {
     int primitive_;
     int generatorBase_;
     bool initialized_;
+#ifndef NO_THREADS
+    // The shared fields above are used by readers on several threads at once
+    std::once_flag initOnce_;
+    Failure initFailure_;
+#endif
     
     Fallible<void> initialize() MB_NOEXCEPT_EXCEPT_BADALLOC;
     Fallible<void> checkInit() MB_NOEXCEPT_EXCEPT_BADALLOC;
@@ -68,9 +76,17 @@ namespace pping {
     Fallible<int> log(int a) MB_NOEXCEPT_EXCEPT_BADALLOC;
     Fallible<int> inverse(int a) MB_NOEXCEPT_EXCEPT_BADALLOC;
     Fallible<int> multiply(int a, int b) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+    /**
+     * Raw tables behind exp and log, for inner loops that cannot afford a
+     * Fallible per multiplication. Only filled once one of the Fallible
+     * accessors above has succeeded.
+     */
+    std::vector<int> const& getExpTable() const noexcept { return expTable_; }
+    std::vector<int> const& getLogTable() const noexcept { return logTable_; }
       
-    bool operator==(GenericGF other) {
-      return (other.getSize() == this->size_ &&
+    bool operator==(GenericGF const& other) const {
+      return (other.size_ == this->size_ &&
               other.primitive_ == this->primitive_);
     }
     
@@ -21,11 +21,13 @@
 #include "zxing/common/reedsolomon/ReedSolomonDecoder.h"
 #include "zxing/common/Array.h"                             // for ArrayRef, Array
 #include "zxing/common/Counted.h"                           // for Ref
-#include "zxing/common/reedsolomon/GenericGF.h"             // for GenericGF, GenericGF::DATA_MATRIX_FIELD_256
+#include "zxing/common/reedsolomon/GenericGF.h"             // for GenericGF
 #include "zxing/common/reedsolomon/GenericGFPoly.h"         // for GenericGFPoly
 #include "zxing/common/reedsolomon/ReedSolomonException.h"  // for ReedSolomonException
+#include "zxing/common/Span.h"                              // for Span
 
 #include <Log.h>                                            // for LOGV
+#include <algorithm>                                        // for max
 #include <Utils/Macros.h>
 
 using pping::Ref;
@@ -46,32 +48,48 @@ ReedSolomonDecoder::~ReedSolomonDecoder() {
 }
 
 Fallible<void> ReedSolomonDecoder::decode(ArrayRef<int> received, int twoS) MB_NOEXCEPT_EXCEPT_BADALLOC {
-  if(twoS < 0) return failure<ReedSolomonException>("twoS should be >= 0");
+  return decode(received, twoS, std::vector<int>());
+}
 
-  auto const tryCreatePoly(GenericGFPoly::createGenericGFPoly(*field, received));
-  if(!tryCreatePoly)
-      return tryCreatePoly.error();
+Fallible<void> ReedSolomonDecoder::decode(ArrayRef<int> received, int twoS, std::vector<int> const& erasures) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  return decode(Span<int>(received), twoS, erasures);
+}
 
-  Ref<GenericGFPoly> poly(*tryCreatePoly);
+Fallible<void> ReedSolomonDecoder::decode(Span<int> received, int twoS, std::vector<int> const& erasures) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  if(twoS < 0) return failure<ReedSolomonException>("twoS should be >= 0");
+  if((int)erasures.size() > twoS) return failure<ReedSolomonException>("Too many erasures");
+  if(received.empty()) return failure<ReedSolomonException>("No codewords");
+
+  // Makes sure the field tables are built
+  auto const tryInit(field->exp(0));
+  if(!tryInit)
+      return tryInit.error();
+
+  std::vector<int> const& expTable = field->getExpTable();
+  std::vector<int> const& logTable = field->getLogTable();
+  int order = field->getSize() - 1;
+  int syndromeBase = getSyndromeBase();
+  if (twoS + syndromeBase > order)
+      return failure<ReedSolomonException>("Bad number of check codewords");
+
+  // Horner's scheme as in findCorruptBlocks: S_i = S_i * alpha^(i + base) + c
   ArrayRef<int> syndromeCoefficients(new Array<int> (twoS));
+  std::vector<int>& syndromes = syndromeCoefficients->values();
+  for (size_t k = 0; k < received.size(); k++) {
+    int codeword = received[k];
+    for (int i = 0; i < twoS; i++) {
+      int s = syndromes[twoS - 1 - i];
+      syndromes[twoS - 1 - i] = (s == 0 ? 0 : expTable[(logTable[s] + i + syndromeBase) % order]) ^ codeword;
+    }
+  }
 
   LOGV("syndromeCoefficients array = %p", syndromeCoefficients.array_);
 
-  bool dataMatrix = (field.object_ == GenericGF::DATA_MATRIX_FIELD_256.object_);
   bool noError = true;
   for (int i = 0; i < twoS; i++) {
-    auto const tryGetExp(field->exp(dataMatrix ? i + 1 : i));
-    if(!tryGetExp)
-        return tryGetExp.error();
-
-    auto const tryEval(poly->evaluateAt(*tryGetExp));
-    if(!tryEval)
-        return tryEval.error();
-
-    int eval = *tryEval;
-    syndromeCoefficients[syndromeCoefficients->size() - 1 - i] = eval;
-    if (eval != 0) {
+    if (syndromes[i] != 0) {
       noError = false;
+      break;
     }
   }
   if (noError) {
@@ -83,11 +101,37 @@ Fallible<void> ReedSolomonDecoder::decode(ArrayRef<int> received, int twoS) MB_N
 
   Ref<GenericGFPoly> syndrome(*tryCreatePolySyndrome);
 
+  // With erasures, solve the key equation for the modified syndrome
+  // S(x) * Gamma(x) mod x^twoS, where Gamma is the erasure locator
+  Ref<GenericGFPoly> erasureLocator;
+  if (!erasures.empty()) {
+    auto const tryLocator(buildErasureLocator((int)received.size(), erasures));
+    if(!tryLocator)
+        return tryLocator.error();
+
+    erasureLocator = *tryLocator;
+
+    auto const tryModify(syndrome->multiply(erasureLocator));
+    if(!tryModify)
+        return tryModify.error();
+
+    Ref<GenericGFPoly> product(*tryModify);
+    ArrayRef<int> modifiedCoefficients(new Array<int>(twoS));
+    for (int i = 0; i < twoS && i <= product->getDegree(); i++) {
+      modifiedCoefficients[twoS - 1 - i] = product->getCoefficient(i);
+    }
+    auto const tryCreateModified(GenericGFPoly::createGenericGFPoly(*field, modifiedCoefficients));
+    if(!tryCreateModified)
+        return tryCreateModified.error();
+
+    syndrome = *tryCreateModified;
+  }
+
   auto const tryBuildMonomial(field->buildMonomial(twoS, 1));
   if(!tryBuildMonomial)
       return tryBuildMonomial.error();
 
-  auto const getSigmaOmega(runEuclideanAlgorithm((*tryBuildMonomial), syndrome, twoS));
+  auto const getSigmaOmega(runEuclideanAlgorithm((*tryBuildMonomial), syndrome, twoS + (int)erasures.size()));
   if(!getSigmaOmega)
       return getSigmaOmega.error();
 
@@ -95,6 +139,15 @@ Fallible<void> ReedSolomonDecoder::decode(ArrayRef<int> received, int twoS) MB_N
   Ref<GenericGFPoly> sigma = sigmaOmega[0];
   Ref<GenericGFPoly> omega = sigmaOmega[1];
 
+  if (erasureLocator) {
+    // Locate errors and erasures together
+    auto const tryMultLocator(sigma->multiply(erasureLocator));
+    if(!tryMultLocator)
+        return tryMultLocator.error();
+
+    sigma = *tryMultLocator;
+  }
+
   auto const errorLocations(findErrorLocations(sigma));
   if(!errorLocations)
       return errorLocations.error();
@@ -110,7 +163,7 @@ Fallible<void> ReedSolomonDecoder::decode(ArrayRef<int> received, int twoS) MB_N
     if(!getLog)
         return getLog.error();
 
-    int position = (int)received->size() - 1 - (*getLog);
+    int position = (int)received.size() - 1 - (*getLog);
 
     if(position < 0)
         return failure<ReedSolomonException>("Bad error location");
@@ -120,6 +173,98 @@ Fallible<void> ReedSolomonDecoder::decode(ArrayRef<int> received, int twoS) MB_N
   return success();
 }
 
+Fallible<std::vector<bool>> ReedSolomonDecoder::findCorruptBlocks(std::vector<Span<unsigned char const> > const& blocks,
+                                                                   std::vector<int> const& twoS) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  if (blocks.size() != twoS.size())
+      return failure<ReedSolomonException>("Every block needs its number of check codewords");
+
+  // Makes sure the field tables are built
+  auto const tryInit(field->exp(0));
+  if(!tryInit)
+      return tryInit.error();
+
+  std::vector<int> const& expTable = field->getExpTable();
+  std::vector<int> const& logTable = field->getLogTable();
+  int order = field->getSize() - 1;
+  int syndromeBase = getSyndromeBase();
+
+  // The syndromes of all blocks, one block after another
+  size_t numBlocks = blocks.size();
+  std::vector<size_t> offsets(numBlocks + 1, 0);
+  size_t longest = 0;
+  for (size_t b = 0; b < numBlocks; b++) {
+    if (twoS[b] < 0 || twoS[b] + syndromeBase > order)
+        return failure<ReedSolomonException>("Bad number of check codewords");
+    offsets[b + 1] = offsets[b] + (size_t)twoS[b];
+    longest = std::max(longest, blocks[b].size());
+  }
+  std::vector<int> syndromes(offsets[numBlocks], 0);
+
+  // Horner's scheme on every block at once: S_j = S_j * alpha^(j + base) + c
+  for (size_t i = 0; i < longest; i++) {
+    for (size_t b = 0; b < numBlocks; b++) {
+      if (i >= blocks[b].size()) {
+        continue;
+      }
+      int codeword = blocks[b][i];
+      int* syndrome = &syndromes[offsets[b]];
+      for (int j = 0; j < twoS[b]; j++) {
+        int s = syndrome[j];
+        syndrome[j] = (s == 0 ? 0 : expTable[(logTable[s] + j + syndromeBase) % order]) ^ codeword;
+      }
+    }
+  }
+
+  std::vector<bool> corrupt(numBlocks, false);
+  for (size_t b = 0; b < numBlocks; b++) {
+    for (size_t k = offsets[b]; k < offsets[b + 1]; k++) {
+      if (syndromes[k] != 0) {
+        corrupt[b] = true;
+        break;
+      }
+    }
+  }
+  return corrupt;
+}
+
+int ReedSolomonDecoder::getSyndromeBase() const noexcept {
+  // The generator polynomial's roots start at alpha^base: alpha^0 for QR
+  // codes, alpha^1 for Data Matrix and Aztec codes
+  return field->getGeneratorBase();
+}
+
+FallibleRef<GenericGFPoly> ReedSolomonDecoder::buildErasureLocator(int numCodewords, std::vector<int> const& erasures) {
+  auto const tryGetOne(field->getOne());
+  if(!tryGetOne)
+      return tryGetOne.error();
+
+  Ref<GenericGFPoly> locator(*tryGetOne);
+  for (size_t i = 0; i < erasures.size(); i++) {
+    int position = erasures[i];
+    if (position < 0 || position >= numCodewords)
+        return failure<ReedSolomonException>("Bad erasure location");
+
+    auto const tryGetExp(field->exp(numCodewords - 1 - position));
+    if(!tryGetExp)
+        return tryGetExp.error();
+
+    // Multiply by (1 + X * x), X being the locator of the erased codeword
+    ArrayRef<int> factorCoefficients(new Array<int>(2));
+    factorCoefficients[0] = *tryGetExp;
+    factorCoefficients[1] = 1;
+    auto const tryCreateFactor(GenericGFPoly::createGenericGFPoly(*field, factorCoefficients));
+    if(!tryCreateFactor)
+        return tryCreateFactor.error();
+
+    auto const tryMult(locator->multiply(*tryCreateFactor));
+    if(!tryMult)
+        return tryMult.error();
+
+    locator = *tryMult;
+  }
+  return locator;
+}
+
 Fallible<std::vector<Ref<GenericGFPoly>>> ReedSolomonDecoder::runEuclideanAlgorithm(Ref<GenericGFPoly> a,
                                                                       Ref<GenericGFPoly> b,
                                                                       int R) {
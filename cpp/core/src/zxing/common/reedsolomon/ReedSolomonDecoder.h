@@ -22,6 +22,7 @@
 #include "zxing/common/Array.h"    // for ArrayRef
 #include "zxing/common/Counted.h"  // for Ref
 #include "zxing/common/Error.hpp"  // for Fallible
+#include "zxing/common/Span.h"     // for Span
 
 #include <vector>                  // for vector
 
@@ -36,9 +37,32 @@ public:
   ReedSolomonDecoder(Ref<GenericGF> fld);
   ~ReedSolomonDecoder();
   Fallible<void> decode(ArrayRef<int> received, int twoS) MB_NOEXCEPT_EXCEPT_BADALLOC;
+  /**
+   * Corrects received, treating the codewords at the given positions as
+   * erasures. Each erasure costs one check codeword instead of the two an
+   * error at an unknown position costs, so up to twoS erasures can be
+   * corrected when nothing else is wrong.
+   */
+  Fallible<void> decode(ArrayRef<int> received, int twoS, std::vector<int> const& erasures) MB_NOEXCEPT_EXCEPT_BADALLOC;
+  /**
+   * Corrects received in place. The syndromes are read straight off the
+   * codewords, so a block that turns out intact allocates nothing.
+   */
+  Fallible<void> decode(Span<int> received, int twoS, std::vector<int> const& erasures) MB_NOEXCEPT_EXCEPT_BADALLOC;
+  /**
+   * Tells which of the codeword blocks of one symbol need correcting, block
+   * i having twoS[i] check codewords. The syndromes of all blocks are
+   * accumulated together in a single pass over the codeword positions,
+   * straight from the field tables, so blocks that arrived intact never
+   * reach decode().
+   */
+  Fallible<std::vector<bool>> findCorruptBlocks(std::vector<Span<unsigned char const> > const& blocks,
+                                                std::vector<int> const& twoS) MB_NOEXCEPT_EXCEPT_BADALLOC;
   Fallible<std::vector<Ref<GenericGFPoly>>> runEuclideanAlgorithm(Ref<GenericGFPoly> a, Ref<GenericGFPoly> b, int R);
 
 private:
+  int getSyndromeBase() const noexcept;
+  FallibleRef<GenericGFPoly> buildErasureLocator(int numCodewords, std::vector<int> const& erasures);
   Fallible<ArrayRef<int>> findErrorLocations(Ref<GenericGFPoly> errorLocator);
   Fallible<ArrayRef<int>> findErrorMagnitudes(Ref<GenericGFPoly> errorEvaluator, ArrayRef<int> errorLocations);
 };
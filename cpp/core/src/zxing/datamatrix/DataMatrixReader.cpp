@@ -20,21 +20,25 @@
  */
 
 #include <zxing/datamatrix/DataMatrixReader.h>
-#include <zxing/datamatrix/detector/ZXingDataMatrixDetector.h>  // for Detector
-#include <vector>                                               // for allocator, vector
-
-#include "Log.h"                                                // for LOGV
-#include "zxing/BarcodeFormat.h"                                // for BarcodeFormat::DATA_MATRIX
-#include "zxing/BinaryBitmap.h"                                 // for BinaryBitmap
-#include "zxing/DecodeHints.h"                                  // for DecodeHints
-#include "zxing/Result.h"                                       // for Result
-#include "zxing/ResultPoint.h"                                  // for ResultPoint
-#include "zxing/ResultPointCallback.h"                          // for ResultPointCallback
-#include "zxing/common/BitMatrix.h"                             // for BitMatrix
-#include "zxing/common/DecoderResult.h"                         // for DecoderResult
-#include "zxing/common/DetectorResult.h"                        // for DetectorResult
-#include "zxing/common/Str.h"                                   // for String
-#include "zxing/datamatrix/decoder/ZXingDataMatrixDecoder.h"    // for Decoder
+#include <zxing/datamatrix/detector/ZXingDataMatrixDetector.h>      // for Detector
+#include <zxing/datamatrix/detector/ZXingDataMatrixLShapeFinder.h>  // for LShapeFinder
+#include <vector>                                                   // for allocator, vector
+
+#include "Log.h"                                                    // for LOGV
+#include "zxing/BarcodeFormat.h"                                    // for BarcodeFormat::DATA_MATRIX
+#include "zxing/BinaryBitmap.h"                                     // for BinaryBitmap
+#include "zxing/DecodeContext.h"                                    // for DecodeContext
+#include "zxing/DecodeHints.h"                                      // for DecodeHints
+#include "zxing/LuminanceSource.h"                                  // for LuminanceSource
+#include "zxing/Result.h"                                           // for Result
+#include "zxing/ResultPoint.h"                                      // for ResultPoint
+#include "zxing/ResultPointCallback.h"                              // for ResultPointCallback
+#include "zxing/TimeoutException.h"                                 // for TimeoutException
+#include "zxing/common/BitMatrix.h"                                 // for BitMatrix
+#include "zxing/common/DecoderResult.h"                             // for DecoderResult
+#include "zxing/common/DetectorResult.h"                            // for DetectorResult
+#include "zxing/common/Str.h"                                       // for String
+#include "zxing/datamatrix/decoder/ZXingDataMatrixDecoder.h"        // for Decoder
 
 #ifdef DEBUG
 #include "Utils/stringstreamlite.hpp"
@@ -45,28 +49,60 @@ namespace datamatrix {
 
 using namespace std;
 
+namespace {
+  // Most symbols found by LShapeFinder that are tried before the centre one
+  const int MAX_CANDIDATES = 4;
+}
+
 DataMatrixReader::DataMatrixReader() noexcept :
     decoder_() {
 }
 
 FallibleRef<Result> DataMatrixReader::decode(Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
-  (void)hints;
-  LOGV("decoding image %p", image.object_);
+  return decode(Ref<DecodeContext>(new DecodeContext(image)), hints);
+}
+
+FallibleRef<Result> DataMatrixReader::decode(Ref<DecodeContext> context, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  LOGV("decoding image %p", context->getImage().object_);
 
-  auto const blackMatrix(image->getBlackMatrix());
+  auto const blackMatrix(context->getBlackMatrix());
   if (!blackMatrix)
       return blackMatrix.error();
-  Detector detector(*blackMatrix);
+  // With greyscale sampling, keep the luminance of each module for the
+  // decoder to fall back on
+  Detector detector(*blackMatrix, hints.getGreyscaleSampling() ? context->getImage()->getLuminanceSource()
+                                                               : Ref<LuminanceSource>());
 
   LOGV("(1) created detector %p", &detector);
 
+  // Symbols anywhere in the image first, then the one WhiteRectangleDetector
+  // finds around the centre
+  LShapeFinder finder(*blackMatrix);
+  std::vector<std::vector<Ref<ResultPoint> > > candidates(finder.find(MAX_CANDIDATES));
+  for (size_t i = 0; i < candidates.size(); i++) {
+    if (hints.isCancelled())
+      return failure<TimeoutException>("Decoding timed out");
+    auto const detectorResult(detector.detect(candidates[i]));
+    if (!detectorResult)
+      continue;
+    auto const result(decode(*detectorResult, hints));
+    if (result)
+      return result;
+  }
+
+  if (hints.isCancelled())
+    return failure<TimeoutException>("Decoding timed out");
   auto const detectorResult(detector.detect());
   if(!detectorResult)
       return detectorResult.error();
 
+  return decode(*detectorResult, hints);
+}
+
+FallibleRef<Result> DataMatrixReader::decode(Ref<DetectorResult> detectorResult, DecodeHints const& hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
   LOGV("(2) detected, have detectorResult %p", detectorResult.object_);
 
-  std::vector<Ref<ResultPoint> > points((*detectorResult)->getPoints());
+  std::vector<Ref<ResultPoint> > points(detectorResult->getPoints());
 
     for (const auto& point : points) {
         hints.getResultPointCallback()->foundPossibleResultPoint(*point.object_);
@@ -82,11 +118,11 @@ FallibleRef<Result> DataMatrixReader::decode(Ref<BinaryBitmap> image, DecodeHint
     LOGV("   %f, %f", points[i]->getX(), points[i]->getY());
   }
   mb::stringstreamlite ss;
-  ss << *((*detectorResult)->getBits());
+  ss << *(detectorResult->getBits());
   LOGV("bits:%s", ss.str().c_str());
 #endif
 
-  auto const decoderResult(decoder_.decode((*detectorResult)->getBits()));
+  auto const decoderResult(decoder_.decode(detectorResult->getBits(), detectorResult->getModuleSamples()));
   if(!decoderResult)
       return decoderResult.error();
 
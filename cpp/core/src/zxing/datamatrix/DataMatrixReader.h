@@ -29,6 +29,8 @@
 
 namespace pping {
 class BinaryBitmap;
+class DecodeContext;
+class DetectorResult;
 class Result;
 }  // namespace pping
 
@@ -41,7 +43,10 @@ private:
 
 public:
   DataMatrixReader() noexcept;
+  /** Decodes a symbol the detector already located, see MultiFormatMultipleBarcodeReader. */
+  FallibleRef<Result> decode(Ref<DetectorResult> detectorResult, DecodeHints const& hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
   virtual FallibleRef<Result> decode(Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC override;
+  virtual FallibleRef<Result> decode(Ref<DecodeContext> context, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC override;
   virtual ~DataMatrixReader();
 
 };
@@ -28,6 +28,161 @@ namespace pping {
 namespace datamatrix {
 using namespace std;
 
+namespace {
+/**
+ * The ECC200 placement of ISO 16022:2006 Annex F, walked over the mapping
+ * matrix, which is the symbol without its finder and alignment patterns. The
+ * module of each codeword bit is recorded by its offset in the whole symbol.
+ */
+class Placement {
+private:
+  int numRows_;
+  int numColumns_;
+  int regionRows_;
+  int regionColumns_;
+  int symbolColumns_;
+  vector<bool> placed_;
+  vector<unsigned short>& modules_;
+
+public:
+  Placement(int numRows, int numColumns, int regionRows, int regionColumns, int symbolColumns,
+            vector<unsigned short>& modules) :
+      numRows_(numRows), numColumns_(numColumns), regionRows_(regionRows), regionColumns_(regionColumns),
+      symbolColumns_(symbolColumns), placed_(numRows * numColumns), modules_(modules) {
+  }
+
+  void place() {
+    int row = 4;
+    int column = 0;
+
+    bool corner1Read = false;
+    bool corner2Read = false;
+    bool corner3Read = false;
+    bool corner4Read = false;
+
+    do {
+      // Check the four corner cases
+      if ((row == numRows_) && (column == 0) && !corner1Read) {
+        corner1();
+        row -= 2;
+        column += 2;
+        corner1Read = true;
+      } else if ((row == numRows_ - 2) && (column == 0) && ((numColumns_ & 0x03) != 0) && !corner2Read) {
+        corner2();
+        row -= 2;
+        column += 2;
+        corner2Read = true;
+      } else if ((row == numRows_ + 4) && (column == 2) && ((numColumns_ & 0x07) == 0) && !corner3Read) {
+        corner3();
+        row -= 2;
+        column += 2;
+        corner3Read = true;
+      } else if ((row == numRows_ - 2) && (column == 0) && ((numColumns_ & 0x07) == 4) && !corner4Read) {
+        corner4();
+        row -= 2;
+        column += 2;
+        corner4Read = true;
+      } else {
+        // Sweep upward diagonally to the right
+        do {
+          if ((row < numRows_) && (column >= 0) && !placed_[row * numColumns_ + column]) {
+            utah(row, column);
+          }
+          row -= 2;
+          column += 2;
+        } while ((row >= 0) && (column < numColumns_));
+        row += 1;
+        column += 3;
+
+        // Sweep downward diagonally to the left
+        do {
+          if ((row >= 0) && (column < numColumns_) && !placed_[row * numColumns_ + column]) {
+            utah(row, column);
+          }
+          row += 2;
+          column -= 2;
+        } while ((row < numRows_) && (column >= 0));
+        row += 3;
+        column += 1;
+      }
+    } while ((row < numRows_) || (column < numColumns_));
+  }
+
+private:
+  void module(int row, int column) {
+    // Adjust the row and column indices based on boundary wrapping
+    if (row < 0) {
+      row += numRows_;
+      column += 4 - ((numRows_ + 4) & 0x07);
+    }
+    if (column < 0) {
+      column += numColumns_;
+      row += 4 - ((numColumns_ + 4) & 0x07);
+    }
+    placed_[row * numColumns_ + column] = true;
+    // Each data region is surrounded by its own finder and alignment patterns
+    int symbolRow = row / regionRows_ * (regionRows_ + 2) + 1 + row % regionRows_;
+    int symbolColumn = column / regionColumns_ * (regionColumns_ + 2) + 1 + column % regionColumns_;
+    modules_.push_back((unsigned short)(symbolRow * symbolColumns_ + symbolColumn));
+  }
+
+  void utah(int row, int column) {
+    module(row - 2, column - 2);
+    module(row - 2, column - 1);
+    module(row - 1, column - 2);
+    module(row - 1, column - 1);
+    module(row - 1, column);
+    module(row, column - 2);
+    module(row, column - 1);
+    module(row, column);
+  }
+
+  void corner1() {
+    module(numRows_ - 1, 0);
+    module(numRows_ - 1, 1);
+    module(numRows_ - 1, 2);
+    module(0, numColumns_ - 2);
+    module(0, numColumns_ - 1);
+    module(1, numColumns_ - 1);
+    module(2, numColumns_ - 1);
+    module(3, numColumns_ - 1);
+  }
+
+  void corner2() {
+    module(numRows_ - 3, 0);
+    module(numRows_ - 2, 0);
+    module(numRows_ - 1, 0);
+    module(0, numColumns_ - 4);
+    module(0, numColumns_ - 3);
+    module(0, numColumns_ - 2);
+    module(0, numColumns_ - 1);
+    module(1, numColumns_ - 1);
+  }
+
+  void corner3() {
+    module(numRows_ - 1, 0);
+    module(numRows_ - 1, numColumns_ - 1);
+    module(0, numColumns_ - 3);
+    module(0, numColumns_ - 2);
+    module(0, numColumns_ - 1);
+    module(1, numColumns_ - 3);
+    module(1, numColumns_ - 2);
+    module(1, numColumns_ - 1);
+  }
+
+  void corner4() {
+    module(numRows_ - 3, 0);
+    module(numRows_ - 2, 0);
+    module(numRows_ - 1, 0);
+    module(0, numColumns_ - 2);
+    module(0, numColumns_ - 1);
+    module(1, numColumns_ - 1);
+    module(2, numColumns_ - 1);
+    module(3, numColumns_ - 1);
+  }
+};
+}
+
 ECB::ECB(int count, int dataCodewords) :
     count_(count), dataCodewords_(dataCodewords) {
 }
@@ -113,6 +268,25 @@ int Version::getTotalCodewords() {
 ECBlocks* Version::getECBlocks() {
   return ecBlocks_;
 }
+
+std::vector<unsigned short> const& Version::getCodewordModules() {
+#ifndef NO_THREADS
+  std::call_once(codewordModulesBuilt_, &Version::buildCodewordModules, this);
+#else
+  if (codewordModules_.empty()) {
+    buildCodewordModules();
+  }
+#endif
+  return codewordModules_;
+}
+
+void Version::buildCodewordModules() {
+  int numRows = symbolSizeRows_ / (dataRegionSizeRows_ + 2) * dataRegionSizeRows_;
+  int numColumns = symbolSizeColumns_ / (dataRegionSizeColumns_ + 2) * dataRegionSizeColumns_;
+  codewordModules_.reserve(totalCodewords_ * 8);
+  Placement(numRows, numColumns, dataRegionSizeRows_, dataRegionSizeColumns_, symbolSizeColumns_,
+            codewordModules_).place();
+}
   
 FallibleRef<Version> Version::getVersionForDimensions(int numRows, int numColumns) MB_NOEXCEPT_EXCEPT_BADALLOC {
     if ((numRows & 0x01) != 0 || (numColumns & 0x01) != 0) {
@@ -24,6 +24,9 @@
 #include "zxing/common/Error.hpp"
 
 #include <vector>                  // for vector
+#ifndef NO_THREADS
+#include <mutex>                   // for once_flag
+#endif
 
 namespace pping {
 namespace datamatrix {
@@ -59,6 +62,10 @@ private:
   int dataRegionSizeColumns_;
   ECBlocks* ecBlocks_;
   int totalCodewords_;
+  std::vector<unsigned short> codewordModules_;
+#ifndef NO_THREADS
+  std::once_flag codewordModulesBuilt_;
+#endif
   Version(int versionNumber, int symbolSizeRows, int symbolSizeColumns, int dataRegionSizeRows,
           int dataRegionSizeColumns, ECBlocks *ecBlocks);
 
@@ -73,10 +80,19 @@ public:
   int getDataRegionSizeColumns();
   int getTotalCodewords();
   ECBlocks* getECBlocks();
+  /**
+   * Where the ECC200 placement puts each bit of each codeword, as offsets of
+   * modules in the whole symbol, alignment patterns included. Codewords are
+   * in reading order, eight bits each from the most significant. Built on
+   * first use and shared by all symbols of this version.
+   */
+  std::vector<unsigned short> const& getCodewordModules();
   static int  buildVersions();  
   static FallibleRef<Version> getVersionForDimensions(int numRows, int numColumns) MB_NOEXCEPT_EXCEPT_BADALLOC;
   
 private:
+  void buildCodewordModules();
+
   Version(const Version&);
   Version & operator=(const Version&);
 };
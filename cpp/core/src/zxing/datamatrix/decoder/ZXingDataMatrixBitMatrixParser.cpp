@@ -20,14 +20,17 @@
 
 #include <zxing/common/IllegalArgumentException.h>    // for IllegalArgumentException
 #include <zxing/datamatrix/decoder/ZXingDataMatrixBitMatrixParser.h>
+#include <algorithm>                                  // for min
+#include <limits>                                     // for numeric_limits
+#include <vector>                                     // for vector
 
 #include "zxing/ReaderException.h"                    // for ReaderException
 #include "zxing/common/Array.h"                       // for ArrayRef
 #include "zxing/common/BitMatrix.h"                   // for BitMatrix
+#include "zxing/common/ByteMatrix.h"                  // for ByteMatrix
 #include "zxing/common/Counted.h"                     // for Ref
 #include "zxing/datamatrix/ZXingDataMatrixVersion.h"  // for Version
 
-
 namespace pping {
 namespace datamatrix {
 
@@ -53,20 +56,15 @@ FallibleRef<BitMatrixParser> BitMatrixParser::createBitMatrixParser(Ref<BitMatri
     if(!parsedVersion)
         return parsedVersion.error();
 
-    auto const extractData = extractDataRegion(bitMatrix, *parsedVersion);
-    if(!extractData)
-        return extractData.error();
-
-    auto const bm = *extractData;
-
-    auto const readBitMatrix = Ref<BitMatrix>(new BitMatrix(bm->getWidth(), bm->getHeight()));
+    if ((int)bitMatrix->getHeight() != (*parsedVersion)->getSymbolSizeRows()) {
+      return failure<IllegalArgumentException>("Dimension of bitMatrix must match the version size");
+    }
 
-    return new BitMatrixParser(bm, *parsedVersion, readBitMatrix);
+    return new BitMatrixParser(bitMatrix, *parsedVersion);
 }
 
-BitMatrixParser::BitMatrixParser(Ref<BitMatrix> bitMatrix, Ref<Version> parsedVersion, Ref<BitMatrix> readBitMatrix) : bitMatrix_(bitMatrix),
-                                                             parsedVersion_(parsedVersion),
-                                                             readBitMatrix_(readBitMatrix) {}
+BitMatrixParser::BitMatrixParser(Ref<BitMatrix> bitMatrix, Ref<Version> parsedVersion) : bitMatrix_(bitMatrix),
+                                                             parsedVersion_(parsedVersion) {}
 
 FallibleRef<Version> BitMatrixParser::readVersion(Ref<BitMatrix> bitMatrix) MB_NOEXCEPT_EXCEPT_BADALLOC {
   if (parsedVersion_ != 0) {
@@ -77,303 +75,49 @@ FallibleRef<Version> BitMatrixParser::readVersion(Ref<BitMatrix> bitMatrix) MB_N
 }
 
 Fallible<ArrayRef<unsigned char>> BitMatrixParser::readCodewords() MB_NOEXCEPT_EXCEPT_BADALLOC {
-    ArrayRef<unsigned char> result(parsedVersion_->getTotalCodewords());
-    int resultOffset = 0;
-    int row = 4;
-    int column = 0;
-
-    int numRows = (int)bitMatrix_->getHeight();
-    int numColumns = (int)bitMatrix_->getWidth();
-
-    bool corner1Read = false;
-    bool corner2Read = false;
-    bool corner3Read = false;
-    bool corner4Read = false;
-
-    // Read all of the codewords
-    do {
-      // Check the four corner cases
-      if ((row == numRows) && (column == 0) && !corner1Read) {
-        result[resultOffset++] = (unsigned char) readCorner1(numRows, numColumns);
-        row -= 2;
-        column +=2;
-        corner1Read = true;
-      } else if ((row == numRows-2) && (column == 0) && ((numColumns & 0x03) != 0) && !corner2Read) {
-        result[resultOffset++] = (unsigned char) readCorner2(numRows, numColumns);
-        row -= 2;
-        column +=2;
-        corner2Read = true;
-      } else if ((row == numRows+4) && (column == 2) && ((numColumns & 0x07) == 0) && !corner3Read) {
-        result[resultOffset++] = (unsigned char) readCorner3(numRows, numColumns);
-        row -= 2;
-        column +=2;
-        corner3Read = true;
-      } else if ((row == numRows-2) && (column == 0) && ((numColumns & 0x07) == 4) && !corner4Read) {
-        result[resultOffset++] = (unsigned char) readCorner4(numRows, numColumns);
-        row -= 2;
-        column +=2;
-        corner4Read = true;
-      } else {
-        // Sweep upward diagonally to the right
-        do {
-          if ((row < numRows) && (column >= 0) && !readBitMatrix_->get(column, row)) {
-            result[resultOffset++] = (unsigned char) readUtah(row, column, numRows, numColumns);
-          }
-          row -= 2;
-          column +=2;
-        } while ((row >= 0) && (column < numColumns));
-        row += 1;
-        column +=3;
+    const int bitsPerWord = std::numeric_limits<unsigned int>::digits;
+    int totalCodewords = parsedVersion_->getTotalCodewords();
+    std::vector<unsigned short> const& modules = parsedVersion_->getCodewordModules();
+    if ((int)modules.size() != totalCodewords * 8) {
+      return failure<ReaderException>("Did not read all codewords");
+    }
 
-        // Sweep downward diagonally to the left
-        do {
-          if ((row >= 0) && (column < numColumns) && !readBitMatrix_->get(column, row)) {
-             result[resultOffset++] = (unsigned char) readUtah(row, column, numRows, numColumns);
-          }
-          row += 2;
-          column -=2;
-        } while ((row < numRows) && (column >= 0));
-        row += 3;
-        column +=1;
+    // The placement is the same for every symbol of a version, so just
+    // gather the bits of each codeword from where it put them
+    ArrayRef<unsigned char> result(totalCodewords);
+    unsigned int const* bits = bitMatrix_->getBits();
+    unsigned short const* module = &modules[0];
+    for (int i = 0; i < totalCodewords; i++) {
+      int currentByte = 0;
+      for (int bit = 0; bit < 8; bit++, module++) {
+        currentByte = (currentByte << 1) | (int)((bits[*module / bitsPerWord] >> (*module % bitsPerWord)) & 1);
       }
-    } while ((row < numRows) || (column < numColumns));
-
-    if (resultOffset != parsedVersion_->getTotalCodewords()) {
-      return failure<ReaderException>("Did not read all codewords");
+      result[i] = (unsigned char)currentByte;
     }
     return result;
 }
 
-bool BitMatrixParser::readModule(int row, int column, int numRows, int numColumns) {
-    // Adjust the row and column indices based on boundary wrapping
-    if (row < 0) {
-      row += numRows;
-      column += 4 - ((numRows + 4) & 0x07);
-    }
-    if (column < 0) {
-      column += numColumns;
-      row += 4 - ((numColumns + 4) & 0x07);
-    }
-    readBitMatrix_->set(column, row);
-    return bitMatrix_->get(column, row);
-  }
-
-int BitMatrixParser::readUtah(int row, int column, int numRows, int numColumns) {
-    int currentByte = 0;
-    if (readModule(row - 2, column - 2, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(row - 2, column - 1, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(row - 1, column - 2, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(row - 1, column - 1, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(row - 1, column, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(row, column - 2, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(row, column - 1, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(row, column, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    return currentByte;
-  }
-
-int BitMatrixParser::readCorner1(int numRows, int numColumns) {
-    int currentByte = 0;
-    if (readModule(numRows - 1, 0, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(numRows - 1, 1, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(numRows - 1, 2, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(0, numColumns - 2, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(0, numColumns - 1, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(1, numColumns - 1, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(2, numColumns - 1, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(3, numColumns - 1, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    return currentByte;
-  }
-
-int BitMatrixParser::readCorner2(int numRows, int numColumns) {
-    int currentByte = 0;
-    if (readModule(numRows - 3, 0, numRows, numColumns)) {
-      currentByte |= 1;
+Fallible<ArrayRef<unsigned char>> BitMatrixParser::readCodewordConfidence(ByteMatrix const& moduleConfidence) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    size_t width = bitMatrix_->getWidth();
+    if (moduleConfidence.getWidth() != width || moduleConfidence.getHeight() != bitMatrix_->getHeight()) {
+      return failure<ReaderException>("Module confidence does not match the bit matrix");
     }
-    currentByte <<= 1;
-    if (readModule(numRows - 2, 0, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(numRows - 1, 0, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(0, numColumns - 4, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(0, numColumns - 3, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(0, numColumns - 2, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(0, numColumns - 1, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(1, numColumns - 1, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    return currentByte;
-  }
-
-int BitMatrixParser::readCorner3(int numRows, int numColumns) {
-    int currentByte = 0;
-    if (readModule(numRows - 1, 0, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(numRows - 1, numColumns - 1, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(0, numColumns - 3, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(0, numColumns - 2, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(0, numColumns - 1, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(1, numColumns - 3, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(1, numColumns - 2, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(1, numColumns - 1, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    return currentByte;
-  }
-
-int BitMatrixParser::readCorner4(int numRows, int numColumns) {
-    int currentByte = 0;
-    if (readModule(numRows - 3, 0, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(numRows - 2, 0, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(numRows - 1, 0, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(0, numColumns - 2, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(0, numColumns - 1, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(1, numColumns - 1, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(2, numColumns - 1, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    currentByte <<= 1;
-    if (readModule(3, numColumns - 1, numRows, numColumns)) {
-      currentByte |= 1;
-    }
-    return currentByte;
-  }
-
-FallibleRef<BitMatrix> BitMatrixParser::extractDataRegion(Ref<BitMatrix> bitMatrix, Ref<Version> parsedVersion) MB_NOEXCEPT_EXCEPT_BADALLOC {
-    int symbolSizeRows = parsedVersion->getSymbolSizeRows();
-    int symbolSizeColumns = parsedVersion->getSymbolSizeColumns();
-
-    if ((int)bitMatrix->getHeight() != symbolSizeRows) {
-      return failure<IllegalArgumentException>("Dimension of bitMatrix must match the version size");
+    int totalCodewords = parsedVersion_->getTotalCodewords();
+    std::vector<unsigned short> const& modules = parsedVersion_->getCodewordModules();
+    if ((int)modules.size() != totalCodewords * 8) {
+      return failure<ReaderException>("Did not read all codewords");
     }
 
-    int dataRegionSizeRows = parsedVersion->getDataRegionSizeRows();
-    int dataRegionSizeColumns = parsedVersion->getDataRegionSizeColumns();
-
-    int numDataRegionsRow = symbolSizeRows / dataRegionSizeRows;
-    int numDataRegionsColumn = symbolSizeColumns / dataRegionSizeColumns;
-
-    int sizeDataRegionRow = numDataRegionsRow * dataRegionSizeRows;
-    int sizeDataRegionColumn = numDataRegionsColumn * dataRegionSizeColumns;
-
-    Ref<BitMatrix> bitMatrixWithoutAlignment(new BitMatrix(sizeDataRegionColumn, sizeDataRegionRow));
-    for (int dataRegionRow = 0; dataRegionRow < numDataRegionsRow; ++dataRegionRow) {
-      int dataRegionRowOffset = dataRegionRow * dataRegionSizeRows;
-      for (int dataRegionColumn = 0; dataRegionColumn < numDataRegionsColumn; ++dataRegionColumn) {
-        int dataRegionColumnOffset = dataRegionColumn * dataRegionSizeColumns;
-        for (int i = 0; i < dataRegionSizeRows; ++i) {
-          int readRowOffset = dataRegionRow * (dataRegionSizeRows + 2) + 1 + i;
-          int writeRowOffset = dataRegionRowOffset + i;
-          for (int j = 0; j < dataRegionSizeColumns; ++j) {
-            int readColumnOffset = dataRegionColumn * (dataRegionSizeColumns + 2) + 1 + j;
-            if (bitMatrix->get(readColumnOffset, readRowOffset)) {
-              int writeColumnOffset = dataRegionColumnOffset + j;
-              bitMatrixWithoutAlignment->set(writeColumnOffset, writeRowOffset);
-            }
-          }
-        }
+    ArrayRef<unsigned char> result(totalCodewords);
+    unsigned short const* module = &modules[0];
+    for (int i = 0; i < totalCodewords; i++) {
+      unsigned char weakest = 0xff;
+      for (int bit = 0; bit < 8; bit++, module++) {
+        weakest = std::min(weakest, moduleConfidence.get(*module % width, *module / width));
       }
+      result[i] = weakest;
     }
-    return bitMatrixWithoutAlignment;
+    return result;
 }
 
 }
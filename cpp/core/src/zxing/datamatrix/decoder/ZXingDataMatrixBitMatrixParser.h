@@ -23,6 +23,7 @@
 #include <stddef.h>                                   // for size_t
 #include <zxing/common/Array.h>                       // for ArrayRef
 #include <zxing/common/BitMatrix.h>                   // for BitMatrix
+#include <zxing/common/ByteMatrix.h>                  // for ByteMatrix
 #include <zxing/common/Counted.h>                     // for Ref, Counted
 #include <zxing/datamatrix/ZXingDataMatrixVersion.h>  // for Version
 
@@ -33,7 +34,6 @@ class BitMatrixParser : public Counted {
 private:
   Ref<BitMatrix> bitMatrix_;
   Ref<Version> parsedVersion_;
-  Ref<BitMatrix> readBitMatrix_;
 
   int copyBit(size_t x, size_t y, int versionBits);
 
@@ -44,17 +44,14 @@ public:
 
   FallibleRef<Version> readVersion(Ref<BitMatrix> bitMatrix) MB_NOEXCEPT_EXCEPT_BADALLOC;
   Fallible<ArrayRef<unsigned char>> readCodewords() MB_NOEXCEPT_EXCEPT_BADALLOC;
-  bool readModule(int row, int column, int numRows, int numColumns);
+  /**
+   * For each codeword, in the order readCodewords returns them, the lowest
+   * confidence of the modules it was read from.
+   */
+  Fallible<ArrayRef<unsigned char>> readCodewordConfidence(ByteMatrix const& moduleConfidence) MB_NOEXCEPT_EXCEPT_BADALLOC;
 
 private:
-  BitMatrixParser(Ref<BitMatrix> bitMatrix, Ref<Version> parsedVersion, Ref<BitMatrix> readBitMatrix);
-
-  int readUtah(int row, int column, int numRows, int numColumns);
-  int readCorner1(int numRows, int numColumns);
-  int readCorner2(int numRows, int numColumns);
-  int readCorner3(int numRows, int numColumns);
-  int readCorner4(int numRows, int numColumns);
-  static FallibleRef<BitMatrix> extractDataRegion(Ref<BitMatrix> bitMatrix, Ref<Version> parsedVersion) MB_NOEXCEPT_EXCEPT_BADALLOC;
+  BitMatrixParser(Ref<BitMatrix> bitMatrix, Ref<Version> parsedVersion);
 };
 
 }
@@ -22,8 +22,7 @@
 #include <zxing/common/IllegalArgumentException.h>    // for IllegalArgumentException
 #include <zxing/datamatrix/decoder/ZXingDataMatrixDataBlock.h>
 
-#include "zxing/common/Array.h"                       // for ArrayRef
-#include "zxing/common/Counted.h"                     // for Ref
+#include "zxing/common/Span.h"                        // for Span
 #include "zxing/datamatrix/ZXingDataMatrixVersion.h"  // for ECB, ECBlocks, Version
 
 namespace pping {
@@ -31,19 +30,20 @@ namespace datamatrix {
 
 using namespace std;
 
-DataBlock::DataBlock(int numDataCodewords, ArrayRef<unsigned char> codewords) :
+DataBlock::DataBlock(int numDataCodewords, Span<unsigned char> codewords) noexcept :
     numDataCodewords_(numDataCodewords), codewords_(codewords) {
 }
 
-int DataBlock::getNumDataCodewords() {
+int DataBlock::getNumDataCodewords() const noexcept {
   return numDataCodewords_;
 }
 
-ArrayRef<unsigned char> DataBlock::getCodewords() {
+Span<unsigned char> DataBlock::getCodewords() const noexcept {
   return codewords_;
 }
 
-Fallible<std::vector<Ref<DataBlock>>> DataBlock::getDataBlocks(ArrayRef<unsigned char> rawCodewords, Version *version) MB_NOEXCEPT_EXCEPT_BADALLOC {
+Fallible<std::vector<DataBlock>> DataBlock::getDataBlocks(Span<unsigned char const> rawCodewords, Span<unsigned char> buffer,
+                                                         Version *version) MB_NOEXCEPT_EXCEPT_BADALLOC {
   // Figure out the number and size of data blocks used by this version and
   // error correction level
   ECBlocks* ecBlocks = version->getECBlocks();
@@ -55,26 +55,34 @@ Fallible<std::vector<Ref<DataBlock>>> DataBlock::getDataBlocks(ArrayRef<unsigned
     totalBlocks += ecBlockArray[i]->getCount();
   }
 
+  if (buffer.size() != rawCodewords.size()) {
+    return failure<IllegalArgumentException>("Buffer does not match the codewords");
+  }
+
   // Now establish DataBlocks of the appropriate size and number of data codewords
-  std::vector<Ref<DataBlock> > result(totalBlocks);
-  int numResultBlocks = 0;
+  std::vector<DataBlock> result;
+  result.reserve(totalBlocks);
+  size_t bufferOffset = 0;
   for (size_t j = 0; j < ecBlockArray.size(); j++) {
     ECB *ecBlock = ecBlockArray[j];
     for (int i = 0; i < ecBlock->getCount(); i++) {
       int numDataCodewords = ecBlock->getDataCodewords();
-      int numBlockCodewords = ecBlocks->getECCodewords() + numDataCodewords;
-      ArrayRef<unsigned char> buffer(numBlockCodewords);
-      Ref<DataBlock> blockRef(new DataBlock(numDataCodewords, buffer));
-      result[numResultBlocks++] = blockRef;
+      size_t numBlockCodewords = (size_t)(ecBlocks->getECCodewords() + numDataCodewords);
+      if (bufferOffset + numBlockCodewords > buffer.size()) {
+        return failure<IllegalArgumentException>("Too few codewords for the version");
+      }
+      result.push_back(DataBlock(numDataCodewords, buffer.subspan(bufferOffset, numBlockCodewords)));
+      bufferOffset += numBlockCodewords;
     }
   }
+  int numResultBlocks = (int)result.size();
 
   // All blocks have the same amount of data, except that the last n
   // (where n may be 0) have 1 more byte. Figure out where these start.
-  int shorterBlocksTotalCodewords = (int)result[0]->codewords_.size();
+  int shorterBlocksTotalCodewords = (int)result[0].codewords_.size();
   int longerBlocksStartAt = (int)result.size() - 1;
   while (longerBlocksStartAt >= 0) {
-    int numCodewords = (int)result[longerBlocksStartAt]->codewords_.size();
+    int numCodewords = (int)result[longerBlocksStartAt].codewords_.size();
     if (numCodewords == shorterBlocksTotalCodewords) {
       break;
     }
@@ -91,19 +99,19 @@ Fallible<std::vector<Ref<DataBlock>>> DataBlock::getDataBlocks(ArrayRef<unsigned
   int rawCodewordsOffset = 0;
   for (int i = 0; i < shorterBlocksNumDataCodewords; i++) {
     for (int j = 0; j < numResultBlocks; j++) {
-      result[j]->codewords_[i] = rawCodewords[rawCodewordsOffset++];
+      result[j].codewords_[i] = rawCodewords[rawCodewordsOffset++];
     }
   }
   // Fill out the last data block in the longer ones
   for (int j = longerBlocksStartAt; j < numResultBlocks; j++) {
-    result[j]->codewords_[shorterBlocksNumDataCodewords] = rawCodewords[rawCodewordsOffset++];
+    result[j].codewords_[shorterBlocksNumDataCodewords] = rawCodewords[rawCodewordsOffset++];
   }
   // Now add in error correction blocks
-  int max = (int)result[0]->codewords_.size();
+  int max = (int)result[0].codewords_.size();
   for (int i = shorterBlocksNumDataCodewords; i < max; i++) {
     for (int j = 0; j < numResultBlocks; j++) {
       int iOffset = j < longerBlocksStartAt ? i : i + 1;
-      result[j]->codewords_[iOffset] = rawCodewords[rawCodewordsOffset++];
+      result[j].codewords_[iOffset] = rawCodewords[rawCodewordsOffset++];
     }
   }
 
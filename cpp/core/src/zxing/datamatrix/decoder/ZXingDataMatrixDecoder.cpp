@@ -28,8 +28,10 @@
 
 #include "zxing/common/Array.h"                                              // for ArrayRef, Array
 #include "zxing/common/BitMatrix.h"                                          // for BitMatrix
+#include "zxing/common/ByteMatrix.h"                                         // for ByteMatrix
 #include "zxing/common/Counted.h"                                            // for Ref
 #include "zxing/common/DecoderResult.h"                                      // for DecoderResult
+#include "zxing/common/ModuleSamples.h"                                      // for ModuleSamples
 #include "zxing/common/reedsolomon/GenericGF.h"                              // for GenericGF, GenericGF::DATA_MATRIX_FIELD_256
 #include "zxing/common/reedsolomon/ReedSolomonDecoder.h"                     // for ReedSolomonDecoder
 
@@ -45,15 +47,14 @@ Decoder::Decoder() :
 }
 
 
-Fallible<void> Decoder::correctErrors(ArrayRef<unsigned char> codewordBytes, int numDataCodewords) {
-  int numCodewords = (int)codewordBytes->size();
-  ArrayRef<int> codewordInts(numCodewords);
-  for (int i = 0; i < numCodewords; i++) {
-    codewordInts[i] = codewordBytes[i] & 0xff;
-  }
+Fallible<void> Decoder::correctErrors(Span<unsigned char> codewordBytes, int numDataCodewords,
+                                      std::vector<int> const& erasures,
+                                      std::vector<int>& codewordInts) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  int numCodewords = (int)codewordBytes.size();
+  codewordInts.assign(codewordBytes.begin(), codewordBytes.end());
   int numECCodewords = numCodewords - numDataCodewords;
 
-  auto const decodingResult = rsDecoder_.decode(codewordInts, numECCodewords);
+  auto const decodingResult = rsDecoder_.decode(Span<int>(codewordInts), numECCodewords, erasures);
   if(!decodingResult)
       return decodingResult.error();
 
@@ -66,6 +67,31 @@ Fallible<void> Decoder::correctErrors(ArrayRef<unsigned char> codewordBytes, int
 }
 
 FallibleRef<DecoderResult> Decoder::decode(Ref<BitMatrix> bits) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  return decodeWithConfidence(bits, Ref<ByteMatrix>());
+}
+
+FallibleRef<DecoderResult> Decoder::decode(Ref<BitMatrix> bits, Ref<ModuleSamples> samples) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  auto const tryDecode(decode(bits));
+  if (tryDecode)
+      return *tryDecode;
+  if (samples.empty())
+      return tryDecode.error();
+
+  // Retry on the samples the bits came from
+  auto const tryDecodeErasures(decodeWithConfidence(samples->threshold(0), samples->getConfidence()));
+  if (tryDecodeErasures)
+      return *tryDecodeErasures;
+
+  for (int bias : { -ModuleSamples::RETHRESHOLD_BIAS, +ModuleSamples::RETHRESHOLD_BIAS }) {
+      auto const tryRethreshold(decode(samples->threshold(bias)));
+      if (tryRethreshold)
+          return *tryRethreshold;
+  }
+
+  return tryDecode.error();
+}
+
+FallibleRef<DecoderResult> Decoder::decodeWithConfidence(Ref<BitMatrix> bits, Ref<ByteMatrix> moduleConfidence) MB_NOEXCEPT_EXCEPT_BADALLOC {
   // Construct a parser and read version, error-correction level
   auto const createParser(BitMatrixParser::createBitMatrixParser(bits));
   if(!createParser)
@@ -86,31 +112,67 @@ FallibleRef<DecoderResult> Decoder::decode(Ref<BitMatrix> bits) MB_NOEXCEPT_EXCE
 
   ArrayRef<unsigned char> codewords(*tryReadCodewords);
 
-  // Separate into data blocks
-  auto const getDataBlocks(DataBlock::getDataBlocks(codewords, version));
+  // Separate into data blocks, all of them viewing one buffer
+  std::vector<unsigned char> blockBuffer(codewords.size());
+  auto const getDataBlocks(DataBlock::getDataBlocks(Span<unsigned char const>(codewords), Span<unsigned char>(blockBuffer),
+                                                    version));
   if(!getDataBlocks)
       return getDataBlocks.error();
 
-  std::vector<Ref<DataBlock> > dataBlocks = *getDataBlocks;
+  std::vector<DataBlock> const& dataBlocks = *getDataBlocks;
+
+  // Split the confidence of each codeword the same way
+  std::vector<unsigned char> confidenceBuffer;
+  std::vector<DataBlock> confidenceBlocks;
+  if (moduleConfidence) {
+    auto const codewordConfidence(parser->readCodewordConfidence(*moduleConfidence));
+    if (!codewordConfidence)
+        return codewordConfidence.error();
+
+    ArrayRef<unsigned char> rawConfidence(*codewordConfidence);
+    confidenceBuffer.resize(rawConfidence.size());
+    auto const tryGetConfidenceBlocks(DataBlock::getDataBlocks(Span<unsigned char const>(rawConfidence),
+                                                               Span<unsigned char>(confidenceBuffer), version));
+    if (!tryGetConfidenceBlocks)
+        return tryGetConfidenceBlocks.error();
+
+    confidenceBlocks = *tryGetConfidenceBlocks;
+  }
 
   int dataBlocksCount = (int)dataBlocks.size();
 
   // Count total number of data bytes
   int totalBytes = 0;
+  std::vector<Span<unsigned char const> > blockCodewords;
+  std::vector<int> blockECCodewords;
   for (int i = 0; i < dataBlocksCount; i++) {
-    totalBytes += dataBlocks[i]->getNumDataCodewords();
+    totalBytes += dataBlocks[i].getNumDataCodewords();
+    blockCodewords.push_back(dataBlocks[i].getCodewords());
+    blockECCodewords.push_back((int)blockCodewords.back().size() - dataBlocks[i].getNumDataCodewords());
   }
   ArrayRef<unsigned char> resultBytes(totalBytes);
 
+  // Check all blocks at once; most of them usually need no correcting
+  auto const corruptBlocks(rsDecoder_.findCorruptBlocks(blockCodewords, blockECCodewords));
+  if(!corruptBlocks)
+      return corruptBlocks.error();
+
   // Error-correct and copy data blocks together into a stream of bytes
+  std::vector<int> codewordInts;
   for (int j = 0; j < dataBlocksCount; j++) {
-    Ref<DataBlock> dataBlock(dataBlocks[j]);
-    ArrayRef<unsigned char> codewordBytes = dataBlock->getCodewords();
-    int numDataCodewords = dataBlock->getNumDataCodewords();
-
-    auto const errorCorrection = correctErrors(codewordBytes, numDataCodewords);
-    if(!errorCorrection)
-        return errorCorrection.error();
+    DataBlock const& dataBlock(dataBlocks[j]);
+    Span<unsigned char> codewordBytes = dataBlock.getCodewords();
+    int numDataCodewords = dataBlock.getNumDataCodewords();
+
+    if ((*corruptBlocks)[j]) {
+      std::vector<int> erasures;
+      if (!confidenceBlocks.empty()) {
+        erasures = ModuleSamples::selectErasures(confidenceBlocks[j].getCodewords(), blockECCodewords[j]);
+      }
+      auto const errorCorrection = correctErrors(codewordBytes, numDataCodewords, erasures, codewordInts);
+      if(!errorCorrection)
+          return errorCorrection.error();
+    }
 
     for (int i = 0; i < numDataCodewords; i++) {
       // De-interlace data blocks.
@@ -22,11 +22,16 @@
 
 #include <zxing/common/Array.h>                           // for ArrayRef
 #include <zxing/common/Counted.h>                         // for Ref
+#include <zxing/common/Span.h>                            // for Span
 #include <zxing/common/reedsolomon/ReedSolomonDecoder.h>  // for ReedSolomonDecoder
 
+#include <vector>                                         // for vector
+
 namespace pping {
 class BitMatrix;
+class ByteMatrix;
 class DecoderResult;
+class ModuleSamples;
 }  // namespace pping
 
 
@@ -37,12 +42,22 @@ class Decoder {
 private:
   ReedSolomonDecoder rsDecoder_;
 
-  Fallible<void> correctErrors(ArrayRef<unsigned char> bytes, int numDataCodewords);
+  /** codewordInts is scratch space, reused for every block of a symbol. */
+  Fallible<void> correctErrors(Span<unsigned char> bytes, int numDataCodewords, std::vector<int> const& erasures,
+                               std::vector<int>& codewordInts) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+  FallibleRef<DecoderResult> decodeWithConfidence(Ref<BitMatrix> bits, Ref<ByteMatrix> moduleConfidence) MB_NOEXCEPT_EXCEPT_BADALLOC;
 
 public:
   Decoder();
 
   FallibleRef<DecoderResult> decode(Ref<BitMatrix> bits) MB_NOEXCEPT_EXCEPT_BADALLOC;
+  /**
+   * Like decode(bits), but if error correction fails, retries on the
+   * greyscale samples bits were thresholded from: first with the codewords
+   * read from unreliable modules erased, then with shifted thresholds.
+   */
+  FallibleRef<DecoderResult> decode(Ref<BitMatrix> bits, Ref<ModuleSamples> samples) MB_NOEXCEPT_EXCEPT_BADALLOC;
 };
 
 }
@@ -24,12 +24,16 @@
 #include <zxing/common/GridSampler.h>                      // for GridSampler
 #include <zxing/common/detector/math_utils.h>              // for round, math_utils
 #include <zxing/datamatrix/detector/ZXingDataMatrixDetector.h>
-#include <algorithm>                                       // for max
+#include <algorithm>                                       // for max, stable_sort
 
+#include "zxing/ReaderException.h"                         // for ReaderException
 #include "zxing/common/BitMatrix.h"                        // for BitMatrix
+#include "zxing/common/ByteMatrix.h"                       // for ByteMatrix
 #include "zxing/common/Counted.h"                          // for Ref
 #include "zxing/common/DetectorResult.h"                   // for DetectorResult
+#include "zxing/common/ModuleSamples.h"                    // for ModuleSamples
 #include "zxing/common/PerspectiveTransform.h"             // for PerspectiveTransform
+#include "zxing/common/ThresholdPlane.h"                   // for ThresholdPlane
 #include "zxing/common/detector/WhiteRectangleDetector.h"  // for WhiteRectangleDetector
 
 namespace math_utils = pping::common::detector::math_utils;
@@ -39,11 +43,10 @@ namespace datamatrix {
 
 using namespace std;
 
-ResultPointsAndTransitions::ResultPointsAndTransitions() {
-  Ref<ResultPoint> ref(new ResultPoint(0, 0));
-  from_ = ref;
-  to_ = ref;
-  transitions_ = 0;
+namespace {
+  bool fewerTransitions(ResultPointsAndTransitions const& a, ResultPointsAndTransitions const& b) {
+    return a.getTransitions() < b.getTransitions();
+  }
 }
 
 ResultPointsAndTransitions::ResultPointsAndTransitions(Ref<ResultPoint> from, Ref<ResultPoint> to,
@@ -51,22 +54,14 @@ ResultPointsAndTransitions::ResultPointsAndTransitions(Ref<ResultPoint> from, Re
     : to_(to), from_(from), transitions_(transitions) {
 }
 
-Ref<ResultPoint> ResultPointsAndTransitions::getFrom() {
-  return from_;
-}
-
-Ref<ResultPoint> ResultPointsAndTransitions::getTo() {
-  return to_;
-}
-
-int ResultPointsAndTransitions::getTransitions() {
-  return transitions_;
-}
-
 Detector::Detector(Ref<BitMatrix> image) noexcept
     : image_(image) {
 }
 
+Detector::Detector(Ref<BitMatrix> image, Ref<LuminanceSource> source) noexcept
+    : image_(image), source_(source) {
+}
+
 Ref<BitMatrix> Detector::getImage() {
   return image_;
 }
@@ -82,56 +77,60 @@ FallibleRef<DetectorResult> Detector::detect() {
   if(!tryDetect)
       return tryDetect.error();
 
-  std::vector<Ref<ResultPoint> > ResultPoints = *tryDetect;
-  Ref<ResultPoint> pointA = ResultPoints[0];
-  Ref<ResultPoint> pointB = ResultPoints[1];
-  Ref<ResultPoint> pointC = ResultPoints[2];
-  Ref<ResultPoint> pointD = ResultPoints[3];
+  return detect(*tryDetect);
+}
+
+FallibleRef<DetectorResult> Detector::detect(std::vector<Ref<ResultPoint> > const& rectangle) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  Ref<ResultPoint> pointA = rectangle[0];
+  Ref<ResultPoint> pointB = rectangle[1];
+  Ref<ResultPoint> pointC = rectangle[2];
+  Ref<ResultPoint> pointD = rectangle[3];
 
   // Point A and D are across the diagonal from one another,
   // as are B and C. Figure out which are the solid black lines
   // by counting transitions
-  std::vector<Ref<ResultPointsAndTransitions> > transitions(4);
-  transitions[0].reset(transitionsBetween(pointA, pointB));
-  transitions[1].reset(transitionsBetween(pointA, pointC));
-  transitions[2].reset(transitionsBetween(pointB, pointD));
-  transitions[3].reset(transitionsBetween(pointC, pointD));
-  insertionSort(transitions);
+  ResultPointsAndTransitions transitions[] = {
+    transitionsBetween(pointA, pointB),
+    transitionsBetween(pointA, pointC),
+    transitionsBetween(pointB, pointD),
+    transitionsBetween(pointC, pointD)
+  };
+  stable_sort(transitions, transitions + 4, fewerTransitions);
 
   // Sort by number of transitions. First two will be the two solid sides; last two
   // will be the two alternating black/white sides
-  Ref<ResultPointsAndTransitions> lSideOne(transitions[0]);
-  Ref<ResultPointsAndTransitions> lSideTwo(transitions[1]);
+  ResultPointsAndTransitions const& lSideOne(transitions[0]);
+  ResultPointsAndTransitions const& lSideTwo(transitions[1]);
 
   // Figure out which point is their intersection by tallying up the number of times we see the
   // endpoints in the four endpoints. One will show up twice.
   Ref<ResultPoint> maybeTopLeft;
   Ref<ResultPoint> bottomLeft;
   Ref<ResultPoint> maybeBottomRight;
-  if (lSideOne->getFrom()->equals(lSideOne->getTo())) {
-    bottomLeft = lSideOne->getFrom();
-    maybeTopLeft = lSideTwo->getFrom();
-    maybeBottomRight = lSideTwo->getTo();
-  } else if (lSideOne->getFrom()->equals(lSideTwo->getFrom())) {
-    bottomLeft = lSideOne->getFrom();
-    maybeTopLeft = lSideOne->getTo();
-    maybeBottomRight = lSideTwo->getTo();
-  } else if (lSideOne->getFrom()->equals(lSideTwo->getTo())) {
-    bottomLeft = lSideOne->getFrom();
-    maybeTopLeft = lSideOne->getTo();
-    maybeBottomRight = lSideTwo->getFrom();
-  } else if (lSideOne->getTo()->equals(lSideTwo->getFrom())) {
-    bottomLeft = lSideOne->getTo();
-    maybeTopLeft = lSideOne->getFrom();
-    maybeBottomRight = lSideTwo->getTo();
-  } else if (lSideOne->getTo()->equals(lSideTwo->getTo())) {
-    bottomLeft = lSideOne->getTo();
-    maybeTopLeft = lSideOne->getFrom();
-    maybeBottomRight = lSideTwo->getFrom();
+  if (lSideOne.getFrom()->equals(lSideOne.getTo())) {
+    bottomLeft = lSideOne.getFrom();
+    maybeTopLeft = lSideTwo.getFrom();
+    maybeBottomRight = lSideTwo.getTo();
+  } else if (lSideOne.getFrom()->equals(lSideTwo.getFrom())) {
+    bottomLeft = lSideOne.getFrom();
+    maybeTopLeft = lSideOne.getTo();
+    maybeBottomRight = lSideTwo.getTo();
+  } else if (lSideOne.getFrom()->equals(lSideTwo.getTo())) {
+    bottomLeft = lSideOne.getFrom();
+    maybeTopLeft = lSideOne.getTo();
+    maybeBottomRight = lSideTwo.getFrom();
+  } else if (lSideOne.getTo()->equals(lSideTwo.getFrom())) {
+    bottomLeft = lSideOne.getTo();
+    maybeTopLeft = lSideOne.getFrom();
+    maybeBottomRight = lSideTwo.getTo();
+  } else if (lSideOne.getTo()->equals(lSideTwo.getTo())) {
+    bottomLeft = lSideOne.getTo();
+    maybeTopLeft = lSideOne.getFrom();
+    maybeBottomRight = lSideTwo.getFrom();
   } else {
-    bottomLeft = lSideTwo->getFrom();
-    maybeTopLeft = lSideOne->getTo();
-    maybeBottomRight = lSideOne->getFrom();
+    bottomLeft = lSideTwo.getFrom();
+    maybeTopLeft = lSideOne.getTo();
+    maybeBottomRight = lSideOne.getFrom();
   }
 
   // Bottom left is correct but top left and bottom right might be switched
@@ -171,8 +170,8 @@ FallibleRef<DetectorResult> Detector::detect() {
   // adjacent to the white module at the top right. Tracing to that corner from either the top left
   // or bottom right should work here.
 
-  int dimensionTop = transitionsBetween(topLeft, topRight)->getTransitions();
-  int dimensionRight = transitionsBetween(bottomRight, topRight)->getTransitions();
+  int dimensionTop = transitionsBetween(topLeft, topRight).getTransitions();
+  int dimensionRight = transitionsBetween(bottomRight, topRight).getTransitions();
 
   //dimensionTop++;
   if ((dimensionTop & 0x01) == 1) {
@@ -189,7 +188,7 @@ FallibleRef<DetectorResult> Detector::detect() {
   dimensionRight += 2;
 
   Ref<BitMatrix> bits;
-  Ref<PerspectiveTransform> transform;
+  PerspectiveTransform transform;
   Ref<ResultPoint> correctedTopRight;
 
 
@@ -204,8 +203,8 @@ FallibleRef<DetectorResult> Detector::detect() {
       correctedTopRight = topRight;
     }
 
-    dimensionTop = transitionsBetween(topLeft, correctedTopRight)->getTransitions();
-    dimensionRight = transitionsBetween(bottomRight, correctedTopRight)->getTransitions();
+    dimensionTop = transitionsBetween(topLeft, correctedTopRight).getTransitions();
+    dimensionRight = transitionsBetween(bottomRight, correctedTopRight).getTransitions();
 
     if ((dimensionTop & 0x01) == 1) {
       // it can't be odd, so, round... up?
@@ -237,8 +236,8 @@ FallibleRef<DetectorResult> Detector::detect() {
     }
 
     // Redetermine the dimension using the corrected top right point
-    int dimensionCorrected = max(transitionsBetween(topLeft, correctedTopRight)->getTransitions(),
-        transitionsBetween(bottomRight, correctedTopRight)->getTransitions());
+    int dimensionCorrected = max(transitionsBetween(topLeft, correctedTopRight).getTransitions(),
+        transitionsBetween(bottomRight, correctedTopRight).getTransitions());
     dimensionCorrected++;
     if ((dimensionCorrected & 0x01) == 1) {
       dimensionCorrected++;
@@ -260,6 +259,12 @@ FallibleRef<DetectorResult> Detector::detect() {
   points[2].reset(correctedTopRight);
   points[3].reset(bottomRight);
   Ref<DetectorResult> detectorResult(new DetectorResult(bits, points));
+  if (source_ != 0) {
+    // Without samples the decoder just cannot retry, so detection stands
+    auto const modules(sampleModules((int)bits->getWidth(), (int)bits->getHeight(), transform));
+    if (modules)
+      detectorResult->setModuleSamples(*modules);
+  }
   return detectorResult;
 }
 
@@ -297,10 +302,10 @@ Ref<ResultPoint> Detector::correctTopRightRectangular(Ref<ResultPoint> bottomLef
     return c1;
   }
 
-  int l1 = abs(dimensionTop - transitionsBetween(topLeft, c1)->getTransitions())
-      + abs(dimensionRight - transitionsBetween(bottomRight, c1)->getTransitions());
-  int l2 = abs(dimensionTop - transitionsBetween(topLeft, c2)->getTransitions())
-      + abs(dimensionRight - transitionsBetween(bottomRight, c2)->getTransitions());
+  int l1 = abs(dimensionTop - transitionsBetween(topLeft, c1).getTransitions())
+      + abs(dimensionRight - transitionsBetween(bottomRight, c1).getTransitions());
+  int l2 = abs(dimensionTop - transitionsBetween(topLeft, c2).getTransitions())
+      + abs(dimensionRight - transitionsBetween(bottomRight, c2).getTransitions());
 
   return l1 <= l2 ? c1 : c2;
 }
@@ -340,11 +345,11 @@ Ref<ResultPoint> Detector::correctTopRight(Ref<ResultPoint> bottomLeft,
   }
 
   int l1 = abs(
-      transitionsBetween(topLeft, c1)->getTransitions()
-          - transitionsBetween(bottomRight, c1)->getTransitions());
+      transitionsBetween(topLeft, c1).getTransitions()
+          - transitionsBetween(bottomRight, c1).getTransitions());
   int l2 = abs(
-      transitionsBetween(topLeft, c2)->getTransitions()
-          - transitionsBetween(bottomRight, c2)->getTransitions());
+      transitionsBetween(topLeft, c2).getTransitions()
+          - transitionsBetween(bottomRight, c2).getTransitions());
 
   return l1 <= l2 ? c1 : c2;
 }
@@ -358,7 +363,7 @@ int Detector::distance(Ref<ResultPoint> a, Ref<ResultPoint> b) {
   return math_utils::round(ResultPoint::distance(a, b));
 }
 
-Ref<ResultPointsAndTransitions> Detector::transitionsBetween(Ref<ResultPoint> from,
+ResultPointsAndTransitions Detector::transitionsBetween(Ref<ResultPoint> from,
     Ref<ResultPoint> to) {
   // See QR Code Detector, sizeOfBlackWhiteBlackRun()
   int fromX = (int) from->getX();
@@ -397,15 +402,14 @@ Ref<ResultPointsAndTransitions> Detector::transitionsBetween(Ref<ResultPoint> fr
       error -= dx;
     }
   }
-  Ref<ResultPointsAndTransitions> result(new ResultPointsAndTransitions(from, to, transitions));
-  return result;
+  return ResultPointsAndTransitions(from, to, transitions);
 }
 
-Ref<PerspectiveTransform> Detector::createTransform(Ref<ResultPoint> topLeft,
+PerspectiveTransform Detector::createTransform(Ref<ResultPoint> topLeft,
     Ref<ResultPoint> topRight, Ref<ResultPoint> bottomLeft, Ref<ResultPoint> bottomRight,
     int dimensionX, int dimensionY) {
 
-  Ref<PerspectiveTransform> transform(
+  PerspectiveTransform transform(
       PerspectiveTransform::quadrilateralToQuadrilateral(
           0.5f,
           0.5f,
@@ -427,31 +431,33 @@ Ref<PerspectiveTransform> Detector::createTransform(Ref<ResultPoint> topLeft,
 }
 
 FallibleRef<BitMatrix> Detector::sampleGrid(Ref<BitMatrix> image, int dimensionX, int dimensionY,
-    Ref<PerspectiveTransform> transform) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC {
   GridSampler &sampler = GridSampler::getInstance();
   return sampler.sampleGrid(image, dimensionX, dimensionY, transform);
 }
 
-void Detector::insertionSort(std::vector<Ref<ResultPointsAndTransitions> > &vector) {
-  int max = (int)vector.size();
-  bool swapped = true;
-  Ref<ResultPointsAndTransitions> value;
-  Ref<ResultPointsAndTransitions> valueB;
-  do {
-    swapped = false;
-    for (int i = 1; i < max; i++) {
-      value = vector[i - 1];
-      if (compare(value, (valueB = vector[i])) > 0){
-        swapped = true;
-        vector[i - 1].reset(valueB);
-        vector[i].reset(value);
-      }
-    }
-  } while (swapped);
-}
+FallibleRef<ModuleSamples> Detector::sampleModules(int dimensionX, int dimensionY,
+    PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  GridSampler &sampler = GridSampler::getInstance();
+  auto const trySampling(sampler.sampleGrid(source_, dimensionX, dimensionY, transform));
+  if (!trySampling)
+    return trySampling.error();
+  Ref<ByteMatrix> samples(*trySampling);
+
+  // The top row starts black at the left and the right column ends black at
+  // the bottom, alternating in between
+  ThresholdPlane plane;
+  for (int x = 0; x + 1 < dimensionX; x += 2) {
+    plane.addPair(x + 0.5, 0, samples->get(x, 0), samples->get(x + 1, 0), 2);
+  }
+  for (int y = dimensionY - 1; y > 0; y -= 2) {
+    plane.addPair(dimensionX - 1, y - 0.5, samples->get(dimensionX - 1, y), samples->get(dimensionX - 1, y - 1), 2);
+  }
+  if (!plane.solve())
+    return failure<ReaderException>("Timing patterns have too little contrast");
 
-int Detector::compare(Ref<ResultPointsAndTransitions> a, Ref<ResultPointsAndTransitions> b) {
-  return a->getTransitions() - b->getTransitions();
+  return new ModuleSamples(samples, plane.thresholds(dimensionX, dimensionY));
 }
+
 }
 }
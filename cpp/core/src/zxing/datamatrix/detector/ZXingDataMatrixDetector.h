@@ -26,39 +26,46 @@
 #include <vector>                    // for vector
 
 #include "zxing/common/Error.hpp"
+#include "zxing/LuminanceSource.h"   // for LuminanceSource
 #include "zxing/ResultPoint.h"       // for ResultPoint
 
 namespace pping {
 class DetectorResult;
+class ModuleSamples;
 class PerspectiveTransform;
 }  // namespace pping
 
 namespace pping {
 namespace datamatrix {
 
-class ResultPointsAndTransitions: public Counted {
+/** Two points and the colour transitions between them, held by value. */
+class ResultPointsAndTransitions {
   private:
     Ref<ResultPoint> to_;
     Ref<ResultPoint> from_;
     int transitions_;
 
   public:
-    ResultPointsAndTransitions();
     ResultPointsAndTransitions(Ref<ResultPoint> from, Ref<ResultPoint> to, int transitions);
-    Ref<ResultPoint> getFrom();
-    Ref<ResultPoint> getTo();
-    int getTransitions();
+    Ref<ResultPoint> const& getFrom() const { return from_; }
+    Ref<ResultPoint> const& getTo() const { return to_; }
+    int getTransitions() const { return transitions_; }
 };
 
 class Detector: public Counted {
   private:
     Ref<BitMatrix> image_;
+    Ref<LuminanceSource> source_;
 
   protected:
     FallibleRef<BitMatrix> sampleGrid(Ref<BitMatrix> image, int dimensionX, int dimensionY,
-        Ref<PerspectiveTransform> transform) MB_NOEXCEPT_EXCEPT_BADALLOC;
-
-    void insertionSort(std::vector<Ref<ResultPointsAndTransitions> >& vector);
+        PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC;
+    /**
+     * Samples the greyscale of every module from source_ and thresholds each
+     * against a plane fitted to the timing patterns on the top and right.
+     */
+    FallibleRef<ModuleSamples> sampleModules(int dimensionX, int dimensionY,
+        PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC;
 
     Ref<ResultPoint> correctTopRightRectangular(Ref<ResultPoint> bottomLeft,
         Ref<ResultPoint> bottomRight, Ref<ResultPoint> topLeft, Ref<ResultPoint> topRight,
@@ -67,7 +74,7 @@ class Detector: public Counted {
         Ref<ResultPoint> topLeft, Ref<ResultPoint> topRight, int dimension);
     bool isValid(Ref<ResultPoint> p);
     int distance(Ref<ResultPoint> a, Ref<ResultPoint> b);
-    Ref<ResultPointsAndTransitions> transitionsBetween(Ref<ResultPoint> from, Ref<ResultPoint> to);
+    ResultPointsAndTransitions transitionsBetween(Ref<ResultPoint> from, Ref<ResultPoint> to);
     int min(int a, int b) {
       return a > b ? b : a;
     }
@@ -82,15 +89,25 @@ class Detector: public Counted {
   public:
     Ref<BitMatrix> getImage();
     Detector(Ref<BitMatrix> image) noexcept;
+    /**
+     * Also keeps the greyscale samples of the modules of every symbol it
+     * detects in the DetectorResult, for Decoder to retry with. source is
+     * the luminance image was binarized from.
+     */
+    Detector(Ref<BitMatrix> image, Ref<LuminanceSource> source) noexcept;
 
-    virtual Ref<PerspectiveTransform> createTransform(Ref<ResultPoint> topLeft,
+    virtual PerspectiveTransform createTransform(Ref<ResultPoint> topLeft,
         Ref<ResultPoint> topRight, Ref<ResultPoint> bottomLeft, Ref<ResultPoint> bottomRight,
         int dimensionX, int dimensionY);
 
     FallibleRef<DetectorResult> detect();
 
-  private:
-    int compare(Ref<ResultPointsAndTransitions> a, Ref<ResultPointsAndTransitions> b);
+    /**
+     * Detects the symbol within the four corners, given in the order
+     * WhiteRectangleDetector returns them: the first and last are across the
+     * diagonal, as are the second and third.
+     */
+    FallibleRef<DetectorResult> detect(std::vector<Ref<ResultPoint> > const& rectangle) MB_NOEXCEPT_EXCEPT_BADALLOC;
 };
 
 }
@@ -0,0 +1,396 @@
+// -*- mode:c++; tab-width:2; indent-tabs-mode:nil; c-basic-offset:2 -*-
+/*
+ *  LShapeFinder.cpp
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/datamatrix/detector/ZXingDataMatrixLShapeFinder.h>
+
+#include <stdlib.h>                  // for abs
+#include <algorithm>                 // for min, max, sort
+
+#include "zxing/common/BitMatrix.h"  // for BitMatrix
+#include "zxing/common/Counted.h"    // for Ref
+
+namespace pping {
+namespace datamatrix {
+
+using namespace std;
+
+namespace {
+  // Shortest side, in pixels, of a shape taken for a symbol
+  const int MIN_SIDE = 12;
+  // Share of the corner quadrilateral a symbol covers with black modules, in percent
+  const int MIN_DENSITY = 20;
+  const int MAX_DENSITY = 90;
+  // Fewest transitions expected along a timing pattern side over the L sides
+  const int MIN_TIMING_TRANSITIONS = 4;
+  // Corners are moved this far inside the shape, as WhiteRectangleDetector does
+  const int CORR = 1;
+
+  struct Point {
+    int x;
+    int y;
+  };
+
+  /** A connected black shape with its pixel count and its extreme points in eight directions. */
+  struct Shape {
+    int pixels;
+    Point minX;
+    Point maxX;
+    Point minY;
+    Point maxY;
+    Point minSum;
+    Point maxSum;
+    Point minDiff;
+    Point maxDiff;
+
+    void add(int y, int start, int end) noexcept {
+      Point first = { start, y };
+      Point last = { end - 1, y };
+      if (pixels == 0) {
+        minX = minY = maxY = minSum = minDiff = first;
+        maxX = maxSum = maxDiff = last;
+      } else {
+        if (first.x < minX.x) {
+          minX = first;
+        }
+        if (last.x > maxX.x) {
+          maxX = last;
+        }
+        if (y < minY.y) {
+          minY = first;
+        }
+        if (y > maxY.y) {
+          maxY = first;
+        }
+        if (first.x + y < minSum.x + minSum.y) {
+          minSum = first;
+        }
+        if (last.x + y > maxSum.x + maxSum.y) {
+          maxSum = last;
+        }
+        if (first.x - y < minDiff.x - minDiff.y) {
+          minDiff = first;
+        }
+        if (last.x - y > maxDiff.x - maxDiff.y) {
+          maxDiff = last;
+        }
+      }
+      pixels += end - start;
+    }
+
+    void merge(Shape const& other) noexcept {
+      if (other.pixels == 0) {
+        return;
+      }
+      if (pixels == 0) {
+        *this = other;
+        return;
+      }
+      if (other.minX.x < minX.x) {
+        minX = other.minX;
+      }
+      if (other.maxX.x > maxX.x) {
+        maxX = other.maxX;
+      }
+      if (other.minY.y < minY.y) {
+        minY = other.minY;
+      }
+      if (other.maxY.y > maxY.y) {
+        maxY = other.maxY;
+      }
+      if (other.minSum.x + other.minSum.y < minSum.x + minSum.y) {
+        minSum = other.minSum;
+      }
+      if (other.maxSum.x + other.maxSum.y > maxSum.x + maxSum.y) {
+        maxSum = other.maxSum;
+      }
+      if (other.minDiff.x - other.minDiff.y < minDiff.x - minDiff.y) {
+        minDiff = other.minDiff;
+      }
+      if (other.maxDiff.x - other.maxDiff.y > maxDiff.x - maxDiff.y) {
+        maxDiff = other.maxDiff;
+      }
+      pixels += other.pixels;
+    }
+  };
+
+  /** A black run of a row and the shape it belongs to. */
+  struct Run {
+    int start;
+    int end;
+    int shape;
+  };
+
+  /** Four corners in order around a shape, with its score. */
+  struct Candidate {
+    Point corners[4];
+    int pixels;
+  };
+
+  int find(vector<int>& parents, int shape) noexcept {
+    while (parents[shape] != shape) {
+      parents[shape] = parents[parents[shape]];
+      shape = parents[shape];
+    }
+    return shape;
+  }
+
+  // Twice the area of the quadrilateral
+  int area(Point const (&corners)[4]) noexcept {
+    int sum = 0;
+    for (int i = 0; i < 4; i++) {
+      Point const& a = corners[i];
+      Point const& b = corners[(i + 1) % 4];
+      sum += a.x * b.y - b.x * a.y;
+    }
+    return abs(sum);
+  }
+
+  int distanceSquared(Point const& a, Point const& b) noexcept {
+    return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y);
+  }
+
+  // Same as Detector::transitionsBetween()
+  int transitionsBetween(BitMatrix const& image, Point const& from, Point const& to) noexcept {
+    int fromX = from.x;
+    int fromY = from.y;
+    int toX = to.x;
+    int toY = to.y;
+    bool steep = abs(toY - fromY) > abs(toX - fromX);
+    if (steep) {
+      swap(fromX, fromY);
+      swap(toX, toY);
+    }
+
+    int dx = abs(toX - fromX);
+    int dy = abs(toY - fromY);
+    int error = -dx >> 1;
+    int ystep = fromY < toY ? 1 : -1;
+    int xstep = fromX < toX ? 1 : -1;
+    int transitions = 0;
+    bool inBlack = image.get(steep ? fromY : fromX, steep ? fromX : fromY);
+    for (int x = fromX, y = fromY; x != toX; x += xstep) {
+      bool isBlack = image.get(steep ? y : x, steep ? x : y);
+      if (isBlack != inBlack) {
+        transitions++;
+        inBlack = isBlack;
+      }
+      error += dy;
+      if (error > 0) {
+        if (y == toY) {
+          break;
+        }
+        y += ystep;
+        error -= dx;
+      }
+    }
+    return transitions;
+  }
+
+  void clamp(BitMatrix const& image, Point& point) noexcept {
+    point.x = max(0, min((int)image.getWidth() - 1, point.x));
+    point.y = max(0, min((int)image.getHeight() - 1, point.y));
+  }
+
+  /**
+   * The black pixel on the edge of the symbol along the line from the given
+   * point towards the other: the last one going away from the other if the
+   * point is black, the first one going towards it within a quarter of the
+   * way otherwise, or the point itself. Both have to be in the image.
+   */
+  Point edgePoint(BitMatrix const& image, Point const& from, Point const& towards) noexcept {
+    int steps = max(abs(towards.x - from.x), abs(towards.y - from.y));
+    int width = (int)image.getWidth();
+    int height = (int)image.getHeight();
+    bool black = image.get(from.x, from.y);
+    int direction = black ? -1 : 1;
+    Point last = from;
+    for (int i = 1; i < steps / 4; i++) {
+      Point point = { from.x + direction * (towards.x - from.x) * i / steps,
+                      from.y + direction * (towards.y - from.y) * i / steps };
+      if (point.x < 0 || point.x >= width || point.y < 0 || point.y >= height) {
+        break;
+      }
+      if (image.get(point.x, point.y) != black) {
+        return black ? last : point;
+      }
+      last = point;
+    }
+    return black ? last : from;
+  }
+
+  /**
+   * Picks the corners of the shape and checks that it could be a symbol: big
+   * enough, neither solid nor hollow, with two adjacent sides solid and the
+   * other two alternating.
+   */
+  bool toCandidate(BitMatrix const& image, Shape const& shape, Candidate& candidate) noexcept {
+    // A square turned by any angle has one corner furthest in each of the four
+    // axis directions and in each of the four diagonal ones, but a corner on
+    // the ends of a side parallel to the direction is ambiguous, and the
+    // corners picked then lie along the side. The larger quadrilateral wins.
+    Point const axes[4] = { shape.minY, shape.maxX, shape.maxY, shape.minX };
+    Point const diagonals[4] = { shape.minSum, shape.maxDiff, shape.maxSum, shape.minDiff };
+    int axesArea = area(axes);
+    int diagonalsArea = area(diagonals);
+    Point const (&corners)[4] = axesArea >= diagonalsArea ? axes : diagonals;
+    int doubleArea = max(axesArea, diagonalsArea);
+
+    for (int i = 0; i < 4; i++) {
+      if (distanceSquared(corners[i], corners[(i + 1) % 4]) < MIN_SIDE * MIN_SIDE) {
+        return false;
+      }
+    }
+    // In 64 bits, as a shape covering most of a large dark frame overflows 200 * pixels
+    long long density = (long long)shape.pixels * 200 / max(1, doubleArea);
+    if (density < MIN_DENSITY || density > MAX_DENSITY) {
+      return false;
+    }
+
+    // Move the corners inside, so the sides run along the outer modules
+    int centerX = 0;
+    int centerY = 0;
+    for (int i = 0; i < 4; i++) {
+      centerX += corners[i].x;
+      centerY += corners[i].y;
+    }
+    for (int i = 0; i < 4; i++) {
+      Point& corner = candidate.corners[i];
+      corner = corners[i];
+      corner.x += 4 * corner.x < centerX ? CORR : -CORR;
+      corner.y += 4 * corner.y < centerY ? CORR : -CORR;
+      clamp(image, corner);
+    }
+
+    // Side i runs from corner i to corner i + 1
+    int transitions[4];
+    for (int i = 0; i < 4; i++) {
+      transitions[i] = transitionsBetween(image, candidate.corners[i], candidate.corners[(i + 1) % 4]);
+    }
+    // The L is the pair of adjacent sides with the fewest transitions, the
+    // timing pattern the two sides opposite them
+    int best = 0;
+    for (int i = 1; i < 4; i++) {
+      if (transitions[i] + transitions[(i + 1) % 4] < transitions[best] + transitions[(best + 1) % 4]) {
+        best = i;
+      }
+    }
+    int solid = max(transitions[best], transitions[(best + 1) % 4]);
+    int timing = min(transitions[(best + 2) % 4], transitions[(best + 3) % 4]);
+    if (timing < solid + MIN_TIMING_TRANSITIONS) {
+      return false;
+    }
+
+    // The timing pattern modules need not touch the rest of the symbol, so
+    // the corner opposite the L can be well inside it. Complete the
+    // parallelogram on the L instead, and move to the edge of the symbol
+    // along one timing pattern, as WhiteRectangleDetector finds the corner
+    Point const& end = candidate.corners[best];
+    Point const& vertex = candidate.corners[(best + 1) % 4];
+    Point const& otherEnd = candidate.corners[(best + 2) % 4];
+    Point& opposite = candidate.corners[(best + 3) % 4];
+    opposite.x = end.x + otherEnd.x - vertex.x;
+    opposite.y = end.y + otherEnd.y - vertex.y;
+    clamp(image, opposite);
+    opposite = edgePoint(image, opposite, otherEnd);
+    candidate.pixels = shape.pixels;
+    return true;
+  }
+}
+
+LShapeFinder::LShapeFinder(Ref<BitMatrix> image) noexcept : image_(image) {
+}
+
+vector<vector<Ref<ResultPoint> > > LShapeFinder::find(int maxCandidates) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  BitMatrix const& image = *image_;
+  int height = (int)image.getHeight();
+
+  vector<Shape> shapes;
+  vector<int> parents;
+  vector<Run> previous;
+  vector<Run> current;
+  vector<int> transitions;
+  for (int y = 0; y < height; y++) {
+    image.getRowTransitions(y, transitions);
+    current.clear();
+    for (size_t i = 0; i < transitions.size(); i += 2) {
+      Run run = { transitions[i], transitions[i + 1], -1 };
+      current.push_back(run);
+    }
+
+    // Join each run with the runs of the row above it touches, diagonally too
+    size_t above = 0;
+    for (size_t i = 0; i < current.size(); i++) {
+      Run& run = current[i];
+      while (above < previous.size() && previous[above].end < run.start) {
+        above++;
+      }
+      for (size_t j = above; j < previous.size() && previous[j].start <= run.end; j++) {
+        int other = ::pping::datamatrix::find(parents, previous[j].shape);
+        if (run.shape < 0) {
+          run.shape = other;
+        } else {
+          int root = ::pping::datamatrix::find(parents, run.shape);
+          if (root != other) {
+            parents[other] = root;
+            shapes[root].merge(shapes[other]);
+            shapes[other].pixels = 0;
+          }
+        }
+      }
+      if (run.shape < 0) {
+        run.shape = (int)shapes.size();
+        Shape shape = Shape();
+        shapes.push_back(shape);
+        parents.push_back(run.shape);
+      } else {
+        run.shape = ::pping::datamatrix::find(parents, run.shape);
+      }
+      shapes[run.shape].add(y, run.start, run.end);
+    }
+    previous.swap(current);
+  }
+
+  vector<Candidate> candidates;
+  for (size_t i = 0; i < shapes.size(); i++) {
+    Candidate candidate;
+    if (parents[i] == (int)i && shapes[i].pixels >= MIN_SIDE * 2 && toCandidate(image, shapes[i], candidate)) {
+      candidates.push_back(candidate);
+    }
+  }
+  sort(candidates.begin(), candidates.end(),
+       [](Candidate const& a, Candidate const& b) { return a.pixels > b.pixels; });
+
+  vector<vector<Ref<ResultPoint> > > result;
+  for (size_t i = 0; i < candidates.size() && (int)i < maxCandidates; i++) {
+    Point const (&corners)[4] = candidates[i].corners;
+    // Corners 0 and 2 are across the diagonal, so the order is 0, 1, 3, 2
+    vector<Ref<ResultPoint> > points(4);
+    int order[4] = { 0, 1, 3, 2 };
+    for (int j = 0; j < 4; j++) {
+      Point const& corner = corners[order[j]];
+      points[j].reset(new ResultPoint((float)corner.x, (float)corner.y));
+    }
+    result.push_back(points);
+  }
+  return result;
+}
+
+}
+}
@@ -0,0 +1,59 @@
+// -*- mode:c++; tab-width:2; indent-tabs-mode:nil; c-basic-offset:2 -*-
+#pragma once
+
+/*
+ *  LShapeFinder.h
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/common/BitMatrix.h>  // for BitMatrix
+#include <zxing/common/Counted.h>    // for Ref
+#include <vector>                    // for vector
+
+#include "zxing/ResultPoint.h"       // for ResultPoint
+
+namespace pping {
+namespace datamatrix {
+
+/**
+ * Finds Data Matrix symbols anywhere in the image in a single pass over its
+ * rows. The black runs of each row are joined with the touching runs of the
+ * row above into connected shapes, each keeping its pixel count and its
+ * extreme points. The solid L border connects a symbol's modules into one
+ * such shape, whose extreme points are the corners of the symbol.
+ *
+ * Shapes of a plausible size and density are kept if two adjacent sides of
+ * their corner quadrilateral are solid and the other two alternate, like the
+ * L border and the timing pattern, and are ranked largest first.
+ */
+class LShapeFinder {
+  private:
+    Ref<BitMatrix> image_;
+
+  public:
+    LShapeFinder(Ref<BitMatrix> image) noexcept;
+
+    /**
+     * Returns up to maxCandidates candidates, best first. Each is four corners
+     * in order around the symbol, the first two and the last two spanning one
+     * side each, as WhiteRectangleDetector returns them.
+     */
+    std::vector<std::vector<Ref<ResultPoint> > > find(int maxCandidates) MB_NOEXCEPT_EXCEPT_BADALLOC;
+};
+
+}
+}
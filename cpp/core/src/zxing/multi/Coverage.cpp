@@ -0,0 +1,95 @@
+/*
+ *  Copyright 2011 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/multi/Coverage.h>
+
+#include "zxing/BarcodeFormat.h"    // for BarcodeFormat
+#include "zxing/Result.h"           // for Result
+#include "zxing/ResultPoint.h"      // for ResultPoint
+#include "zxing/common/BitArray.h"  // for BitArray
+#include "zxing/common/Counted.h"   // for Ref
+
+#include <algorithm>                // for max, min
+
+namespace pping {
+namespace multi {
+
+const int Coverage::CELL_SIZE;
+
+Coverage::Coverage(int width, int height) :
+    width_(width), columns_((width + CELL_SIZE - 1) / CELL_SIZE), rows_((height + CELL_SIZE - 1) / CELL_SIZE),
+    cells_((size_t)(columns_ * rows_), false) {
+}
+
+bool Coverage::covers(float x, float y) const {
+  int column = (int)x / CELL_SIZE;
+  int row = (int)y / CELL_SIZE;
+  return x >= 0.0f && y >= 0.0f && column < columns_ && row < rows_ && cells_[(size_t)(row * columns_ + column)];
+}
+
+void Coverage::add(Result& result) {
+  std::vector<Ref<ResultPoint> > const& points(result.getResultPoints());
+  if (points.empty()) {
+    return;
+  }
+  float minX = points[0]->getX();
+  float maxX = minX;
+  float minY = points[0]->getY();
+  float maxY = minY;
+  for (size_t i = 1; i < points.size(); i++) {
+    minX = std::min(minX, points[i]->getX());
+    maxX = std::max(maxX, points[i]->getX());
+    minY = std::min(minY, points[i]->getY());
+    maxY = std::max(maxY, points[i]->getY());
+  }
+  if (result.getBarcodeFormat() == BarcodeFormat::QR_CODE && points.size() >= 3) {
+    // The bottom right corner completes bottom left, top left and top right
+    float x = points[0]->getX() - points[1]->getX() + points[2]->getX();
+    float y = points[0]->getY() - points[1]->getY() + points[2]->getY();
+    minX = std::min(minX, x);
+    maxX = std::max(maxX, x);
+    minY = std::min(minY, y);
+    maxY = std::max(maxY, y);
+  }
+  float margin = std::max(maxX - minX, maxY - minY) / 4.0f;
+  int left = std::max(0, (int)(minX - margin) / CELL_SIZE);
+  int right = std::min(columns_ - 1, (int)(maxX + margin) / CELL_SIZE);
+  int top = std::max(0, (int)(minY - margin) / CELL_SIZE);
+  int bottom = std::min(rows_ - 1, (int)(maxY + margin) / CELL_SIZE);
+  for (int row = top; row <= bottom; row++) {
+    for (int column = left; column <= right; column++) {
+      cells_[(size_t)(row * columns_ + column)] = true;
+    }
+  }
+}
+
+void Coverage::blacken(int y, BitArray& row) const {
+  size_t offset = (size_t)((y / CELL_SIZE) * columns_);
+  for (int column = 0; column < columns_; column++) {
+    if (!cells_[offset + (size_t)column]) {
+      continue;
+    }
+    int end = column;
+    while (end + 1 < columns_ && cells_[offset + (size_t)end + 1]) {
+      end++;
+    }
+    row.setRange(column * CELL_SIZE, std::min(width_, (end + 1) * CELL_SIZE));
+    column = end;
+  }
+}
+
+} // End zxing::multi namespace
+} // End zxing namespace
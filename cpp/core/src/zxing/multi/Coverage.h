@@ -0,0 +1,59 @@
+#pragma once
+
+/*
+ *  Copyright 2011 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>  // for vector
+
+namespace pping {
+class BitArray;
+class Result;
+}  // namespace pping
+
+namespace pping {
+namespace multi {
+/**
+ * The parts of the image covered by the symbols decoded so far, kept in
+ * cells of CELL_SIZE pixels. MultiFormatMultipleBarcodeReader does not
+ * decode candidates on them again, and the 1D readers do not see them.
+ */
+class Coverage {
+  private:
+    int width_;
+    int columns_;
+    int rows_;
+    std::vector<bool> cells_;
+
+  public:
+    // Pixels on a side of the cells
+    static const int CELL_SIZE = 8;
+
+    Coverage(int width, int height);
+
+    bool covers(float x, float y) const;
+
+    /**
+     * Covers the bounding box of the points of a decoded symbol, grown by a
+     * quarter of its size on each side: QR points are finder pattern centres
+     * inside the symbol, and the symbol's quiet zone goes with it.
+     */
+    void add(Result& result);
+
+    /** Blackens the covered pixels of row y, where no 1D reader finds a start pattern. */
+    void blacken(int y, BitArray& row) const;
+};
+} // End zxing::multi namespace
+} // End zxing namespace
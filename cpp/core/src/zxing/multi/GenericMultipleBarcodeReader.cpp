@@ -14,15 +14,17 @@
  * limitations under the License.
  */
 
-#include <zxing/ReaderException.h>  // for ReaderException
-#include <zxing/ResultPoint.h>      // for ResultPoint
+#include <zxing/ReaderException.h>   // for ReaderException
+#include <zxing/ResultPoint.h>       // for ResultPoint
 #include <zxing/multi/GenericMultipleBarcodeReader.h>
-#include <string>                   // for string
+#include <string>                    // for string
 
-#include "zxing/BinaryBitmap.h"     // for BinaryBitmap
-#include "zxing/Reader.h"           // for Reader
-#include "zxing/Result.h"           // for Result
-#include "zxing/common/Str.h"       // for String
+#include "zxing/BinaryBitmap.h"      // for BinaryBitmap
+#include "zxing/DecodeContext.h"     // for DecodeContext
+#include "zxing/Reader.h"            // for Reader
+#include "zxing/Result.h"            // for Result
+#include "zxing/TimeoutException.h"  // for TimeoutException
+#include "zxing/common/Str.h"        // for String
 
 namespace pping {
 namespace multi {
@@ -35,19 +37,31 @@ GenericMultipleBarcodeReader::~GenericMultipleBarcodeReader(){}
 
 Fallible<std::vector<Ref<Result>>> GenericMultipleBarcodeReader::decodeMultiple(
   Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC
+{
+  return decodeMultiple(Ref<DecodeContext>(new DecodeContext(image)), hints);
+}
+
+Fallible<std::vector<Ref<Result>>> GenericMultipleBarcodeReader::decodeMultiple(
+  Ref<DecodeContext> context, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC
 {
   std::vector<Ref<Result> > results;
-  doDecodeMultiple(image, hints, results, 0, 0);
+  doDecodeMultiple(context, hints, results, 0, 0);
+  if (results.empty() && hints.isCancelled()){
+    return failure<TimeoutException>("Decoding timed out");
+  }
   if (results.empty()){
     return failure<ReaderException>("No code detected");
   }
   return results;
 }
 
-void GenericMultipleBarcodeReader::doDecodeMultiple(Ref<BinaryBitmap> image,
+void GenericMultipleBarcodeReader::doDecodeMultiple(Ref<DecodeContext> context,
   DecodeHints hints, std::vector<Ref<Result> >& results, int xOffset, int yOffset)
 {
-  auto const result(delegate_.decode(image, hints));
+  // What was found so far is kept
+  if (hints.isCancelled())
+    return;
+  auto const result(delegate_.decode(context, hints));
   if (!result || (*result).empty())
     return;
 
@@ -69,6 +83,8 @@ void GenericMultipleBarcodeReader::doDecodeMultiple(Ref<BinaryBitmap> image,
     return;
   }
 
+  // Crops are images of their own, each decoded in a context of its own
+  Ref<BinaryBitmap> image(context->getImage());
   int width = image->getWidth();
   int height = image->getHeight();
   float minX = (float)width;
@@ -95,22 +111,22 @@ void GenericMultipleBarcodeReader::doDecodeMultiple(Ref<BinaryBitmap> image,
 
   // Decode left of barcode
   if (minX > MIN_DIMENSION_TO_RECUR) {
-    doDecodeMultiple(image->crop(0, 0, (int) minX, height),
+    doDecodeMultiple(Ref<DecodeContext>(new DecodeContext(image->crop(0, 0, (int) minX, height))),
                      hints, results, xOffset, yOffset);
   }
   // Decode above barcode
   if (minY > MIN_DIMENSION_TO_RECUR) {
-    doDecodeMultiple(image->crop(0, 0, width, (int) minY),
+    doDecodeMultiple(Ref<DecodeContext>(new DecodeContext(image->crop(0, 0, width, (int) minY))),
                      hints, results, xOffset, yOffset);
   }
   // Decode right of barcode
   if (maxX < static_cast<float>(width - MIN_DIMENSION_TO_RECUR)) {
-    doDecodeMultiple(image->crop((int) maxX, 0, width - (int) maxX, height),
+    doDecodeMultiple(Ref<DecodeContext>(new DecodeContext(image->crop((int) maxX, 0, width - (int) maxX, height))),
                      hints, results, xOffset + (int) maxX, yOffset);
   }
   // Decode below barcode
   if (maxY < static_cast<float>(height - MIN_DIMENSION_TO_RECUR)) {
-    doDecodeMultiple(image->crop(0, (int) maxY, width, height - (int) maxY),
+    doDecodeMultiple(Ref<DecodeContext>(new DecodeContext(image->crop(0, (int) maxY, width, height - (int) maxY))),
                      hints, results, xOffset, yOffset + (int) maxY);
   }
 }
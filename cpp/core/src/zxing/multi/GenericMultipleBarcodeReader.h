@@ -24,6 +24,7 @@
 
 namespace pping {
 class BinaryBitmap;
+class DecodeContext;
 class Reader;
 class Result;
 }  // namespace pping
@@ -35,7 +36,7 @@ class GenericMultipleBarcodeReader : public MultipleBarcodeReader {
     static Ref<Result> translateResultPoints(Ref<Result> result, 
                                              int xOffset, 
                                              int yOffset);
-    void doDecodeMultiple(Ref<BinaryBitmap> image, 
+    void doDecodeMultiple(Ref<DecodeContext> context, 
                           DecodeHints hints, 
                           std::vector<Ref<Result> >& results, 
                           int xOffset, 
@@ -48,6 +49,8 @@ class GenericMultipleBarcodeReader : public MultipleBarcodeReader {
     virtual ~GenericMultipleBarcodeReader();
     virtual Fallible<std::vector<Ref<Result>>> decodeMultiple(Ref<BinaryBitmap> image, 
                                                      DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC override;
+    virtual Fallible<std::vector<Ref<Result>>> decodeMultiple(Ref<DecodeContext> context,
+                                                     DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC override;
 };
 } // End zxing::multi namespace
 } // End zxing namespace
@@ -0,0 +1,73 @@
+/*
+ *  Copyright 2011 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/multi/LinearSymbol.h>
+
+#include "zxing/BarcodeFormat.h"  // for BarcodeFormat
+
+#include <algorithm>              // for max, min
+
+namespace pping {
+namespace multi {
+
+const int LinearSymbol::MIN_ROW_READS;
+const float LinearSymbol::MIN_WIDTH_RATIO = 0.75f;
+
+LinearSymbol::LinearSymbol(float left, float right, int y) : left_(left), right_(right), lastRow_(y), reads_() {
+}
+
+bool LinearSymbol::overlaps(float left, float right, int y) const {
+  return left <= right_ && right >= left_ && !hasEnded(y);
+}
+
+bool LinearSymbol::hasEnded(int y) const {
+  return (float)(y - lastRow_) > right_ - left_;
+}
+
+void LinearSymbol::add(Ref<Result> result, std::string const& text, float left, float right, int y) {
+  left_ = std::min(left_, left);
+  right_ = std::max(right_, right);
+  lastRow_ = y;
+  for (auto & read : reads_) {
+    if (read.text == text && read.result->getBarcodeFormat() == result->getBarcodeFormat()) {
+      read.width = std::max(read.width, right - left);
+      read.rows++;
+      return;
+    }
+  }
+  Read read = { result, text, right - left, 1 };
+  reads_.push_back(read);
+}
+
+void LinearSymbol::getResults(std::vector<Ref<Result> >& results) const {
+  Read const* best = NULL;
+  for (auto const & read : reads_) {
+    if (read.rows >= MIN_ROW_READS && (best == NULL || read.rows > best->rows)) {
+      best = &read;
+    }
+  }
+  if (best == NULL) {
+    return;
+  }
+  for (auto const & read : reads_) {
+    if (read.rows >= MIN_ROW_READS && 2 * read.rows >= best->rows && read.width >= best->width * MIN_WIDTH_RATIO) {
+      results.push_back(read.result);
+    }
+  }
+}
+
+} // End zxing::multi namespace
+} // End zxing namespace
@@ -0,0 +1,68 @@
+#pragma once
+
+/*
+ *  Copyright 2011 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>                  // for string
+#include <vector>                  // for vector
+
+#include "zxing/Result.h"          // for Result
+#include "zxing/common/Counted.h"  // for Ref
+
+namespace pping {
+namespace multi {
+/**
+ * A 1D symbol as read on the rows so far: the reads that overlap it at
+ * most as far below as it is wide, as bar codes are rarely taller than
+ * that. Texts read on too few rows, on less than half as many rows as
+ * the text read on the most, or on narrower spans than that one, are
+ * misreads or reads of part of the symbol. Others are symbols of their
+ * own, stacked one above the other.
+ */
+class LinearSymbol {
+  private:
+    struct Read {
+      Ref<Result> result;
+      std::string text;
+      float width;
+      int rows;
+    };
+
+    float left_;
+    float right_;
+    int lastRow_;
+    std::vector<Read> reads_;
+
+  public:
+    // Rows a text has to be read on before it is reported
+    static const int MIN_ROW_READS = 2;
+    // Narrowest span, relative to the best read, of a text that is not part of it
+    static const float MIN_WIDTH_RATIO;
+
+    LinearSymbol(float left, float right, int y);
+
+    bool overlaps(float left, float right, int y) const;
+
+    /** Whether row y is too far below for the symbol to be read on it. */
+    bool hasEnded(int y) const;
+
+    void add(Ref<Result> result, std::string const& text, float left, float right, int y);
+
+    /** Appends the texts that are symbols of their own to results. */
+    void getResults(std::vector<Ref<Result> >& results) const;
+};
+} // End zxing::multi namespace
+} // End zxing namespace
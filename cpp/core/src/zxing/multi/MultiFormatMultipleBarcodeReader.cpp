@@ -0,0 +1,262 @@
+/*
+ *  Copyright 2011 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/ReaderException.h>                                  // for ReaderException
+#include <zxing/multi/Coverage.h>                                   // for Coverage
+#include <zxing/multi/LinearSymbol.h>                               // for LinearSymbol
+#include <zxing/multi/MultiFormatMultipleBarcodeReader.h>
+#include <zxing/multi/qrcode/detector/MultiDetector.h>              // for MultiDetector
+#include <string>                                                   // for string
+
+#include "zxing/BarcodeFormat.h"                                    // for BarcodeFormat
+#include "zxing/BinaryBitmap.h"                                     // for BinaryBitmap
+#include "zxing/DecodeContext.h"                                    // for DecodeContext
+#include "zxing/Result.h"                                           // for Result
+#include "zxing/ResultPoint.h"                                      // for ResultPoint
+#include "zxing/TimeoutException.h"                                 // for TimeoutException
+#include "zxing/aztec/AztecDetectorResult.h"                        // for AztecDetectorResult
+#include "zxing/aztec/AztecReader.h"                                // for AztecReader
+#include "zxing/aztec/detector/ZxingAztecBullseyeFinder.h"          // for BullseyeFinder
+#include "zxing/aztec/detector/ZxingAztecDetector.h"                // for Detector, Point
+#include "zxing/common/BitArray.h"                                  // for BitArray
+#include "zxing/common/BitMatrix.h"                                 // for BitMatrix
+#include "zxing/common/DecoderResult.h"                             // for DecoderResult
+#include "zxing/common/DetectorResult.h"                            // for DetectorResult
+#include "zxing/common/Str.h"                                       // for String
+#include "zxing/datamatrix/DataMatrixReader.h"                      // for DataMatrixReader
+#include "zxing/datamatrix/detector/ZXingDataMatrixDetector.h"      // for Detector
+#include "zxing/datamatrix/detector/ZXingDataMatrixLShapeFinder.h"  // for LShapeFinder
+#include "zxing/oned/ZXingMultiFormatOneDReader.h"                  // for MultiFormatOneDReader
+#include "zxing/oned/ZXingRunLengthRow.h"                           // for RunLengthRow
+#include "zxing/qrcode/decoder/ZXingQRCodeDecoder.h"                // for Decoder
+#include "zxing/qrcode/detector/FinderPatternInfo.h"                // for FinderPatternInfo
+
+#include <algorithm>                                                // for find_if, max, min, stable_partition, stable_sort
+#include <cmath>                                                    // for ceil, floor
+
+namespace pping {
+namespace multi {
+
+namespace {
+  // Most Data Matrix and Aztec candidates the finders return
+  const int MAX_CANDIDATES = 32;
+  // Most 1D symbols read on one row
+  const int MAX_ROW_SYMBOLS = 8;
+
+  /** Reports the symbols that have ended on row y, or all of them once the rows are done. */
+  void reportEnded(std::vector<LinearSymbol>& symbols, int y, bool done, std::vector<Ref<Result> >& results) {
+    auto ended = std::stable_partition(symbols.begin(), symbols.end(), [&](LinearSymbol const& symbol) {
+      return !done && !symbol.hasEnded(y);
+    });
+    for (auto symbol = ended; symbol != symbols.end(); ++symbol) {
+      symbol->getResults(results);
+    }
+    symbols.erase(ended, symbols.end());
+  }
+
+  bool hasOneDFormat(DecodeHints const& hints) {
+    return hints.containsFormat(BarcodeFormat::UPC_E) ||
+           hints.containsFormat(BarcodeFormat::UPC_A) ||
+           hints.containsFormat(BarcodeFormat::EAN_8) ||
+           hints.containsFormat(BarcodeFormat::EAN_13) ||
+           hints.containsFormat(BarcodeFormat::CODE_128) ||
+           hints.containsFormat(BarcodeFormat::CODE_39) ||
+           hints.containsFormat(BarcodeFormat::ITF);
+  }
+
+  void addResult(Ref<Result> result, Coverage& coverage, std::vector<Ref<Result> >& results) {
+    coverage.add(*result);
+    results.push_back(result);
+  }
+
+  /** The distances from the top left finder pattern to the other two. */
+  float span(qrcode::FinderPatternInfo& info) {
+    return ResultPoint::distance(info.getTopLeft(), info.getTopRight()) +
+           ResultPoint::distance(info.getTopLeft(), info.getBottomLeft());
+  }
+
+  void decodeQRCodes(Ref<BitMatrix> matrix, DecodeHints const& hints, Coverage& coverage,
+                     std::vector<Ref<Result> >& results) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    MultiDetector detector(matrix);
+    auto const found(detector.findMulti(hints));
+    if (!found)
+      return;
+    // Triples of patterns from different symbols span more than those of
+    // one, so the smallest go first and cover the patterns the others reuse
+    std::vector<Ref<qrcode::FinderPatternInfo> > infos(*found);
+    std::stable_sort(infos.begin(), infos.end(), [](Ref<qrcode::FinderPatternInfo> const& a,
+                                                    Ref<qrcode::FinderPatternInfo> const& b) {
+      return span(*a) < span(*b);
+    });
+    qrcode::Decoder decoder;
+    for (auto const & info : infos) {
+      if (hints.isCancelled())
+        return;
+      if (coverage.covers(info->getBottomLeft()->getX(), info->getBottomLeft()->getY()) ||
+          coverage.covers(info->getTopLeft()->getX(), info->getTopLeft()->getY()) ||
+          coverage.covers(info->getTopRight()->getX(), info->getTopRight()->getY()))
+        continue;
+      auto const detectorResult(detector.detect(info));
+      if (!detectorResult)
+        continue;
+      auto const decoderResult(decoder.decode((*detectorResult)->getBits()));
+      if (!decoderResult)
+        continue;
+      addResult(Ref<Result>(new Result((*decoderResult)->getText(), (*decoderResult)->getRawBytes(),
+                                       (*detectorResult)->getPoints(), BarcodeFormat::QR_CODE)),
+                coverage, results);
+    }
+  }
+
+  void decodeDataMatrices(Ref<BitMatrix> matrix, DecodeHints const& hints, Coverage& coverage,
+                          std::vector<Ref<Result> >& results) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    datamatrix::Detector detector(matrix);
+    datamatrix::DataMatrixReader reader;
+    datamatrix::LShapeFinder finder(matrix);
+    std::vector<std::vector<Ref<ResultPoint> > > candidates(finder.find(MAX_CANDIDATES));
+    for (auto const & corners : candidates) {
+      if (hints.isCancelled())
+        return;
+      float x = 0.0f;
+      float y = 0.0f;
+      for (auto const & corner : corners) {
+        x += corner->getX() / (float)corners.size();
+        y += corner->getY() / (float)corners.size();
+      }
+      if (coverage.covers(x, y))
+        continue;
+      auto const detectorResult(detector.detect(corners));
+      if (!detectorResult)
+        continue;
+      auto const result(reader.decode(*detectorResult, hints));
+      if (result)
+        addResult(*result, coverage, results);
+    }
+  }
+
+  void decodeAztecCodes(Ref<BitMatrix> matrix, DecodeHints const& hints, Coverage& coverage,
+                        std::vector<Ref<Result> >& results) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    aztec::Detector detector(matrix);
+    aztec::AztecReader reader;
+    aztec::BullseyeFinder finder(matrix);
+    std::vector<aztec::Point> centers(finder.find(MAX_CANDIDATES));
+    for (auto const & center : centers) {
+      if (hints.isCancelled())
+        return;
+      if (coverage.covers((float)center.x, (float)center.y))
+        continue;
+      auto const detectorResult(detector.detect(center));
+      if (!detectorResult)
+        continue;
+      auto const result(reader.decode(*detectorResult));
+      if (result)
+        addResult(*result, coverage, results);
+    }
+  }
+
+  /**
+   * Reads rows spread over the whole image, with the 2D symbols blackened
+   * out. A row may cross several symbols: each one read is blackened in
+   * turn and the row read again. A symbol is reported once it has ended,
+   * see LinearSymbol.
+   */
+  void decodeOneDCodes(Ref<BitMatrix> matrix, DecodeHints const& hints, Coverage& coverage,
+                       std::vector<Ref<Result> >& results) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    oned::MultiFormatOneDReader reader(hints);
+    int width = (int)matrix->getWidth();
+    int height = (int)matrix->getHeight();
+    int rowStep = std::max(1, height >> (hints.getTryHarder() ? 8 : 6));
+    std::vector<LinearSymbol> symbols;
+    Ref<BitArray> row(new BitArray((size_t)width));
+    // What the rows read so far is kept when cancelled
+    for (int y = rowStep / 2; y < height && !hints.isCancelled(); y += rowStep) {
+      row = matrix->getRow(y, row);
+      coverage.blacken(y, *row);
+      for (int i = 0; i < MAX_ROW_SYMBOLS; i++) {
+        auto const tryResult(reader.decodeLine(y, Ref<oned::RunLengthRow>(new oned::RunLengthRow(row))));
+        if (!tryResult)
+          break;
+        Ref<Result> result(*tryResult);
+        std::vector<Ref<ResultPoint> > const& points(result->getResultPoints());
+        if (points.size() < 2)
+          break;
+        float left = std::min(points.front()->getX(), points.back()->getX());
+        float right = std::max(points.front()->getX(), points.back()->getX());
+        int start = std::max(0, (int)std::floor(left));
+        int end = std::min(width, (int)std::ceil(right) + 1);
+        if (end <= start)
+          break;
+        row->setRange(start, end);
+
+        auto symbol = std::find_if(symbols.begin(), symbols.end(), [&](LinearSymbol const& known) {
+          return known.overlaps(left, right, y);
+        });
+        if (symbol == symbols.end()) {
+          symbol = symbols.insert(symbols.end(), LinearSymbol(left, right, y));
+        }
+        symbol->add(result, result->getText()->getText(), left, right, y);
+      }
+      reportEnded(symbols, y, false, results);
+    }
+    reportEnded(symbols, height, true, results);
+  }
+}
+
+MultiFormatMultipleBarcodeReader::MultiFormatMultipleBarcodeReader(){}
+
+MultiFormatMultipleBarcodeReader::~MultiFormatMultipleBarcodeReader(){}
+
+Fallible<std::vector<Ref<Result>>> MultiFormatMultipleBarcodeReader::decodeMultiple(Ref<BinaryBitmap> image,
+  DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC
+{
+  return decodeMultiple(Ref<DecodeContext>(new DecodeContext(image)), hints);
+}
+
+Fallible<std::vector<Ref<Result>>> MultiFormatMultipleBarcodeReader::decodeMultiple(Ref<DecodeContext> context,
+  DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC
+{
+  auto const blackMatrix(context->getBlackMatrix());
+  if (!blackMatrix)
+      return blackMatrix.error();
+  Ref<BitMatrix> matrix(*blackMatrix);
+
+  // 2D symbols first, their finder patterns are the most telling
+  Coverage coverage((int)matrix->getWidth(), (int)matrix->getHeight());
+  std::vector<Ref<Result> > results;
+  if (hints.containsFormat(BarcodeFormat::QR_CODE)) {
+    decodeQRCodes(matrix, hints, coverage, results);
+  }
+  if (hints.containsFormat(BarcodeFormat::DATA_MATRIX) && !hints.isCancelled()) {
+    decodeDataMatrices(matrix, hints, coverage, results);
+  }
+  if (hints.containsFormat(BarcodeFormat::AZTEC_BARCODE) && !hints.isCancelled()) {
+    decodeAztecCodes(matrix, hints, coverage, results);
+  }
+  if (hasOneDFormat(hints) && !hints.isCancelled()) {
+    decodeOneDCodes(matrix, hints, coverage, results);
+  }
+
+  if (results.empty() && hints.isCancelled()){
+    return failure<TimeoutException>("Decoding timed out");
+  }
+  if (results.empty()){
+    return failure<ReaderException>("No code detected");
+  }
+  return results;
+}
+
+} // End zxing::multi namespace
+} // End zxing namespace
@@ -0,0 +1,55 @@
+#pragma once
+
+/*
+ *  Copyright 2011 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/multi/MultipleBarcodeReader.h>  // for MultipleBarcodeReader
+#include <vector>                               // for vector
+
+#include "zxing/DecodeHints.h"                  // for DecodeHints
+#include "zxing/common/Counted.h"               // for Ref
+#include "zxing/common/Error.hpp"
+
+namespace pping {
+class BinaryBitmap;
+class DecodeContext;
+class Result;
+}  // namespace pping
+
+namespace pping {
+namespace multi {
+/**
+ * Finds every symbol of the enabled formats in one pass over the image,
+ * instead of decoding it again and again around each symbol found as
+ * GenericMultipleBarcodeReader does. The finders collect all candidates at
+ * once, QR finder pattern triples, Data Matrix L-shapes and Aztec bull's
+ * eyes, and each is sampled and decoded once, unless it lies on a symbol
+ * already decoded. The 1D readers then sweep rows over the whole image,
+ * passing over those symbols, and a 1D symbol read on several rows is
+ * reported once. The work grows with the size of the image and the number
+ * of symbols in it, not with how they are laid out.
+ */
+class MultiFormatMultipleBarcodeReader : public MultipleBarcodeReader {
+  public:
+    MultiFormatMultipleBarcodeReader();
+    virtual ~MultiFormatMultipleBarcodeReader();
+    virtual Fallible<std::vector<Ref<Result>>> decodeMultiple(Ref<BinaryBitmap> image,
+                                                     DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC override;
+    virtual Fallible<std::vector<Ref<Result>>> decodeMultiple(Ref<DecodeContext> context,
+                                                     DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC override;
+};
+} // End zxing::multi namespace
+} // End zxing namespace
@@ -17,6 +17,7 @@
 #include <zxing/multi/MultipleBarcodeReader.h>
 
 #include "zxing/BinaryBitmap.h"    // for BinaryBitmap
+#include "zxing/DecodeContext.h"   // for DecodeContext
 #include "zxing/DecodeHints.h"     // for DecodeHints, DecodeHints::DEFAULT_HINT
 #include "zxing/Result.h"          // for Result
 #include "zxing/common/Counted.h"  // for Ref
@@ -30,5 +31,10 @@ Fallible<std::vector<Ref<Result>>> MultipleBarcodeReader::decodeMultiple(Ref<Bin
   return decodeMultiple(image, DecodeHints::DEFAULT_HINT);
 }
 
+Fallible<std::vector<Ref<Result>>> MultipleBarcodeReader::decodeMultiple(Ref<DecodeContext> context,
+                                                                        DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  return decodeMultiple(context->getImage(), hints);
+}
+
 } // End zxing::multi namespace
 } // End zxing namespace
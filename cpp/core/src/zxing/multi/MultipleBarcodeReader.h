@@ -24,6 +24,7 @@
 
 namespace pping {
 class BinaryBitmap;
+class DecodeContext;
 class Result;
 }  // namespace pping
 
@@ -35,6 +36,8 @@ class MultipleBarcodeReader : public Counted {
   public:
     virtual Fallible<std::vector<Ref<Result>>> decodeMultiple(Ref<BinaryBitmap> image) MB_NOEXCEPT_EXCEPT_BADALLOC;
     virtual Fallible<std::vector<Ref<Result>>> decodeMultiple(Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC = 0;
+    /** Like Reader::decode(context, hints), sharing what is derived from the image. */
+    virtual Fallible<std::vector<Ref<Result>>> decodeMultiple(Ref<DecodeContext> context, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
     virtual ~MultipleBarcodeReader();
 };
 } // End zxing::multi namespace
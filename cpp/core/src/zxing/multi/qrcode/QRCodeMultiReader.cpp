@@ -21,17 +21,64 @@
 #include <zxing/multi/qrcode/detector/MultiDetector.h>  // for MultiDetector
 
 #include "zxing/BinaryBitmap.h"                         // for BinaryBitmap
+#include "zxing/DecodeContext.h"                        // for DecodeContext
 #include "zxing/Result.h"                               // for Result
 #include "zxing/ResultPoint.h"                          // for ResultPoint
+#include "zxing/TimeoutException.h"                     // for TimeoutException
 #include "zxing/common/BitMatrix.h"                     // for BitMatrix
 #include "zxing/common/Counted.h"                       // for Ref
 #include "zxing/common/DecoderResult.h"                 // for DecoderResult
 #include "zxing/common/DetectorResult.h"                // for DetectorResult
 #include "zxing/common/Str.h"                           // for String
+#include "zxing/common/Threads.h"                       // for runOnThreads
 #include "zxing/qrcode/decoder/ZXingQRCodeDecoder.h"    // for Decoder
+#include "zxing/qrcode/detector/FinderPatternInfo.h"    // for FinderPatternInfo
+
+#include <algorithm>                                    // for max, min
+#include <atomic>                                       // for atomic
+#ifndef NO_THREADS
+#include <thread>                                       // for thread
+#endif
 
 namespace pping {
 namespace multi {
+using namespace pping::qrcode;
+
+namespace {
+  /**
+   * Samples and decodes the detections workers claim one at a time until
+   * none are left or the hints are cancelled. Each worker has a decoder of
+   * its own, and writes only the slots of results that belong to the
+   * detections it claimed.
+   */
+  void decodeDetections(MultiDetector& detector, std::vector<Ref<FinderPatternInfo> > const& infos,
+                        DecodeHints const& hints, std::atomic<size_t>& next,
+                        std::vector<Ref<Result> >& results) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    Decoder decoder;
+    for (size_t i = next++; i < infos.size() && !hints.isCancelled(); i = next++) {
+      auto const detectorResult(detector.detect(infos[i]));
+      if (!detectorResult)
+        continue;
+      auto const decoderResult(decoder.decode((*detectorResult)->getBits()));
+      if (!decoderResult)
+        continue;
+      auto const & points((*detectorResult)->getPoints());
+      results[i] = Ref<Result>(new Result((*decoderResult)->getText(), (*decoderResult)->getRawBytes(),
+                                          points, BarcodeFormat::QR_CODE));
+      // result->putMetadata(ResultMetadataType.BYTE_SEGMENTS, decoderResult->getByteSegments());
+      // result->putMetadata(ResultMetadataType.ERROR_CORRECTION_LEVEL, decoderResult->getECLevel().toString());
+    }
+  }
+
+#ifndef NO_THREADS
+  /** Number of threads to decode with, the calling one included. */
+  size_t decodingThreads(size_t detections) noexcept {
+    size_t threads = std::thread::hardware_concurrency();
+    return std::max<size_t>(1, std::min(threads, detections));
+  }
+#endif
+}
+
 QRCodeMultiReader::QRCodeMultiReader(){}
 
 QRCodeMultiReader::~QRCodeMultiReader(){}
@@ -39,28 +86,42 @@ QRCodeMultiReader::~QRCodeMultiReader(){}
 Fallible<std::vector<Ref<Result>>> QRCodeMultiReader::decodeMultiple(Ref<BinaryBitmap> image,
   DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC
 {
-  auto blackMatrix(image->getBlackMatrix());
+  return decodeMultiple(Ref<DecodeContext>(new DecodeContext(image)), hints);
+}
+
+Fallible<std::vector<Ref<Result>>> QRCodeMultiReader::decodeMultiple(Ref<DecodeContext> context,
+  DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC
+{
+  auto blackMatrix(context->getBlackMatrix());
   if (!blackMatrix)
       return blackMatrix.error();
   MultiDetector detector(*blackMatrix);
-  std::vector<Ref<Result> > results;
 
-  auto const tryGetDetectorResult(detector.detectMulti(hints));
-  if(!tryGetDetectorResult)
-      return tryGetDetectorResult.error();
+  auto const tryFindMulti(detector.findMulti(hints));
+  if(!tryFindMulti)
+      return tryFindMulti.error();
 
-  std::vector<Ref<DetectorResult> > detectorResult = *tryGetDetectorResult;
-  for (unsigned int i = 0; i < detectorResult.size(); i++) {
-      auto const decoderResult(getDecoder().decode(detectorResult[i]->getBits()));
-      if (!decoderResult)
-          continue;
-      auto const & points(detectorResult[i]->getPoints());
-      Ref<Result> result(Ref<Result>(new Result((*decoderResult)->getText(), (*decoderResult)->getRawBytes(),
-                                        points, BarcodeFormat::QR_CODE)));
-      // result->putMetadata(ResultMetadataType.BYTE_SEGMENTS, decoderResult->getByteSegments());
-      // result->putMetadata(ResultMetadataType.ERROR_CORRECTION_LEVEL, decoderResult->getECLevel().toString());
+  std::vector<Ref<FinderPatternInfo> > const & infos = *tryFindMulti;
+  std::vector<Ref<Result> > decoded(infos.size());
+  std::atomic<size_t> next(0);
+#ifndef NO_THREADS
+  size_t threads = decodingThreads(infos.size());
+#else
+  size_t threads = 1;
+#endif
+  runOnThreads(threads, [&](size_t) {
+    decodeDetections(detector, infos, hints, next, decoded);
+  });
+
+  // Keep the order of the detections, whichever thread decoded them
+  std::vector<Ref<Result> > results;
+  for (auto const & result : decoded) {
+    if (!result.empty())
       results.push_back(result);
   }
+  if (results.empty() && hints.isCancelled()){
+    return failure<TimeoutException>("Decoding timed out");
+  }
   if (results.empty()){
     return failure<ReaderException>("No code detected");
   }
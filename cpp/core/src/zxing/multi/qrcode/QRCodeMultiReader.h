@@ -25,6 +25,7 @@
 
 namespace pping {
 class BinaryBitmap;
+class DecodeContext;
 class Result;
 template <typename T> class Ref;
 }  // namespace pping
@@ -36,6 +37,7 @@ class QRCodeMultiReader: public pping::qrcode::QRCodeReader, public MultipleBarc
     QRCodeMultiReader();
     virtual ~QRCodeMultiReader();
     virtual Fallible<std::vector<Ref<Result>>> decodeMultiple(Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC override;
+    virtual Fallible<std::vector<Ref<Result>>> decodeMultiple(Ref<DecodeContext> context, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC override;
 };
 } // End zxing::multi namespace
 } // End zxing namespace
@@ -35,9 +35,7 @@ MultiDetector::MultiDetector(Ref<BitMatrix> image) : Detector(image) {}
 MultiDetector::~MultiDetector(){}
 
 Fallible<std::vector<Ref<DetectorResult>>> MultiDetector::detectMulti(DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
-  Ref<BitMatrix> image = getImage();
-  MultiFinderPatternFinder finder = MultiFinderPatternFinder(image, hints.getResultPointCallback());
-  auto const tryFindMulti(finder.findMulti(hints));
+  auto const tryFindMulti(findMulti(hints));
   if(!tryFindMulti)
       return tryFindMulti.error();
 
@@ -45,7 +43,7 @@ Fallible<std::vector<Ref<DetectorResult>>> MultiDetector::detectMulti(DecodeHint
   std::vector<Ref<DetectorResult> > result;
   for(unsigned int i = 0; i < info.size(); i++) {
 
-      auto const processInfo(processFinderPatternInfo(info[i]));
+      auto const processInfo(detect(info[i]));
       if(processInfo)
           result.push_back(*processInfo);
   }
@@ -53,5 +51,15 @@ Fallible<std::vector<Ref<DetectorResult>>> MultiDetector::detectMulti(DecodeHint
   return result;
 }
 
+Fallible<std::vector<Ref<FinderPatternInfo>>> MultiDetector::findMulti(DecodeHints const& hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  Ref<BitMatrix> image = getImage();
+  MultiFinderPatternFinder finder = MultiFinderPatternFinder(image, hints.getResultPointCallback());
+  return finder.findMulti(hints);
+}
+
+FallibleRef<DetectorResult> MultiDetector::detect(Ref<FinderPatternInfo> info) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  return processFinderPatternInfo(info);
+}
+
 } // End zxing::multi namespace
 } // End zxing namespace
@@ -24,6 +24,9 @@ namespace pping {
 class BitMatrix;
 class DetectorResult;
 template <typename T> class Ref;
+namespace qrcode {
+class FinderPatternInfo;
+}  // namespace qrcode
 }  // namespace pping
 
 namespace pping {
@@ -32,7 +35,15 @@ class MultiDetector : public pping::qrcode::Detector {
   public:
     MultiDetector(Ref<BitMatrix> image);
     virtual ~MultiDetector();
+    using Detector::detect;
     virtual Fallible<std::vector<Ref<DetectorResult> > > detectMulti(DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
+    /** The finder pattern triples detectMulti would sample, without sampling them. */
+    Fallible<std::vector<Ref<qrcode::FinderPatternInfo> > > findMulti(DecodeHints const& hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
+    /**
+     * Samples the code located by one triple of findMulti. Only reads the
+     * detector's state, so several threads may call it at once.
+     */
+    FallibleRef<DetectorResult> detect(Ref<qrcode::FinderPatternInfo> info) MB_NOEXCEPT_EXCEPT_BADALLOC;
 };
 } // End zxing::multi namespace
 } // End zxing namespace
@@ -17,6 +17,7 @@
 #include <math.h>                                                  // for fabs, sqrt
 #include <zxing/DecodeHints.h>                                     // for DecodeHints
 #include <zxing/ReaderException.h>                                 // for ReaderException
+#include <zxing/TimeoutException.h>                                // for TimeoutException
 #include <zxing/multi/qrcode/detector/MultiFinderPatternFinder.h>
 #include <algorithm>                                               // for min, sort
 
@@ -40,12 +41,6 @@ const float MultiFinderPatternFinder::MIN_MODULE_COUNT_PER_EDGE = 9;
 const float MultiFinderPatternFinder::DIFF_MODSIZE_CUTOFF_PERCENT = 0.05f;
 const float MultiFinderPatternFinder::DIFF_MODSIZE_CUTOFF = 0.5f;
 
-bool compareModuleSize(Ref<FinderPattern> a, Ref<FinderPattern> b){
-    float value = a->getEstimatedModuleSize() - b->getEstimatedModuleSize();
-    return value < 0.0;
-}
-
-
 MultiFinderPatternFinder::MultiFinderPatternFinder(Ref<BitMatrix> image, 
   Ref<ResultPointCallback> resultPointCallback) : 
     FinderPatternFinder(image, resultPointCallback)
@@ -72,7 +67,7 @@ Fallible<std::vector<Ref<FinderPatternInfo>>> MultiFinderPatternFinder::findMult
   }
 
   int stateCount[5];
-  for (int i = iSkip - 1; i < maxI; i += iSkip) {
+  for (int i = iSkip - 1; i < maxI && !hints.isCancelled(); i += iSkip) {
     // Get a row of black/white values
     stateCount[0] = 0;
     stateCount[1] = 0;
@@ -126,7 +121,9 @@ Fallible<std::vector<Ref<FinderPatternInfo>>> MultiFinderPatternFinder::findMult
       handlePossibleCenter(stateCount, i, maxJ);
     } // end if foundPatternCross
   } // for i=iSkip-1 ...
-  auto const trySelectPatterns(selectBestPatterns());
+  if (hints.isCancelled())
+    return failure<TimeoutException>("Decoding timed out");
+  auto const trySelectPatterns(selectBestPatterns(hints));
   if(!trySelectPatterns)
       return trySelectPatterns.error();
 
@@ -134,14 +131,14 @@ Fallible<std::vector<Ref<FinderPatternInfo>>> MultiFinderPatternFinder::findMult
   std::vector<Ref<FinderPatternInfo> > result;
   for (unsigned int i = 0; i < patternInfo.size(); i++) {
     std::vector<Ref<FinderPattern> > pattern = patternInfo[i];
-    FinderPatternFinder::orderBestPatterns(pattern);
+    pattern = FinderPatternFinder::orderBestPatterns(pattern);
     result.push_back(Ref<FinderPatternInfo>(new FinderPatternInfo(pattern)));
   }
   return result;
 }
 
-Fallible<std::vector<std::vector<Ref<FinderPattern>>>> MultiFinderPatternFinder::selectBestPatterns() MB_NOEXCEPT_EXCEPT_BADALLOC {
-  std::vector<Ref<FinderPattern> > possibleCenters = possibleCenters_;
+Fallible<std::vector<std::vector<Ref<FinderPattern>>>> MultiFinderPatternFinder::selectBestPatterns(DecodeHints const& hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  std::vector<Candidate> possibleCenters = possibleCenters_;
   
   int size = (int)possibleCenters.size();
 
@@ -156,13 +153,27 @@ Fallible<std::vector<std::vector<Ref<FinderPattern>>>> MultiFinderPatternFinder:
   * Begin HE modifications to safely detect multiple codes of equal size
   */
   if (size == 3) {
-    results.push_back(possibleCenters_);
+    std::vector<Ref<FinderPattern> > patterns;
+    for (auto const & center : possibleCenters) {
+      patterns.push_back(toFinderPattern(center));
+    }
+    results.push_back(patterns);
     return results;
   }
 
   // Sort by estimated module size to speed up the upcoming checks
   //TODO do a sort based on module size
-  std::sort(possibleCenters.begin(), possibleCenters.end(), compareModuleSize);
+  std::sort(possibleCenters.begin(), possibleCenters.end(), [](Candidate const& a, Candidate const& b) {
+    return a.estimatedModuleSize - b.estimatedModuleSize < 0.0;
+  });
+  // A candidate becomes a FinderPattern once it is in a triple, and stays the same one in the others
+  std::vector<Ref<FinderPattern> > patterns((size_t)size);
+  auto pattern = [&](int i) {
+    if (patterns[(size_t)i].empty()) {
+      patterns[(size_t)i] = toFinderPattern(possibleCenters[(size_t)i]);
+    }
+    return patterns[(size_t)i];
+  };
 
   /*
   * Now lets start: build a list of tuples of three finder locations that
@@ -180,39 +191,53 @@ Fallible<std::vector<std::vector<Ref<FinderPattern>>>> MultiFinderPatternFinder:
   */
 
   for (int i1 = 0; i1 < (size - 2); i1++) {
-    Ref<FinderPattern> p1 = possibleCenters[i1];
+    Candidate const& p1 = possibleCenters[(size_t)i1];
     for (int i2 = i1 + 1; i2 < (size - 1); i2++) {
-      Ref<FinderPattern> p2 = possibleCenters[i2];
+      // The triples grow with the cube of the candidates, so an unlucky image can take long
+      if (hints.isCancelled()) {
+        return failure<TimeoutException>("Decoding timed out");
+      }
+      Candidate const& p2 = possibleCenters[(size_t)i2];
       // Compare the expected module sizes; if they are really off, skip
-      float vModSize12 = (p1->getEstimatedModuleSize() - p2->getEstimatedModuleSize()) / std::min(p1->getEstimatedModuleSize(), p2->getEstimatedModuleSize());
-      float vModSize12A = (float)fabs(p1->getEstimatedModuleSize() - p2->getEstimatedModuleSize());
+      float vModSize12 = (p1.estimatedModuleSize - p2.estimatedModuleSize) / std::min(p1.estimatedModuleSize, p2.estimatedModuleSize);
+      float vModSize12A = (float)fabs(p1.estimatedModuleSize - p2.estimatedModuleSize);
       if (vModSize12A > DIFF_MODSIZE_CUTOFF && vModSize12 >= DIFF_MODSIZE_CUTOFF_PERCENT) {
         // break, since elements are ordered by the module size deviation there cannot be
         // any more interesting elements for the given p1.
         break;
       }
       for (int i3 = i2 + 1; i3 < size; i3++) {
-        Ref<FinderPattern> p3 = possibleCenters[i3];
+        Candidate const& p3 = possibleCenters[(size_t)i3];
         // Compare the expected module sizes; if they are really off, skip
-        float vModSize23 = (p2->getEstimatedModuleSize() - p3->getEstimatedModuleSize()) / std::min(p2->getEstimatedModuleSize(), p3->getEstimatedModuleSize());
-        float vModSize23A = (float)fabs(p2->getEstimatedModuleSize() - p3->getEstimatedModuleSize());
+        float vModSize23 = (p2.estimatedModuleSize - p3.estimatedModuleSize) / std::min(p2.estimatedModuleSize, p3.estimatedModuleSize);
+        float vModSize23A = (float)fabs(p2.estimatedModuleSize - p3.estimatedModuleSize);
         if (vModSize23A > DIFF_MODSIZE_CUTOFF && vModSize23 >= DIFF_MODSIZE_CUTOFF_PERCENT) {
           // break, since elements are ordered by the module size deviation there cannot be
           // any more interesting elements for the given p1.
           break;
         }
-        std::vector<Ref<FinderPattern> > test;
-        test.push_back(p1);
-        test.push_back(p2);
-        test.push_back(p3);
-        FinderPatternFinder::orderBestPatterns(test);
-        // Calculate the distances: a = topleft-bottomleft, b=topleft-topright, c = diagonal
-        Ref<FinderPatternInfo> info = Ref<FinderPatternInfo>(new FinderPatternInfo(test));
-        float dA = FinderPatternFinder::distance(info->getTopLeft(), info->getBottomLeft());
-        float dC = FinderPatternFinder::distance(info->getTopRight(), info->getBottomLeft());
-        float dB = FinderPatternFinder::distance(info->getTopLeft(), info->getTopRight());
+        // Calculate the distances: a = topleft-bottomleft, b=topleft-topright, c = diagonal.
+        // Top left is opposite the longest side, as orderBestPatterns has it, so the
+        // triple is only ordered once it passed the tests.
+        float d12 = ResultPoint::distance(p1.x, p2.x, p1.y, p2.y);
+        float d13 = ResultPoint::distance(p1.x, p3.x, p1.y, p3.y);
+        float d23 = ResultPoint::distance(p2.x, p3.x, p2.y, p3.y);
+        float dA, dB, dC;
+        if (d23 >= d12 && d23 >= d13) {
+          dA = d12;
+          dB = d13;
+          dC = d23;
+        } else if (d13 >= d23 && d13 >= d12) {
+          dA = d12;
+          dB = d23;
+          dC = d13;
+        } else {
+          dA = d13;
+          dB = d23;
+          dC = d12;
+        }
         // Check the sizes
-        float estimatedModuleCount = (dA + dB) / (p1->getEstimatedModuleSize() * 2.0f);
+        float estimatedModuleCount = (dA + dB) / (p1.estimatedModuleSize * 2.0f);
         if (estimatedModuleCount > MAX_MODULE_COUNT_PER_EDGE || estimatedModuleCount < MIN_MODULE_COUNT_PER_EDGE) {
           continue;
         }
@@ -229,7 +254,11 @@ Fallible<std::vector<std::vector<Ref<FinderPattern>>>> MultiFinderPatternFinder:
           continue;
         }
         // All tests passed!
-        results.push_back(test);
+        std::vector<Ref<FinderPattern> > test;
+        test.push_back(pattern(i1));
+        test.push_back(pattern(i2));
+        test.push_back(pattern(i3));
+        results.push_back(FinderPatternFinder::orderBestPatterns(test));
       } // end iterate p3
     } // end iterate p2
   } // end iterate p1
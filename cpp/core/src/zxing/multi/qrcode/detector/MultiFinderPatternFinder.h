@@ -35,7 +35,7 @@ namespace pping {
 namespace multi {
 class MultiFinderPatternFinder : pping::qrcode::FinderPatternFinder {
   private:
-    Fallible<std::vector<std::vector<Ref<qrcode::FinderPattern> > > > selectBestPatterns() MB_NOEXCEPT_EXCEPT_BADALLOC;
+    Fallible<std::vector<std::vector<Ref<qrcode::FinderPattern> > > > selectBestPatterns(DecodeHints const& hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
 
     static const float MAX_MODULE_COUNT_PER_EDGE;
     static const float MIN_MODULE_COUNT_PER_EDGE;
@@ -28,10 +28,8 @@
 #include "zxing/BarcodeFormat.h"              // for BarcodeFormat::CODE_128
 #include "zxing/Result.h"                     // for Result
 #include "zxing/ResultPoint.h"                // for ResultPoint
-#include "zxing/common/BitArray.h"            // for BitArray
 #include "zxing/common/Str.h"                 // for String
-
-#include <memory>
+#include "zxing/oned/ZXingRunLengthRow.h"     // for RunLengthRow
 
 namespace pping {
 namespace oned {
@@ -150,96 +148,41 @@ static const int CODE_PATTERNS[CODE_PATTERNS_LENGTH][countersLength] = {
 Code128Reader::Code128Reader() {
 }
 
-Fallible<int*> Code128Reader::findStartPattern(Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
-    int width = (int) row->getSize();
-    int rowOffset = 0;
-    while (rowOffset < width) {
-        auto const getAt(row->get(rowOffset));
-        if(!getAt)
-            return getAt.error();
-        if (*getAt) {
-            break;
-        }
-        rowOffset++;
+Fallible<std::array<int, 3>> Code128Reader::findStartPattern(Ref<RunLengthRow> row, int rowOffset) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    int width = row->getSize();
+    int patternStart = row->getNext(rowOffset, true);
+    if (patternStart >= width) {
+        return failure<ReaderException>("Can't find start pattern");
     }
 
-    int counterPosition = 0;
     int counters[countersLength] = {0, 0, 0, 0, 0, 0};
-    int patternStart = rowOffset;
-    bool isWhite = false;
     int patternLength = (int) (sizeof(counters) / sizeof(int));
 
-    for (int i = rowOffset; i < width; i++)
+    // The pattern starts on a black run and has to end on a color change
+    for (int run = row->getRun(patternStart); run + patternLength < row->getRunCount(); run += 2)
     {
-        auto const getAtPixel(row->get(i));
-        if(!getAtPixel)
-            return getAtPixel.error();
-        bool pixel = *getAtPixel;
-
-        if (pixel ^ isWhite) {
-            counters[counterPosition]++;
-        } else {
-            if (counterPosition == patternLength - 1) {
-                unsigned int bestVariance = MAX_AVG_VARIANCE;
-                int bestMatch = -1;
-                for (int startCode = CODE_START_A; startCode <= CODE_START_C; startCode++) {
-                    unsigned int variance = patternMatchVariance(counters, (int) (sizeof(counters) / sizeof(int)), CODE_PATTERNS[startCode],
-                                                                 MAX_INDIVIDUAL_VARIANCE);
-                    if (variance < bestVariance) {
-                        bestVariance = variance;
-                        bestMatch = startCode;
-                    }
-                }
-                // Look for whitespace before start pattern, >= 50% of width of start pattern
-                auto const startRange = std::max(0, patternStart - (i - patternStart) / 2), endRange = patternStart;
-
-                auto const checkRange(row->isRange(startRange, endRange, false));
-                if(!checkRange)
-                    return checkRange.error();
-
-                if (bestMatch >= 0 && (*checkRange)) {
-                    int* resultValue = new int[3];
-                    resultValue[0] = patternStart;
-                    resultValue[1] = i;
-                    resultValue[2] = bestMatch;
-                    return resultValue;
-                }
-                patternStart += counters[0] + counters[1];
-                for (int y = 2; y < patternLength; y++) {
-                    counters[y - 2] = counters[y];
-                }
-                counters[patternLength - 2] = 0;
-                counters[patternLength - 1] = 0;
-                counterPosition--;
-            } else {
-                counterPosition++;
-            }
-            counters[counterPosition] = 1;
-            isWhite = !isWhite;
+        row->recordPattern(patternStart, counters, patternLength);
+        int patternEnd = row->getRunEnd(run + patternLength - 1);
+
+        int bestMatch = findBestPattern(counters, patternLength, CODE_PATTERNS[CODE_START_A],
+                                        CODE_START_C - CODE_START_A + 1, MAX_AVG_VARIANCE, MAX_INDIVIDUAL_VARIANCE);
+        // Look for whitespace before start pattern, >= 50% of width of start pattern
+        if (bestMatch >= 0 &&
+            row->isRange(std::max(0, patternStart - (patternEnd - patternStart) / 2), patternStart, false)) {
+            std::array<int, 3> resultValue{ { patternStart, patternEnd, CODE_START_A + bestMatch } };
+            return resultValue;
         }
+        patternStart = row->getRunStart(run + 2);
     }
     return failure<ReaderException>("Can't find start pattern");
 }
 
-Fallible<int> Code128Reader::decodeCode(Ref<BitArray> row, int counters[], int countersCount, int rowOffset) noexcept {
-    if (!recordPattern(row, rowOffset, counters, countersCount)) {
+Fallible<int> Code128Reader::decodeCode(Ref<RunLengthRow> row, int counters[], int countersCount, int rowOffset) noexcept {
+    if (!row->recordPattern(rowOffset, counters, countersCount)) {
         return failure<ReaderException>("Cannot record pattern");
     }
-    unsigned int bestVariance = MAX_AVG_VARIANCE;  // worst variance we'll accept
-    int bestMatch = -1;
-    for (int d = 0; d < CODE_PATTERNS_LENGTH; d++) {
-        int pattern[countersLength];
-
-        for (int ind = 0; ind < countersLength; ind++) {
-            pattern[ind] = CODE_PATTERNS[d][ind];
-        }
-//				memcpy(pattern, CODE_PATTERNS[d], countersLength);
-        unsigned int variance = patternMatchVariance(counters, countersCount, pattern, MAX_INDIVIDUAL_VARIANCE);
-        if (variance < bestVariance) {
-            bestVariance = variance;
-            bestMatch = d;
-        }
-    }
+    int bestMatch = findBestPattern(counters, countersCount, CODE_PATTERNS[0], CODE_PATTERNS_LENGTH,
+                                    MAX_AVG_VARIANCE, MAX_INDIVIDUAL_VARIANCE);
     // TODO We're overlooking the fact that the STOP pattern has 7 values, not 6.
     if (bestMatch >= 0) {
         return bestMatch;
@@ -248,13 +191,17 @@ Fallible<int> Code128Reader::decodeCode(Ref<BitArray> row, int counters[], int c
     }
 }
 
-FallibleRef<Result> Code128Reader::decodeRow(int rowNumber, Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
+FallibleRef<Result> Code128Reader::decodeRow(int rowNumber, Ref<RunLengthRow> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
+        return decodeRow(rowNumber, row, 0);
+}
+
+FallibleRef<Result> Code128Reader::decodeRow(int rowNumber, Ref<RunLengthRow> row, int rowOffset) MB_NOEXCEPT_EXCEPT_BADALLOC {
 
-        auto const getStartInfo(findStartPattern(row));
+        auto const getStartInfo(findStartPattern(row, rowOffset));
         if(!getStartInfo)
             return getStartInfo.error();
 
-        auto const startPatternInfo = std::unique_ptr<int[]>(*getStartInfo);
+        auto const startPatternInfo = *getStartInfo;
 
         int startCode = startPatternInfo[2];
         int codeSet;
@@ -445,18 +392,9 @@ FallibleRef<Result> Code128Reader::decodeRow(int rowNumber, Ref<BitArray> row) M
         // Check for ample whitespace following pattern, but, to do this we first need to remember that
         // we fudged decoding CODE_STOP since it actually has 7 bars, not 6. There is a black bar left
         // to read off. Would be slightly better to properly read. Here we just skip it:
-        int width = (int) row->getSize();
-        auto const getAt(row->get(nextStart));
-        if(!getAt)
-            return getAt.error();
-        while (nextStart < width && *getAt) {
-            nextStart++;
-        }
-        auto const checkRange(row->isRange(nextStart, std::min(width, nextStart + (nextStart - lastStart) / 2), false));
-        if(!checkRange)
-            return checkRange.error();
-
-        if (!(*checkRange)) {
+        int width = row->getSize();
+        nextStart = row->getNext(nextStart, false);
+        if (!row->isRange(nextStart, std::min(width, nextStart + (nextStart - lastStart) / 2), false)) {
             return failure<ReaderException>("Invalid range");
         }
 
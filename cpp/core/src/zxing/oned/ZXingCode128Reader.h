@@ -21,9 +21,13 @@
 #include "zxing/common/Counted.h"        // for Ref
 #include <Utils/Macros.h>
 
+#include <array>
+
 namespace pping {
-class BitArray;
 class Result;
+namespace oned {
+class RunLengthRow;
+}  // namespace oned
 }  // namespace pping
 
 namespace pping {
@@ -50,12 +54,15 @@ namespace pping {
             static const int CODE_START_C = 105;
             static const int CODE_STOP = 106;
             
-            static Fallible<int*> findStartPattern(Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
-            static Fallible<int> decodeCode(Ref<BitArray> row, int counters[], int countersCount, int rowOffset) noexcept;
+            // Returns the start and end of the start pattern and its code
+            static Fallible<std::array<int, 3>> findStartPattern(Ref<RunLengthRow> row, int rowOffset) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            static Fallible<int> decodeCode(Ref<RunLengthRow> row, int counters[], int countersCount, int rowOffset) noexcept;
             
             void append(char* s, char c);
         public:
-            FallibleRef<Result> decodeRow(int rowNumber, Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            FallibleRef<Result> decodeRow(int rowNumber, Ref<RunLengthRow> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            // Decodes the row, looking for the start pattern from rowOffset on.
+            FallibleRef<Result> decodeRow(int rowNumber, Ref<RunLengthRow> row, int rowOffset) MB_NOEXCEPT_EXCEPT_BADALLOC;
             Code128Reader();
             ~Code128Reader();
         };
@@ -28,8 +28,8 @@
 #include "zxing/BarcodeFormat.h"              // for BarcodeFormat::CODE_39
 #include "zxing/Result.h"                     // for Result
 #include "zxing/ResultPoint.h"                // for ResultPoint
-#include "zxing/common/BitArray.h"            // for BitArray
 #include "zxing/common/Str.h"                 // for String
+#include "zxing/oned/ZXingRunLengthRow.h"     // for RunLengthRow
 
 namespace pping {
 namespace oned {
@@ -73,8 +73,12 @@ Code39Reader::Code39Reader(bool usingCheckDigit_) :
         alphabet_string(ALPHABET_STRING), usingCheckDigit(usingCheckDigit_) {
 }
 
-FallibleRef<Result> Code39Reader::decodeRow(int rowNumber, Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
-        auto const tryFindStart(findAsteriskPattern(row));
+FallibleRef<Result> Code39Reader::decodeRow(int rowNumber, Ref<RunLengthRow> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
+        return decodeRow(rowNumber, row, 0);
+}
+
+FallibleRef<Result> Code39Reader::decodeRow(int rowNumber, Ref<RunLengthRow> row, int rowOffset) MB_NOEXCEPT_EXCEPT_BADALLOC {
+        auto const tryFindStart(findAsteriskPattern(row, rowOffset));
         if(!tryFindStart)
             return tryFindStart.error();
 
@@ -85,15 +89,10 @@ FallibleRef<Result> Code39Reader::decodeRow(int rowNumber, Ref<BitArray> row) MB
         {
             return failure<ReaderException>( "nextStart < 0" );
         }
-        int end = (int) row->getSize();
+        int end = row->getSize();
 
         // Read off white space
-        auto const getAt(row->get(nextStart));
-        if(!getAt)
-            return getAt.error();
-        while (nextStart < end && getAt && !(*getAt)) {
-            nextStart++;
-        }
+        nextStart = row->getNext(nextStart, true);
 
         std::string tmpResultString;
 
@@ -105,7 +104,7 @@ FallibleRef<Result> Code39Reader::decodeRow(int rowNumber, Ref<BitArray> row) MB
         char decodedChar;
         int lastStart;
         do {
-            if (!recordPattern(row, nextStart, counters, countersLen))
+            if (!row->recordPattern(nextStart, counters, countersLen))
                 return failure<ReaderException>("Recording pattern failed");
 
             int pattern = toNarrowWidePattern(counters, countersLen);
@@ -124,13 +123,7 @@ FallibleRef<Result> Code39Reader::decodeRow(int rowNumber, Ref<BitArray> row) MB
                 nextStart += counters[i];
             }
             // Read off white space
-            auto const getAtNextStart(row->get(nextStart));
-            if(!getAtNextStart)
-                return getAtNextStart.error();
-
-            while (nextStart < end && !(*getAtNextStart)) {
-                nextStart++;
-            }
+            nextStart = row->getNext(nextStart, true);
         } while (decodedChar != '*');
         tmpResultString.erase(tmpResultString.length() - 1, 1);  // remove asterisk
 
@@ -191,67 +184,30 @@ FallibleRef<Result> Code39Reader::decodeRow(int rowNumber, Ref<BitArray> row) MB
         return res;
 }
 
-Fallible<std::array<int, 2>> Code39Reader::findAsteriskPattern(Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
-    int width = (int) row->getSize();
-    int rowOffset = 0;
-    while (rowOffset < width) {
-
-        auto const getAtOffset(row->get(rowOffset));
-        if(!getAtOffset)
-            return getAtOffset.error();
-
-        if(*getAtOffset) {
-            break;
-        }
-        rowOffset++;
+Fallible<std::array<int, 2>> Code39Reader::findAsteriskPattern(Ref<RunLengthRow> row, int rowOffset) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    int width = row->getSize();
+    int patternStart = row->getNext(rowOffset, true);
+    if (patternStart >= width) {
+        return failure<ReaderException>("Cannot find asterisk pattern");
     }
 
-    int counterPosition = 0;
     const int countersLen = 9;
     int counters[countersLen];
-    for (int i = 0; i < countersLen; i++) {
-        counters[i] = 0;
-    }
-    int patternStart = rowOffset;
-    bool isWhite = false;
     int patternLength = countersLen;
 
-    for (int i = rowOffset; i < width; i++) {
-        auto const getAt(row->get(i));
-        if(!getAt)
-            return getAt.error();
-
-        bool pixel = *getAt;
-        if (pixel ^ isWhite) {
-            counters[counterPosition]++;
-        } else {
-            if (counterPosition == patternLength - 1) {
-                // Look for whitespace before start pattern, >= 50% of width of
-                // start pattern.
-                auto const startRange = std::max(0, patternStart - ((i - patternStart) >> 1)), endRange = patternStart;
-
-                auto const checkRange(row->isRange(startRange, endRange, false));
-                if(!checkRange)
-                    return checkRange.error();
-
-                if (toNarrowWidePattern(counters, countersLen) == ASTERISK_ENCODING
-                        && (*checkRange)) {
-                    std::array<int, 2> resultValue{ { patternStart, i } };
-                    return resultValue;
-                }
-                patternStart += counters[0] + counters[1];
-                for (int y = 2; y < patternLength; y++) {
-                    counters[y - 2] = counters[y];
-                }
-                counters[patternLength - 2] = 0;
-                counters[patternLength - 1] = 0;
-                counterPosition--;
-            } else {
-                counterPosition++;
-            }
-            counters[counterPosition] = 1;
-            isWhite = !isWhite;
+    // The pattern starts on a black run and has to end on a color change
+    for (int run = row->getRun(patternStart); run + patternLength < row->getRunCount(); run += 2) {
+        row->recordPattern(patternStart, counters, patternLength);
+        int patternEnd = row->getRunEnd(run + patternLength - 1);
+
+        // Look for whitespace before start pattern, >= 50% of width of
+        // start pattern.
+        if (toNarrowWidePattern(counters, countersLen) == ASTERISK_ENCODING &&
+            row->isRange(std::max(0, patternStart - ((patternEnd - patternStart) >> 1)), patternStart, false)) {
+            std::array<int, 2> resultValue{ { patternStart, patternEnd } };
+            return resultValue;
         }
+        patternStart = row->getRunStart(run + 2);
     }
     return failure<ReaderException>("Cannot find asterisk pattern");
 }
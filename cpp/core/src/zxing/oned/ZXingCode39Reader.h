@@ -26,9 +26,11 @@
 #include <array>
 
 namespace pping {
-class BitArray;
 class Result;
 class String;
+namespace oned {
+class RunLengthRow;
+}  // namespace oned
 }  // namespace pping
 
 namespace pping {
@@ -51,7 +53,7 @@ private:
      */
 //    bool extendedMode;
 
-    static Fallible<std::array<int, 2>> findAsteriskPattern(Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
+    static Fallible<std::array<int, 2>> findAsteriskPattern(Ref<RunLengthRow> row, int rowOffset) MB_NOEXCEPT_EXCEPT_BADALLOC;
     static int toNarrowWidePattern(int counters[], int countersLen);
     static Fallible<char> patternToChar(int pattern);
     static Ref<String> decodeExtended(const std::string encoded);
@@ -61,7 +63,10 @@ public:
     Code39Reader();
     Code39Reader(bool usingCheckDigit_);
 
-    FallibleRef<Result> decodeRow(int rowNumber, Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
+    FallibleRef<Result> decodeRow(int rowNumber, Ref<RunLengthRow> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+    // Decodes the row, looking for the start pattern from rowOffset on.
+    FallibleRef<Result> decodeRow(int rowNumber, Ref<RunLengthRow> row, int rowOffset) MB_NOEXCEPT_EXCEPT_BADALLOC;
 };
 }
 }
@@ -17,8 +17,8 @@
 
 #include "ZXingEAN13Reader.h"
 
-#include "zxing/common/BitArray.h"         // for BitArray
 #include "zxing/common/Counted.h"          // for Ref
+#include "zxing/oned/ZXingRunLengthRow.h"  // for RunLengthRow
 #include "zxing/oned/ZXingUPCEANReader.h"  // for UPC_EAN_PATTERNS::UPC_EAN_PATTERNS_L_AND_G_PATTERNS, UPC_EAN_PATTERNS::UPC_EAN_PATTERNS_L_PATTERNS
 
 namespace pping {
@@ -30,7 +30,7 @@ namespace pping {
 
     EAN13Reader::EAN13Reader() { }
 
-    int EAN13Reader::decodeMiddle(Ref<BitArray> row, int startGuardBegin, int startGuardEnd,
+    int EAN13Reader::decodeMiddle(Ref<RunLengthRow> row, int startGuardBegin, int startGuardEnd,
         std::string& resultString) {
       (void)startGuardBegin;
       const int countersLen = 4;
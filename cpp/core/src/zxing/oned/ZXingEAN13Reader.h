@@ -25,8 +25,10 @@
 #include "zxing/BarcodeFormat.h"           // for BarcodeFormat
 
 namespace pping {
-class BitArray;
 template <typename T> class Ref;
+namespace oned {
+class RunLengthRow;
+}  // namespace oned
 }  // namespace pping
 
 namespace pping {
@@ -39,7 +41,7 @@ namespace pping {
     public:
       EAN13Reader();
 
-      int decodeMiddle(Ref<BitArray> row, int startGuardBegin, int startGuardEnd,
+      int decodeMiddle(Ref<RunLengthRow> row, int startGuardBegin, int startGuardEnd,
           std::string& resultString);
 
       BarcodeFormat getBarcodeFormat();
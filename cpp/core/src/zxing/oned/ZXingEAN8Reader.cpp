@@ -17,8 +17,8 @@
 
 #include "ZXingEAN8Reader.h"
 
-#include "zxing/common/BitArray.h"         // for BitArray
 #include "zxing/common/Counted.h"          // for Ref
+#include "zxing/oned/ZXingRunLengthRow.h"  // for RunLengthRow
 #include "zxing/oned/ZXingUPCEANReader.h"  // for UPC_EAN_PATTERNS::UPC_EAN_PATTERNS_L_PATTERNS
 
 namespace pping {
@@ -26,7 +26,7 @@ namespace pping {
 
     EAN8Reader::EAN8Reader(){ }
 
-    int EAN8Reader::decodeMiddle(Ref<BitArray> row, int startGuardBegin, int startGuardEnd,
+    int EAN8Reader::decodeMiddle(Ref<RunLengthRow> row, int startGuardBegin, int startGuardEnd,
         std::string& resultString){
       (void)startGuardBegin;
       const int countersLen = 4;
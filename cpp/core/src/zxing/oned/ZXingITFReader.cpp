@@ -25,8 +25,8 @@
 #include "zxing/BarcodeFormat.h"              // for BarcodeFormat::ITF
 #include "zxing/Result.h"                     // for Result
 #include "zxing/ResultPoint.h"                // for ResultPoint
-#include "zxing/common/BitArray.h"            // for BitArray
 #include "zxing/common/Str.h"                 // for String
+#include "zxing/oned/ZXingRunLengthRow.h"     // for RunLengthRow
 
 namespace pping {
   namespace oned {
@@ -70,16 +70,23 @@ namespace pping {
     };
 
 
-    ITFReader::ITFReader() : narrowLineWidth(-1) {
+    ITFReader::ITFReader() {
     }
 
 
-    FallibleRef<Result> ITFReader::decodeRow(int rowNumber, Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
-        // Find out where the Middle section (payload) starts & ends
-        auto const tryDecodeStart(decodeStart(row));
-        auto const tryDecodeEnd(decodeEnd(row));
+    FallibleRef<Result> ITFReader::decodeRow(int rowNumber, Ref<RunLengthRow> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
+        return decodeRow(rowNumber, row, 0);
+    }
 
-        if(!tryDecodeStart || !tryDecodeEnd) {
+    FallibleRef<Result> ITFReader::decodeRow(int rowNumber, Ref<RunLengthRow> row, int rowOffset) MB_NOEXCEPT_EXCEPT_BADALLOC {
+        // Find out where the Middle section (payload) starts & ends. There is
+        // no point in reversing the row for the end if the start is missing.
+        auto const tryDecodeStart(decodeStart(row, rowOffset));
+        if(!tryDecodeStart) {
+            return failure<ReaderException>("Decoding start/end failed");
+        }
+        auto const tryDecodeEnd(decodeEnd(row));
+        if(!tryDecodeEnd) {
             return failure<ReaderException>("Decoding start/end failed");
         }
         auto const startRange = *tryDecodeStart;
@@ -131,7 +138,7 @@ namespace pping {
      * @param payloadStart offset of start pattern
      * @param resultString {@link StringBuffer} to append decoded chars to
      */
-    Fallible<void> ITFReader::decodeMiddle(Ref<BitArray> row, int payloadStart, int payloadEnd,
+    Fallible<void> ITFReader::decodeMiddle(Ref<RunLengthRow> row, int payloadStart, int payloadEnd,
         std::string& resultString) {
       // Digits are interleaved in pairs - 5 black lines for one digit, and the
       // 5
@@ -153,7 +160,7 @@ namespace pping {
 
       while (payloadStart < payloadEnd) {
         // Get 10 runs of black/white.
-        if (!recordPattern(row, payloadStart, counterDigitPair, counterDigitPairLen))
+        if (!row->recordPattern(payloadStart, counterDigitPair, counterDigitPairLen))
           return failure<ReaderException>("Can't decode middle");
 
         // Split them into each array
@@ -188,12 +195,13 @@ namespace pping {
     /**
      * Identify where the start of the middle / payload section starts.
      *
-     * @param row row of black/white values to search
+     * @param row       row of black/white values to search
+     * @param rowOffset position to start search
      * @return Array, containing index of start of 'start block' and end of
      *         'start block'
      */
-    Fallible<std::array<int, 2>> ITFReader::decodeStart(Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
-      auto const trySkipWhitespace(skipWhiteSpace(row));
+    Fallible<std::array<int, 2>> ITFReader::decodeStart(Ref<RunLengthRow> row, int rowOffset) MB_NOEXCEPT_EXCEPT_BADALLOC {
+      auto const trySkipWhitespace(skipWhiteSpace(row, rowOffset));
       if(!trySkipWhitespace) {
           return trySkipWhitespace.error();
       }
@@ -205,10 +213,6 @@ namespace pping {
       }
       auto const startPattern = *tryFindGuardPattern;
 
-          // Determine the width of a narrow line in pixels. We can do this by
-          // getting the width of the start pattern and dividing by 4 because its
-          // made up of 4 narrow lines.
-          narrowLineWidth = (startPattern[1] - startPattern[0]) >> 2;
           validateQuietZone(row, startPattern[0]);
           return startPattern;
     }
@@ -221,24 +225,20 @@ namespace pping {
      *         block'
      */
 
-    Fallible<std::array<int, 2>> ITFReader::decodeEnd(Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    Fallible<std::array<int, 2>> ITFReader::decodeEnd(Ref<RunLengthRow> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
       // For convenience, reverse the row and then
       // search from 'the start' for the end block
-        row->reverse();
+        Ref<RunLengthRow> reversedRow(row->reversed());
 
-        auto const trySkipWhitespace(skipWhiteSpace(row));
+        auto const trySkipWhitespace(skipWhiteSpace(reversedRow, 0));
         if(!trySkipWhitespace) {
-            row->reverse();
-
             return trySkipWhitespace.error();
         }
         int endStart = *trySkipWhitespace;
 
-        auto const tryFindGuardPattern(findGuardPattern(row, endStart, END_PATTERN_REVERSED, END_PATTERN_REVERSED_LEN));
+        auto const tryFindGuardPattern(findGuardPattern(reversedRow, endStart, END_PATTERN_REVERSED, END_PATTERN_REVERSED_LEN));
 
         if(!tryFindGuardPattern) {
-            row->reverse();
-
             return tryFindGuardPattern.error();
         }
         auto endPattern = *tryFindGuardPattern;
@@ -246,16 +246,15 @@ namespace pping {
         // The start & end patterns must be pre/post fixed by a quiet zone. This
         // zone must be at least 10 times the width of a narrow line.
         // ref: http://www.barcode-1.net/i25code.html
-        validateQuietZone(row, endPattern[0]);
+        validateQuietZone(reversedRow, endPattern[0]);
 
         // Now recalculate the indices of where the 'endblock' starts & stops to
         // accommodate
         // the reversed nature of the search
         int temp = endPattern[0];
-        endPattern[0] = (int)row->getSize() - endPattern[1];
-        endPattern[1] = (int)row->getSize() - temp;
+        endPattern[0] = row->getSize() - endPattern[1];
+        endPattern[1] = row->getSize() - temp;
 
-        row->reverse();
         return endPattern;
     }
 
@@ -273,7 +272,7 @@ namespace pping {
      * @param row bit array representing the scanned barcode.
      * @param startPattern index into row of the start or end pattern.
      */
-    void ITFReader::validateQuietZone(Ref<BitArray> row, int startPattern) {
+    void ITFReader::validateQuietZone(Ref<RunLengthRow> row, int startPattern) {
       (void)row;
       (void)startPattern;
 //#pragma mark needs some corrections
@@ -294,22 +293,13 @@ namespace pping {
     /**
      * Skip all whitespace until we get to the first black line.
      *
-     * @param row row of black/white values to search
+     * @param row       row of black/white values to search
+     * @param rowOffset position to start skipping from
      * @return index of the first black line.
      */
-    Fallible<int> ITFReader::skipWhiteSpace(Ref<BitArray> row) noexcept {
-      int width = (int)row->getSize();
-      int endStart = 0;
-      while (endStart < width) {
-        auto const getAt(row->get(endStart));
-        if(!getAt)
-            return getAt.error();
-
-        if (*getAt) {
-          break;
-        }
-        endStart++;
-      }
+    Fallible<int> ITFReader::skipWhiteSpace(Ref<RunLengthRow> row, int rowOffset) noexcept {
+      int width = row->getSize();
+      int endStart = row->getNext(rowOffset, true);
       if (endStart == width) {
         return failure<ReaderException>("Whitespace-only row found?");
       }
@@ -324,51 +314,28 @@ namespace pping {
      * @return start/end horizontal offset of guard pattern, as an array of two
      *         ints
      */
-    Fallible<std::array<int, 2>> ITFReader::findGuardPattern(Ref<BitArray> row, int rowOffset, const int pattern[],
+    Fallible<std::array<int, 2>> ITFReader::findGuardPattern(Ref<RunLengthRow> row, int rowOffset, const int pattern[],
         int patternLen) MB_NOEXCEPT_EXCEPT_BADALLOC {
       // TODO: This is very similar to implementation in UPCEANReader. Consider if they can be
       // merged to a single method.
       int patternLength = patternLen;
-      int *counters = new int[patternLength];
-      for (int i=0; i<patternLength; i++) {
-        counters[i] = 0;
+      int counters[START_PATTERN_LEN]; // the longer of the two guard patterns
+      int width = row->getSize();
+      if (rowOffset >= width) {
+        return failure<ReaderException>("Cannot find guard pattern");
       }
-      int width = (int)row->getSize();
-      bool isWhite = false;
 
-      int counterPosition = 0;
+      // rowOffset is on a black run; the last run of a match has to end on a color change
       int patternStart = rowOffset;
-      for (int x = rowOffset; x < width; x++) {
-        auto const getAt(row->get(x));
-        if(!getAt)
-            return getAt.error();
-
-        bool pixel = *getAt;
-        if (pixel ^ isWhite) {
-          counters[counterPosition]++;
-        } else {
-          if (counterPosition == patternLength - 1) {
-            if (patternMatchVariance(counters, patternLength, pattern,
-                MAX_INDIVIDUAL_VARIANCE) < MAX_AVG_VARIANCE) {
-              std::array<int, 2> resultValue{ { patternStart, x } };
-              delete[] counters;
-              return resultValue;
-            }
-            patternStart += counters[0] + counters[1];
-            for (int y = 2; y < patternLength; y++) {
-              counters[y - 2] = counters[y];
-            }
-            counters[patternLength - 2] = 0;
-            counters[patternLength - 1] = 0;
-            counterPosition--;
-          } else {
-            counterPosition++;
-          }
-          counters[counterPosition] = 1;
-          isWhite = !isWhite;
+      for (int run = row->getRun(patternStart); run + patternLength < row->getRunCount(); run += 2) {
+        row->recordPattern(patternStart, counters, patternLength);
+        if (patternMatchVariance(counters, patternLength, pattern,
+            MAX_INDIVIDUAL_VARIANCE) < MAX_AVG_VARIANCE) {
+          std::array<int, 2> resultValue{ { patternStart, row->getRunEnd(run + patternLength - 1) } };
+          return resultValue;
         }
+        patternStart = row->getRunStart(run + 2);
       }
-      delete[] counters;
       return failure<ReaderException>("Cannot find guard pattern");
     }
 
@@ -380,22 +347,8 @@ namespace pping {
      * @return The decoded digit
      */
     Fallible<int> ITFReader::decodeDigit(int counters[], int countersLen) MB_NOEXCEPT_EXCEPT_BADALLOC {
-      unsigned int bestVariance = MAX_AVG_VARIANCE; // worst variance we'll accept
-      int bestMatch = -1;
-      int max = PATTERNS_LEN;
-      for (int i = 0; i < max; i++) {
-        int *pattern = new int[countersLen];
-        for(int ind = 0; ind<countersLen; ind++){
-          pattern[ind] = PATTERNS[i][ind];
-        }
-        unsigned int variance = patternMatchVariance(counters, countersLen, pattern,
-            MAX_INDIVIDUAL_VARIANCE);
-        if (variance < bestVariance) {
-          bestVariance = variance;
-          bestMatch = i;
-        }
-        delete[] pattern;
-      }
+      int bestMatch = findBestPattern(counters, countersLen, PATTERNS[0], PATTERNS_LEN, MAX_AVG_VARIANCE,
+          MAX_INDIVIDUAL_VARIANCE);
       if (bestMatch >= 0) {
         return bestMatch;
       } else {
@@ -25,8 +25,10 @@
 #include <array>
 
 namespace pping {
-class BitArray;
 class Result;
+namespace oned {
+class RunLengthRow;
+}  // namespace oned
 }  // namespace pping
 
 namespace pping {
@@ -36,22 +38,22 @@ namespace pping {
         private:
       enum {MAX_AVG_VARIANCE = (unsigned int) (PATTERN_MATCH_RESULT_SCALE_FACTOR * 420/1000)};
             enum {MAX_INDIVIDUAL_VARIANCE = (int) (PATTERN_MATCH_RESULT_SCALE_FACTOR * 800/1000)};
-            // Stores the actual narrow line width of the image being decoded.
-            int narrowLineWidth;
             
-            Fallible<std::array<int, 2>> decodeStart(Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
-            Fallible<std::array<int, 2>> decodeEnd(Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            Fallible<std::array<int, 2>> decodeStart(Ref<RunLengthRow> row, int rowOffset) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            Fallible<std::array<int, 2>> decodeEnd(Ref<RunLengthRow> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
 
-            static Fallible<void> decodeMiddle(Ref<BitArray> row, int payloadStart, int payloadEnd, std::string& resultString);
-            void validateQuietZone(Ref<BitArray> row, int startPattern);
-            static Fallible<int> skipWhiteSpace(Ref<BitArray> row) noexcept;
+            static Fallible<void> decodeMiddle(Ref<RunLengthRow> row, int payloadStart, int payloadEnd, std::string& resultString);
+            void validateQuietZone(Ref<RunLengthRow> row, int startPattern);
+            static Fallible<int> skipWhiteSpace(Ref<RunLengthRow> row, int rowOffset) noexcept;
             
-            static Fallible<std::array<int, 2>> findGuardPattern(Ref<BitArray> row, int rowOffset, const int pattern[], int patternLen) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            static Fallible<std::array<int, 2>> findGuardPattern(Ref<RunLengthRow> row, int rowOffset, const int pattern[], int patternLen) MB_NOEXCEPT_EXCEPT_BADALLOC;
             static Fallible<int> decodeDigit(int counters[], int countersLen) MB_NOEXCEPT_EXCEPT_BADALLOC;
             
             void append(char* s, char c);
         public:
-            FallibleRef<Result> decodeRow(int rowNumber, Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            FallibleRef<Result> decodeRow(int rowNumber, Ref<RunLengthRow> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            // Decodes the row, looking for the start pattern from rowOffset on.
+            FallibleRef<Result> decodeRow(int rowNumber, Ref<RunLengthRow> row, int rowOffset) MB_NOEXCEPT_EXCEPT_BADALLOC;
 
             ITFReader();
             ~ITFReader();
@@ -19,53 +19,206 @@
 
 #include "ZXingMultiFormatOneDReader.h"
 
-#include <zxing/oned/ZXingCode128Reader.h>            // for Code128Reader
-#include <zxing/oned/ZXingCode39Reader.h>             // for Code39Reader
-#include <zxing/oned/ZXingITFReader.h>                // for ITFReader
-#include <zxing/oned/ZXingMultiFormatUPCEANReader.h>  // for MultiFormatUPCEANReader
-
-#include "zxing/BarcodeFormat.h"                      // for BarcodeFormat::CODE_128, BarcodeFormat::CODE_39, BarcodeFormat::EAN_13, BarcodeFormat::Barcod...
-#include "zxing/Result.h"                             // for Result
-#include "zxing/common/BitArray.h"                    // for BitArray
-#include "zxing/oned/ZXingOneDReader.h"               // for OneDReader
+#include <stdlib.h>                           // for abs
+#include <algorithm>                          // for max, min
+
+#include "zxing/BarcodeFormat.h"              // for BarcodeFormat::CODE_128, BarcodeFormat::CODE_39, BarcodeFormat::EAN_13, BarcodeFormat::Barcod...
 #include "zxing/ReaderException.h"
+#include "zxing/Result.h"                     // for Result
+#include "zxing/oned/ZXingRunLengthRow.h"     // for RunLengthRow
 
 namespace pping {
   namespace oned {
-    MultiFormatOneDReader::MultiFormatOneDReader(DecodeHints hints) : readers() {
+    namespace {
+      const int NO_CANDIDATE = -1;
+
+      // Offsets of the first plausible start pattern of each symbology in a row
+      struct StartCandidates {
+        int upcean;
+        int code39;
+        int code128;
+        int itf;
+      };
+
+      /**
+       * Whether a run is within tenths of a module of the given number of modules,
+       * total being the width of a pattern of totalModules. The readers allow
+       * 7/10 (8/10 for ITF) of a module in patternMatchVariance, so one tenth more
+       * keeps every start pattern they would accept despite their rounding.
+       */
+      bool isNearModules(int width, int modules, int total, int totalModules, int tenths) noexcept {
+        return abs(width * totalModules - modules * total) * 10 <= tenths * total;
+      }
+
+      int patternWidth(RunLengthRow const& row, int run, int runCount) noexcept {
+        return row.getRunStart(run + runCount) - row.getRunStart(run);
+      }
+
+      // 1-1-1 bar-space-bar, the quiet zone is left to the reader
+      bool isUPCEANGuard(RunLengthRow const& row, int run) noexcept {
+        int total = patternWidth(row, run, 3);
+        if (total < 3) {
+          return false;
+        }
+        for (int i = 0; i < 3; i++) {
+          if (!isNearModules(row.getRunWidth(run + i), 1, total, 3, 8)) {
+            return false;
+          }
+        }
+        return true;
+      }
+
+      // The asterisk is narrow-wide-narrow-narrow-wide-narrow-wide-narrow-narrow
+      bool isCode39Asterisk(RunLengthRow const& row, int run) noexcept {
+        int minWide = std::min(row.getRunWidth(run + 1), std::min(row.getRunWidth(run + 4), row.getRunWidth(run + 6)));
+        int maxNarrow = std::max(std::max(row.getRunWidth(run), row.getRunWidth(run + 2)),
+                                 std::max(std::max(row.getRunWidth(run + 3), row.getRunWidth(run + 5)),
+                                          std::max(row.getRunWidth(run + 7), row.getRunWidth(run + 8))));
+        if (minWide <= maxNarrow) {
+          return false;
+        }
+        int start = row.getRunStart(run);
+        return row.isRange(std::max(0, start - (patternWidth(row, run, 9) >> 1)), start, false);
+      }
+
+      // All three start codes begin with 2-1-1 of their 11 modules
+      bool isCode128Start(RunLengthRow const& row, int run) noexcept {
+        int total = patternWidth(row, run, 6);
+        if (total < 11 ||
+            !isNearModules(row.getRunWidth(run), 2, total, 11, 8) ||
+            !isNearModules(row.getRunWidth(run + 1), 1, total, 11, 8) ||
+            !isNearModules(row.getRunWidth(run + 2), 1, total, 11, 8)) {
+          return false;
+        }
+        int start = row.getRunStart(run);
+        return row.isRange(std::max(0, start - total / 2), start, false);
+      }
+
+      // Four narrow lines
+      bool isITFStart(RunLengthRow const& row, int run) noexcept {
+        int total = patternWidth(row, run, 4);
+        if (total < 4) {
+          return false;
+        }
+        for (int i = 0; i < 4; i++) {
+          if (!isNearModules(row.getRunWidth(run + i), 1, total, 4, 9)) {
+            return false;
+          }
+        }
+        return true;
+      }
+
+      /**
+       * Looks at every black run once for the start patterns of the enabled
+       * symbologies. Like the readers, a pattern has to end on a color change
+       * before the end of the row.
+       */
+      StartCandidates findStartCandidates(RunLengthRow const& row, bool upcean, bool code39, bool code128,
+                                          bool itf) noexcept {
+        StartCandidates found = { NO_CANDIDATE, NO_CANDIDATE, NO_CANDIDATE, NO_CANDIDATE };
+        int runCount = row.getRunCount();
+        int remaining = (int)upcean + (int)code39 + (int)code128 + (int)itf;
+        for (int run = 1; run < runCount && remaining > 0; run += 2) {
+          int start = row.getRunStart(run);
+          if (upcean && found.upcean == NO_CANDIDATE && run + 3 < runCount && isUPCEANGuard(row, run)) {
+            found.upcean = start;
+            remaining--;
+          }
+          if (code39 && found.code39 == NO_CANDIDATE && run + 9 < runCount && isCode39Asterisk(row, run)) {
+            found.code39 = start;
+            remaining--;
+          }
+          if (code128 && found.code128 == NO_CANDIDATE && run + 6 < runCount && isCode128Start(row, run)) {
+            found.code128 = start;
+            remaining--;
+          }
+          if (itf && found.itf == NO_CANDIDATE && run + 4 < runCount && isITFStart(row, run)) {
+            found.itf = start;
+            remaining--;
+          }
+        }
+        return found;
+      }
+    }
+
+    MultiFormatOneDReader::MultiFormatOneDReader(DecodeHints hints) :
+        upceanReader(), code39Reader(), code128Reader(), itfReader() {
       if (hints.containsFormat(BarcodeFormat::EAN_13) ||
           hints.containsFormat(BarcodeFormat::EAN_8) ||
           hints.containsFormat(BarcodeFormat::UPC_A) ||
           hints.containsFormat(BarcodeFormat::UPC_E)) {
-        readers.push_back(Ref<OneDReader>(new MultiFormatUPCEANReader(hints)));
+        upceanReader = new MultiFormatUPCEANReader(hints);
       }
       if (hints.containsFormat(BarcodeFormat::CODE_39)) {
-        readers.push_back(Ref<OneDReader>(new Code39Reader()));
+        code39Reader = new Code39Reader();
       }
       if (hints.containsFormat(BarcodeFormat::CODE_128)) {
-        readers.push_back(Ref<OneDReader>(new Code128Reader()));
+        code128Reader = new Code128Reader();
       }
       if (hints.containsFormat(BarcodeFormat::ITF)) {
-        readers.push_back(Ref<OneDReader>(new ITFReader()));
+        itfReader = new ITFReader();
       }
-      if (readers.size() == 0) {
-        readers.push_back(Ref<OneDReader>(new MultiFormatUPCEANReader(hints)));
-        readers.push_back(Ref<OneDReader>(new Code39Reader()));
-        readers.push_back(Ref<OneDReader>(new Code128Reader()));
-        readers.push_back(Ref<OneDReader>(new ITFReader()));
+      if (upceanReader.empty() && code39Reader.empty() && code128Reader.empty() && itfReader.empty()) {
+        upceanReader = new MultiFormatUPCEANReader(hints);
+        code39Reader = new Code39Reader();
+        code128Reader = new Code128Reader();
+        itfReader = new ITFReader();
       }
     }
 
-    FallibleRef<Result> MultiFormatOneDReader::decodeRow(int rowNumber, Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
-      int size = (int)readers.size();
-      for (int i = 0; i < size; i++) {
-        OneDReader* reader = readers[i];
+    FallibleRef<Result> MultiFormatOneDReader::decodeRow(int rowNumber, Ref<RunLengthRow> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
+      StartCandidates const candidates(findStartCandidates(*row, !upceanReader.empty(), !code39Reader.empty(),
+                                                           !code128Reader.empty(), !itfReader.empty()));
 
-        auto const result(reader->decodeRow(rowNumber, row));
-        if(result && !(*result).empty())
-            return *result;
+      if (candidates.upcean != NO_CANDIDATE) {
+        auto const result(upceanReader->decodeRow(rowNumber, row, candidates.upcean));
+        if (result && !(*result).empty())
+          return *result;
+      }
+      if (candidates.code39 != NO_CANDIDATE) {
+        auto const result(code39Reader->decodeRow(rowNumber, row, candidates.code39));
+        if (result && !(*result).empty())
+          return *result;
+      }
+      if (candidates.code128 != NO_CANDIDATE) {
+        auto const result(code128Reader->decodeRow(rowNumber, row, candidates.code128));
+        if (result && !(*result).empty())
+          return *result;
+      }
+      if (candidates.itf != NO_CANDIDATE) {
+        auto const result(itfReader->decodeRow(rowNumber, row, candidates.itf));
+        if (result && !(*result).empty())
+          return *result;
       }
       return failure<ReaderException>("Can't decode row");
     }
+
+    void MultiFormatOneDReader::setVoting(bool voting) noexcept {
+      OneDReader::setVoting(voting);
+      if (!upceanReader.empty()) {
+        upceanReader->setVoting(voting);
+      }
+      if (!code39Reader.empty()) {
+        code39Reader->setVoting(voting);
+      }
+      if (!code128Reader.empty()) {
+        code128Reader->setVoting(voting);
+      }
+      if (!itfReader.empty()) {
+        itfReader->setVoting(voting);
+      }
+    }
+
+    bool MultiFormatOneDReader::checkVotedText(BarcodeFormat format, std::string const& text, bool readOnOneRow) {
+      switch (format) {
+        case BarcodeFormat::EAN_13:
+        case BarcodeFormat::EAN_8:
+        case BarcodeFormat::UPC_A:
+        case BarcodeFormat::UPC_E:
+          return !upceanReader.empty() && upceanReader->checkVotedText(format, text, readOnOneRow);
+        default:
+          return OneDReader::checkVotedText(format, text, readOnOneRow);
+      }
+    }
   }
 }
@@ -18,27 +18,49 @@
  * limitations under the License.
  */
 
-#include <zxing/oned/ZXingOneDReader.h>  // for OneDReader
-#include <vector>                        // for vector
+#include <zxing/oned/ZXingCode128Reader.h>            // for Code128Reader
+#include <zxing/oned/ZXingCode39Reader.h>             // for Code39Reader
+#include <zxing/oned/ZXingITFReader.h>                // for ITFReader
+#include <zxing/oned/ZXingMultiFormatUPCEANReader.h>  // for MultiFormatUPCEANReader
+#include <zxing/oned/ZXingOneDReader.h>               // for OneDReader
+#include <string>                                     // for string
 
-#include "zxing/DecodeHints.h"           // for DecodeHints
-#include "zxing/common/Counted.h"        // for Ref
+#include "zxing/BarcodeFormat.h"                      // for BarcodeFormat
+#include "zxing/DecodeHints.h"                        // for DecodeHints
+#include "zxing/common/Counted.h"                     // for Ref
 
 namespace pping {
-class BitArray;
 class Result;
+namespace oned {
+class RunLengthRow;
+}  // namespace oned
 }  // namespace pping
 
 namespace pping {
   namespace oned {
+    /**
+     * Tries the enabled 1D readers on a row, but only those whose start pattern
+     * plausibly occurs in it. A single pass over the runs of the row looks for
+     * the UPC/EAN start guard, the Code 39 asterisk, the Code 128 start codes and
+     * the ITF start pattern, with a tolerance a little looser than the readers'
+     * own, and each reader starts its search at its first candidate. Most rows
+     * hold no barcode, and on those most readers are not invoked at all.
+     */
     class MultiFormatOneDReader : public OneDReader {
 
     private:
-      std::vector<Ref<OneDReader> > readers;
+      // Empty when the format is not enabled; tried in this order
+      Ref<MultiFormatUPCEANReader> upceanReader;
+      Ref<Code39Reader> code39Reader;
+      Ref<Code128Reader> code128Reader;
+      Ref<ITFReader> itfReader;
     public:
       MultiFormatOneDReader(DecodeHints hints);
 
-      FallibleRef<Result> decodeRow(int rowNumber, Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
+      FallibleRef<Result> decodeRow(int rowNumber, Ref<RunLengthRow> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+      void setVoting(bool voting) noexcept;
+      bool checkVotedText(BarcodeFormat format, std::string const& text, bool readOnOneRow);
     };
   }
 }
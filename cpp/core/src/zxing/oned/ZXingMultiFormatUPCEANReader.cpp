@@ -27,41 +27,50 @@
 #include "zxing/BarcodeFormat.h"          // for BarcodeFormat::EAN_13, BarcodeFormat::UPC_A, BarcodeFormat::EAN_8, BarcodeFormat::UPC_E
 #include "zxing/Result.h"                 // for Result
 #include "zxing/ResultPoint.h"            // for ResultPoint
-#include "zxing/common/BitArray.h"        // for BitArray
 #include "zxing/common/Str.h"             // for String
 #include "zxing/oned/ZXingOneDReader.h"   // for OneDReader
 #include "zxing/ReaderException.h"
+#include "zxing/oned/ZXingRunLengthRow.h" // for RunLengthRow
 
 namespace pping {
   namespace oned {
 
     MultiFormatUPCEANReader::MultiFormatUPCEANReader(DecodeHints hints) : readers() {
       if (hints.containsFormat(BarcodeFormat::EAN_13)) {
-        readers.push_back(Ref<OneDReader>(new EAN13Reader()));
+        readers.push_back(Ref<UPCEANReader>(new EAN13Reader()));
       } else if (hints.containsFormat(BarcodeFormat::UPC_A)) {
-        readers.push_back(Ref<OneDReader>(new UPCAReader()));
+        readers.push_back(Ref<UPCEANReader>(new UPCAReader()));
       }
       if (hints.containsFormat(BarcodeFormat::EAN_8)) {
-        readers.push_back(Ref<OneDReader>(new EAN8Reader()));
+        readers.push_back(Ref<UPCEANReader>(new EAN8Reader()));
       }
       if (hints.containsFormat(BarcodeFormat::UPC_E)) {
-        readers.push_back(Ref<OneDReader>(new UPCEReader()));
+        readers.push_back(Ref<UPCEANReader>(new UPCEReader()));
       }
       if (readers.size() == 0) {
-        readers.push_back(Ref<OneDReader>(new EAN13Reader()));
+        readers.push_back(Ref<UPCEANReader>(new EAN13Reader()));
         // UPC-A is covered by EAN-13
-        readers.push_back(Ref<OneDReader>(new EAN8Reader()));
-        readers.push_back(Ref<OneDReader>(new UPCEReader()));
+        readers.push_back(Ref<UPCEANReader>(new EAN8Reader()));
+        readers.push_back(Ref<UPCEANReader>(new UPCEReader()));
       }
     }
 
-    FallibleRef<Result> MultiFormatUPCEANReader::decodeRow(int rowNumber, Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    FallibleRef<Result> MultiFormatUPCEANReader::decodeRow(int rowNumber, Ref<RunLengthRow> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
+      return decodeRow(rowNumber, row, 0);
+    }
+
+    FallibleRef<Result> MultiFormatUPCEANReader::decodeRow(int rowNumber, Ref<RunLengthRow> row, int rowOffset) MB_NOEXCEPT_EXCEPT_BADALLOC {
       // Compute this location once and reuse it on multiple implementations
+      int startGuardBegin;
+      int startGuardEnd;
+      if (!UPCEANReader::findStartGuardPattern(row, rowOffset, &startGuardBegin, &startGuardEnd)) {
+        return failure<ReaderException>("Can't find start guard");
+      }
       int size = (int)readers.size();
       for (int i = 0; i < size; i++) {
-        Ref<OneDReader> reader = readers[i];
+        Ref<UPCEANReader> reader = readers[i];
 
-        auto const getResult(reader->decodeRow(rowNumber, row));
+        auto const getResult(reader->decodeRow(rowNumber, row, startGuardBegin, startGuardEnd));
         if(!getResult || (*getResult).empty())
             continue;
 
@@ -90,5 +99,23 @@ namespace pping {
       }
       return failure<ReaderException>("Can't decode row");
     }
+
+    void MultiFormatUPCEANReader::setVoting(bool voting) noexcept {
+      OneDReader::setVoting(voting);
+      for (size_t i = 0; i < readers.size(); i++) {
+        readers[i]->setVoting(voting);
+      }
+    }
+
+    bool MultiFormatUPCEANReader::checkVotedText(BarcodeFormat format, std::string const& text, bool readOnOneRow) {
+      for (size_t i = 0; i < readers.size(); i++) {
+        BarcodeFormat readerFormat = readers[i]->getBarcodeFormat();
+        // EAN-13 reads UPC-A too, see decodeRow
+        if (readerFormat == format || (format == BarcodeFormat::UPC_A && readerFormat == BarcodeFormat::EAN_13)) {
+          return readers[i]->checkVotedText(format, text, readOnOneRow);
+        }
+      }
+      return false;
+    }
   }
 }
@@ -18,15 +18,20 @@
  * limitations under the License.
  */
 
-#include <zxing/oned/ZXingOneDReader.h>  // for OneDReader
-#include <vector>                        // for vector
+#include <zxing/oned/ZXingOneDReader.h>    // for OneDReader
+#include <zxing/oned/ZXingUPCEANReader.h>  // for UPCEANReader
+#include <string>                          // for string
+#include <vector>                          // for vector
 
-#include "zxing/DecodeHints.h"           // for DecodeHints
-#include "zxing/common/Counted.h"        // for Ref
+#include "zxing/BarcodeFormat.h"           // for BarcodeFormat
+#include "zxing/DecodeHints.h"             // for DecodeHints
+#include "zxing/common/Counted.h"          // for Ref
 
 namespace pping {
-class BitArray;
 class Result;
+namespace oned {
+class RunLengthRow;
+}  // namespace oned
 }  // namespace pping
 
 namespace pping {
@@ -34,11 +39,16 @@ namespace pping {
     class MultiFormatUPCEANReader : public OneDReader {
 
     private:
-      std::vector<Ref<OneDReader> > readers;
+      std::vector<Ref<UPCEANReader> > readers;
     public:
       MultiFormatUPCEANReader(DecodeHints hints);
 
-      FallibleRef<Result> decodeRow(int rowNumber, Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
+      FallibleRef<Result> decodeRow(int rowNumber, Ref<RunLengthRow> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
+      // Decodes the row, looking for the start guard from rowOffset on.
+      FallibleRef<Result> decodeRow(int rowNumber, Ref<RunLengthRow> row, int rowOffset) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+      void setVoting(bool voting) noexcept;
+      bool checkVotedText(BarcodeFormat format, std::string const& text, bool readOnOneRow);
     };
   }
 }
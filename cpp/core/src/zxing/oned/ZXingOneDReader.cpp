@@ -24,16 +24,30 @@
 #include <stddef.h>                                 // for NULL, size_t
 #include <zxing/ReaderException.h>                  // for ReaderException
 #include <zxing/oned/ZXingOneDResultPoint.h>        // for OneDResultPoint
-#include <algorithm>                                // for max
+#include <zxing/oned/ZXingRunLengthRow.h>           // for RunLengthRow
+#include <zxing/oned/ZXingScanline.h>               // for Scanline
+#include <algorithm>                                // for max, min
+#include <atomic>                                   // for atomic
+#include <cmath>                                    // for cos, sin, fabs
+#include <string>                                   // for string
+#include <utility>                                  // for pair, make_pair
 #include <vector>                                   // for vector, allocator, __vector_base<>::value_type
+#ifndef NO_THREADS
+#include <thread>                                   // for thread
+#endif
 
 #include "zxing/BinaryBitmap.h"                     // for BinaryBitmap
+#include "zxing/DecodeContext.h"                    // for DecodeContext
+#include "zxing/LuminanceSource.h"                  // for LuminanceSource
 #include "zxing/Result.h"                           // for Result
 #include "zxing/ResultPoint.h"                      // for ResultPoint
 #include "zxing/ResultPointCallback.h"              // for ResultPointCallback
+#include "zxing/TimeoutException.h"                 // for TimeoutException
 #include "zxing/common/BitArray.h"                  // for BitArray
+#include "zxing/common/BitMatrix.h"                 // for BitMatrix
 #include "zxing/common/IllegalArgumentException.h"  // for IllegalArgumentException
 #include "zxing/common/Str.h"                       // for String
+#include "zxing/common/Threads.h"                   // for runOnThreads
 
 #if (defined _WIN32 || defined _WIN64)
 #undef min
@@ -44,41 +58,202 @@ namespace pping {
   namespace oned {
     using namespace std;
 
-    OneDReader::OneDReader() {
+    namespace {
+      const float HALF_PI = 1.57079632679f;
+      // An estimated scan direction this close to vertical makes the vertical scan redundant
+      const float VERTICAL_SCAN_MAX_COS = 0.2f;
+      // Tilt, as the sine of the scan angle, below which rows read as well as angled lines
+      const float TRY_HARDER_MIN_SIN = 0.1f;
+      // Lines cut shorter than this by the image border are not worth reading
+      const int MIN_SCANLINE_LENGTH = 16;
+      // Scanlines across the middle half of the image are 2^VOTING_ROW_DENSITY times as dense while voting
+      const int VOTING_ROW_DENSITY = 2;
+#ifndef NO_THREADS
+      // Lines per thread below which starting another one does not pay off
+      const int MIN_LINES_PER_THREAD = 32;
+#endif
+
+      /** Number of threads to scan lineCount lines with, the calling one included. */
+      int scanThreads(int lineCount, bool parallel) noexcept {
+#ifndef NO_THREADS
+        if (parallel) {
+          int threads = (int)std::thread::hardware_concurrency();
+          return std::max(1, std::min(threads, lineCount / MIN_LINES_PER_THREAD));
+        }
+#else
+        (void)lineCount;
+        (void)parallel;
+#endif
+        return 1;
+      }
+
+      /**
+       * Returns the result of the first of lines 0 to lineCount - 1 that decodes.
+       * Each of the threads takes every threads-th line, with a line decoder of
+       * its own from makeDecoder, and skips the lines after one that decoded.
+       * All of them stop once the hints are cancelled.
+       */
+      template <typename MakeDecoder>
+      Ref<Result> scanLines(int lineCount, int threads, DecodeHints const& hints, MakeDecoder const& makeDecoder) {
+        std::atomic<int> found(lineCount);
+        std::vector<Ref<Result> > results(threads);
+        std::vector<int> resultLines(threads, lineCount);
+        runOnThreads((size_t)threads, [&](size_t part) {
+          int first = (int)part;
+          auto decode = makeDecoder();
+          for (int x = first; x < found.load() && !hints.isCancelled(); x += threads) {
+            Ref<Result> result(decode(x));
+            if (!result.empty()) {
+              results[first] = result;
+              resultLines[first] = x;
+              int current = found.load();
+              while (x < current && !found.compare_exchange_weak(current, x)) {
+              }
+              return;
+            }
+          }
+        });
+
+        // The first line that decoded wins, whichever thread read it
+        int best = 0;
+        for (int i = 1; i < threads; i++) {
+          if (resultLines[i] < resultLines[best]) {
+            best = i;
+          }
+        }
+        return results[best];
+      }
     }
 
-    FallibleRef<Result> OneDReader::decode(Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
-        auto result = Ref<Result>();
+    /**
+     * Counts the votes of the rows on each character. Only rows that read the
+     * same format and number of characters vote together.
+     */
+    class RowConsensus {
+    private:
+      struct Candidate {
+        BarcodeFormat format;
+        // Rows per character read at each position
+        std::vector<std::vector<std::pair<char, int> > > votes;
+        std::vector<Ref<Result> > rows;
+      };
 
-        auto const tryDecoding(doDecode(image, hints));
-        if(tryDecoding)
-            result = *tryDecoding;
+      int margin_;
+      std::vector<Candidate> candidates_;
 
-      if (result.empty() && hints.getTryHarder() && image->isRotateSupported()) {
-        Ref<BinaryBitmap> rotatedImage(image->rotateCounterClockwise());
+    public:
+      explicit RowConsensus(int margin) : margin_(margin), candidates_() {
+      }
 
-        auto const tryDecodingRotated(doDecode(rotatedImage, hints));
-        if(tryDecodingRotated)
-            result = *tryDecodingRotated;
+      /**
+       * Adds the text read on a row. Returns true, with the characters that won
+       * in text, once each of them leads by the margin. row is then the first
+       * result that read all of text, or empty if it took several rows.
+       */
+      bool add(Ref<Result>& row, std::string& text) {
+        std::string const& rowText = row->getText()->getText();
+        BarcodeFormat format = row->getBarcodeFormat();
+        Candidate* candidate = NULL;
+        for (size_t i = 0; i < candidates_.size() && candidate == NULL; i++) {
+          if (candidates_[i].format == format && candidates_[i].votes.size() == rowText.size()) {
+            candidate = &candidates_[i];
+          }
+        }
+        if (candidate == NULL) {
+          candidates_.push_back(Candidate());
+          candidate = &candidates_.back();
+          candidate->format = format;
+          candidate->votes.resize(rowText.size());
+        }
+        candidate->rows.push_back(row);
 
-        if (!result.empty()) {
-          /*
-          // Record that we found it rotated 90 degrees CCW / 270 degrees CW
-          Hashtable metadata = result.getResultMetadata();
-          int orientation = 270;
-          if (metadata != null && metadata.containsKey(ResultMetadataType.ORIENTATION)) {
-            // But if we found it reversed in doDecode(), add in that result here:
-            orientation = (orientation +
-                     ((Integer) metadata.get(ResultMetadataType.ORIENTATION)).intValue()) % 360;
+        text.clear();
+        bool agreed = true;
+        for (size_t i = 0; i < rowText.size(); i++) {
+          std::vector<std::pair<char, int> >& votes = candidate->votes[i];
+          size_t c = 0;
+          while (c < votes.size() && votes[c].first != rowText[i]) {
+            c++;
           }
-          result.putMetadata(ResultMetadataType.ORIENTATION, new Integer(orientation));
-          */
-          // Update result points
-          std::vector<Ref<ResultPoint> >& points (result->getResultPoints());
-          for (size_t i = 0; i < points.size(); i++) {
-              points[i].reset(new OneDResultPoint(points[i]->getY(), points[i]->getX()));
+          if (c == votes.size()) {
+            votes.push_back(std::make_pair(rowText[i], 0));
           }
+          votes[c].second++;
+
+          int best = -1;
+          int runnerUp = 0;
+          for (size_t v = 0; v < votes.size(); v++) {
+            if (best < 0 || votes[v].second > votes[best].second) {
+              runnerUp = best < 0 ? 0 : votes[best].second;
+              best = (int)v;
+            } else {
+              runnerUp = std::max(runnerUp, votes[v].second);
+            }
+          }
+          text += votes[best].first;
+          agreed = agreed && votes[best].second - runnerUp >= margin_;
+        }
+        if (!agreed) {
+          return false;
+        }
+        row.reset(NULL);
+        for (size_t i = 0; i < candidate->rows.size() && row.empty(); i++) {
+          if (candidate->rows[i]->getText()->getText() == text) {
+            row = candidate->rows[i];
+          }
+        }
+        return true;
+      }
+    };
+
+    OneDReader::OneDReader() : voting_(false) {
+    }
+
+    FallibleRef<Result> OneDReader::decode(Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+        return decode(Ref<DecodeContext>(new DecodeContext(image)), hints);
+    }
+
+    FallibleRef<Result> OneDReader::decode(Ref<DecodeContext> context, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+        Ref<BinaryBitmap> image(context->getImage());
+        auto result = Ref<Result>();
+
+        int consensusRows = hints.getConsensusRows();
+        RowConsensus consensus(consensusRows);
+        RowConsensus* voting = consensusRows > 0 ? &consensus : NULL;
+        setVoting(voting != NULL);
+
+        auto const tryDecoding(doDecode(image, hints, voting));
+        if(tryDecoding)
+            result = *tryDecoding;
+
+      // Only trying harder goes on to barcodes whose bars are not vertical
+      if (result.empty() && hints.getTryHarder() && !hints.isCancelled()) {
+        // Rather than rotating the image, scan across the bars of a tilted barcode
+        Ref<LuminanceSource> source(image->getLuminanceSource());
+        int width = source->getWidth();
+        int height = source->getHeight();
+        unsigned char const* luminances = context->getLuminances();
+        float angle = 0.0f;
+        float centerX = 0.0f;
+        float centerY = 0.0f;
+        bool tilted = Scanline::estimateBarDirection(luminances, width, height, angle, centerX, centerY);
+        // Every row was scanned already, which covers slightly tilted bars too
+        if (tilted && std::fabs(std::sin(angle)) > TRY_HARDER_MIN_SIN) {
+          auto const tryDecodingAngled(doDecodeAngled(context, luminances, hints, voting, angle, centerX,
+                                                              centerY));
+          if (tryDecodingAngled)
+            result = *tryDecodingAngled;
         }
+        // What rotating the image by 90 degrees used to cover
+        if (result.empty() && (!tilted || std::fabs(std::cos(angle)) > VERTICAL_SCAN_MAX_COS)) {
+          auto const tryDecodingVertical(doDecodeAngled(context, luminances, hints, voting, HALF_PI,
+                                                        (float)(width / 2), (float)(height / 2)));
+          if (tryDecodingVertical)
+            result = *tryDecodingVertical;
+        }
+      }
+      if (result.empty() && hints.isCancelled()) {
+        return failure<TimeoutException>("Decoding timed out");
       }
       if (result.empty()) {
         return failure<ReaderException>();
@@ -92,84 +267,226 @@ namespace pping {
           }
           callback->finishedFindingPoints();
       }
-      if(result.empty())
-          return failure<ReaderException>();
       return result;
     }
 
-    FallibleRef<Result> OneDReader::doDecode(Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    FallibleRef<Result> OneDReader::doDecode(Ref<BinaryBitmap> image, DecodeHints hints,
+        RowConsensus* consensus) MB_NOEXCEPT_EXCEPT_BADALLOC {
       int width = image->getWidth();
       int height = image->getHeight();
-      Ref<BitArray> row(new BitArray(width));
+      bool greyscale = hints.getGreyscaleOneD();
+      Ref<LuminanceSource> source(image->getLuminanceSource());
       int middle = height >> 1;
       bool tryHarder = hints.getTryHarder();
-      int rowStep = (int)std::max(1, height >> (tryHarder ? 8 : 5));
+      // Votes need rows that decode, so while voting the middle half is scanned more densely
+      int density = consensus != NULL && !tryHarder ? VOTING_ROW_DENSITY : 0;
+      int rowStep = (int)std::max(1, height >> (tryHarder ? 8 : 5 + density));
       int maxLines;
 
       if (tryHarder) {
         maxLines = height; // Look at the whole image, not just the center
       } else {
-        maxLines = 15; // 15 rows spaced 1/32 apart is roughly the middle half of the image
+        maxLines = (16 << density) - 1; // 15 rows spaced 1/32 apart is roughly the middle half of the image
       }
 
-      for (int x = 0; x < maxLines; x++) {
-        // Scanning from the middle out. Determine which row we're looking at next:
+      // Scanning from the middle out. Line x is row:
+      auto rowNumberOf = [=](int x) {
         int rowStepsAboveOrBelow = (x + 1) >> 1;
         bool isAbove = (x & 0x01) == 0; // i.e. is x even?
-        int rowNumber = middle + rowStep * (isAbove ? rowStepsAboveOrBelow : -rowStepsAboveOrBelow);
-        if (rowNumber < 0 || rowNumber >= height) {
-          // Oops, if we run off the top or bottom, stop
-          break;
+        return middle + rowStep * (isAbove ? rowStepsAboveOrBelow : -rowStepsAboveOrBelow);
+      };
+      int lineCount = 0;
+      while (lineCount < maxLines && rowNumberOf(lineCount) >= 0 && rowNumberOf(lineCount) < height) {
+        // Stop where we run off the top or bottom
+        lineCount++;
+      }
+
+      int threads = scanThreads(lineCount, tryHarder && consensus == NULL);
+      auto makeDecoder = [&]() {
+        // The binarizer caches the last row, so each thread needs its own
+        Ref<BinaryBitmap> bitmap(threads > 1 ? image->copy() : image);
+        Ref<BitArray> row(new BitArray(width));
+        std::vector<unsigned char> luminances(greyscale ? width : 0);
+        return [=](int x) mutable -> Ref<Result> {
+          int rowNumber = rowNumberOf(x);
+          // Measure the bars once; every reader and both directions work from these runs,
+          // and reversing them to handle upside down barcodes is cheap.
+          Ref<RunLengthRow> runs;
+          if (greyscale) {
+            // Take the edges from the luminances, the row is never binarized
+            source->getRow(rowNumber, &luminances[0]);
+            runs = RunLengthRow::fromLuminances(&luminances[0], width);
+          } else {
+            // Estimate black point for this row and load it:
+            auto const blackRowResult(bitmap->getBlackRow(rowNumber, row));
+            if (!blackRowResult)
+              return Ref<Result>();
+            row = *blackRowResult;
+            runs = new RunLengthRow(row);
+          }
+          auto const tryResult(decodeLine(rowNumber, runs));
+          if (!tryResult)
+            return Ref<Result>();
+          return consensus == NULL ? *tryResult : vote(*consensus, *tryResult);
+        };
+      };
+      Ref<Result> result(scanLines(lineCount, threads, hints, makeDecoder));
+      if (result.empty() && hints.isCancelled())
+        return failure<TimeoutException>("Decoding timed out");
+      if (result.empty())
+        return failure<ReaderException>("Decoding failed");
+      return result;
+    }
+
+    FallibleRef<Result> OneDReader::doDecodeAngled(Ref<DecodeContext> context, unsigned char const* luminances,
+        DecodeHints hints, RowConsensus* consensus, float angle, float centerX,
+        float centerY) MB_NOEXCEPT_EXCEPT_BADALLOC {
+      int width = context->getImage()->getWidth();
+      int height = context->getImage()->getHeight();
+      bool greyscale = hints.getGreyscaleOneD();
+      Ref<BitMatrix> matrix;
+      if (!greyscale) {
+        auto const blackMatrix(context->getBlackMatrix());
+        if (!blackMatrix)
+          return blackMatrix.error();
+        matrix = *blackMatrix;
+      }
+
+      // Scanlines run along (dx, dy), across the bars, and are stepped apart along (-dy, dx)
+      float dx = std::cos(angle);
+      float dy = std::sin(angle);
+      int extent = (int)(std::fabs(dy) * (float)width + std::fabs(dx) * (float)height);
+      bool tryHarder = hints.getTryHarder();
+      int density = consensus != NULL && !tryHarder ? VOTING_ROW_DENSITY : 0;
+      int lineStep = std::max(1, extent >> (tryHarder ? 8 : 5 + density));
+      int maxLines = tryHarder ? extent : (16 << density) - 1;
+
+      // Scanning from the middle out, as doDecode does with rows
+      auto lineOf = [=](int x) {
+        int stepsAboveOrBelow = (x + 1) >> 1;
+        bool isAbove = (x & 0x01) == 0;
+        float offset = (float)(lineStep * (isAbove ? stepsAboveOrBelow : -stepsAboveOrBelow));
+        return Scanline(centerX - offset * dy, centerY + offset * dx, dx, dy, width, height);
+      };
+      // Until the lines miss the image on both sides
+      int lineCount = 0;
+      bool missedAbove = false;
+      bool missedBelow = false;
+      while (lineCount < maxLines && !(missedAbove && missedBelow)) {
+        if (lineOf(lineCount).getLength() < MIN_SCANLINE_LENGTH) {
+          ((lineCount & 0x01) == 0 ? missedAbove : missedBelow) = true;
         }
+        lineCount++;
+      }
+
+      int threads = scanThreads(lineCount, tryHarder && consensus == NULL);
+      auto makeDecoder = [&]() {
+        std::vector<unsigned char> profile;
+        return [=](int x) mutable -> Ref<Result> {
+          Scanline line(lineOf(x));
+          if (line.getLength() < MIN_SCANLINE_LENGTH)
+            return Ref<Result>();
 
-        // Estimate black point for this row and load it:
-        auto const blackRowResult(image->getBlackRow(rowNumber, row));
-        if (!blackRowResult)
+          Ref<RunLengthRow> runs;
+          if (greyscale) {
+            line.sample(luminances, width, height, profile);
+            runs = RunLengthRow::fromLuminances(&profile[0], line.getLength());
+          } else {
+            runs = new RunLengthRow(line.sample(*matrix));
+          }
+          auto const tryResult(decodeLine(x, runs));
+          if (!tryResult)
+            return Ref<Result>();
+
+          // Back from positions along the line to the image
+          Ref<Result> result = *tryResult;
+          std::vector<Ref<ResultPoint> >& points(result->getResultPoints());
+          for (size_t i = 0; i < points.size(); i++) {
+            points[i] = line.pointAt(points[i]->getX());
+          }
+          return consensus == NULL ? result : vote(*consensus, result);
+        };
+      };
+      Ref<Result> result(scanLines(lineCount, threads, hints, makeDecoder));
+      if (result.empty() && hints.isCancelled())
+        return failure<TimeoutException>("Decoding timed out");
+      if (result.empty())
+        return failure<ReaderException>("Decoding failed");
+      return result;
+    }
+
+    FallibleRef<Result> OneDReader::decodeLine(int rowNumber, Ref<RunLengthRow> runs) MB_NOEXCEPT_EXCEPT_BADALLOC {
+      // Length of the line in pixels
+      int width = runs->getSize() / runs->getScale();
+      for (int attempt = 0; attempt < 2; attempt++) {
+        if (attempt == 1) {
+          runs = runs->reversed(); // reverse the row and continue
+        }
+
+        // Look for a barcode
+        auto const tryResult(decodeRow(rowNumber, runs));
+        if(!tryResult)
             continue;
-        row = *blackRowResult;
 
-        // While we have the image data in a BitArray, it's fairly cheap to reverse it in place to
-        // handle decoding upside down barcodes.
-        for (int attempt = 0; attempt < 2; attempt++) {
-          if (attempt == 1) {
-            row->reverse(); // reverse the row and continue
+        Ref<Result> result = *tryResult;
+        // We found our barcode
+        if (!result.empty()) {
+          if (runs->getScale() != 1) {
+            // The readers worked in sub-pixel units
+            std::vector<Ref<ResultPoint> >& points(result->getResultPoints());
+            for (size_t i = 0; i < points.size(); i++) {
+              points[i].reset(new OneDResultPoint(points[i]->getX() / (float)runs->getScale(), points[i]->getY()));
+            }
           }
+          if (attempt == 1) {
+            // But it was upside down, so note that
+            // result.putMetadata(ResultMetadataType.ORIENTATION, new Integer(180));
+            // And remember to flip the result points horizontally.
+            std::vector<Ref<ResultPoint> > points(result->getResultPoints());
+            // if there's exactly two points (which there should be), flip the x coordinate
+            // if there's not exactly 2, I don't know what do do with it
+            if (points.size() == 2) {
+              Ref<ResultPoint> pointZero(new OneDResultPoint((float)width - points[0]->getX() - 1.f,
+                  points[0]->getY()));
+              points[0] = pointZero;
 
-          // Look for a barcode
-          auto const tryResult(decodeRow(rowNumber, row));
-          if(!tryResult)
-              continue;
+              Ref<ResultPoint> pointOne(new OneDResultPoint((float)width - points[1]->getX() - 1.f,
+                  points[1]->getY()));
+              points[1] = pointOne;
 
-          Ref<Result> result = *tryResult;
-          // We found our barcode
-          if (!result.empty()) {
-            if (attempt == 1) {
-              // But it was upside down, so note that
-              // result.putMetadata(ResultMetadataType.ORIENTATION, new Integer(180));
-              // And remember to flip the result points horizontally.
-              std::vector<Ref<ResultPoint> > points(result->getResultPoints());
-              // if there's exactly two points (which there should be), flip the x coordinate
-              // if there's not exactly 2, I don't know what do do with it
-              if (points.size() == 2) {
-                Ref<ResultPoint> pointZero(new OneDResultPoint((float)width - points[0]->getX() - 1.f,
-                    points[0]->getY()));
-                points[0] = pointZero;
-
-                Ref<ResultPoint> pointOne(new OneDResultPoint((float)width - points[1]->getX() - 1.f,
-                    points[1]->getY()));
-                points[1] = pointOne;
-
-                result.reset(new Result(result->getText(), result->getRawBytes(), points,
-                    result->getBarcodeFormat()));
-              }
+              result.reset(new Result(result->getText(), result->getRawBytes(), points,
+                  result->getBarcodeFormat()));
             }
-            return result;
           }
+          return result;
         }
       }
       return failure<ReaderException>("Decoding failed");
     }
 
+    Ref<Result> OneDReader::vote(RowConsensus& consensus, Ref<Result> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
+      BarcodeFormat format = row->getBarcodeFormat();
+      Ref<Result> sameRow(row);
+      std::string text;
+      if (!consensus.add(sameRow, text) || !checkVotedText(format, text, !sameRow.empty())) {
+        return Ref<Result>();
+      }
+      if (!sameRow.empty()) {
+        return sameRow;
+      }
+      // No row read it all, take the points of the last one
+      return Ref<Result>(new Result(Ref<String>(new String(text)), row->getRawBytes(), row->getResultPoints(),
+          format));
+    }
+
+    void OneDReader::setVoting(bool voting) noexcept {
+      voting_ = voting;
+    }
+
+    bool OneDReader::checkVotedText(BarcodeFormat, std::string const&, bool readOnOneRow) {
+      return readOnOneRow;
+    }
+
     unsigned int OneDReader::patternMatchVariance(int counters[], int countersSize,
         const int pattern[], int maxIndividualVariance) noexcept {
       int numCounters = countersSize;
@@ -208,46 +525,47 @@ namespace pping {
       return totalVariance / total;
     }
 
-    bool OneDReader::recordPattern(Ref<BitArray> row, int start, int counters[], int countersCount) noexcept {
-      int numCounters = countersCount;//sizeof(counters) / sizeof(int);
-      for (int i = 0; i < numCounters; i++) {
-        counters[i] = 0;
+    int OneDReader::findBestPattern(const int counters[], int countersSize, const int* patterns,
+        int patternCount, unsigned int maxAverageVariance, int maxIndividualVariance) noexcept {
+      unsigned int total = 0;
+      unsigned int patternLength = 0;
+      for (int i = 0; i < countersSize; i++) {
+        total += counters[i];
+        patternLength += patterns[i];
       }
-      int end = (int)row->getSize();
-      if (start >= end) {
-        return false;
+      if (total < patternLength || patternLength == 0) {
+        return -1;
       }
-      auto const getAtStart(row->get(start));
-      if(!getAtStart)
-          return false;
-      bool isWhite = !(*getAtStart);
-      int counterPosition = 0;
-      int i = start;
-      while (i < end) {
-        auto const getAt(row->get(i));
-        if(!getAt)
-            return false;
-        bool pixel = getAt && *getAt;
-
-        if (pixel ^ isWhite) { // that is, exactly one is true
-          counters[counterPosition]++;
-        } else {
-          counterPosition++;
-          if (counterPosition == numCounters) {
+      // Same fixed point math as patternMatchVariance, done once for all patterns
+      unsigned int unitBarWidth = (total << INTEGER_MATH_SHIFT) / patternLength;
+      int maxVariance = (maxIndividualVariance * unitBarWidth) >> INTEGER_MATH_SHIFT;
+
+      unsigned int bestVariance = maxAverageVariance;
+      int bestMatch = -1;
+      for (int p = 0; p < patternCount; p++) {
+        const int* pattern = patterns + p * countersSize;
+        // totalVariance / total < bestVariance exactly when totalVariance < limit
+        unsigned int limit = bestVariance * total;
+        unsigned int totalVariance = 0;
+        int x = 0;
+        for (; x < countersSize; x++) {
+          int counter = counters[x] << INTEGER_MATH_SHIFT;
+          int scaledPattern = pattern[x] * unitBarWidth;
+          int variance = counter > scaledPattern ? counter - scaledPattern : scaledPattern - counter;
+          if (variance > maxVariance) {
+            break;
+          }
+          totalVariance += variance;
+          if (totalVariance >= limit) {
             break;
-          } else {
-            counters[counterPosition] = 1;
-            isWhite ^= true; // isWhite = !isWhite;
           }
         }
-        i++;
-      }
-      // If we read fully the last section of pixels and filled up our counters -- or filled
-      // the last counter but ran off the side of the image, OK. Otherwise, a problem.
-      if (!(counterPosition == numCounters || (counterPosition == numCounters - 1 && i == end))) {
-        return false;
+        if (x == countersSize) {
+          bestVariance = totalVariance / total;
+          bestMatch = p;
+        }
       }
-      return true;
+      return bestMatch;
     }
 
     OneDReader::~OneDReader() {
@@ -21,14 +21,21 @@
 
 #include <zxing/Reader.h>          // for Reader
 
+#include "zxing/BarcodeFormat.h"   // for BarcodeFormat
 #include "zxing/DecodeHints.h"     // for DecodeHints
 #include "zxing/common/Counted.h"  // for Ref
 #include "zxing/common/Error.hpp"
 
+#include <string>                  // for string
+
 namespace pping {
 class BinaryBitmap;
-class BitArray;
+class DecodeContext;
 class Result;
+namespace oned {
+class RowConsensus;
+class RunLengthRow;
+}  // namespace oned
 }  // namespace pping
 
 namespace pping {
@@ -37,20 +44,59 @@ namespace pping {
         private:
             static const int INTEGER_MATH_SHIFT = 8;
 
-            FallibleRef<Result> doDecode(Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            // consensus is NULL unless rows are combined by vote
+            FallibleRef<Result> doDecode(Ref<BinaryBitmap> image, DecodeHints hints,
+                RowConsensus* consensus) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            // Scans lines at angle, in radians, through (centerX, centerY) and parallel to it
+            FallibleRef<Result> doDecodeAngled(Ref<DecodeContext> context, unsigned char const* luminances,
+                DecodeHints hints, RowConsensus* consensus, float angle, float centerX,
+                float centerY) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            // Adds a decoded row to the vote, and returns the result once the rows agree on a valid text
+            Ref<Result> vote(RowConsensus& consensus, Ref<Result> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+        protected:
+            // Set while rows are combined by vote, see DecodeHints::setConsensusRows
+            bool voting_;
+
         public:
             static const int PATTERN_MATCH_RESULT_SCALE_FACTOR = 1 << INTEGER_MATH_SHIFT;
 
             OneDReader();
             virtual FallibleRef<Result> decode(Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            virtual FallibleRef<Result> decode(Ref<DecodeContext> context, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
 
             // Implementations must not throw any exceptions. If a barcode is not found on this row,
             // a empty ref should be returned e.g. return Ref<Result>();
-            virtual FallibleRef<Result> decodeRow(int rowNumber, Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC = 0;
+            // The row is shared by all readers trying it, so it must not be modified.
+            virtual FallibleRef<Result> decodeRow(int rowNumber, Ref<RunLengthRow> row) MB_NOEXCEPT_EXCEPT_BADALLOC = 0;
+
+            // Tries the runs of a line in both directions, result points are pixels along the line
+            FallibleRef<Result> decodeLine(int rowNumber, Ref<RunLengthRow> runs) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+            // Readers holding other readers pass this on to them
+            virtual void setVoting(bool voting) noexcept;
+
+            /**
+             * Whether text, voted on by the rows, is a valid result of format. Readers that
+             * check a row as a whole, like the UPC/EAN checksum, leave that check out while
+             * voting and apply it here instead. Otherwise the text is only trusted if a single
+             * row read it all, as the rows were checked but a mix of them was not.
+             */
+            virtual bool checkVotedText(BarcodeFormat format, std::string const& text, bool readOnOneRow);
 
             static unsigned int patternMatchVariance(int counters[], int countersSize,
                 const int pattern[], int maxIndividualVariance) noexcept;
-            static bool recordPattern(Ref<BitArray> row, int start, int counters[], int countersCount) noexcept;
+
+            /**
+             * Matches counters against a table of patternCount patterns of countersSize
+             * widths each, stored row after row, and returns the index of the one with
+             * the lowest patternMatchVariance below maxAverageVariance, or -1. All the
+             * patterns have to add up to the same width, so the bar width unit is
+             * worked out once for the whole table, and a pattern is dropped as soon as
+             * it cannot beat the best one so far.
+             */
+            static int findBestPattern(const int counters[], int countersSize, const int* patterns,
+                int patternCount, unsigned int maxAverageVariance, int maxIndividualVariance) noexcept;
             virtual ~OneDReader();
         };
     }
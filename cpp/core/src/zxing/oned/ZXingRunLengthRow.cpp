@@ -0,0 +1,204 @@
+/*
+ *  RunLengthRow.cpp
+ *  ZXing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ZXingRunLengthRow.h"
+
+#include <stdlib.h>                 // for abs
+#include <algorithm>                // for max, min, upper_bound
+#include <limits>                   // for numeric_limits
+
+#include "zxing/common/BitArray.h"  // for BitArray
+
+namespace pping {
+  namespace oned {
+    namespace {
+      // Weakest luminance step taken for a bar edge
+      const int MIN_EDGE_GRADIENT = 8;
+      // Edges weaker than this fraction of the strongest one in the row are ignored
+      const int EDGE_GRADIENT_FRACTION = 5;
+
+      /**
+       * Offset of the extremum of the parabola through the gradients at -1, 0
+       * and 1, in 1/SUBPIXEL_SCALE pixels and within half a pixel of 0.
+       */
+      int parabolaPeakOffset(int before, int peak, int after) noexcept {
+        int curvature = before - 2 * peak + after;
+        if (curvature == 0) {
+          return 0;
+        }
+        int offset = (before - after) * RunLengthRow::SUBPIXEL_SCALE / (2 * curvature);
+        return std::max(-RunLengthRow::SUBPIXEL_SCALE / 2, std::min(RunLengthRow::SUBPIXEL_SCALE / 2, offset));
+      }
+    }
+
+    RunLengthRow::RunLengthRow() : starts_(), scale_(1) {
+    }
+
+    RunLengthRow::RunLengthRow(Ref<BitArray> row) : starts_(), scale_(1) {
+      const int bitsPerWord = std::numeric_limits<unsigned int>::digits;
+      int size = (int)row->getSize();
+      std::vector<unsigned int> const& bits = row->getBitArray();
+
+      starts_.push_back(0);
+      bool black = false;
+      for (int x = 0; x < size;) {
+        unsigned int word = bits[x / bitsPerWord];
+        if (x % bitsPerWord == 0 && word == (black ? ~0u : 0u)) {
+          // A whole word inside the current run
+          x += bitsPerWord;
+          continue;
+        }
+        if ((((word >> (x % bitsPerWord)) & 1) != 0) != black) {
+          starts_.push_back(x);
+          black = !black;
+        }
+        x++;
+      }
+      starts_.push_back(size);
+    }
+
+    Ref<RunLengthRow> RunLengthRow::reversed() const {
+      Ref<RunLengthRow> result(new RunLengthRow());
+      result->scale_ = scale_;
+      std::vector<int>& starts = result->starts_;
+      int size = getSize();
+      int runCount = getRunCount();
+
+      starts.reserve(starts_.size() + 1);
+      starts.push_back(0);
+      if (isBlackRun(runCount - 1)) {
+        // The reversed row has to start with a white run too
+        starts.push_back(0);
+      }
+      for (int run = runCount - 1; run > 0; run--) {
+        if (starts_[run] > 0) {
+          starts.push_back(size - starts_[run]);
+        }
+      }
+      starts.push_back(size);
+      return result;
+    }
+
+    Ref<RunLengthRow> RunLengthRow::fromLuminances(unsigned char const* luminances, int width) {
+      Ref<RunLengthRow> result(new RunLengthRow());
+      std::vector<int>& starts = result->starts_;
+      result->scale_ = SUBPIXEL_SCALE;
+
+      // The gradient between pixels i and i + 1 belongs to the pixel border at i + 1
+      std::vector<int> gradient(std::max(0, width - 1));
+      int maxGradient = 0;
+      for (int i = 0; i + 1 < width; i++) {
+        gradient[i] = (int)luminances[i + 1] - (int)luminances[i];
+        maxGradient = std::max(maxGradient, abs(gradient[i]));
+      }
+      // Ignore sensor noise, and the faint texture around a barcode with strong edges
+      int threshold = std::max(MIN_EDGE_GRADIENT, maxGradient / EDGE_GRADIENT_FRACTION);
+
+      starts.push_back(0);
+      int lastStrength = 0;
+      int count = (int)gradient.size();
+      for (int i = 0; i < count; i++) {
+        int g = gradient[i];
+        int strength = abs(g);
+        if (strength < threshold) {
+          continue;
+        }
+        int before = i > 0 ? gradient[i - 1] : 0;
+        int after = i + 1 < count ? gradient[i + 1] : 0;
+        // Extremum of the gradient, taking the first pixel of a plateau
+        if (g < 0 ? (g > before || g >= after) : (g < before || g <= after)) {
+          continue;
+        }
+        int position = (i + 1) * SUBPIXEL_SCALE + parabolaPeakOffset(before, g, after);
+        // A falling edge starts a black run, so it has to follow a white one
+        bool startsBlack = g < 0;
+        if (!startsBlack && starts.size() == 1) {
+          // The row starts dark, leave run 0 empty
+          starts.push_back(0);
+        }
+        if (isBlackRun((int)starts.size() - 1) == startsBlack) {
+          // Same direction as the previous edge, keep the stronger one
+          if (strength > lastStrength && starts.size() > 1) {
+            starts.back() = std::max(position, starts[starts.size() - 2]);
+            lastStrength = strength;
+          }
+          continue;
+        }
+        starts.push_back(std::max(position, starts.back()));
+        lastStrength = strength;
+      }
+      starts.push_back(std::max(width * SUBPIXEL_SCALE, starts.back()));
+      return result;
+    }
+
+    int RunLengthRow::getRun(int x) const noexcept {
+      return (int)(std::upper_bound(starts_.begin(), starts_.end(), x) - starts_.begin()) - 1;
+    }
+
+    bool RunLengthRow::get(int x) const noexcept {
+      if (x < 0 || x >= getSize()) {
+        return false;
+      }
+      return isBlackRun(getRun(x));
+    }
+
+    int RunLengthRow::getNext(int x, bool value) const noexcept {
+      if (x >= getSize()) {
+        return getSize();
+      }
+      int run = getRun(x);
+      return isBlackRun(run) == value ? x : getRunEnd(run);
+    }
+
+    bool RunLengthRow::isRange(int start, int end, bool value) const noexcept {
+      if (end <= start) {
+        return true;
+      }
+      if (start < 0) {
+        return false;
+      }
+      if (start >= getSize()) {
+        return !value;
+      }
+      int run = getRun(start);
+      if (isBlackRun(run) != value) {
+        return false;
+      }
+      return getRunEnd(run) >= end || (!value && getRunEnd(run) == getSize());
+    }
+
+    bool RunLengthRow::recordPattern(int start, int counters[], int countersCount) const noexcept {
+      for (int i = 0; i < countersCount; i++) {
+        counters[i] = 0;
+      }
+      if (start < 0 || start >= getSize()) {
+        return false;
+      }
+      int run = getRun(start);
+      if (run + countersCount > getRunCount()) {
+        return false;
+      }
+      counters[0] = getRunEnd(run) - start;
+      for (int i = 1; i < countersCount; i++) {
+        counters[i] = getRunWidth(run + i);
+      }
+      return true;
+    }
+  }
+}
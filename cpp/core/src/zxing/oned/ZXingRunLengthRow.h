@@ -0,0 +1,118 @@
+#pragma once
+
+/*
+ *  RunLengthRow.h
+ *  ZXing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/common/Counted.h>  // for Counted, Ref
+
+#include <vector>                  // for vector
+
+namespace pping {
+class BitArray;
+}  // namespace pping
+
+namespace pping {
+  namespace oned {
+
+    /**
+     * A binarized row kept as its alternating white and black runs, built once
+     * per scanned row and shared by all the 1D readers trying it. Positions are
+     * still pixel offsets, but finding the runs around a position does not
+     * visit the pixels in between.
+     *
+     * Run 0 is white and may be empty, so odd runs are the black ones. Pixels
+     * past the end of the row read as white.
+     *
+     * Rows measured on the luminances directly place their edges with sub-pixel
+     * precision. Their offsets count 1/getScale() pixels, which the readers do
+     * not need to know about as long as they only compare widths.
+     */
+    class RunLengthRow : public Counted {
+    private:
+      // starts_[i] is the offset of run i, the last entry is the row width
+      std::vector<int> starts_;
+      int scale_;
+
+      RunLengthRow();
+
+    public:
+      // Offsets per pixel in rows built by fromLuminances
+      static const int SUBPIXEL_SCALE = 8;
+
+      explicit RunLengthRow(Ref<BitArray> row);
+
+      /**
+       * Finds the bar edges of a greyscale row at the extrema of its luminance
+       * gradient, without binarizing it. Each edge is placed between pixels by
+       * fitting a parabola through the gradient around the extremum, so the
+       * widths of blurred narrow bars survive better than with a threshold.
+       */
+      static Ref<RunLengthRow> fromLuminances(unsigned char const* luminances, int width);
+
+      /** The same row read right to left. */
+      Ref<RunLengthRow> reversed() const;
+
+      int getSize() const noexcept {
+        return starts_.back();
+      }
+
+      int getScale() const noexcept {
+        return scale_;
+      }
+
+      int getRunCount() const noexcept {
+        return (int)starts_.size() - 1;
+      }
+
+      int getRunStart(int run) const noexcept {
+        return starts_[run];
+      }
+
+      int getRunEnd(int run) const noexcept {
+        return starts_[run + 1];
+      }
+
+      int getRunWidth(int run) const noexcept {
+        return starts_[run + 1] - starts_[run];
+      }
+
+      static bool isBlackRun(int run) noexcept {
+        return (run & 1) == 1;
+      }
+
+      /** Index of the run holding pixel x, which must lie within the row. */
+      int getRun(int x) const noexcept;
+
+      bool get(int x) const noexcept;
+
+      /** Offset of the first pixel at or after x with the given color, or the row width. */
+      int getNext(int x, bool value) const noexcept;
+
+      /** Whether every pixel from start up to, but excluding, end has the given color. */
+      bool isRange(int start, int end, bool value) const noexcept;
+
+      /**
+       * Fills counters with the widths of the countersCount runs that follow
+       * start, the first of them counted from start itself. The last run may
+       * be cut off by the end of the row; fewer runs than that fail.
+       */
+      bool recordPattern(int start, int counters[], int countersCount) const noexcept;
+    };
+  }
+}
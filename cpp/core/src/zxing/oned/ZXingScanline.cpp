@@ -0,0 +1,176 @@
+/*
+ *  Scanline.cpp
+ *  ZXing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ZXingScanline.h"
+
+#include <zxing/oned/ZXingOneDResultPoint.h>  // for OneDResultPoint
+#include <algorithm>                          // for max, min
+#include <cmath>                              // for atan2, floor, sqrt, fabs
+
+#include "zxing/ResultPoint.h"                // for ResultPoint
+#include "zxing/common/BitArray.h"            // for BitArray
+#include "zxing/common/BitMatrix.h"           // for BitMatrix
+
+namespace pping {
+  namespace oned {
+    namespace {
+      // The image is split into TILES x TILES areas, each checked for parallel edges
+      const int TILES = 8;
+      // Samples taken across each tile in either direction
+      const int SAMPLES_PER_TILE = 16;
+      // Weakest luminance step, over two pixels, counted as an edge
+      const int MIN_EDGE_GRADIENT = 16;
+      // Share of the samples of a tile that have to be on an edge
+      const int MIN_EDGE_SAMPLES_FRACTION = 8;
+      // How well the edges of a tile have to agree on their direction, from 0 to 1
+      const double MIN_COHERENCE = 0.75;
+
+      /** Sums of the gradient structure tensor over one tile. */
+      struct EdgeTensor {
+        double xx;
+        double yy;
+        double xy;
+        int edges;
+
+        double coherence() const noexcept {
+          double energy = xx + yy;
+          return energy > 0.0 ? std::sqrt((xx - yy) * (xx - yy) + 4.0 * xy * xy) / energy : 0.0;
+        }
+
+        double angle() const noexcept {
+          return 0.5 * std::atan2(2.0 * xy, xx - yy);
+        }
+      };
+
+      // Clips t so that start + t * d stays within [0, max]
+      bool clip(float start, float d, float max, float& tMin, float& tMax) noexcept {
+        if (std::fabs(d) < 1e-6f) {
+          return start >= 0.0f && start <= max;
+        }
+        float t1 = -start / d;
+        float t2 = (max - start) / d;
+        tMin = std::max(tMin, std::min(t1, t2));
+        tMax = std::min(tMax, std::max(t1, t2));
+        return true;
+      }
+    }
+
+    Scanline::Scanline(float x, float y, float dx, float dy, int width, int height) noexcept :
+        startX_(x), startY_(y), dx_(dx), dy_(dy), length_(0) {
+      float tMin = -(float)(width + height);
+      float tMax = (float)(width + height);
+      if (!clip(x, dx, (float)(width - 1), tMin, tMax) || !clip(y, dy, (float)(height - 1), tMin, tMax) ||
+          tMax < tMin) {
+        return;
+      }
+      startX_ = x + tMin * dx;
+      startY_ = y + tMin * dy;
+      length_ = (int)std::floor(tMax - tMin) + 1;
+    }
+
+    Ref<BitArray> Scanline::sample(BitMatrix const& matrix) const {
+      Ref<BitArray> row(new BitArray(length_));
+      int maxX = (int)matrix.getWidth() - 1;
+      int maxY = (int)matrix.getHeight() - 1;
+      for (int i = 0; i < length_; i++) {
+        int x = std::min(maxX, std::max(0, (int)(startX_ + (float)i * dx_ + 0.5f)));
+        int y = std::min(maxY, std::max(0, (int)(startY_ + (float)i * dy_ + 0.5f)));
+        if (matrix.get(x, y)) {
+          row->set(i);
+        }
+      }
+      return row;
+    }
+
+    void Scanline::sample(unsigned char const* luminances, int width, int height,
+                          std::vector<unsigned char>& profile) const {
+      profile.resize(length_);
+      for (int i = 0; i < length_; i++) {
+        float x = std::min((float)(width - 1), std::max(0.0f, startX_ + (float)i * dx_));
+        float y = std::min((float)(height - 1), std::max(0.0f, startY_ + (float)i * dy_));
+        int x0 = (int)x;
+        int y0 = (int)y;
+        // Samples on the last column or row have nothing to interpolate with
+        int x1 = std::min(x0 + 1, width - 1);
+        int y1 = std::min(y0 + 1, height - 1);
+        float fx = x - (float)x0;
+        float fy = y - (float)y0;
+        unsigned char const* row0 = luminances + y0 * width;
+        unsigned char const* row1 = luminances + y1 * width;
+        float top = (float)row0[x0] + fx * (float)(row0[x1] - row0[x0]);
+        float bottom = (float)row1[x0] + fx * (float)(row1[x1] - row1[x0]);
+        profile[i] = (unsigned char)(top + fy * (bottom - top) + 0.5f);
+      }
+    }
+
+    Ref<ResultPoint> Scanline::pointAt(float position) const {
+      return Ref<ResultPoint>(new OneDResultPoint(startX_ + position * dx_, startY_ + position * dy_));
+    }
+
+    bool Scanline::estimateBarDirection(unsigned char const* luminances, int width, int height, float& angle,
+                                        float& centerX, float& centerY) {
+      int tileWidth = width / TILES;
+      int tileHeight = height / TILES;
+      if (tileWidth < 3 || tileHeight < 3) {
+        return false;
+      }
+      int stepX = std::max(1, tileWidth / SAMPLES_PER_TILE);
+      int stepY = std::max(1, tileHeight / SAMPLES_PER_TILE);
+
+      double bestScore = 0.0;
+      for (int tileY = 0; tileY < TILES; tileY++) {
+        for (int tileX = 0; tileX < TILES; tileX++) {
+          EdgeTensor tensor = { 0.0, 0.0, 0.0, 0 };
+          int samples = 0;
+          int top = std::max(1, tileY * tileHeight);
+          int bottom = std::min(height - 1, (tileY + 1) * tileHeight);
+          int left = std::max(1, tileX * tileWidth);
+          int right = std::min(width - 1, (tileX + 1) * tileWidth);
+          for (int y = top; y < bottom; y += stepY) {
+            unsigned char const* row = luminances + y * width;
+            for (int x = left; x < right; x += stepX) {
+              samples++;
+              int gx = (int)row[x + 1] - (int)row[x - 1];
+              int gy = (int)row[x + width] - (int)row[x - width];
+              if (gx * gx + gy * gy < MIN_EDGE_GRADIENT * MIN_EDGE_GRADIENT) {
+                continue;
+              }
+              tensor.xx += (double)(gx * gx);
+              tensor.yy += (double)(gy * gy);
+              tensor.xy += (double)(gx * gy);
+              tensor.edges++;
+            }
+          }
+          if (tensor.edges * MIN_EDGE_SAMPLES_FRACTION < samples) {
+            continue;
+          }
+          double coherence = tensor.coherence();
+          double score = coherence * (double)tensor.edges;
+          if (coherence >= MIN_COHERENCE && score > bestScore) {
+            bestScore = score;
+            angle = (float)tensor.angle();
+            centerX = (float)(left + right) / 2.0f;
+            centerY = (float)(top + bottom) / 2.0f;
+          }
+        }
+      }
+      return bestScore > 0.0;
+    }
+  }
+}
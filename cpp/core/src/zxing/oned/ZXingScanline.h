@@ -0,0 +1,80 @@
+#pragma once
+
+/*
+ *  Scanline.h
+ *  ZXing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/common/Counted.h>  // for Ref
+
+#include <vector>                  // for vector
+
+namespace pping {
+class BitArray;
+class BitMatrix;
+class ResultPoint;
+}  // namespace pping
+
+namespace pping {
+  namespace oned {
+
+    /**
+     * A straight line across the image at any angle, clipped to the image and
+     * sampled one pixel step at a time, so 1D barcodes that are not horizontal
+     * can be read without rotating the image.
+     */
+    class Scanline {
+    private:
+      float startX_;
+      float startY_;
+      float dx_;
+      float dy_;
+      int length_;
+
+    public:
+      /**
+       * The part of the line through (x, y) along the unit vector (dx, dy) that
+       * lies within a width x height image.
+       */
+      Scanline(float x, float y, float dx, float dy, int width, int height) noexcept;
+
+      /** Number of samples on the line, 0 if it misses the image. */
+      int getLength() const noexcept {
+        return length_;
+      }
+
+      /** The nearest pixel of the matrix at each sample. */
+      Ref<BitArray> sample(BitMatrix const& matrix) const;
+
+      /** Bilinearly interpolated luminances at each sample. */
+      void sample(unsigned char const* luminances, int width, int height, std::vector<unsigned char>& profile) const;
+
+      /** The image point position samples along the line. */
+      Ref<ResultPoint> pointAt(float position) const;
+
+      /**
+       * Looks for the most uniformly oriented edges in the image, as the bars of
+       * a 1D barcode make them, and returns the direction across them as an
+       * angle in radians from the x axis, within (-pi/2, pi/2], along with the
+       * centre of the area they were found in. Fails when no part of the image
+       * has enough parallel edges.
+       */
+      static bool estimateBarDirection(unsigned char const* luminances, int width, int height, float& angle,
+                                       float& centerX, float& centerY);
+    };
+  }
+}
@@ -25,9 +25,9 @@
 #include "zxing/DecodeHints.h"            // for DecodeHints
 #include "zxing/Result.h"                 // for Result
 #include "zxing/ResultPoint.h"            // for ResultPoint
-#include "zxing/common/BitArray.h"        // for BitArray
 #include "zxing/common/Str.h"             // for String
 #include "zxing/oned/ZXingEAN13Reader.h"  // for EAN13Reader
+#include "zxing/oned/ZXingRunLengthRow.h" // for RunLengthRow
 #include <zxing/ReaderException.h>
 
 namespace pping {
@@ -35,11 +35,11 @@ namespace pping {
     UPCAReader::UPCAReader() : ean13Reader() {
     }
 
-    FallibleRef<Result> UPCAReader::decodeRow(int rowNumber, Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    FallibleRef<Result> UPCAReader::decodeRow(int rowNumber, Ref<RunLengthRow> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
       return maybeReturnResult(ean13Reader.decodeRow(rowNumber, row));
     }
 
-    FallibleRef<Result> UPCAReader::decodeRow(int rowNumber, Ref<BitArray> row, int startGuardBegin,
+    FallibleRef<Result> UPCAReader::decodeRow(int rowNumber, Ref<RunLengthRow> row, int startGuardBegin,
         int startGuardEnd) MB_NOEXCEPT_EXCEPT_BADALLOC {
       return maybeReturnResult(ean13Reader.decodeRow(rowNumber, row, startGuardBegin,
           startGuardEnd));
@@ -49,7 +49,12 @@ namespace pping {
       return maybeReturnResult(ean13Reader.decode(image, hints));
     }
 
-    int UPCAReader::decodeMiddle(Ref<BitArray> row, int startGuardBegin, int startGuardEnd,
+    void UPCAReader::setVoting(bool voting) noexcept {
+      UPCEANReader::setVoting(voting);
+      ean13Reader.setVoting(voting);
+    }
+
+    int UPCAReader::decodeMiddle(Ref<RunLengthRow> row, int startGuardBegin, int startGuardEnd,
         std::string& resultString) {
       return ean13Reader.decodeMiddle(row, startGuardBegin, startGuardEnd, resultString);
     }
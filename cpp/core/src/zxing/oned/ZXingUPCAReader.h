@@ -28,8 +28,10 @@
 
 namespace pping {
 class BinaryBitmap;
-class BitArray;
 class Result;
+namespace oned {
+class RunLengthRow;
+}  // namespace oned
 }  // namespace pping
 
 namespace pping {
@@ -44,14 +46,16 @@ namespace pping {
     public:
       UPCAReader();
 
-      int decodeMiddle(Ref<BitArray> row, int startGuardBegin, int startGuardEnd,
+      int decodeMiddle(Ref<RunLengthRow> row, int startGuardBegin, int startGuardEnd,
           std::string& resultString);
 
-      FallibleRef<Result> decodeRow(int rowNumber, Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
-      FallibleRef<Result> decodeRow(int rowNumber, Ref<BitArray> row, int startGuardBegin,
+      FallibleRef<Result> decodeRow(int rowNumber, Ref<RunLengthRow> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
+      FallibleRef<Result> decodeRow(int rowNumber, Ref<RunLengthRow> row, int startGuardBegin,
           int startGuardEnd) MB_NOEXCEPT_EXCEPT_BADALLOC;
       FallibleRef<Result> decode(Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
 
+      void setVoting(bool voting) noexcept;
+
       BarcodeFormat getBarcodeFormat();
     };
   }
@@ -27,8 +27,8 @@
 #include "zxing/Result.h"                     // for Result
 #include "zxing/ResultPoint.h"                // for ResultPoint
 #include "zxing/common/Array.h"               // for ArrayRef
-#include "zxing/common/BitArray.h"            // for BitArray
 #include "zxing/common/Str.h"                 // for String
+#include "zxing/oned/ZXingRunLengthRow.h"     // for RunLengthRow
 
 namespace pping {
   namespace oned {
@@ -104,19 +104,18 @@ namespace pping {
     }
 
 
-    FallibleRef<Result> UPCEANReader::decodeRow(int rowNumber, Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
+    FallibleRef<Result> UPCEANReader::decodeRow(int rowNumber, Ref<RunLengthRow> row) MB_NOEXCEPT_EXCEPT_BADALLOC {
       int rangeStart;
       int rangeEnd;
-      auto const tryFindPattern( findStartGuardPattern( row, &rangeStart, &rangeEnd ) );
-      if ( tryFindPattern && *tryFindPattern )
+      if (findStartGuardPattern(row, 0, &rangeStart, &rangeEnd))
           return decodeRow(rowNumber, row, rangeStart, rangeEnd);
 
       LOGD("Decoding row %d failed", rowNumber);
       return failure<ReaderException>("Decoding row failed");
     }
 
-    FallibleRef<Result> UPCEANReader::decodeRow(int rowNumber, Ref<BitArray> row, int startGuardBegin,
-                                         int startGuardEnd) {
+    FallibleRef<Result> UPCEANReader::decodeRow(int rowNumber, Ref<RunLengthRow> row, int startGuardBegin,
+                                         int startGuardEnd) MB_NOEXCEPT_EXCEPT_BADALLOC {
       std::string tmpResultString;
       std::string& tmpResultStringRef = tmpResultString;
       int endStart = decodeMiddle(row, startGuardBegin, startGuardEnd, tmpResultStringRef);
@@ -132,16 +131,13 @@ namespace pping {
 
       // Make sure there is a quiet zone at least as big as the end pattern after the barcode.
       // The spec might want more whitespace, but in practice this is the maximum we can count on.
-      size_t quietEnd = endGuardEnd + (endGuardEnd - endGuardBegin);
-      auto const checkRange(row->isRange(endGuardEnd, quietEnd, false));
-      if(!checkRange)
-          return checkRange.error();
-
-      if (quietEnd >= row->getSize() || !(*checkRange)) {
+      int quietEnd = endGuardEnd + (endGuardEnd - endGuardBegin);
+      if (quietEnd >= row->getSize() || !row->isRange(endGuardEnd, quietEnd, false)) {
         return failure<ReaderException>();
       }
 
-      if (!checkChecksum(tmpResultString)) {
+      // While voting, a row with one digit wrong still helps; the voted digits are checked instead
+      if (!voting_ && !checkChecksum(tmpResultString)) {
         return failure<ReaderException>();
       }
 
@@ -159,8 +155,8 @@ namespace pping {
       return Ref<Result>(new Result(resultString, resultBytes, resultPoints, getBarcodeFormat()));
     }
 
-    Fallible<bool> UPCEANReader::findStartGuardPattern(Ref<BitArray> row, int* rangeStart, int* rangeEnd) {
-      int nextStart = 0;
+    bool UPCEANReader::findStartGuardPattern(Ref<RunLengthRow> row, int rowOffset, int* rangeStart, int* rangeEnd) {
+      int nextStart = rowOffset;
       while (findGuardPattern(row, nextStart, false, START_END_PATTERN,
                 (int)(sizeof(START_END_PATTERN) / sizeof(int)), rangeStart, rangeEnd)) {
         int start = *rangeStart;
@@ -169,131 +165,66 @@ namespace pping {
         // If this check would run off the left edge of the image, do not accept this barcode,
         // as it is very likely to be a false positive.
         int quietStart = start - (nextStart - start);
-
-        auto const checkRange(row->isRange( static_cast< size_t >( quietStart ), static_cast< size_t >( start ), false));
-        if(!checkRange)
-            return DisambiguationWrapper{ checkRange.error() };
-
-        if (quietStart >= 0 && (*checkRange)) {
+        if (quietStart < 0) {
+          return false;
+        }
+        if (row->isRange(quietStart, start, false)) {
           return true;
         }
       }
       return false;
     }
 
-    bool UPCEANReader::findGuardPattern(Ref<BitArray> row, int rowOffset, bool whiteFirst,
+    bool UPCEANReader::findGuardPattern(Ref<RunLengthRow> row, int rowOffset, bool whiteFirst,
         const int pattern[], int patternLen, int* start, int* end) {
       int patternLength = patternLen;
-      int *counters = new int[patternLength];
-//      int countersCount = (int)(sizeof(counters) / sizeof(int));
-      for (int i = 0; i < patternLength; i++) { //
-        counters[i] = 0;
-      }
-      int width = (int)row->getSize();
-      bool isWhite = false;
-      while (rowOffset < width) {
-        auto const getAtOffset(row->get(rowOffset));
-        if(!getAtOffset)
-            return false;
-        isWhite = !(*getAtOffset);
-
-        if (whiteFirst == isWhite) {
-          break;
-        }
-        rowOffset++;
+      int counters[MAX_GUARD_PATTERN_LEN];
+      int width = row->getSize();
+      int patternStart = row->getNext(rowOffset, !whiteFirst);
+      if (patternStart >= width) {
+        return false;
       }
 
-      int counterPosition = 0;
-      int patternStart = rowOffset;
-      for (int x = rowOffset; x < width; x++) {
-        auto const getAtX(row->get(x));
-        if(!getAtX)
-            return false;
-        bool pixel = *getAtX;
-
-        if (pixel ^ isWhite) {
-          counters[counterPosition]++;
-        } else {
-          if (counterPosition == patternLength - 1) {
-            if (patternMatchVariance(counters, patternLength, pattern, //
-                MAX_INDIVIDUAL_VARIANCE) < MAX_AVG_VARIANCE) {
-              *start = patternStart;
-              *end = x;
-              delete[] counters;
-              return true;
-            }
-            patternStart += counters[0] + counters[1];
-            for (int y = 2; y < patternLength; y++) {
-              counters[y - 2] = counters[y];
-            }
-            counters[patternLength - 2] = 0;
-            counters[patternLength - 1] = 0;
-            counterPosition--;
-          } else {
-            counterPosition++;
-          }
-          counters[counterPosition] = 1;
-          isWhite = !isWhite;
+      // Slide over the runs two at a time, so the first one keeps its color. The last run of
+      // a match has to end on a color change, not at the end of the row.
+      for (int run = row->getRun(patternStart); run + patternLength < row->getRunCount(); run += 2) {
+        row->recordPattern(patternStart, counters, patternLength);
+        if (patternMatchVariance(counters, patternLength, pattern, //
+            MAX_INDIVIDUAL_VARIANCE) < MAX_AVG_VARIANCE) {
+          *start = patternStart;
+          *end = row->getRunEnd(run + patternLength - 1);
+          return true;
         }
+        patternStart = row->getRunStart(run + 2);
       }
-      delete[] counters;
       return false;
     }
 
-    bool UPCEANReader::decodeEnd(Ref<BitArray> row, int endStart, int* endGuardBegin,
+    bool UPCEANReader::decodeEnd(Ref<RunLengthRow> row, int endStart, int* endGuardBegin,
                                   int* endGuardEnd) {
       return findGuardPattern(row, endStart, false, START_END_PATTERN,
           (int)(sizeof(START_END_PATTERN) / sizeof(int)), endGuardBegin, endGuardEnd);
     }
 
-    int UPCEANReader::decodeDigit(Ref<BitArray> row, int counters[], int countersLen, int rowOffset,
+    int UPCEANReader::decodeDigit(Ref<RunLengthRow> row, int counters[], int countersLen, int rowOffset,
         UPC_EAN_PATTERNS patternType) {
-      if (!recordPattern(row, rowOffset, counters, countersLen)) {
+      if (!row->recordPattern(rowOffset, counters, countersLen)) {
         return -1;
       }
-      unsigned int bestVariance = MAX_AVG_VARIANCE; // worst variance we'll accept
-      int bestMatch = -1;
-
-      int max = 0;
       switch (patternType) {
         case UPC_EAN_PATTERNS_L_PATTERNS:
-          max = L_PATTERNS_LEN;
-          for (int i = 0; i < max; i++) {
-            int *pattern = new int[countersLen];
-            for(int j = 0; j< countersLen; j++){
-              pattern[j] = L_PATTERNS[i][j];
-            }
-
-            unsigned int variance = patternMatchVariance(counters, countersLen, pattern,
-                MAX_INDIVIDUAL_VARIANCE);
-            if (variance < bestVariance) {
-              bestVariance = variance;
-              bestMatch = i;
-            }
-            delete[] pattern;
-          }
-          break;
+          return findBestPattern(counters, countersLen, L_PATTERNS[0], L_PATTERNS_LEN, MAX_AVG_VARIANCE,
+              MAX_INDIVIDUAL_VARIANCE);
         case UPC_EAN_PATTERNS_L_AND_G_PATTERNS:
-          max = L_AND_G_PATTERNS_LEN;
-          for (int i = 0; i < max; i++) {
-            int *pattern = new int[countersLen];
-            for(int j = 0; j< countersLen; j++){
-              pattern[j] = L_AND_G_PATTERNS[i][j];
-            }
-
-            unsigned int variance = patternMatchVariance(counters, countersLen, pattern,
-                MAX_INDIVIDUAL_VARIANCE);
-            if (variance < bestVariance) {
-              bestVariance = variance;
-              bestMatch = i;
-            }
-            delete[] pattern;
-          }
-          break;
+          return findBestPattern(counters, countersLen, L_AND_G_PATTERNS[0], L_AND_G_PATTERNS_LEN,
+              MAX_AVG_VARIANCE, MAX_INDIVIDUAL_VARIANCE);
         default:
-          break;
+          return -1;
       }
-      return bestMatch;
+    }
+
+    bool UPCEANReader::checkVotedText(BarcodeFormat, std::string const& text, bool) {
+      return checkChecksum(text);
     }
 
     /**
@@ -24,8 +24,10 @@
 #include "zxing/common/Counted.h"        // for Ref
 
 namespace pping {
-class BitArray;
 class Result;
+namespace oned {
+class RunLengthRow;
+}  // namespace oned
 }  // namespace pping
 
 typedef enum UPC_EAN_PATTERNS {
@@ -40,15 +42,15 @@ namespace pping {
         private:
             enum {MAX_AVG_VARIANCE = (unsigned int) (PATTERN_MATCH_RESULT_SCALE_FACTOR * 420/1000)};
             enum {MAX_INDIVIDUAL_VARIANCE = (int) (PATTERN_MATCH_RESULT_SCALE_FACTOR * 700/1000)};
+            // Longest pattern findGuardPattern is asked for, the UPC-E end guard
+            enum {MAX_GUARD_PATTERN_LEN = 6};
 
-            static Fallible<bool> findStartGuardPattern(Ref<BitArray> row, int* rangeStart, int* rangeEnd);
-
-            virtual bool decodeEnd(Ref<BitArray> row, int endStart, int* endGuardBegin, int* endGuardEnd);
+            virtual bool decodeEnd(Ref<RunLengthRow> row, int endStart, int* endGuardBegin, int* endGuardEnd);
 
             static bool checkStandardUPCEANChecksum(std::string s);
 
         protected:
-            static bool findGuardPattern(Ref<BitArray> row, int rowOffset, bool whiteFirst,
+            static bool findGuardPattern(Ref<RunLengthRow> row, int rowOffset, bool whiteFirst,
                                           const int pattern[], int patternLen, int* start, int* end);
 
             virtual int getMIDDLE_PATTERN_LEN();
@@ -58,21 +60,28 @@ namespace pping {
             UPCEANReader();
 
             // Returns < 0 on failure, >= 0 on success.
-            virtual int decodeMiddle(Ref<BitArray> row, int startGuardBegin, int startGuardEnd,
+            virtual int decodeMiddle(Ref<RunLengthRow> row, int startGuardBegin, int startGuardEnd,
                                       std::string& resultString) = 0;
 
-            FallibleRef<Result> decodeRow(int rowNumber, Ref<BitArray> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            FallibleRef<Result> decodeRow(int rowNumber, Ref<RunLengthRow> row) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+            // Decodes the row given the start guard found by findStartGuardPattern, so several
+            // readers can share one search.
+            virtual FallibleRef<Result> decodeRow(int rowNumber, Ref<RunLengthRow> row, int startGuardBegin,
+                                  int startGuardEnd) MB_NOEXCEPT_EXCEPT_BADALLOC;
 
-            // TODO(dswitkin): Should this be virtual so that UPCAReader can override it?
-            FallibleRef<Result> decodeRow(int rowNumber, Ref<BitArray> row, int startGuardBegin,
-                                  int startGuardEnd);
+            // Finds the first start guard from rowOffset on that has a quiet zone before it.
+            static bool findStartGuardPattern(Ref<RunLengthRow> row, int rowOffset, int* rangeStart, int* rangeEnd);
 
             // Returns < 0 on failure, >= 0 on success.
-            static int decodeDigit(Ref<BitArray> row, int counters[], int countersLen, int rowOffset,
+            static int decodeDigit(Ref<RunLengthRow> row, int counters[], int countersLen, int rowOffset,
                                     UPC_EAN_PATTERNS patternType);
 
             virtual bool checkChecksum(std::string s);
 
+            // The checksum, left out of the rows while voting
+            bool checkVotedText(BarcodeFormat format, std::string const& text, bool readOnOneRow);
+
             virtual BarcodeFormat getBarcodeFormat() = 0;
             virtual ~UPCEANReader();
         };
@@ -17,8 +17,8 @@
 
 #include "ZXingUPCEReader.h"
 
-#include "zxing/common/BitArray.h"         // for BitArray
 #include "zxing/common/Counted.h"          // for Ref
+#include "zxing/oned/ZXingRunLengthRow.h"  // for RunLengthRow
 #include "zxing/oned/ZXingUPCEANReader.h"  // for UPCEANReader, UPC_EAN_PATTERNS::UPC_EAN_PATTERNS_L_AND_G_PATTERNS
 
 namespace pping {
@@ -43,7 +43,7 @@ namespace pping {
     UPCEReader::UPCEReader() {
     }
 
-    int UPCEReader::decodeMiddle(Ref<BitArray> row, int startGuardBegin, int startGuardEnd,
+    int UPCEReader::decodeMiddle(Ref<RunLengthRow> row, int startGuardBegin, int startGuardEnd,
         std::string& resultString) {
       (void)startGuardBegin;
       const int countersLen = 4;
@@ -74,7 +74,7 @@ namespace pping {
       return rowOffset;
     }
 
-    bool UPCEReader::decodeEnd(Ref<BitArray> row, int endStart, int* endGuardBegin,
+    bool UPCEReader::decodeEnd(Ref<RunLengthRow> row, int endStart, int* endGuardBegin,
         int* endGuardEnd) {
       return findGuardPattern(row, endStart, true, MIDDLE_END_PATTERN,
           (int)(sizeof(MIDDLE_END_PATTERN) / sizeof(int)), endGuardBegin, endGuardEnd);
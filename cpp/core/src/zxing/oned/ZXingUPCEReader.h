@@ -22,8 +22,10 @@
 #include "zxing/BarcodeFormat.h"           // for BarcodeFormat
 
 namespace pping {
-class BitArray;
 template <typename T> class Ref;
+namespace oned {
+class RunLengthRow;
+}  // namespace oned
 }  // namespace pping
 
 namespace pping {
@@ -33,12 +35,12 @@ namespace pping {
     private:
       static bool determineNumSysAndCheckDigit(std::string& resultString, int lgPatternFound);
     protected:
-      bool decodeEnd(Ref<BitArray> row, int endStart, int* endGuardBegin, int* endGuardEnd);
+      bool decodeEnd(Ref<RunLengthRow> row, int endStart, int* endGuardBegin, int* endGuardEnd);
       bool checkChecksum(std::string s);
     public:
       UPCEReader();
 
-      int decodeMiddle(Ref<BitArray> row, int startGuardBegin, int startGuardEnd,
+      int decodeMiddle(Ref<RunLengthRow> row, int startGuardBegin, int startGuardEnd,
           std::string& resultString);
       static std::string convertUPCEtoUPCA(std::string upce);
 
@@ -20,11 +20,13 @@
  */
 
 #include <zxing/qrcode/QRCodeReader.h>
+#include <zxing/qrcode/detector/GreyscaleDetector.h>    // for GreyscaleDetector
 #include <zxing/qrcode/detector/ZXingQRCodeDetector.h>  // for Detector
 
 #include "Log.h"                                        // for LOGV
 #include "zxing/BarcodeFormat.h"                        // for BarcodeFormat::QR_CODE
 #include "zxing/BinaryBitmap.h"                         // for BinaryBitmap
+#include "zxing/DecodeContext.h"                        // for DecodeContext
 #include "zxing/DecodeHints.h"                          // for DecodeHints
 #include "zxing/Result.h"                               // for Result
 #include "zxing/ResultPoint.h"                          // for ResultPoint
@@ -39,6 +41,7 @@
 #ifdef DEBUG
 #include <Utils/stringstreamlite.hpp>
 #endif
+#include <algorithm>                                    // for max, min
 #include <vector>                                       // for allocator, vector
 
 namespace pping {
@@ -46,20 +49,22 @@ namespace pping {
 
         using namespace std;
 
+        namespace {
+            // Smaller image side the greyscale path locates finder patterns at
+            const int GREYSCALE_DETECTION_DIMENSION = 540;
+        }
+
         QRCodeReader::QRCodeReader() noexcept : decoder_() {}
 
         //TODO: see if any of the other files in the qrcode tree need tryHarder
         FallibleRef<Result> QRCodeReader::decode(Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
-            LOGV("decoding image %p", image.object_);
-
-            auto const blackMatrix(image->getBlackMatrix());
-            if (!blackMatrix)
-                return blackMatrix.error();
-            Detector detector(*blackMatrix);
+            return decode(Ref<DecodeContext>(new DecodeContext(image)), hints);
+        }
 
-            LOGV("(1) created detector %p", &detector);
+        FallibleRef<Result> QRCodeReader::decode(Ref<DecodeContext> context, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+            LOGV("decoding image %p", context->getImage().object_);
 
-            auto const detectorResult(detector.detect(hints));
+            auto const detectorResult(hints.getGreyscaleSampling() ? detectGreyscale(context, hints) : detect(context, hints));
             if(!detectorResult)
                 return detectorResult.error();
 
@@ -79,7 +84,7 @@ namespace pping {
             LOGV("bits:\n%s", ss.str().c_str());
 #endif
 
-            auto const decoderResult(decoder_.decode((*detectorResult)->getBits()));
+            auto const decoderResult(decoder_.decode((*detectorResult)->getBits(), (*detectorResult)->getModuleSamples()));
             if (!decoderResult)
                 return decoderResult.error();
             LOGV("(4) decoded, have decoderResult %p", decoderResult->object_);
@@ -91,6 +96,34 @@ namespace pping {
             return result;
         }
 
+        FallibleRef<DetectorResult> QRCodeReader::detect(Ref<DecodeContext> context, DecodeHints const& hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+            auto const blackMatrix(context->getBlackMatrix());
+            if (!blackMatrix)
+                return blackMatrix.error();
+            Detector detector(*blackMatrix);
+
+            LOGV("(1) created detector %p", &detector);
+
+            return detector.detect(hints);
+        }
+
+        FallibleRef<DetectorResult> QRCodeReader::detectGreyscale(Ref<DecodeContext> context, DecodeHints const& hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+            // Binarize a copy small enough to keep the finder patterns of a
+            // code filling a fair part of the frame a few pixels wide.
+            Ref<BinaryBitmap> image(context->getImage());
+            int scale = std::max(1, std::min(image->getWidth(), image->getHeight()) / GREYSCALE_DETECTION_DIMENSION);
+            Ref<DecodeContext> coarse(context->getDownscaled(scale));
+
+            auto const blackMatrix(coarse->getBlackMatrix());
+            if (!blackMatrix)
+                return blackMatrix.error();
+            GreyscaleDetector detector(*blackMatrix, image->getLuminanceSource(), scale);
+
+            LOGV("(1) created greyscale detector %p at scale %d", &detector, scale);
+
+            return detector.detect(hints);
+        }
+
     Decoder& QRCodeReader::getDecoder() {
         return decoder_;
     }
@@ -28,6 +28,8 @@
 
 namespace pping {
 class BinaryBitmap;
+class DecodeContext;
+class DetectorResult;
 class Result;
 }  // namespace pping
 
@@ -37,13 +39,17 @@ namespace pping {
         class QRCodeReader : public Reader {
         private:
             Decoder decoder_;
-            
+
+            FallibleRef<DetectorResult> detect(Ref<DecodeContext> context, DecodeHints const& hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
+            FallibleRef<DetectorResult> detectGreyscale(Ref<DecodeContext> context, DecodeHints const& hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
     protected:
       Decoder& getDecoder();
 
         public:
             QRCodeReader() noexcept;
             virtual FallibleRef<Result> decode(Ref<BinaryBitmap> image, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC override;
+            virtual FallibleRef<Result> decode(Ref<DecodeContext> context, DecodeHints hints) MB_NOEXCEPT_EXCEPT_BADALLOC override;
         };
     }
 }
@@ -24,14 +24,47 @@
 #include "zxing/ReaderException.h"            // for ReaderException
 #include "zxing/common/Array.h"               // for ArrayRef
 #include "zxing/common/BitMatrix.h"           // for BitMatrix
+#include "zxing/common/ByteMatrix.h"          // for ByteMatrix
 #include "zxing/common/Counted.h"             // for Ref
 #include "zxing/qrcode/FormatInformation.h"   // for FormatInformation
 #include "zxing/qrcode/ZXingQRCodeVersion.h"  // for Version
 
+#include <algorithm>                          // for min
+
 
 namespace pping {
 namespace qrcode {
 
+namespace {
+  /**
+   * Calls visit(x, y) for every module not covered by the function pattern,
+   * in the order the codeword bits are placed in the symbol.
+   */
+  template <typename Visitor>
+  void forEachDataModule(int dimension, BitMatrix& functionPattern, Visitor visit) {
+    bool readingUp = true;
+    // Read columns in pairs, from right to left
+    for (int x = dimension - 1; x > 0; x -= 2) {
+      if (x == 6) {
+        // Skip whole column with vertical alignment pattern;
+        // saves time and makes the other code proceed more cleanly
+        x--;
+      }
+      // Read alternatingly from bottom to top then top to bottom
+      for (int counter = 0; counter < dimension; counter++) {
+        int y = readingUp ? dimension - 1 - counter : counter;
+        for (int col = 0; col < 2; col++) {
+          // Ignore bits covered by the function pattern
+          if (!functionPattern.get(x - col, y)) {
+            visit(x - col, y);
+          }
+        }
+      }
+      readingUp = !readingUp; // switch directions
+    }
+  }
+}
+
 int BitMatrixParser::copyBit(size_t x, size_t y, int versionBits) {
   return bitMatrix_->get(x, y) ? (versionBits << 1) | 0x1 : versionBits << 1;
 }
@@ -167,41 +200,58 @@ Fallible<ArrayRef<unsigned char>> BitMatrixParser::readCodewords() {
 
   //	cout << *functionPattern << endl;
 
-  bool readingUp = true;
   ArrayRef<unsigned char> result((*version)->getTotalCodewords());
   int resultOffset = 0;
   int currentByte = 0;
   int bitsRead = 0;
-  // Read columns in pairs, from right to left
-  for (int x = dimension - 1; x > 0; x -= 2) {
-    if (x == 6) {
-      // Skip whole column with vertical alignment pattern;
-      // saves time and makes the other code proceed more cleanly
-      x--;
+  forEachDataModule(dimension, *functionPattern, [&](int x, int y) {
+    // Read a bit
+    bitsRead++;
+    currentByte <<= 1;
+    if (bitMatrix_->get(x, y)) {
+      currentByte |= 1;
     }
-    // Read alternatingly from bottom to top then top to bottom
-    for (int counter = 0; counter < dimension; counter++) {
-      int y = readingUp ? dimension - 1 - counter : counter;
-      for (int col = 0; col < 2; col++) {
-        // Ignore bits covered by the function pattern
-        if (!functionPattern->get(x - col, y)) {
-          // Read a bit
-          bitsRead++;
-          currentByte <<= 1;
-          if (bitMatrix_->get(x - col, y)) {
-            currentByte |= 1;
-          }
-          // If we've made a whole byte, save it off
-          if (bitsRead == 8) {
-            result[resultOffset++] = (unsigned char)currentByte;
-            bitsRead = 0;
-            currentByte = 0;
-          }
-        }
-      }
+    // If we've made a whole byte, save it off
+    if (bitsRead == 8) {
+      result[resultOffset++] = (unsigned char)currentByte;
+      bitsRead = 0;
+      currentByte = 0;
     }
-    readingUp = !readingUp; // switch directions
+  });
+
+  if (resultOffset != (*version)->getTotalCodewords()) {
+    return failure<ReaderException>("Did not read all codewords");
   }
+  return result;
+}
+
+Fallible<ArrayRef<unsigned char>> BitMatrixParser::readCodewordConfidence(ByteMatrix const& moduleConfidence) {
+  auto const version = readVersion();
+  if (!version)
+      return version.error();
+
+  int dimension = (int)bitMatrix_->getDimension();
+  if ((int)moduleConfidence.getDimension() != dimension)
+      return failure<ReaderException>("Module confidence does not match the bit matrix");
+
+  auto const getFunctionPattern((*version)->buildFunctionPattern());
+  if(!getFunctionPattern)
+      return getFunctionPattern.error();
+
+  Ref<BitMatrix> functionPattern = *getFunctionPattern;
+
+  ArrayRef<unsigned char> result((*version)->getTotalCodewords());
+  int resultOffset = 0;
+  int bitsRead = 0;
+  unsigned char weakest = 0xff;
+  forEachDataModule(dimension, *functionPattern, [&](int x, int y) {
+    weakest = std::min(weakest, moduleConfidence.get(x, y));
+    if (++bitsRead == 8) {
+      result[resultOffset++] = weakest;
+      bitsRead = 0;
+      weakest = 0xff;
+    }
+  });
 
   if (resultOffset != (*version)->getTotalCodewords()) {
     return failure<ReaderException>("Did not read all codewords");
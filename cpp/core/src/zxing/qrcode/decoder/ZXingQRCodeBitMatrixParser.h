@@ -27,6 +27,8 @@
 #include <zxing/qrcode/FormatInformation.h>  // for FormatInformation
 
 namespace pping {
+class ByteMatrix;
+
 namespace qrcode {
 
 class Version;
@@ -45,6 +47,11 @@ public:
   FallibleRef<FormatInformation> readFormatInformation() MB_NOEXCEPT_EXCEPT_BADALLOC;
   Fallible<Version *> readVersion() noexcept;
   Fallible<ArrayRef<unsigned char>> readCodewords();
+  /**
+   * For each codeword, in the order readCodewords returns them, the lowest
+   * confidence of the modules it was read from.
+   */
+  Fallible<ArrayRef<unsigned char>> readCodewordConfidence(ByteMatrix const& moduleConfidence);
 
   Fallible<void>    remask();
   void              mirror();
@@ -19,9 +19,8 @@
  * limitations under the License.
  */
 
-#include "zxing/common/Array.h"    // for ArrayRef
-#include "zxing/common/Counted.h"  // for Counted
 #include "zxing/common/Error.hpp"
+#include "zxing/common/Span.h"     // for Span
 
 #include <vector>                  // for vector
 
@@ -31,19 +30,28 @@ namespace qrcode {
 class ErrorCorrectionLevel;
 class Version;
 
-class DataBlock : public Counted {
+/**
+ * The codewords of one error correction block, viewed in a buffer that holds
+ * all blocks of the symbol one after another.
+ */
+class DataBlock {
 private:
   int numDataCodewords_;
-  ArrayRef<unsigned char> codewords_;
+  Span<unsigned char> codewords_;
 
-  DataBlock(int numDataCodewords, ArrayRef<unsigned char> codewords) noexcept;
+  DataBlock(int numDataCodewords, Span<unsigned char> codewords) noexcept;
 
 public:
-  static Fallible<std::vector<Ref<DataBlock> >>
-  getDataBlocks(ArrayRef<unsigned char> rawCodewords, Version *version, ErrorCorrectionLevel &ecLevel) MB_NOEXCEPT_EXCEPT_BADALLOC;
-
-  int getNumDataCodewords();
-  ArrayRef<unsigned char> getCodewords();
+  /**
+   * De-interleaves rawCodewords into buffer, which must be as long, and
+   * returns the blocks viewing it.
+   */
+  static Fallible<std::vector<DataBlock> >
+  getDataBlocks(Span<unsigned char const> rawCodewords, Span<unsigned char> buffer, Version *version,
+                ErrorCorrectionLevel &ecLevel) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+  int getNumDataCodewords() const noexcept;
+  Span<unsigned char> getCodewords() const noexcept;
 };
 
 }
@@ -21,17 +21,11 @@
 
 #include <zxing/FormatException.h>                  // for FormatException
 #include <zxing/common/CharacterSetECI.h>           // for CharacterSetECI
-#include <zxing/common/StringUtils.h>               // for StringUtils, pping::common::StringUtils::ASCII, pping::common::StringUtils::GB2312, pping::common::StringUtils::SHIFT_JIS, pping::common::StringUtils::UTF8
+#include <zxing/common/StringUtils.h>               // for StringUtils, pping::common::StringUtils::ASCII, pping::common::StringUtils::GB2312, pping::common::StringUtils::SHIFT_JIS
 #include <zxing/qrcode/decoder/ZXingQRCodeDecodedBitStreamParser.h>
 #include <string>                                   // for basic_string, char_traits, allocator
 #include <vector>                                   // for vector
 
-#ifndef NO_ICONV
-#   include "Wrappers/Iconv.hpp"                    // for iconv_close, iconv, iconv_open, iconv_t
-#   ifdef __APPLE__
-#       include <TargetConditionals.h>
-#   endif
-#endif
 #include "zxing/ReaderException.h"                  // for ReaderException
 #include "zxing/common/Array.h"                     // for ArrayRef, Array
 #include "zxing/common/BitSource.h"                 // for BitSource
@@ -52,14 +46,6 @@ class Version;
 }  // namespace pping
 
 
-#ifndef NO_ICONV
-#   if TARGET_OS_IPHONE || defined( __EMSCRIPTEN__ )
-#       define ICONV_CONST
-#   else
-#       define ICONV_CONST const
-#   endif
-#endif
-
 using namespace std;
 using namespace pping;
 using namespace pping::qrcode;
@@ -83,45 +69,8 @@ Fallible<void> DecodedBitStreamParser::append(std::string &result,
 Fallible<void> DecodedBitStreamParser::append(std::string &result,
                                     const unsigned char *bufIn,
                                     size_t nIn,
-                                    [[maybe_unused]] const char *src) {
-#ifndef NO_ICONV
-  if (nIn == 0) {
-    return success(); // ???
-  }
-
-  iconv_t cd = iconv_open(pping::common::StringUtils::UTF8, src);
-  if (cd == (iconv_t)-1) {
-    result.append((const char *)bufIn, nIn);
-    return success();
-  }
-
-  const int maxOut = 4 * (int)nIn + 1;
-  unsigned char* bufOut = new unsigned char[maxOut];
-
-  size_t nFrom = nIn;
-  char *toPtr = (char *)bufOut;
-  size_t nTo = maxOut;
-
-  while (nFrom > 0) {
-    ICONV_CONST char *fromPtr = (ICONV_CONST char *)bufIn;
-    size_t oneway = iconv(cd, &fromPtr, &nFrom, &toPtr, &nTo);
-    if (oneway == (size_t)(-1)) {
-      iconv_close(cd);
-      delete[] bufOut;
-      return failure<ReaderException>("Error converting characters");
-    }
-  }
-  iconv_close(cd);
-
-  int nResult = maxOut - (int)nTo;
-  bufOut[nResult] = '\0';
-  result.append((const char *)bufOut, static_cast<size_t>(nResult));
-  delete[] bufOut;
-#else
-  result.append((const char *)bufIn, nIn);
-#endif
-
-  return success();
+                                    const char *src) {
+  return StringUtils::appendAsUtf8(result, bufIn, nIn, src);
 }
 
 Fallible<void> DecodedBitStreamParser::decodeHanziSegment(Ref<BitSource> bits_,
@@ -29,8 +29,11 @@
 
 #include "zxing/common/Array.h"                                      // for ArrayRef, Array
 #include "zxing/common/BitMatrix.h"                                  // for BitMatrix
+#include "zxing/common/ByteMatrix.h"                                 // for ByteMatrix
 #include "zxing/common/Counted.h"                                    // for Ref
 #include "zxing/common/DecoderResult.h"                              // for DecoderResult
+#include "zxing/common/ModuleSamples.h"                              // for ModuleSamples
+#include "zxing/common/Span.h"                                       // for Span
 #include "zxing/common/reedsolomon/GenericGF.h"                      // for GenericGF, GenericGF::QR_CODE_FIELD_256
 #include "zxing/common/reedsolomon/ReedSolomonDecoder.h"             // for ReedSolomonDecoder
 #include "zxing/qrcode/FormatInformation.h"                          // for FormatInformation
@@ -47,15 +50,14 @@ Decoder::Decoder() noexcept:
     rsDecoder_(GenericGF::QR_CODE_FIELD_256) {
 }
 
-Fallible<void> Decoder::correctErrors(ArrayRef<unsigned char> codewordBytes, int numDataCodewords) MB_NOEXCEPT_EXCEPT_BADALLOC {
-  int numCodewords = (int)codewordBytes->size();
-  ArrayRef<int> codewordInts(numCodewords);
-  for (int i = 0; i < numCodewords; i++) {
-    codewordInts[i] = codewordBytes[i] & 0xff;
-  }
+Fallible<void> Decoder::correctErrors(Span<unsigned char> codewordBytes, int numDataCodewords,
+                                      std::vector<int> const& erasures,
+                                      std::vector<int>& codewordInts) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  int numCodewords = (int)codewordBytes.size();
+  codewordInts.assign(codewordBytes.begin(), codewordBytes.end());
   int numECCodewords = numCodewords - numDataCodewords;
 
-  const auto decoderResult(rsDecoder_.decode(codewordInts, numECCodewords));
+  const auto decoderResult(rsDecoder_.decode(Span<int>(codewordInts), numECCodewords, erasures));
   if(!decoderResult) {
       return decoderResult.error();
   }
@@ -67,7 +69,7 @@ Fallible<void> Decoder::correctErrors(ArrayRef<unsigned char> codewordBytes, int
   return success();
 }
 
-FallibleRef<DecoderResult> Decoder::decodeWithParser(Ref<BitMatrixParser> parser)
+FallibleRef<DecoderResult> Decoder::decodeWithParser(Ref<BitMatrixParser> parser, Ref<ByteMatrix> moduleConfidence)
 {
     auto const version(parser->readVersion());
     if (!version)
@@ -84,28 +86,66 @@ FallibleRef<DecoderResult> Decoder::decodeWithParser(Ref<BitMatrixParser> parser
     if (!codewords)
         return codewords.error();
 
-    // Separate into data blocks
-    auto const dataBlocks(DataBlock::getDataBlocks(*codewords, *version, ecLevel));
+    // Separate into data blocks, all of them viewing one buffer
+    ArrayRef<unsigned char> rawCodewords(*codewords);
+    std::vector<unsigned char> blockBuffer(rawCodewords.size());
+    auto const dataBlocks(DataBlock::getDataBlocks(Span<unsigned char const>(rawCodewords), Span<unsigned char>(blockBuffer),
+                                                   *version, ecLevel));
     if(!dataBlocks)
         return dataBlocks.error();
 
+    // Split the confidence of each codeword the same way
+    std::vector<unsigned char> confidenceBuffer;
+    std::vector<DataBlock> confidenceBlocks;
+    if (moduleConfidence) {
+        auto const codewordConfidence(parser->readCodewordConfidence(*moduleConfidence));
+        if (!codewordConfidence)
+            return codewordConfidence.error();
+
+        ArrayRef<unsigned char> rawConfidence(*codewordConfidence);
+        confidenceBuffer.resize(rawConfidence.size());
+        auto const tryGetConfidenceBlocks(DataBlock::getDataBlocks(Span<unsigned char const>(rawConfidence),
+                                                                   Span<unsigned char>(confidenceBuffer),
+                                                                   *version, ecLevel));
+        if (!tryGetConfidenceBlocks)
+            return tryGetConfidenceBlocks.error();
+
+        confidenceBlocks = *tryGetConfidenceBlocks;
+    }
+
     // Count total number of data bytes
   int totalBytes = 0;
+  std::vector<Span<unsigned char const> > blockCodewords;
+  std::vector<int> blockECCodewords;
   for (size_t i = 0; i < (*dataBlocks).size(); i++) {
-    totalBytes += (*dataBlocks)[i]->getNumDataCodewords();
+    totalBytes += (*dataBlocks)[i].getNumDataCodewords();
+    blockCodewords.push_back((*dataBlocks)[i].getCodewords());
+    blockECCodewords.push_back((int)blockCodewords.back().size() - (*dataBlocks)[i].getNumDataCodewords());
     }
     ArrayRef<unsigned char> resultBytes(totalBytes);
     int resultOffset = 0;
 
+    // Check all blocks at once; most of them usually need no correcting
+    auto const corruptBlocks(rsDecoder_.findCorruptBlocks(blockCodewords, blockECCodewords));
+    if (!corruptBlocks)
+        return corruptBlocks.error();
+
 
     // Error-correct and copy data blocks together into a stream of bytes
+  std::vector<int> codewordInts;
   for (size_t j = 0; j < (*dataBlocks).size(); j++) {
-    Ref<DataBlock> dataBlock((*dataBlocks)[j]);
-      ArrayRef<unsigned char> codewordBytes = dataBlock->getCodewords();
-      int numDataCodewords = dataBlock->getNumDataCodewords();
-      auto const success(correctErrors(codewordBytes, numDataCodewords));
-      if (!success)
-          return success.error();
+    DataBlock const& dataBlock((*dataBlocks)[j]);
+      Span<unsigned char> codewordBytes = dataBlock.getCodewords();
+      int numDataCodewords = dataBlock.getNumDataCodewords();
+      if ((*corruptBlocks)[j]) {
+        std::vector<int> erasures;
+        if (!confidenceBlocks.empty()) {
+          erasures = ModuleSamples::selectErasures(confidenceBlocks[j].getCodewords(), blockECCodewords[j]);
+        }
+        auto const success(correctErrors(codewordBytes, numDataCodewords, erasures, codewordInts));
+        if (!success)
+            return success.error();
+      }
 
       for (int i = 0; i < numDataCodewords; i++) {
         resultBytes[resultOffset++] = codewordBytes[i];
@@ -141,6 +181,31 @@ FallibleRef<DecoderResult> Decoder::decode(Ref<BitMatrix> bits) MB_NOEXCEPT_EXCE
 
 }
 
+FallibleRef<DecoderResult> Decoder::decode(Ref<BitMatrix> bits, Ref<ModuleSamples> samples) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  auto const tryDecode(decode(bits));
+  if (tryDecode)
+      return *tryDecode;
+  if (samples.empty())
+      return tryDecode.error();
+
+  // Retry on the samples the bits came from. bits has been unmasked and
+  // possibly mirrored by now, so threshold them again from scratch.
+  auto const tryCreateParser(BitMatrixParser::createBitMatrixParser(samples->threshold(0)));
+  if (tryCreateParser) {
+      auto const tryDecodeErasures(decodeWithParser(*tryCreateParser, samples->getConfidence()));
+      if (tryDecodeErasures)
+          return *tryDecodeErasures;
+  }
+
+  for (int bias : { -ModuleSamples::RETHRESHOLD_BIAS, +ModuleSamples::RETHRESHOLD_BIAS }) {
+      auto const tryRethreshold(decode(samples->threshold(bias)));
+      if (tryRethreshold)
+          return *tryRethreshold;
+  }
+
+  return tryDecode.error();
+}
+
 } // namespace qrcode
 
 } // namespace pping
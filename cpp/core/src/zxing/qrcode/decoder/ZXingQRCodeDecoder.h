@@ -20,14 +20,19 @@
  */
 
 #include <zxing/common/Array.h>                           // for ArrayRef
+#include <zxing/common/ByteMatrix.h>                      // for ByteMatrix
 #include <zxing/common/Counted.h>                         // for Ref
 #include <zxing/common/Error.hpp>
+#include <zxing/common/Span.h>                            // for Span
 #include <zxing/common/reedsolomon/ReedSolomonDecoder.h>  // for ReedSolomonDecoder
 
+#include <vector>                                         // for vector
+
 namespace pping {
 class BitMatrix;
 class DecoderResult;
 class BitMatrixParser;
+class ModuleSamples;
 }  // namespace pping
 
 namespace pping {
@@ -37,13 +42,21 @@ class Decoder {
 private:
   ReedSolomonDecoder rsDecoder_;
 
-  Fallible<void> correctErrors(ArrayRef<unsigned char> bytes, int numDataCodewords) MB_NOEXCEPT_EXCEPT_BADALLOC;
+  /** codewordInts is scratch space, reused for every block of a symbol. */
+  Fallible<void> correctErrors(Span<unsigned char> bytes, int numDataCodewords, std::vector<int> const& erasures,
+                               std::vector<int>& codewordInts) MB_NOEXCEPT_EXCEPT_BADALLOC;
 
-  FallibleRef<DecoderResult> decodeWithParser(Ref<BitMatrixParser> parser);
+  FallibleRef<DecoderResult> decodeWithParser(Ref<BitMatrixParser> parser, Ref<ByteMatrix> moduleConfidence = Ref<ByteMatrix>());
 
 public:
   Decoder() noexcept;
   FallibleRef<DecoderResult> decode(Ref<BitMatrix> bits) MB_NOEXCEPT_EXCEPT_BADALLOC;
+  /**
+   * Like decode(bits), but if error correction fails, retries on the
+   * greyscale samples bits were thresholded from: first with the codewords
+   * read from unreliable modules erased, then with shifted thresholds.
+   */
+  FallibleRef<DecoderResult> decode(Ref<BitMatrix> bits, Ref<ModuleSamples> samples) MB_NOEXCEPT_EXCEPT_BADALLOC;
 };
 
 }
@@ -18,18 +18,15 @@
 #include <float.h>                                           // for FLT_MAX
 #include <math.h>                                            // for fabsf, sqrt
 #include <algorithm>                                         // for max
-#include <vector>                                            // for vector, allocator
 
 #include "FinderPatternAnalizator.hpp"
-#include "zxing/common/Counted.h"                            // for Ref
-#include "zxing/qrcode/detector/ZXingQRCodeFinderPattern.h"  // for FinderPattern
 
 namespace pping {
 
 namespace qrcode {
 
-ZXingFinderPatternVector::ZXingFinderPatternVector(const Ref<FinderPattern> from, const Ref<FinderPattern> to) :
-        x_(to->getX() - from->getX()), y_(to->getY() - from->getY()){
+ZXingFinderPatternVector::ZXingFinderPatternVector(float fromX, float fromY, float toX, float toY) :
+        x_(toX - fromX), y_(toY - fromY){
     norm_ = (float)sqrt(x_ * x_ + y_ * y_);
 }
 
@@ -37,7 +34,7 @@ ZXingFinderPatternVector::~ZXingFinderPatternVector(){
     // nothing to do
 }
 
-float ZXingFinderPatternVector::getNorm(){
+float ZXingFinderPatternVector::getNorm() const {
     return norm_;
 }
 
@@ -55,14 +52,16 @@ FinderPatternAnalizator::~FinderPatternAnalizator(){
     // nothing to do
 }
 
-float FinderPatternAnalizator::analize(const Ref<FinderPattern> first, const Ref<FinderPattern> second, const Ref<FinderPattern> third){
-    std::vector<ZXingFinderPatternVector> triangle;
-    triangle.push_back(ZXingFinderPatternVector(first, second));
-    triangle.push_back(ZXingFinderPatternVector(second, third));
-    triangle.push_back(ZXingFinderPatternVector(third, first));
+float FinderPatternAnalizator::analize(float firstX, float firstY, float secondX, float secondY, float thirdX, float thirdY){
+    // Called for every triple of candidates, so the sides stay on the stack
+    ZXingFinderPatternVector const triangle[3] = {
+        ZXingFinderPatternVector(firstX, firstY, secondX, secondY),
+        ZXingFinderPatternVector(secondX, secondY, thirdX, thirdY),
+        ZXingFinderPatternVector(thirdX, thirdY, firstX, firstY)
+    };
 
     float error = FLT_MAX;
-    for (int i = 0; i < (int) triangle.size(); ++i){
+    for (int i = 0; i < 3; ++i){
 
         float angleError = fabsf(triangle[i].getCosinusAngle(triangle[(i+1)%3]));
 
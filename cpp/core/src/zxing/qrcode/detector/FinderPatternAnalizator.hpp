@@ -17,23 +17,17 @@
 
 #pragma once
 
-namespace pping {
-template <typename T> class Ref;
-}  // namespace pping
-
 namespace pping {
 
 namespace qrcode {
 
-class FinderPattern;
-
 class ZXingFinderPatternVector{
 public:
-    ZXingFinderPatternVector(const Ref<FinderPattern> from, const Ref<FinderPattern> to);
+    ZXingFinderPatternVector(float fromX, float fromY, float toX, float toY);
 
     ~ZXingFinderPatternVector();
 
-    float getNorm();
+    float getNorm() const;
 
     float getCosinusAngle(const ZXingFinderPatternVector &other) const;
 
@@ -51,7 +45,8 @@ public:
 
     ~FinderPatternAnalizator();
 
-    static float analize(const Ref<FinderPattern> first, const Ref<FinderPattern> second, const Ref<FinderPattern> third);
+    /** The centers are passed by coordinates, as the finder keeps its candidates by value. */
+    static float analize(float firstX, float firstY, float secondX, float secondY, float thirdX, float thirdY);
 };
 
 } /* namespace qrcode */
@@ -0,0 +1,164 @@
+// -*- mode:c++; tab-width:2; indent-tabs-mode:nil; c-basic-offset:2 -*-
+/*
+ *  GreyscaleDetector.cpp
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/common/GridSampler.h>                   // for GridSampler
+#include <zxing/qrcode/detector/GreyscaleDetector.h>
+#include <algorithm>                                    // for max
+#include <cmath>                                        // for abs
+#include <vector>                                       // for vector
+
+#include "zxing/DecodeHints.h"                          // for DecodeHints
+#include "zxing/ReaderException.h"                      // for ReaderException
+#include "zxing/ResultPoint.h"                          // for ResultPoint
+#include "zxing/common/BitMatrix.h"                     // for BitMatrix
+#include "zxing/common/ByteMatrix.h"                    // for ByteMatrix
+#include "zxing/common/Counted.h"                       // for Ref
+#include "zxing/common/DetectorResult.h"                // for DetectorResult
+#include "zxing/common/ModuleSamples.h"                 // for ModuleSamples
+#include "zxing/common/PerspectiveTransform.h"          // for PerspectiveTransform
+#include "zxing/common/ThresholdPlane.h"                // for ThresholdPlane
+#include "zxing/qrcode/detector/ZXingQRCodeDetector.h"  // for Detector
+
+namespace pping {
+namespace qrcode {
+
+namespace {
+  /**
+   * Adds the threshold halfway between the black and white modules of the
+   * finder pattern whose top left module is at (left, top). Returns the
+   * contrast observed, or a negative value if the pattern is not there.
+   */
+  int addFinderPattern(ByteMatrix const& samples, int left, int top, ThresholdPlane& plane) noexcept {
+    int black = 0;
+    int blackCount = 0;
+    int white = 0;
+    int whiteCount = 0;
+    for (int y = 0; y < 7; y++) {
+      for (int x = 0; x < 7; x++) {
+        int ring = std::max(std::abs(x - 3), std::abs(y - 3));
+        int sample = samples.get(left + x, top + y);
+        if (ring == 2) {
+          white += sample;
+          whiteCount++;
+        } else {
+          black += sample;
+          blackCount++;
+        }
+      }
+    }
+    black /= blackCount;
+    white /= whiteCount;
+    if (!plane.addPair(left + 3, top + 3, black, white, blackCount + whiteCount)) {
+      return -1;
+    }
+    return white - black;
+  }
+
+  /** Adds one threshold per black/white pair of the timing patterns. */
+  void addTimingPatterns(ByteMatrix const& samples, ThresholdPlane& plane) noexcept {
+    int dimension = (int)samples.getDimension();
+    for (int i = 8; i + 1 <= dimension - 9; i += 2) {
+      plane.addPair(i, 6, samples.get(i, 6), samples.get(i + 1, 6), 2);
+      plane.addPair(6, i, samples.get(6, i), samples.get(6, i + 1), 2);
+    }
+  }
+}
+
+GreyscaleDetector::GreyscaleDetector(Ref<BitMatrix> image, Ref<LuminanceSource> source, int scale) noexcept :
+    Detector(image), source_(source), scale_(scale) {
+}
+
+FallibleRef<DetectorResult> GreyscaleDetector::detect(DecodeHints const& hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  DecodeHints coarseHints(hints);
+  if (scale_ > 1 && !hints.getTrackedResultPoints().empty()) {
+    // Tracked points come in full resolution coordinates
+    std::vector<Ref<ResultPoint> > tracked;
+    for (auto const & point : hints.getTrackedResultPoints()) {
+      tracked.push_back(Ref<ResultPoint>(new ResultPoint(point->getX() / (float)scale_, point->getY() / (float)scale_)));
+    }
+    coarseHints.setTrackedResultPoints(tracked);
+  }
+
+  auto const detectorResult(Detector::detect(coarseHints));
+  if (!detectorResult)
+    return detectorResult.error();
+  if (scale_ == 1) {
+    (*detectorResult)->setModuleSamples(moduleSamples_);
+    return *detectorResult;
+  }
+
+  // Report the points in the coordinates of the full resolution frame
+  std::vector<Ref<ResultPoint> > points;
+  for (auto const & point : (*detectorResult)->getPoints()) {
+    points.push_back(Ref<ResultPoint>(new ResultPoint(point->getX() * (float)scale_, point->getY() * (float)scale_)));
+  }
+  Ref<DetectorResult> result(new DetectorResult((*detectorResult)->getBits(), points));
+  result->setModuleSamples(moduleSamples_);
+  return result;
+}
+
+PerspectiveTransform GreyscaleDetector::createTransform(Ref<ResultPoint> topLeft, Ref<ResultPoint> topRight, Ref <
+    ResultPoint > bottomLeft, Ref<ResultPoint> alignmentPattern, int dimension) {
+  PerspectiveTransform transform(Detector::createTransform(topLeft, topRight, bottomLeft, alignmentPattern, dimension));
+  if (scale_ == 1) {
+    return transform;
+  }
+  float scale = (float)scale_;
+  PerspectiveTransform upscale(PerspectiveTransform::squareToQuadrilateral(0.0f, 0.0f, scale, 0.0f, scale, scale,
+                                    0.0f, scale));
+  return upscale.times(transform);
+}
+
+FallibleRef<BitMatrix> GreyscaleDetector::sampleGrid(int dimension, PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  GridSampler &sampler = GridSampler::getInstance();
+  auto const samples(sampler.sampleGrid(source_, dimension, transform));
+  if (!samples)
+    return samples.error();
+  auto const modules(fitThresholds(*samples));
+  if (!modules)
+    return modules.error();
+  moduleSamples_ = *modules;
+  return moduleSamples_->threshold(0);
+}
+
+FallibleRef<ModuleSamples> GreyscaleDetector::fitThresholds(Ref<ByteMatrix> samples) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  int dimension = (int)samples->getDimension();
+  if (dimension < 21) {
+    return failure<ReaderException>("Dimension too small for a QR code");
+  }
+
+  ThresholdPlane plane;
+  int finders = 0;
+  finders += addFinderPattern(*samples, 0, 0, plane) > 0 ? 1 : 0;
+  finders += addFinderPattern(*samples, dimension - 7, 0, plane) > 0 ? 1 : 0;
+  finders += addFinderPattern(*samples, 0, dimension - 7, plane) > 0 ? 1 : 0;
+  if (finders == 0) {
+    return failure<ReaderException>("Finder patterns have too little contrast");
+  }
+  addTimingPatterns(*samples, plane);
+  if (!plane.solve()) {
+    return failure<ReaderException>("Could not estimate module threshold");
+  }
+
+  return new ModuleSamples(samples, plane.thresholds(dimension, dimension));
+}
+
+}
+}
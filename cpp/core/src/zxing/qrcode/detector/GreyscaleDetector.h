@@ -0,0 +1,73 @@
+// -*- mode:c++; tab-width:2; indent-tabs-mode:nil; c-basic-offset:2 -*-
+#pragma once
+
+/*
+ *  GreyscaleDetector.h
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <zxing/qrcode/detector/ZXingQRCodeDetector.h>  // for Detector
+
+#include "zxing/LuminanceSource.h"                      // for LuminanceSource
+#include "zxing/common/BitMatrix.h"                     // for BitMatrix
+#include "zxing/common/Counted.h"                       // for Ref
+#include "zxing/common/Error.hpp"
+#include "zxing/common/ModuleSamples.h"                 // for ModuleSamples
+
+namespace pping {
+class ByteMatrix;
+class DecodeHints;
+class DetectorResult;
+class PerspectiveTransform;
+class ResultPoint;
+}  // namespace pping
+
+namespace pping {
+namespace qrcode {
+
+/**
+ * Detector that finds the finder patterns on a downscaled binarization of the
+ * frame, but samples the modules from the full resolution luminance and
+ * thresholds each of them against a threshold plane fitted to the finder and
+ * timing patterns. The full resolution frame is never binarized. The samples
+ * and thresholds are handed on in the DetectorResult so the decoder can
+ * retry with them when error correction fails.
+ */
+class GreyscaleDetector : public Detector {
+private:
+  Ref<LuminanceSource> source_;
+  int scale_;
+  Ref<ModuleSamples> moduleSamples_;
+
+protected:
+  virtual FallibleRef<BitMatrix> sampleGrid(int dimension, PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC override;
+
+public:
+  /** image is source binarized after downscaling it by scale. */
+  GreyscaleDetector(Ref<BitMatrix> image, Ref<LuminanceSource> source, int scale) noexcept;
+
+  virtual PerspectiveTransform createTransform(Ref<ResultPoint> topLeft, Ref<ResultPoint> topRight, Ref <
+      ResultPoint > bottomLeft, Ref<ResultPoint> alignmentPattern, int dimension) override;
+
+  FallibleRef<DetectorResult> detect(DecodeHints const& hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
+
+  /** Estimates a threshold for each sampled QR module from the finder and timing patterns. */
+  static FallibleRef<ModuleSamples> fitThresholds(Ref<ByteMatrix> samples) MB_NOEXCEPT_EXCEPT_BADALLOC;
+};
+
+}
+}
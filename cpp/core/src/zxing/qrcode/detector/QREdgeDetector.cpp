@@ -50,7 +50,7 @@ static Point rp(Ref<ResultPoint> rp) {
 
 QREdgeDetector::QREdgeDetector(Ref<BitMatrix> image) : Detector(image) { }
 
-Ref<PerspectiveTransform> QREdgeDetector::createTransform(Ref<ResultPoint> topLeft, Ref<ResultPoint> topRight, Ref <
+PerspectiveTransform QREdgeDetector::createTransform(Ref<ResultPoint> topLeft, Ref<ResultPoint> topRight, Ref <
       ResultPoint > bottomLeft, Ref<ResultPoint> alignmentPattern, int dimension) {
 
   if(alignmentPattern == NULL) {
@@ -102,10 +102,10 @@ Line QREdgeDetector::findPatternEdge(const BitMatrix& image, Point pattern, Poin
 }
 
 
-Ref<PerspectiveTransform> QREdgeDetector::get1CornerTransform(Point topLeft, Point topRight, Point bottomLeft, Point corner, int dimension) {
+PerspectiveTransform QREdgeDetector::get1CornerTransform(Point topLeft, Point topRight, Point bottomLeft, Point corner, int dimension) {
   float dimMinusThree = (float) dimension - 3.5f;
 
-  Ref<PerspectiveTransform> transform(PerspectiveTransform::quadrilateralToQuadrilateral(3.5f, 3.5f, dimMinusThree, 3.5f, (float)dimension, (float)dimension, 3.5f, dimMinusThree, topLeft.x, topLeft.y, topRight.x, topRight.y, corner.x, corner.y, bottomLeft.x, bottomLeft.y));
+  PerspectiveTransform transform(PerspectiveTransform::quadrilateralToQuadrilateral(3.5f, 3.5f, dimMinusThree, 3.5f, (float)dimension, (float)dimension, 3.5f, dimMinusThree, topLeft.x, topLeft.y, topRight.x, topRight.y, corner.x, corner.y, bottomLeft.x, bottomLeft.y));
 
   return transform;
 }
@@ -37,7 +37,7 @@ class QREdgeDetector : public Detector {
 public:
   QREdgeDetector(Ref<BitMatrix> image);
 
-  virtual Ref<PerspectiveTransform> createTransform(Ref<ResultPoint> topLeft, Ref<ResultPoint> topRight, Ref <
+  virtual PerspectiveTransform createTransform(Ref<ResultPoint> topLeft, Ref<ResultPoint> topRight, Ref <
       ResultPoint > bottomLeft, Ref<ResultPoint> alignmentPattern, int dimension);
 
 private:
@@ -46,7 +46,7 @@ private:
 
   Point endOfReverseBlackWhiteBlackRun(const BitMatrix& image, Point from, Point to);
 
-  Ref<PerspectiveTransform> get1CornerTransform(Point topLeft, Point topRight, Point bottomLeft, Point corner, int dimension);
+  PerspectiveTransform get1CornerTransform(Point topLeft, Point topRight, Point bottomLeft, Point corner, int dimension);
 };
 
 }
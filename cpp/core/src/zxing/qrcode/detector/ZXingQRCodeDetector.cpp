@@ -66,6 +66,21 @@ Ref<ResultPointCallback> Detector::getResultPointCallback() const {
 
 FallibleRef<DetectorResult> Detector::detect(DecodeHints const& hints) MB_NOEXCEPT_EXCEPT_BADALLOC {
   callback_ = hints.getResultPointCallback();
+
+  if (hints.getTrackedResultPoints().size() >= 3) {
+    // Video: the code has probably not moved far since the previous frame
+    FinderPatternFinder tracker(image_, hints.getResultPointCallback());
+    auto const trackedInfo(tracker.findNear(hints.getTrackedResultPoints()));
+    if (trackedInfo) {
+      if (callback_ != NULL){
+        callback_->finishedFindingPoints();
+      }
+      auto const trackedResult(processFinderPatternInfo(*trackedInfo));
+      if (trackedResult)
+          return *trackedResult;
+    }
+  }
+
   FinderPatternFinder finder(image_, hints.getResultPointCallback());
 
   auto const info(finder.find(hints));
@@ -125,9 +140,9 @@ FallibleRef<DetectorResult> Detector::processFinderPatternInfo(Ref<FinderPattern
     }
   }
 
-  Ref<PerspectiveTransform> transform = createTransform(topLeft, topRight, bottomLeft, alignmentPattern, *dimension);
+  PerspectiveTransform transform = createTransform(topLeft, topRight, bottomLeft, alignmentPattern, *dimension);
 
-  auto const bits(sampleGrid(image_, *dimension, transform));
+  auto const bits(sampleGrid(*dimension, transform));
   if(!bits)
       return bits.error();
 
@@ -142,7 +157,7 @@ FallibleRef<DetectorResult> Detector::processFinderPatternInfo(Ref<FinderPattern
   return new DetectorResult(*bits, points);
 }
 
-Ref<PerspectiveTransform> Detector::createTransform(Ref<ResultPoint> topLeft, Ref<ResultPoint> topRight, Ref <
+PerspectiveTransform Detector::createTransform(Ref<ResultPoint> topLeft, Ref<ResultPoint> topRight, Ref <
     ResultPoint > bottomLeft, Ref<ResultPoint> alignmentPattern, int dimension) {
 
   float dimMinusThree = (float)dimension - 3.5f;
@@ -163,16 +178,16 @@ Ref<PerspectiveTransform> Detector::createTransform(Ref<ResultPoint> topLeft, Re
     sourceBottomRightY = dimMinusThree;
   }
 
-  Ref<PerspectiveTransform> transform(PerspectiveTransform::quadrilateralToQuadrilateral(3.5f, 3.5f, dimMinusThree, 3.5f, sourceBottomRightX,
+  PerspectiveTransform transform(PerspectiveTransform::quadrilateralToQuadrilateral(3.5f, 3.5f, dimMinusThree, 3.5f, sourceBottomRightX,
                                       sourceBottomRightY, 3.5f, dimMinusThree, topLeft->getX(), topLeft->getY(), topRight->getX(),
                                       topRight->getY(), bottomRightX, bottomRightY, bottomLeft->getX(), bottomLeft->getY()));
 
   return transform;
 }
 
-FallibleRef<BitMatrix> Detector::sampleGrid(Ref<BitMatrix> image, int dimension, Ref<PerspectiveTransform> transform) MB_NOEXCEPT_EXCEPT_BADALLOC {
+FallibleRef<BitMatrix> Detector::sampleGrid(int dimension, PerspectiveTransform const &transform) MB_NOEXCEPT_EXCEPT_BADALLOC {
   GridSampler &sampler = GridSampler::getInstance();
-  return sampler.sampleGrid(image, dimension, transform);
+  return sampler.sampleGrid(image_, dimension, transform);
 }
 
 Fallible<int> Detector::computeDimension(Ref<ResultPoint> topLeft, Ref<ResultPoint> topRight, Ref<ResultPoint> bottomLeft,
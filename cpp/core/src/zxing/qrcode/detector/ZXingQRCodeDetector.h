@@ -47,7 +47,7 @@ protected:
   Ref<BitMatrix> getImage() const;
   Ref<ResultPointCallback> getResultPointCallback() const;
 
-  static FallibleRef<BitMatrix> sampleGrid(Ref<BitMatrix> image, int dimension, Ref<PerspectiveTransform>) MB_NOEXCEPT_EXCEPT_BADALLOC;
+  virtual FallibleRef<BitMatrix> sampleGrid(int dimension, PerspectiveTransform const &) MB_NOEXCEPT_EXCEPT_BADALLOC;
   static Fallible<int> computeDimension(Ref<ResultPoint> topLeft, Ref<ResultPoint> topRight, Ref<ResultPoint> bottomLeft,
                               float moduleSize) MB_NOEXCEPT_EXCEPT_BADALLOC;
   float calculateModuleSize(Ref<ResultPoint> topLeft, Ref<ResultPoint> topRight, Ref<ResultPoint> bottomLeft);
@@ -58,7 +58,7 @@ protected:
       float allowanceFactor);
   FallibleRef<DetectorResult> processFinderPatternInfo(Ref<FinderPatternInfo> info);
 public:
-  virtual Ref<PerspectiveTransform> createTransform(Ref<ResultPoint> topLeft, Ref<ResultPoint> topRight, Ref <
+  virtual PerspectiveTransform createTransform(Ref<ResultPoint> topLeft, Ref<ResultPoint> topRight, Ref <
       ResultPoint > bottomLeft, Ref<ResultPoint> alignmentPattern, int dimension);
 
   Detector(Ref<BitMatrix> image) noexcept;
@@ -36,6 +36,7 @@ namespace pping {
             int references_;
             
             FinderPattern(float posX, float posY, float estimatedModuleSize, int count);
+            friend class FinderPatternFinder;
 
         public:
             FinderPattern(float posX, float posY, float estimatedModuleSize);
@@ -27,10 +27,11 @@
 #include "zxing/ReaderException.h"                           // for ReaderException
 #include "zxing/ResultPoint.h"                               // for ResultPoint
 #include "zxing/ResultPointCallback.h"                       // for ResultPointCallback
+#include "zxing/TimeoutException.h"                          // for TimeoutException
 #include "zxing/qrcode/detector/FinderPatternInfo.h"         // for FinderPatternInfo
 #include "zxing/qrcode/detector/ZXingQRCodeFinderPattern.h"  // for FinderPattern
 
-#include <algorithm>                                         // for sort, max
+#include <algorithm>                                         // for sort, max, min
 #include <cmath>                                             // for NAN, abs, fabs, isnan, sqrt
 #include <float.h>                                           // for FLT_MAX
 #include <opencv2/core/fast_math.hpp>
@@ -48,9 +49,10 @@ public:
   FurthestFromAverageComparator(float averageModuleSize) :
     averageModuleSize_(averageModuleSize) {
   }
-  bool operator()(Ref<FinderPattern> a, Ref<FinderPattern> b) {
-    float dA = abs(a->getEstimatedModuleSize() - averageModuleSize_);
-    float dB = abs(b->getEstimatedModuleSize() - averageModuleSize_);
+  template<typename Center>
+  bool operator()(Center const& a, Center const& b) const {
+    float dA = abs(a.estimatedModuleSize - averageModuleSize_);
+    float dB = abs(b.estimatedModuleSize - averageModuleSize_);
     return dA > dB;
   }
 };
@@ -61,13 +63,14 @@ public:
   CenterComparator(float averageModuleSize) :
     averageModuleSize_(averageModuleSize) {
   }
-  bool operator()(Ref<FinderPattern> a, Ref<FinderPattern> b) {
+  template<typename Center>
+  bool operator()(Center const& a, Center const& b) const {
     // N.B.: we want the result in descending order ...
-    if (a->getCount() != b->getCount()) {
-      return a->getCount() > b->getCount();
+    if (a.count != b.count) {
+      return a.count > b.count;
     } else {
-      float dA = abs(a->getEstimatedModuleSize() - averageModuleSize_);
-      float dB = abs(b->getEstimatedModuleSize() - averageModuleSize_);
+      float dA = abs(a.estimatedModuleSize - averageModuleSize_);
+      float dB = abs(b.estimatedModuleSize - averageModuleSize_);
       return dA < dB;
     }
   }
@@ -76,6 +79,7 @@ public:
 int FinderPatternFinder::CENTER_QUORUM = 2;
 int FinderPatternFinder::MIN_SKIP = 3;
 int FinderPatternFinder::MAX_MODULES = 57;
+int FinderPatternFinder::MIN_TRACKING_RADIUS = 16;
 
 float FinderPatternFinder::centerFromEnd(int* stateCount, int end) {
   return (float)(end - stateCount[4] - stateCount[3]) - (float)stateCount[2] / 2.0f;
@@ -243,19 +247,19 @@ bool FinderPatternFinder::handlePossibleCenter(int* stateCount, size_t i, size_t
       bool found = false;
       size_t max = possibleCenters_.size();
       for (size_t index = 0; index < max; index++) {
-        Ref<FinderPattern> center = possibleCenters_[index];
+        Candidate& center = possibleCenters_[index];
         // Look for about the same center and module size:
-        if (center->aboutEquals(estimatedModuleSize, centerI, centerJ)) {
-          possibleCenters_[index] = center->combineEstimate(centerI, centerJ, estimatedModuleSize);
+        if (center.aboutEquals(estimatedModuleSize, centerI, centerJ)) {
+          center.combineEstimate(centerI, centerJ, estimatedModuleSize);
           found = true;
           break;
         }
       }
       if (!found) {
-        Ref<FinderPattern> newPattern(new FinderPattern(centerJ, centerI, estimatedModuleSize));
-        possibleCenters_.push_back(newPattern);
+        Candidate newCenter = { centerJ, centerI, estimatedModuleSize, 1 };
+        possibleCenters_.push_back(newCenter);
         if (callback_ != 0) {
-          callback_->foundPossibleResultPoint(*newPattern);
+          callback_->foundPossibleResultPoint(FinderPattern(centerJ, centerI, estimatedModuleSize));
         }
       }
       return true;
@@ -264,17 +268,65 @@ bool FinderPatternFinder::handlePossibleCenter(int* stateCount, size_t i, size_t
   return false;
 }
 
+template<typename OnCenter>
+void FinderPatternFinder::scanRowForCenters(size_t i, size_t startJ, size_t endJ, OnCenter onCenter) {
+  // This is slightly faster than using the Ref. Efficiency is important here
+  BitMatrix& matrix = *image_;
+
+  // As this is used often, we use an integer array instead of vector
+  int stateCount[5] = { 0, 0, 0, 0, 0 };
+  int currentState = 0;
+  for (size_t j = startJ; j < endJ; j++) {
+    if (matrix.get(j, i)) {
+      // Black pixel
+      if ((currentState & 1) == 1) { // Counting white pixels
+        currentState++;
+      }
+      stateCount[currentState]++;
+    } else { // White pixel
+      if ((currentState & 1) == 0) { // Counting black pixels
+        if (currentState == 4) { // A winner?
+          if (foundPatternCross(stateCount) && handlePossibleCenter(stateCount, i, j)) {
+            if (!onCenter(stateCount, false)) {
+              return;
+            }
+            // Clear state to start looking again
+            currentState = 0;
+            for (int k = 0; k < 5; k++) {
+              stateCount[k] = 0;
+            }
+          } else { // No, shift counts back by two
+            stateCount[0] = stateCount[2];
+            stateCount[1] = stateCount[3];
+            stateCount[2] = stateCount[4];
+            stateCount[3] = 1;
+            stateCount[4] = 0;
+            currentState = 3;
+          }
+        } else {
+          stateCount[++currentState]++;
+        }
+      } else { // Counting white pixels
+        stateCount[currentState]++;
+      }
+    }
+  }
+  if (foundPatternCross(stateCount) && handlePossibleCenter(stateCount, i, endJ)) {
+    onCenter(stateCount, true);
+  }
+}
+
 int FinderPatternFinder::findRowSkip() {
   size_t max = possibleCenters_.size();
   if (max <= 1) {
     return 0;
   }
-  Ref<FinderPattern> firstConfirmedCenter;
+  Candidate const* firstConfirmedCenter = NULL;
   for (size_t i = 0; i < max; i++) {
-    Ref<FinderPattern> center = possibleCenters_[i];
-    if (center->getCount() >= CENTER_QUORUM) {
-      if (firstConfirmedCenter == 0) {
-        firstConfirmedCenter = center;
+    Candidate const& center = possibleCenters_[i];
+    if (center.count >= CENTER_QUORUM) {
+      if (firstConfirmedCenter == NULL) {
+        firstConfirmedCenter = &center;
       } else {
         // We have two confirmed centers
         // How far down can we skip before resuming looking for the next
@@ -282,8 +334,8 @@ int FinderPatternFinder::findRowSkip() {
         // difference in the x / y coordinates of the two centers.
         // This is the case where you find top left first. Draw it out.
         hasSkipped_ = true;
-        return (int)(abs(firstConfirmedCenter->getX() - center->getX()) - abs(firstConfirmedCenter->getY()
-                     - center->getY()))/2;
+        return (int)(abs(firstConfirmedCenter->x - center.x) - abs(firstConfirmedCenter->y
+                     - center.y))/2;
       }
     }
   }
@@ -295,10 +347,10 @@ bool FinderPatternFinder::haveMultiplyConfirmedCenters() {
   float totalModuleSize = 0.0f;
   size_t max = possibleCenters_.size();
   for (size_t i = 0; i < max; i++) {
-    Ref<FinderPattern> pattern = possibleCenters_[i];
-    if (pattern->getCount() >= CENTER_QUORUM) {
+    Candidate const& pattern = possibleCenters_[i];
+    if (pattern.count >= CENTER_QUORUM) {
       confirmedCount++;
-      totalModuleSize += pattern->getEstimatedModuleSize();
+      totalModuleSize += pattern.estimatedModuleSize;
     }
   }
   if (confirmedCount < 3) {
@@ -311,13 +363,12 @@ bool FinderPatternFinder::haveMultiplyConfirmedCenters() {
   float average = totalModuleSize / (float)max;
   float totalDeviation = 0.0f;
   for (size_t i = 0; i < max; i++) {
-    Ref<FinderPattern> pattern = possibleCenters_[i];
-    totalDeviation += abs(pattern->getEstimatedModuleSize() - average);
+    totalDeviation += abs(possibleCenters_[i].estimatedModuleSize - average);
   }
   return totalDeviation <= 0.05f * totalModuleSize;
 }
 
-Fallible<vector<Ref<FinderPattern> >> FinderPatternFinder::selectBestPatterns() noexcept
+Fallible<vector<Ref<FinderPattern> >> FinderPatternFinder::selectBestPatterns() MB_NOEXCEPT_EXCEPT_BADALLOC
 #ifdef __clang__
     __attribute__(( no_sanitize( "unsigned-integer-overflow" ) ))
 #endif
@@ -335,7 +386,7 @@ Fallible<vector<Ref<FinderPattern> >> FinderPatternFinder::selectBestPatterns()
     float totalModuleSize = 0.0f;
     float square = 0.0f;
     for (size_t i = 0; i < startSize; i++) {
-      float size = possibleCenters_[i]->getEstimatedModuleSize();
+      float size = possibleCenters_[i].estimatedModuleSize;
       totalModuleSize += size;
       square += size * size;
     }
@@ -351,7 +402,7 @@ Fallible<vector<Ref<FinderPattern> >> FinderPatternFinder::selectBestPatterns()
     float limit = max(0.2f * average, stdDev);
 
     for (size_t i = 0; i < possibleCenters_.size() && possibleCenters_.size() > 3; i++) {
-      if (abs(possibleCenters_[i]->getEstimatedModuleSize() - average) > limit) {
+      if (abs(possibleCenters_[i].estimatedModuleSize - average) > limit) {
         possibleCenters_.erase(possibleCenters_.begin()+i);
         i--;
       }
@@ -397,7 +448,7 @@ Fallible<vector<Ref<FinderPattern> >> FinderPatternFinder::selectBestPatterns()
     if (possibleCenters_.size() > 40) {
         float totalModuleSize = 0.0f;
         for (size_t i = 0; i < possibleCenters_.size(); i++) {
-          float size = possibleCenters_[i]->getEstimatedModuleSize();
+          float size = possibleCenters_[i].estimatedModuleSize;
           totalModuleSize += size;
         }
         float average = totalModuleSize / (float) possibleCenters_.size();
@@ -406,24 +457,31 @@ Fallible<vector<Ref<FinderPattern> >> FinderPatternFinder::selectBestPatterns()
     }
 
     float error = FLT_MAX;
-    vector<Ref<FinderPattern> > result(3);
+    int best[3] = { 0, 1, 2 };
     for (int i = 0; i < (int) possibleCenters_.size(); ++i){
+        Candidate const& first = possibleCenters_[i];
         for (int j = i + 1; j < (int) possibleCenters_.size(); ++j){
+            Candidate const& second = possibleCenters_[j];
             for (int k = j + 1; k < (int) possibleCenters_.size(); ++k){
+                Candidate const& third = possibleCenters_[k];
 
-                float currError = FinderPatternAnalizator::analize(possibleCenters_[i], possibleCenters_[j], possibleCenters_[k]);
+                float currError = FinderPatternAnalizator::analize(first.x, first.y, second.x, second.y, third.x, third.y);
 
                 if (currError < error){
                     error = currError;
 
-                    result[0] = possibleCenters_[i];
-                    result[1] = possibleCenters_[j];
-                    result[2] = possibleCenters_[k];
+                    best[0] = i;
+                    best[1] = j;
+                    best[2] = k;
                 }
             }
         }
     }
 
+    vector<Ref<FinderPattern> > result(3);
+    for (int i = 0; i < 3; i++) {
+      result[i] = toFinderPattern(possibleCenters_[best[i]]);
+    }
     return result;
 }
 
@@ -486,15 +544,8 @@ FallibleRef<FinderPatternInfo> FinderPatternFinder::find(DecodeHints const& hint
   size_t maxI = image_->getHeight();
   size_t maxJ = image_->getWidth();
 
-
-  // We are looking for black/white/black/white/black modules in
-  // 1:1:3:1:1 ratio; this tracks the number of such modules seen so far
-
-  // As this is used often, we use an integer array instead of vector
-  int stateCount[5];
   bool done = false;
 
-
   // Let's assume that the maximum version QR Code we support takes up 1/4
   // the height of the image, and then account for the center being 3
   // modules in size. This gives the smallest number of pixels the center
@@ -505,93 +556,89 @@ FallibleRef<FinderPatternInfo> FinderPatternFinder::find(DecodeHints const& hint
       iSkip = MIN_SKIP;
   }
 
-  // This is slightly faster than using the Ref. Efficiency is important here
-  BitMatrix& matrix = *image_;
-
-  for (size_t i = iSkip - 1; i < maxI && !done; i += iSkip) {
-    // Get a row of black/white values
-
-    stateCount[0] = 0;
-    stateCount[1] = 0;
-    stateCount[2] = 0;
-    stateCount[3] = 0;
-    stateCount[4] = 0;
-    int currentState = 0;
-    for (size_t j = 0; j < maxJ; j++) {
-      if (matrix.get(j, i)) {
-        // Black pixel
-        if ((currentState & 1) == 1) { // Counting white pixels
-          currentState++;
-        }
-        stateCount[currentState]++;
-      } else { // White pixel
-        if ((currentState & 1) == 0) { // Counting black pixels
-          if (currentState == 4) { // A winner?
-            if (foundPatternCross(stateCount)) { // Yes
-              bool confirmed = handlePossibleCenter(stateCount, i, j);
-              if (confirmed) {
-                // Start examining every other line. Checking each line turned out to be too
-                // expensive and didn't improve performance.
-                iSkip = 2;
-                if (hasSkipped_) {
-                  done = tryHarder ? false : haveMultiplyConfirmedCenters();
-                } else {
-                  int rowSkip = findRowSkip();
-                  if (rowSkip > stateCount[2]) {
-                    // Skip rows between row of lower confirmed center
-                    // and top of presumed third confirmed center
-                    // but back up a bit to get a full chance of detecting
-                    // it, entire width of center of finder pattern
-
-                    // Skip by rowSkip, but back off by stateCount[2] (size
-                    // of last center of pattern we saw) to be conservative,
-                    // and also back off by iSkip which is about to be
-                    // re-added
-                    i += rowSkip - stateCount[2] - iSkip;
-                    j = maxJ - 1;
-                  }
-                }
-              } else {
-                stateCount[0] = stateCount[2];
-                stateCount[1] = stateCount[3];
-                stateCount[2] = stateCount[4];
-                stateCount[3] = 1;
-                stateCount[4] = 0;
-                currentState = 3;
-                continue;
-              }
-              // Clear state to start looking again
-              currentState = 0;
-              stateCount[0] = 0;
-              stateCount[1] = 0;
-              stateCount[2] = 0;
-              stateCount[3] = 0;
-              stateCount[4] = 0;
-            } else { // No, shift counts back by two
-              stateCount[0] = stateCount[2];
-              stateCount[1] = stateCount[3];
-              stateCount[2] = stateCount[4];
-              stateCount[3] = 1;
-              stateCount[4] = 0;
-              currentState = 3;
-            }
-          } else {
-            stateCount[++currentState]++;
-          }
-        } else { // Counting white pixels
-          stateCount[currentState]++;
-        }
-      }
-    }
-    if (foundPatternCross(stateCount)) {
-      bool confirmed = handlePossibleCenter(stateCount, i, maxJ);
-      if (confirmed) {
+  for (size_t i = iSkip - 1; i < maxI && !done && !hints.isCancelled(); i += iSkip) {
+    // Look for black/white/black/white/black modules in 1:1:3:1:1 ratio
+    scanRowForCenters(i, 0, maxJ, [&](int* stateCount, bool endOfRow) {
+      if (endOfRow) {
         iSkip = stateCount[0];
         if (hasSkipped_) {
           // Found a third one
           done = tryHarder ? false : haveMultiplyConfirmedCenters();
         }
+        return true;
       }
+      // Start examining every other line. Checking each line turned out to be too
+      // expensive and didn't improve performance.
+      iSkip = 2;
+      if (hasSkipped_) {
+        done = tryHarder ? false : haveMultiplyConfirmedCenters();
+      } else {
+        int rowSkip = findRowSkip();
+        if (rowSkip > stateCount[2]) {
+          // Skip rows between row of lower confirmed center
+          // and top of presumed third confirmed center
+          // but back up a bit to get a full chance of detecting
+          // it, entire width of center of finder pattern
+
+          // Skip by rowSkip, but back off by stateCount[2] (size
+          // of last center of pattern we saw) to be conservative,
+          // and also back off by iSkip which is about to be
+          // re-added
+          i += rowSkip - stateCount[2] - iSkip;
+          return false;
+        }
+      }
+      return true;
+    });
+  }
+  if (hints.isCancelled())
+      return failure<TimeoutException>("Decoding timed out");
+
+  auto const patternInfoGetter(selectBestPatterns());
+  if(!patternInfoGetter)
+      return patternInfoGetter.error();
+
+  auto const patternInfo = orderBestPatterns(*patternInfoGetter);
+
+  Ref<FinderPatternInfo> result(new FinderPatternInfo(patternInfo));
+  return result;
+}
+
+FallibleRef<FinderPatternInfo> FinderPatternFinder::findNear(vector<Ref<ResultPoint> > const& previousCenters) MB_NOEXCEPT_EXCEPT_BADALLOC {
+  if (previousCenters.size() < 3) {
+      return failure<ReaderException>("Need three finder pattern centers to track");
+  }
+
+  // Finder pattern centers are at least 14 modules apart, so a third of the
+  // closest spacing is at least 4.7 modules: the 3.5 from a center to the
+  // edge of its pattern plus about 1.2 modules of movement since the previous
+  // frame. Larger versions leave more, and MIN_TRACKING_RADIUS keeps codes
+  // only a few pixels per module from losing their patterns to jitter.
+  float spacing = min(distance(previousCenters[0], previousCenters[1]),
+                      min(distance(previousCenters[1], previousCenters[2]), distance(previousCenters[0], previousCenters[2])));
+  int radius = max((int)(spacing / 3.0f), MIN_TRACKING_RADIUS);
+
+  int maxI = (int)image_->getHeight();
+  int maxJ = (int)image_->getWidth();
+  possibleCenters_.clear();
+  for (size_t k = 0; k < 3; k++) {
+    int centerI = (int)previousCenters[k]->getY();
+    int centerJ = (int)previousCenters[k]->getX();
+    int top = max(centerI - radius, 0);
+    int bottom = min(centerI + radius, maxI - 1);
+    int left = max(centerJ - radius, 0);
+    int right = min(centerJ + radius + 1, maxJ);
+    if (top > bottom || left >= right) {
+        return failure<ReaderException>("Tracked finder pattern left the image");
+    }
+
+    size_t found = possibleCenters_.size();
+    // Every other row, as the full scan does once it has confirmed a center
+    for (int i = top; i <= bottom; i += 2) {
+      scanRowForCenters((size_t)i, (size_t)left, (size_t)right, [](int*, bool) { return true; });
+    }
+    if (possibleCenters_.size() == found) {
+        return failure<ReaderException>("Tracked finder pattern not found again");
     }
   }
 
@@ -609,9 +656,29 @@ Ref<BitMatrix> FinderPatternFinder::getImage() {
   return image_;
 }
 
-std::vector<Ref<FinderPattern> >& FinderPatternFinder::getPossibleCenters() {
+std::vector<FinderPatternFinder::Candidate>& FinderPatternFinder::getPossibleCenters() {
   return possibleCenters_;
 }
 
+Ref<FinderPattern> FinderPatternFinder::toFinderPattern(Candidate const& candidate) {
+  return Ref<FinderPattern>(new FinderPattern(candidate.x, candidate.y, candidate.estimatedModuleSize, candidate.count));
+}
+
+bool FinderPatternFinder::Candidate::aboutEquals(float moduleSize, float i, float j) const {
+  if (abs(i - y) <= moduleSize && abs(j - x) <= moduleSize) {
+    float moduleSizeDiff = abs(moduleSize - estimatedModuleSize);
+    return moduleSizeDiff <= 1.0f || moduleSizeDiff <= estimatedModuleSize;
+  }
+  return false;
+}
+
+void FinderPatternFinder::Candidate::combineEstimate(float i, float j, float newModuleSize) {
+  int combinedCount = count + 1;
+  x = ((float)count * x + j) / (float)combinedCount;
+  y = ((float)count * y + i) / (float)combinedCount;
+  estimatedModuleSize = ((float)count * estimatedModuleSize + newModuleSize) / (float)combinedCount;
+  count = combinedCount;
+}
+
 }
 }
@@ -47,9 +47,26 @@ private:
 protected:
   static int MIN_SKIP;
   static int MAX_MODULES;
+  static int MIN_TRACKING_RADIUS;
+
+  /**
+   * A possible center found while scanning, kept by value as a frame yields
+   * many of them. Only those picked become FinderPatterns, see toFinderPattern().
+   */
+  struct Candidate {
+    float x;
+    float y;
+    float estimatedModuleSize;
+    int count;
+
+    /** Same as FinderPattern::aboutEquals(). */
+    bool aboutEquals(float moduleSize, float i, float j) const;
+    /** Same as FinderPattern::combineEstimate(), in place. */
+    void combineEstimate(float i, float j, float newModuleSize);
+  };
 
   Ref<BitMatrix> image_;
-  std::vector<Ref<FinderPattern> > possibleCenters_;
+  std::vector<Candidate> possibleCenters_;
   bool hasSkipped_;
 
   Ref<ResultPointCallback> callback_;
@@ -63,18 +80,33 @@ protected:
 
   /** stateCount must be int[5] */
   bool handlePossibleCenter(int* stateCount, size_t i, size_t j);
+  /**
+   * Runs the 1:1:3:1:1 state machine over row i from startJ to endJ and
+   * hands every candidate to handlePossibleCenter(). Each confirmed center
+   * is reported as onCenter(stateCount, endOfRow); returning false from it
+   * ends the row there.
+   */
+  template<typename OnCenter>
+  void scanRowForCenters(size_t i, size_t startJ, size_t endJ, OnCenter onCenter);
   int findRowSkip();
   bool haveMultiplyConfirmedCenters();
-  Fallible<std::vector<Ref<FinderPattern> >> selectBestPatterns() noexcept;
+  Fallible<std::vector<Ref<FinderPattern> >> selectBestPatterns() MB_NOEXCEPT_EXCEPT_BADALLOC;
   static std::vector<Ref<FinderPattern> > orderBestPatterns(std::vector<Ref<FinderPattern> > patterns);
+  static Ref<FinderPattern> toFinderPattern(Candidate const& candidate);
 
   Ref<BitMatrix> getImage();
-  std::vector<Ref<FinderPattern> >& getPossibleCenters();
+  std::vector<Candidate>& getPossibleCenters();
 
 public:
   static float distance(Ref<ResultPoint> p1, Ref<ResultPoint> p2) noexcept;
   FinderPatternFinder(Ref<BitMatrix> image, Ref<ResultPointCallback>const&) noexcept;
   FallibleRef<FinderPatternInfo> find(DecodeHints const& hints) MB_NOEXCEPT_EXCEPT_BADALLOC;
+  /**
+   * Looks for the finder patterns only in windows around previousCenters,
+   * the first three result points of a QR code found in an earlier frame.
+   * Fails unless every window still holds a finder pattern.
+   */
+  FallibleRef<FinderPatternInfo> findNear(std::vector<Ref<ResultPoint> > const& previousCenters) MB_NOEXCEPT_EXCEPT_BADALLOC;
 };
 }
 }
@@ -0,0 +1,136 @@
+/*
+ *  DecoderTest.cpp
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DecoderTest.h"
+#include <zxing/aztec/decoder/Decoder.h>
+
+namespace pping {
+namespace aztec {
+using std::vector;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DecoderTest);
+
+// Symbol sizes of ISO/IEC 24778 by number of layers
+static int COMPACT_SIZES[] = { 15, 19, 23, 27 };
+static int FULL_SIZES[] = {
+  19, 23, 27, 31, 37, 41, 45, 49, 53, 57, 61, 67, 71, 75, 79, 83,
+  87, 91, 95, 101, 105, 109, 113, 117, 121, 125, 131, 135, 139, 143, 147, 151
+};
+
+/**
+ * Offsets of all the bits of a symbol in reading order: the layers from the
+ * outside in, each as two module wide strips down the left, along the
+ * bottom, up the right and back along the top.
+ */
+vector<unsigned int> DecoderTest::readingOrder(bool compact, int layers) {
+  int baseSize = (compact ? 11 : 14) + 4 * layers;
+  int size = Decoder::matrixSize(compact, layers);
+  // Where the modules of the symbol without its reference grid lines are
+  vector<int> alignmentMap(baseSize);
+  if (compact) {
+    for (int i = 0; i < baseSize; i++) {
+      alignmentMap[i] = i;
+    }
+  } else {
+    int baseCenter = baseSize / 2;
+    for (int i = 0; i < baseCenter; i++) {
+      int offset = i + i / 15;
+      alignmentMap[baseCenter - i - 1] = size / 2 - offset - 1;
+      alignmentMap[baseCenter + i] = size / 2 + offset + 1;
+    }
+  }
+
+  vector<unsigned int> bits;
+  for (int layer = 0; layer < layers; layer++) {
+    int length = (layers - layer) * 4 + (compact ? 9 : 12);
+    int low = layer * 2;
+    int high = baseSize - 1 - low;
+    vector<unsigned int> left, bottom, right, top;
+    for (int j = 0; j < length; j++) {
+      for (int k = 0; k < 2; k++) {
+        left.push_back(alignmentMap[low + k] + alignmentMap[low + j] * size);
+        bottom.push_back(alignmentMap[low + j] + alignmentMap[high - k] * size);
+        right.push_back(alignmentMap[high - k] + alignmentMap[high - j] * size);
+        top.push_back(alignmentMap[high - j] + alignmentMap[low + k] * size);
+      }
+    }
+    bits.insert(bits.end(), left.begin(), left.end());
+    bits.insert(bits.end(), bottom.begin(), bottom.end());
+    bits.insert(bits.end(), right.begin(), right.end());
+    bits.insert(bits.end(), top.begin(), top.end());
+  }
+  return bits;
+}
+
+void DecoderTest::checkCodewordBits(bool compact, int layers) {
+  vector<unsigned int> const& offsets = Decoder::getCodewordBits(compact, layers);
+  vector<unsigned int> bits = readingOrder(compact, layers);
+  // As many codewords as fit, aligned to the end of the bits
+  int codewordSize = layers <= 2 ? 6 : layers <= 8 ? 8 : layers <= 22 ? 10 : 12;
+  size_t used = bits.size() / codewordSize * codewordSize;
+  CPPUNIT_ASSERT_EQUAL(used, offsets.size());
+  for (size_t i = 0; i < used; i++) {
+    CPPUNIT_ASSERT_EQUAL(bits[bits.size() - used + i], offsets[i]);
+  }
+  // Built once
+  CPPUNIT_ASSERT(&offsets == &Decoder::getCodewordBits(compact, layers));
+}
+
+void DecoderTest::testMatrixSize() {
+  for (int layers = 1; layers <= 4; layers++) {
+    CPPUNIT_ASSERT_EQUAL(COMPACT_SIZES[layers - 1], Decoder::matrixSize(true, layers));
+  }
+  for (int layers = 1; layers <= 32; layers++) {
+    CPPUNIT_ASSERT_EQUAL(FULL_SIZES[layers - 1], Decoder::matrixSize(false, layers));
+  }
+}
+
+void DecoderTest::testCompactCodewordBits() {
+  // 15x15, 17 codewords of 6 bits after 2 unused ones, starting at (0, 1)
+  vector<unsigned int> const& offsets = Decoder::getCodewordBits(true, 1);
+  CPPUNIT_ASSERT_EQUAL((size_t)102, offsets.size());
+  CPPUNIT_ASSERT_EQUAL(0u + 1 * 15, offsets[0]);
+  CPPUNIT_ASSERT_EQUAL(1u + 1 * 15, offsets[1]);
+  CPPUNIT_ASSERT_EQUAL(0u + 2 * 15, offsets[2]);
+  // The last bit is in the top strip, next to where the layer started
+  CPPUNIT_ASSERT_EQUAL(2u + 1 * 15, offsets[101]);
+
+  for (int layers = 1; layers <= 4; layers++) {
+    checkCodewordBits(true, layers);
+  }
+}
+
+void DecoderTest::testFullCodewordBits() {
+  // 19x19 with the reference grid lines through row and column 9, 21
+  // codewords of 6 bits after 2 unused ones
+  vector<unsigned int> const& offsets = Decoder::getCodewordBits(false, 1);
+  CPPUNIT_ASSERT_EQUAL((size_t)126, offsets.size());
+  CPPUNIT_ASSERT_EQUAL(0u + 1 * 19, offsets[0]);
+  CPPUNIT_ASSERT_EQUAL(1u + 1 * 19, offsets[1]);
+  for (size_t i = 0; i < offsets.size(); i++) {
+    CPPUNIT_ASSERT(offsets[i] % 19 != 9 && offsets[i] / 19 != 9);
+  }
+
+  for (int layers = 1; layers <= 32; layers++) {
+    checkCodewordBits(false, layers);
+  }
+}
+
+}
+}
@@ -0,0 +1,51 @@
+#ifndef __AZTEC_DECODER_TEST_H__
+#define __AZTEC_DECODER_TEST_H__
+
+/*
+ *  DecoderTest.h
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <vector>
+
+namespace pping {
+namespace aztec {
+
+class DecoderTest : public CPPUNIT_NS::TestFixture {
+  CPPUNIT_TEST_SUITE(DecoderTest);
+  CPPUNIT_TEST(testMatrixSize);
+  CPPUNIT_TEST(testCompactCodewordBits);
+  CPPUNIT_TEST(testFullCodewordBits);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+protected:
+  void testMatrixSize();
+  void testCompactCodewordBits();
+  void testFullCodewordBits();
+
+private:
+  static std::vector<unsigned int> readingOrder(bool compact, int layers);
+  static void checkCodewordBits(bool compact, int layers);
+};
+}
+}
+
+#endif // __AZTEC_DECODER_TEST_H__
@@ -19,11 +19,13 @@
  */
 
 #include "BitMatrixTest.h"
+#include <zxing/common/BitArray.h>
 #include <limits>
+#include <vector>
 #include <stdlib.h>
 #include <unistd.h>
 
-namespace zxing {
+namespace pping {
 using namespace std;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(BitMatrixTest);
@@ -33,9 +35,9 @@ BitMatrixTest::BitMatrixTest() {
 }
 
 void BitMatrixTest::testGetSet() {
-  const int bits = BitMatrix::bitsPerWord;
+  const int bits = numeric_limits<unsigned int>::digits;
   BitMatrix matrix(bits + 1);
-  CPPUNIT_ASSERT_EQUAL(bits + 1, matrix.getHeight());
+  CPPUNIT_ASSERT_EQUAL((size_t)(bits + 1), matrix.getHeight());
   for (int i = 0; i < bits + 1; i++) {
     for (int j = 0; j < bits + 1; j++) {
       if (i * j % 3 == 0) {
@@ -52,7 +54,7 @@ void BitMatrixTest::testGetSet() {
 
 void BitMatrixTest::testSetRegion() {
   BitMatrix matrix(5);
-  matrix.setRegion(1, 1, 3, 3);
+  CPPUNIT_ASSERT(matrix.setRegion(1, 1, 3, 3));
   for (int i = 0; i < 5; i++) {
     for (int j = 0; j < 5; j++) {
       CPPUNIT_ASSERT_EQUAL(i >= 1 && i <= 3 && j >= 1 && j <= 3,
@@ -85,22 +87,126 @@ void BitMatrixTest::testGetRow3() {
   runBitMatrixGetRowTest(width, height);
 }
 
-void BitMatrixTest::runBitMatrixGetRowTest(int width, int height) {
-  BitMatrix mat(width, height);
+void BitMatrixTest::testGetRowPartialWord() {
+  // The last word of each row also holds the start of the next one, which
+  // must not show up past the width in a longer row
+  const int width = 45;
+  const int height = 7;
+  BitMatrix matrix(width, height);
+  CPPUNIT_ASSERT(matrix.setRegion(0, 0, width, height));
+  Ref<BitArray> row(new BitArray(96));
+  for (int y = 0; y < height; y++) {
+    row = matrix.getRow(y, row);
+    CPPUNIT_ASSERT_EQUAL((size_t)96, row->getSize());
+    for (int x = 0; x < 96; x++) {
+      CPPUNIT_ASSERT_EQUAL(x < width, *row->get(x));
+    }
+  }
+}
+
+void BitMatrixTest::testCrop() {
+  Ref<BitMatrix> parent(randomMatrix(100, 40));
+  // Neither the origin nor the rows of the crop line up with the words
+  const int left = 13;
+  const int top = 5;
+  Ref<BitMatrix> crop(parent->crop(left, top, 70, 30));
+  CPPUNIT_ASSERT_EQUAL((size_t)70, crop->getWidth());
+  CPPUNIT_ASSERT_EQUAL((size_t)30, crop->getHeight());
+  checkCrop(*parent, *crop, left, top);
+
+  // Bits set through either one show up in the other
+  for (int y = 0; y < 30; y += 3) {
+    for (int x = y % 7; x < 70; x += 7) {
+      crop->set(x, y);
+      CPPUNIT_ASSERT(parent->get(left + x, top + y));
+      parent->set(left + x + 1, top + y + 1);
+    }
+  }
+  checkCrop(*parent, *crop, left, top);
+}
+
+void BitMatrixTest::testCropOfCrop() {
+  Ref<BitMatrix> parent(randomMatrix(130, 50));
+  Ref<BitMatrix> crop(parent->crop(7, 3, 100, 40));
+  Ref<BitMatrix> cropOfCrop(crop->crop(29, 11, 50, 20));
+  checkCrop(*crop, *cropOfCrop, 29, 11);
+  checkCrop(*parent, *cropOfCrop, 36, 14);
+
+  // Still views the bits of the original once the crop in between is gone
+  crop = Ref<BitMatrix>();
+  cropOfCrop->set(49, 19);
+  CPPUNIT_ASSERT(parent->get(85, 33));
+  checkCrop(*parent, *cropOfCrop, 36, 14);
+}
+
+void BitMatrixTest::testClearCrop() {
+  const int width = 90;
+  const int height = 30;
+  Ref<BitMatrix> parent(randomMatrix(width, height));
+  vector<bool> before;
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      before.push_back(parent->get(x, y));
+    }
+  }
+  parent->crop(5, 4, 41, 9)->clear();
   for (int y = 0; y < height; y++) {
     for (int x = 0; x < width; x++) {
-      bool v = ((rand() & 0x01) != 0);
-      if (v) {
-        mat.set(x, y);
+      bool inside = x >= 5 && x < 46 && y >= 4 && y < 13;
+      CPPUNIT_ASSERT_EQUAL(inside ? false : (bool)before[y * width + x], parent->get(x, y));
+    }
+  }
+}
+
+Ref<BitMatrix> BitMatrixTest::randomMatrix(int width, int height) {
+  Ref<BitMatrix> matrix(new BitMatrix(width, height));
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      if ((rand() & 0x01) != 0) {
+        matrix->set(x, y);
       }
     }
   }
+  return matrix;
+}
+
+void BitMatrixTest::runBitMatrixGetRowTest(int width, int height) {
+  Ref<BitMatrix> mat(randomMatrix(width, height));
   Ref<BitArray> row(new BitArray(width));
   for (int y = 0; y < height; y++) {
-    row = mat.getRow(y, row);
+    row = mat->getRow(y, row);
     for (int x = 0; x < width; x++) {
-      CPPUNIT_ASSERT_EQUAL(row->get(x), mat.get(x,y));
+      CPPUNIT_ASSERT_EQUAL(*row->get(x), mat->get(x,y));
+    }
+  }
+}
+
+void BitMatrixTest::checkCrop(BitMatrix& parent, BitMatrix& crop, int left, int top) {
+  int width = (int)crop.getWidth();
+  int height = (int)crop.getHeight();
+  Ref<BitArray> row;
+  vector<int> transitions;
+  for (int y = 0; y < height; y++) {
+    row = crop.getRow(y, row);
+    crop.getRowTransitions(y, transitions);
+    size_t transition = 0;
+    bool black = false;
+    for (int x = 0; x < width; x++) {
+      bool expected = parent.get(left + x, top + y);
+      CPPUNIT_ASSERT_EQUAL(expected, crop.get(x, y));
+      CPPUNIT_ASSERT_EQUAL(expected, *row->get(x));
+      // The transitions of the crop follow its own pixels, not the parent's
+      if (expected != black) {
+        CPPUNIT_ASSERT(transition < transitions.size());
+        CPPUNIT_ASSERT_EQUAL(x, transitions[transition++]);
+        black = expected;
+      }
+    }
+    if (black) {
+      CPPUNIT_ASSERT(transition < transitions.size());
+      CPPUNIT_ASSERT_EQUAL(width, transitions[transition++]);
     }
+    CPPUNIT_ASSERT_EQUAL(transitions.size(), transition);
   }
 }
 }
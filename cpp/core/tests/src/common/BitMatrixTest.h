@@ -24,7 +24,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <zxing/common/BitMatrix.h>
 
-namespace zxing {
+namespace pping {
 class BitMatrixTest : public CPPUNIT_NS::TestFixture {
   CPPUNIT_TEST_SUITE(BitMatrixTest);
   CPPUNIT_TEST(testGetSet);
@@ -33,6 +33,10 @@ class BitMatrixTest : public CPPUNIT_NS::TestFixture {
   CPPUNIT_TEST(testGetRow1);
   CPPUNIT_TEST(testGetRow2);
   CPPUNIT_TEST(testGetRow3);
+  CPPUNIT_TEST(testGetRowPartialWord);
+  CPPUNIT_TEST(testCrop);
+  CPPUNIT_TEST(testCropOfCrop);
+  CPPUNIT_TEST(testClearCrop);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -45,9 +49,15 @@ protected:
   void testGetRow1();
   void testGetRow2();
   void testGetRow3();
+  void testGetRowPartialWord();
+  void testCrop();
+  void testCropOfCrop();
+  void testClearCrop();
 
 private:
+  static Ref<BitMatrix> randomMatrix(int width, int height);
   void runBitMatrixGetRowTest(int width, int height);
+  void checkCrop(BitMatrix& parent, BitMatrix& crop, int left, int top);
 };
 }
 
@@ -28,7 +28,7 @@ static float EPSILON = 0.0001f;
 CPPUNIT_TEST_SUITE_REGISTRATION(PerspectiveTransformTest);
 
 void PerspectiveTransformTest::testSquareToQuadrilateral() {
-  Ref<PerspectiveTransform> pt
+  PerspectiveTransform pt
   (PerspectiveTransform::squareToQuadrilateral
    (2.0f, 3.0f, 10.0f, 4.0f, 16.0f, 15.0f, 4.0f, 9.0f));
   assertPointEquals(2.0f, 3.0f, 0.0f, 0.0f, pt);
@@ -40,7 +40,7 @@ void PerspectiveTransformTest::testSquareToQuadrilateral() {
 }
 
 void PerspectiveTransformTest::testQuadrilateralToQuadrilateral() {
-  Ref<PerspectiveTransform> pt
+  PerspectiveTransform pt
   (PerspectiveTransform::quadrilateralToQuadrilateral
    (2.0f, 3.0f, 10.0f, 4.0f, 16.0f, 15.0f, 4.0f, 9.0f,
     103.0f, 110.0f, 300.0f, 120.0f, 290.0f, 270.0f, 150.0f, 280.0f));
@@ -56,11 +56,11 @@ void PerspectiveTransformTest::assertPointEquals(float expectedX,
     float expectedY,
     float sourceX,
     float sourceY,
-    Ref<PerspectiveTransform> pt) {
+    PerspectiveTransform const &pt) {
   vector<float> points(2);
   points[0] = sourceX;
   points[1] = sourceY;
-  pt->transformPoints(points);
+  pt.transformPoints(points);
   CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedX, points[0], EPSILON);
   CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedY, points[1], EPSILON);
 
@@ -40,7 +40,7 @@ protected:
 private:
   static void assertPointEquals(float expectedX, float expectedY,
                                 float sourceX, float sourceY,
-                                Ref<PerspectiveTransform> pt);
+                                PerspectiveTransform const &pt);
 };
 }
 
@@ -0,0 +1,160 @@
+/*
+ *  StringUtilsTest.cpp
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StringUtilsTest.h"
+#include <zxing/common/StringUtils.h>
+
+namespace pping {
+using common::StringUtils;
+using std::string;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(StringUtilsTest);
+
+string StringUtilsTest::appendAsUtf8(string const& bytes, char const* encoding) {
+  string result("<");
+  CPPUNIT_ASSERT(StringUtils::appendAsUtf8(result, (unsigned char const*)bytes.data(), bytes.size(), encoding));
+  return result.substr(1);
+}
+
+bool StringUtilsTest::canAppendAsUtf8(string const& bytes, char const* encoding) {
+  string result;
+  return static_cast<bool>(StringUtils::appendAsUtf8(result, (unsigned char const*)bytes.data(), bytes.size(), encoding));
+}
+
+bool StringUtilsTest::isValidUtf8(string const& text) {
+  size_t i = 0;
+  while (i < text.size()) {
+    unsigned char lead = (unsigned char)text[i];
+    size_t length = lead < 0x80 ? 1 : lead < 0xC2 ? 0 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : lead < 0xF5 ? 4 : 0;
+    if (length == 0 || i + length > text.size()) {
+      return false;
+    }
+    unsigned int codePoint = length == 1 ? lead : lead & (0x7F >> length);
+    for (size_t j = 1; j < length; j++) {
+      unsigned char next = (unsigned char)text[i + j];
+      if ((next & 0xC0) != 0x80) {
+        return false;
+      }
+      codePoint = (codePoint << 6) | (next & 0x3F);
+    }
+    // No overlong forms, surrogates or code points above U+10FFFF
+    unsigned int const minimum[5] = { 0, 0, 0x80, 0x800, 0x10000 };
+    if (codePoint < minimum[length] || (codePoint >= 0xD800 && codePoint <= 0xDFFF) || codePoint > 0x10FFFF) {
+      return false;
+    }
+    i += length;
+  }
+  return true;
+}
+
+void StringUtilsTest::testCountAsciiPrefix() {
+  unsigned char bytes[40];
+  for (size_t length = 0; length <= sizeof(bytes); length++) {
+    for (size_t i = 0; i < length; i++) {
+      bytes[i] = (unsigned char)('a' + i % 26);
+    }
+    CPPUNIT_ASSERT_EQUAL(length, StringUtils::countAsciiPrefix(bytes, length));
+    // A byte above 0x7F ends the prefix, wherever it is within or across words
+    for (size_t high = 0; high < length; high++) {
+      bytes[high] = 0x80;
+      CPPUNIT_ASSERT_EQUAL(high, StringUtils::countAsciiPrefix(bytes, length));
+      bytes[high] = 0xFF;
+      CPPUNIT_ASSERT_EQUAL(high, StringUtils::countAsciiPrefix(bytes, length));
+      bytes[high] = 0x7F;
+      CPPUNIT_ASSERT_EQUAL(length, StringUtils::countAsciiPrefix(bytes, length));
+      bytes[high] = (unsigned char)('a' + high % 26);
+    }
+  }
+}
+
+void StringUtilsTest::testAppendAscii() {
+  string text("The quick brown fox jumps over the lazy dog 0123456789");
+  CPPUNIT_ASSERT_EQUAL(text, appendAsUtf8(text, StringUtils::ASCII));
+  CPPUNIT_ASSERT_EQUAL(text, appendAsUtf8(text, "US-ASCII"));
+  CPPUNIT_ASSERT_EQUAL(string(), appendAsUtf8(string(), StringUtils::ASCII));
+
+  // The result is appended to, not replaced
+  string result("abc");
+  CPPUNIT_ASSERT(StringUtils::appendAsUtf8(result, (unsigned char const*)"def", 3, StringUtils::UTF8));
+  CPPUNIT_ASSERT_EQUAL(string("abcdef"), result);
+}
+
+void StringUtilsTest::testAppendUtf8() {
+  string text("na\xC3\xAFve \xE2\x82\xAC \xF0\x9F\x98\x80 long enough to span several words");
+  CPPUNIT_ASSERT_EQUAL(text, appendAsUtf8(text, StringUtils::UTF8));
+  CPPUNIT_ASSERT_EQUAL(text, appendAsUtf8(text, "utf-8"));
+  CPPUNIT_ASSERT(!canAppendAsUtf8(string("ab\xC3"), StringUtils::UTF8));
+  CPPUNIT_ASSERT(!canAppendAsUtf8(string("ab\x80" "cd"), StringUtils::UTF8));
+}
+
+void StringUtilsTest::testAppendUtf16() {
+  CPPUNIT_ASSERT_EQUAL(string("A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80"),
+                       appendAsUtf8(string("\x00\x41\x00\xE9\x20\xAC\xD8\x3D\xDE\x00", 10), "UTF-16BE"));
+  CPPUNIT_ASSERT(!canAppendAsUtf8(string("\x00\x41\x00", 3), "UTF-16BE"));
+  CPPUNIT_ASSERT(!canAppendAsUtf8(string("\xD8\x3D\x00\x41", 4), "UTF-16BE"));
+}
+
+void StringUtilsTest::testAppendLatin() {
+  CPPUNIT_ASSERT_EQUAL(string("caf\xC3\xA9 \xC2\xA4"), appendAsUtf8(string("caf\xE9 \xA4"), StringUtils::ISO88591));
+  CPPUNIT_ASSERT_EQUAL(string("caf\xC3\xA9 \xC2\xA4"), appendAsUtf8(string("caf\xE9 \xA4"), "ISO8859_1"));
+  CPPUNIT_ASSERT_EQUAL(string("caf\xC3\xA9 \xE2\x82\xAC"), appendAsUtf8(string("caf\xE9 \xA4"), "ISO-8859-15"));
+  CPPUNIT_ASSERT_EQUAL(string("\xE2\x82\xAC \xE2\x80\x9Cq\xE2\x80\x9D \xC3\xBF"),
+                       appendAsUtf8(string("\x80 \x93q\x94 \xFF"), "windows-1252"));
+  CPPUNIT_ASSERT(!canAppendAsUtf8(string("\x81"), "windows-1252"));
+}
+
+void StringUtilsTest::testAppendShiftJis() {
+  // Nihon, "Japan", in Shift_JIS around some ASCII, then half-width katakana
+  CPPUNIT_ASSERT_EQUAL(string("a\xE6\x97\xA5\xE6\x9C\xAC" "b"), appendAsUtf8(string("a\x93\xFA\x96\x7B" "b"), StringUtils::SHIFT_JIS));
+  CPPUNIT_ASSERT_EQUAL(string("\xEF\xBD\xB1"), appendAsUtf8(string("\xB1"), "Shift_JIS"));
+  // The same characters in EUC-JP
+  CPPUNIT_ASSERT_EQUAL(string("\xE6\x97\xA5\xE6\x9C\xAC"), appendAsUtf8(string("\xC6\xFC\xCB\xDC"), StringUtils::EUC_JP));
+}
+
+void StringUtilsTest::testAppendGb2312() {
+  // Zhongwen, "Chinese", in GB 2312
+  CPPUNIT_ASSERT_EQUAL(string("\xE4\xB8\xAD\xE6\x96\x87"), appendAsUtf8(string("\xD6\xD0\xCE\xC4"), StringUtils::GB2312));
+  CPPUNIT_ASSERT_EQUAL(string("\xE4\xB8\xAD\xE6\x96\x87"), appendAsUtf8(string("\xD6\xD0\xCE\xC4"), "GB2312"));
+}
+
+void StringUtilsTest::testAppendUndecodable() {
+#ifdef NO_ICONV
+  // Without iconv, bytes that cannot be decoded become U+FFFD instead of
+  // passing through as invalid UTF-8
+  char const* const encodings[] = { StringUtils::SHIFT_JIS, StringUtils::EUC_JP, StringUtils::GB2312, "Big5", "ISO-8859-2" };
+  for (char const* encoding : encodings) {
+    for (int lead = 0x80; lead <= 0xFF; lead++) {
+      for (int trail = 0; trail <= 0xFF; trail++) {
+        string bytes;
+        bytes.push_back((char)lead);
+        bytes.push_back((char)trail);
+        bytes.push_back((char)0xFF);
+        bytes.push_back((char)lead);
+        CPPUNIT_ASSERT(isValidUtf8(appendAsUtf8(bytes, encoding)));
+      }
+    }
+  }
+  // A truncated Shift_JIS character and a user-defined one
+  CPPUNIT_ASSERT_EQUAL(string("a\xEF\xBF\xBD"), appendAsUtf8(string("a\x93"), StringUtils::SHIFT_JIS));
+  CPPUNIT_ASSERT_EQUAL(string("\xEF\xBF\xBD"), appendAsUtf8(string("\xF0\x40"), StringUtils::SHIFT_JIS));
+  CPPUNIT_ASSERT_EQUAL(string("x\xEF\xBF\xBDy"), appendAsUtf8(string("x\xB1y"), "ISO-8859-2"));
+#endif
+}
+
+}
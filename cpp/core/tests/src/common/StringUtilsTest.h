@@ -0,0 +1,59 @@
+#ifndef __STRING_UTILS_TEST_H__
+#define __STRING_UTILS_TEST_H__
+
+/*
+ *  StringUtilsTest.h
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+namespace pping {
+class StringUtilsTest : public CPPUNIT_NS::TestFixture {
+  CPPUNIT_TEST_SUITE(StringUtilsTest);
+  CPPUNIT_TEST(testCountAsciiPrefix);
+  CPPUNIT_TEST(testAppendAscii);
+  CPPUNIT_TEST(testAppendUtf8);
+  CPPUNIT_TEST(testAppendUtf16);
+  CPPUNIT_TEST(testAppendLatin);
+  CPPUNIT_TEST(testAppendShiftJis);
+  CPPUNIT_TEST(testAppendGb2312);
+  CPPUNIT_TEST(testAppendUndecodable);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+protected:
+  void testCountAsciiPrefix();
+  void testAppendAscii();
+  void testAppendUtf8();
+  void testAppendUtf16();
+  void testAppendLatin();
+  void testAppendShiftJis();
+  void testAppendGb2312();
+  void testAppendUndecodable();
+
+private:
+  static std::string appendAsUtf8(std::string const& bytes, char const* encoding);
+  static bool canAppendAsUtf8(std::string const& bytes, char const* encoding);
+  static bool isValidUtf8(std::string const& text);
+};
+}
+
+#endif // __STRING_UTILS_TEST_H__
@@ -0,0 +1,85 @@
+/*
+ *  ThreadsTest.cpp
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ThreadsTest.h"
+#include <zxing/common/Threads.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace pping {
+using std::vector;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ThreadsTest);
+
+void ThreadsTest::testRunsEveryPart() {
+  for (size_t count = 1; count <= 8; count++) {
+    vector<int> runs(count, 0);
+    runOnThreads(count, [&](size_t i) {
+      runs[i]++;
+    });
+    for (size_t i = 0; i < count; i++) {
+      CPPUNIT_ASSERT_EQUAL(1, runs[i]);
+    }
+  }
+}
+
+void ThreadsTest::testRethrowsAfterJoining() {
+  // The parts after the ones that throw still run to the end
+  std::atomic<int> finished(0);
+  bool caught = false;
+  try {
+    runOnThreads(4, [&](size_t i) {
+      if (i == 1) {
+        throw std::bad_alloc();
+      }
+      if (i == 2) {
+        throw std::runtime_error("later part");
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      finished++;
+    });
+  } catch (std::bad_alloc const&) {
+    caught = true;
+  }
+  CPPUNIT_ASSERT(caught);
+  CPPUNIT_ASSERT_EQUAL(2, finished.load());
+}
+
+void ThreadsTest::testRethrowsFromCallingThread() {
+  std::atomic<int> finished(0);
+  bool caught = false;
+  try {
+    runOnThreads(3, [&](size_t i) {
+      if (i == 0) {
+        throw std::bad_alloc();
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      finished++;
+    });
+  } catch (std::bad_alloc const&) {
+    caught = true;
+  }
+  CPPUNIT_ASSERT(caught);
+  CPPUNIT_ASSERT_EQUAL(2, finished.load());
+}
+}
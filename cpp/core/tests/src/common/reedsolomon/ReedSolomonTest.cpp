@@ -19,14 +19,13 @@
  */
 
 #include "ReedSolomonTest.h"
+#include <zxing/common/reedsolomon/GenericGF.h>
 #include <zxing/common/reedsolomon/ReedSolomonDecoder.h>
-#include <zxing/common/reedsolomon/ReedSolomonException.h>
-#include <zxing/common/IllegalArgumentException.h>
 #include <vector>
 #include <cmath>
 #include <cstdlib>
 
-namespace zxing {
+namespace pping {
 using namespace std;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ReedSolomonTest);
@@ -43,6 +42,8 @@ static int QR_CODE_TEST_WITH_EC[] = { 0x10, 0x20, 0x0C, 0x56, 0x61, 0x80, 0xEC,
                                       0x11, 0xEC, 0x11, 0xEC, 0x11, 0xEC, 0x11, 0xA5, 0x24,
                                       0xD4, 0xC1, 0xED, 0x36, 0xC7, 0x87, 0x2C, 0x55
                                     };
+static int DATA_MATRIX_TEST_WITH_EC[] = { 142, 164, 186, 114, 25, 5, 88, 102 };
+static int AZTEC_PARAM_TEST_WITH_EC[] = { 0x0, 0x0, 0x0, 0x9, 0xA, 0xD, 0x8, 0x6, 0x5, 0x6 };
 
 void ReedSolomonTest::setUp() {
   qrCodeTest_ =
@@ -70,7 +71,7 @@ void ReedSolomonTest::testNoError() {
 void ReedSolomonTest::testOneError() {
   ArrayRef<int> received(new Array<int>(qrCodeTestWithEc_->size()));
   srandom(0xDEADBEEFL);
-  for (int i = 0; i < received->size(); i++) {
+  for (size_t i = 0; i < received->size(); i++) {
     *received = *qrCodeTestWithEc_;
     received[i] = random() % 256;
     checkQRRSDecode(received);
@@ -80,7 +81,7 @@ void ReedSolomonTest::testOneError() {
 void ReedSolomonTest::testMaxErrors() {
   ArrayRef<int> received(new Array<int>(qrCodeTestWithEc_->size()));
   srandom(0xDEADBEEFL);
-  for (int i = 0; i < qrCodeTest_->size(); i++) {
+  for (size_t i = 0; i < qrCodeTest_->size(); i++) {
     *received = *qrCodeTestWithEc_;
     corrupt(received, qrCodeCorrectable_);
     checkQRRSDecode(received);
@@ -91,39 +92,164 @@ void ReedSolomonTest::testTooManyErrors() {
   ArrayRef<int> received(new Array<int>(qrCodeTestWithEc_->size()));
   srandom(0xDEADBEEFL);
   *received = *qrCodeTestWithEc_;
-  try {
-    corrupt(received, qrCodeCorrectable_ + 1);
-    checkQRRSDecode(received);
-    cout << "expected exception!\n";
-    CPPUNIT_FAIL("should not happen!");
-  } catch (ReedSolomonException const& e) {
-    // expected
-  } catch (...) {
-    CPPUNIT_FAIL("unexpected exception!");
+  corrupt(received, qrCodeCorrectable_ + 1);
+  CPPUNIT_ASSERT(!qrRSDecoder_->decode(received, 2 * qrCodeCorrectable_));
+}
+
+void ReedSolomonTest::testErasuresAndErrors() {
+  ArrayRef<int> received(new Array<int>(qrCodeTestWithEc_->size()));
+  int twoS = 2 * qrCodeCorrectable_;
+  srandom(0xDEADBEEFL);
+  // Every mix of e erasures and t errors with 2t + e <= twoS
+  for (int numErasures = 0; numErasures <= twoS; numErasures++) {
+    int numErrors = (twoS - numErasures) / 2;
+    for (int i = 0; i < 8; i++) {
+      *received = *qrCodeTestWithEc_;
+      vector<bool> corrupted(received->size());
+      vector<int> erasures = erase(received, numErasures, corrupted);
+      corrupt(received, numErrors, corrupted);
+      checkQRRSDecode(received, erasures);
+    }
   }
 }
 
+void ReedSolomonTest::testTooManyErasuresAndErrors() {
+  ArrayRef<int> received(new Array<int>(qrCodeTestWithEc_->size()));
+  int twoS = 2 * qrCodeCorrectable_;
+  srandom(0xDEADBEEFL);
+  // One error more than the check codewords left over by the erasures allow.
+  // Once the erasures take all but a couple of them nearly any word is close
+  // to some codeword and miscorrects, so stop short of that.
+  for (int numErasures = 0; numErasures <= twoS - 3; numErasures++) {
+    int numErrors = (twoS - numErasures) / 2 + 1;
+    *received = *qrCodeTestWithEc_;
+    vector<bool> corrupted(received->size());
+    vector<int> erasures = erase(received, numErasures, corrupted);
+    corrupt(received, numErrors, corrupted);
+    CPPUNIT_ASSERT(!qrRSDecoder_->decode(received, twoS, erasures));
+  }
+}
+
+void ReedSolomonTest::testNoErasures() {
+  ArrayRef<int> received(new Array<int>(qrCodeTestWithEc_->size()));
+  ArrayRef<int> receivedWithErasures(new Array<int>(qrCodeTestWithEc_->size()));
+  int twoS = 2 * qrCodeCorrectable_;
+  srandom(0xDEADBEEFL);
+  // An empty erasure list takes the errors-only path, also past its bound
+  for (int numErrors = 0; numErrors <= qrCodeCorrectable_ + 2; numErrors++) {
+    *received = *qrCodeTestWithEc_;
+    corrupt(received, numErrors);
+    *receivedWithErasures = *received;
+    bool decoded = static_cast<bool>(qrRSDecoder_->decode(received, twoS));
+    bool decodedWithErasures = static_cast<bool>(qrRSDecoder_->decode(receivedWithErasures, twoS, vector<int>()));
+    CPPUNIT_ASSERT_EQUAL(decoded, decodedWithErasures);
+    CPPUNIT_ASSERT(received->values() == receivedWithErasures->values());
+  }
+}
+
+void ReedSolomonTest::testFindCorruptBlocks() {
+  checkFindCorruptBlocks(GenericGF::QR_CODE_FIELD_256,
+                         vector<int>(QR_CODE_TEST_WITH_EC, QR_CODE_TEST_WITH_EC + 26), 9);
+  checkFindCorruptBlocks(GenericGF::DATA_MATRIX_FIELD_256,
+                         vector<int>(DATA_MATRIX_TEST_WITH_EC, DATA_MATRIX_TEST_WITH_EC + 8), 5);
+  // Aztec codes are generated from alpha^1 on, like Data Matrix codes
+  checkFindCorruptBlocks(GenericGF::AZTEC_PARAM,
+                         vector<int>(AZTEC_PARAM_TEST_WITH_EC, AZTEC_PARAM_TEST_WITH_EC + 10), 6);
+}
+
+void ReedSolomonTest::testSpanDecode() {
+  ArrayRef<int> received(new Array<int>(qrCodeTestWithEc_->size()));
+  int twoS = 2 * qrCodeCorrectable_;
+  srandom(0xDEADBEEFL);
+  // The same codewords decoded in place through a Span and through an
+  // ArrayRef, with and without erasures and past what can be corrected
+  for (int numErasures = 0; numErasures <= 2; numErasures++) {
+    for (int numErrors = 0; numErrors <= qrCodeCorrectable_ + 1; numErrors++) {
+      *received = *qrCodeTestWithEc_;
+      vector<bool> corrupted(received->size());
+      vector<int> erasures = erase(received, numErasures, corrupted);
+      corrupt(received, numErrors, corrupted);
+      vector<int> span(received->values());
+      bool decoded = static_cast<bool>(erasures.empty() ? qrRSDecoder_->decode(received, twoS)
+                                                        : qrRSDecoder_->decode(received, twoS, erasures));
+      bool decodedSpan = static_cast<bool>(qrRSDecoder_->decode(Span<int>(span), twoS, erasures));
+      CPPUNIT_ASSERT_EQUAL(decoded, decodedSpan);
+      CPPUNIT_ASSERT(received->values() == span);
+    }
+  }
+}
+
+void ReedSolomonTest::checkFindCorruptBlocks(Ref<GenericGF> field, vector<int> const& codewords, int twoS) {
+  ReedSolomonDecoder decoder(field);
+  vector<unsigned char> clean(codewords.begin(), codewords.end());
+  vector<unsigned char> corrupted(clean);
+  corrupted[1] ^= 1;
+  vector<unsigned char> lastCorrupted(clean);
+  lastCorrupted.back() ^= 3;
+
+  vector<Span<unsigned char const> > blocks;
+  blocks.push_back(Span<unsigned char const>(clean));
+  blocks.push_back(Span<unsigned char const>(corrupted));
+  blocks.push_back(Span<unsigned char const>(clean));
+  blocks.push_back(Span<unsigned char const>(lastCorrupted));
+  vector<int> blockTwoS(blocks.size(), twoS);
+  Fallible<vector<bool> > corrupt(decoder.findCorruptBlocks(blocks, blockTwoS));
+  CPPUNIT_ASSERT(corrupt);
+  CPPUNIT_ASSERT_EQUAL(blocks.size(), (*corrupt).size());
+  CPPUNIT_ASSERT(!(*corrupt)[0]);
+  CPPUNIT_ASSERT((*corrupt)[1]);
+  CPPUNIT_ASSERT(!(*corrupt)[2]);
+  CPPUNIT_ASSERT((*corrupt)[3]);
+
+  // The corrupted block goes on to decode with the same syndromes
+  vector<int> received(corrupted.begin(), corrupted.end());
+  CPPUNIT_ASSERT(decoder.decode(Span<int>(received), twoS, vector<int>()));
+  CPPUNIT_ASSERT(received == codewords);
+}
 
 void ReedSolomonTest::checkQRRSDecode(ArrayRef<int> &received) {
+  checkQRRSDecode(received, vector<int>());
+}
+
+void ReedSolomonTest::checkQRRSDecode(ArrayRef<int> &received, vector<int> const& erasures) {
   int twoS = 2 * qrCodeCorrectable_;
-  qrRSDecoder_->decode(received, twoS);
-  for (int i = 0; i < qrCodeTest_->size(); i++) {
+  CPPUNIT_ASSERT(qrRSDecoder_->decode(received, twoS, erasures));
+  for (size_t i = 0; i < qrCodeTest_->size(); i++) {
     CPPUNIT_ASSERT_EQUAL(qrCodeTest_[i], received[i]);
   }
 }
 
 void ReedSolomonTest::corrupt(ArrayRef<int> &received, int howMany) {
   vector<bool> corrupted(received->size());
+  corrupt(received, howMany, corrupted);
+}
+
+void ReedSolomonTest::corrupt(ArrayRef<int> &received, int howMany, vector<bool> &corrupted) {
+  for (int j = 0; j < howMany; j++) {
+    int location = floor(received->size() * ((double)(random() >> 1) / (double)((RAND_MAX >> 1) + 1)));
+    if (corrupted[location]) {
+      j--;
+    } else {
+      corrupted[location] = true;
+      // Never leaves the codeword as it was, so there are exactly howMany errors
+      received[location] ^= 1 + random() % 255;
+    }
+  }
+}
+
+vector<int> ReedSolomonTest::erase(ArrayRef<int> &received, int howMany, vector<bool> &corrupted) {
+  vector<int> erasures;
   for (int j = 0; j < howMany; j++) {
     int location = floor(received->size() * ((double)(random() >> 1) / (double)((RAND_MAX >> 1) + 1)));
     if (corrupted[location]) {
       j--;
     } else {
       corrupted[location] = true;
-      int newByte = random() % 256;
-      received[location] = newByte;
+      erasures.push_back(location);
+      received[location] = 0;
     }
   }
+  return erasures;
 }
 
 }
@@ -28,7 +28,8 @@
 #include <zxing/common/Array.h>
 
 
-namespace zxing {
+namespace pping {
+class GenericGF;
 class ReedSolomonDecoder;
 
 class ReedSolomonTest : public CppUnit::TestFixture {
@@ -37,6 +38,11 @@ class ReedSolomonTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testOneError);
   CPPUNIT_TEST(testMaxErrors);
   CPPUNIT_TEST(testTooManyErrors);
+  CPPUNIT_TEST(testErasuresAndErrors);
+  CPPUNIT_TEST(testTooManyErasuresAndErrors);
+  CPPUNIT_TEST(testNoErasures);
+  CPPUNIT_TEST(testFindCorruptBlocks);
+  CPPUNIT_TEST(testSpanDecode);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -48,6 +54,11 @@ protected:
   void testOneError();
   void testMaxErrors();
   void testTooManyErrors();
+  void testErasuresAndErrors();
+  void testTooManyErasuresAndErrors();
+  void testNoErasures();
+  void testFindCorruptBlocks();
+  void testSpanDecode();
 
 private:
   ArrayRef<int> qrCodeTest_;
@@ -55,7 +66,11 @@ private:
   int qrCodeCorrectable_;
   ReedSolomonDecoder *qrRSDecoder_;
   void checkQRRSDecode(ArrayRef<int> &received);
+  void checkQRRSDecode(ArrayRef<int> &received, std::vector<int> const& erasures);
   static void corrupt(ArrayRef<int> &received, int howMany);
+  static void checkFindCorruptBlocks(Ref<GenericGF> field, std::vector<int> const& codewords, int twoS);
+  static void corrupt(ArrayRef<int> &received, int howMany, std::vector<bool> &corrupted);
+  static std::vector<int> erase(ArrayRef<int> &received, int howMany, std::vector<bool> &corrupted);
 };
 }
 
@@ -0,0 +1,148 @@
+/*
+ *  VersionTest.cpp
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "VersionTest.h"
+#include <zxing/datamatrix/ZXingDataMatrixVersion.h>
+#include <algorithm>
+#include <vector>
+
+namespace pping {
+namespace datamatrix {
+using std::vector;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(VersionTest);
+
+int VersionTest::numMappingRows(Version& version) {
+  return version.getSymbolSizeRows() / (version.getDataRegionSizeRows() + 2) * version.getDataRegionSizeRows();
+}
+
+int VersionTest::numMappingColumns(Version& version) {
+  return version.getSymbolSizeColumns() / (version.getDataRegionSizeColumns() + 2) * version.getDataRegionSizeColumns();
+}
+
+/**
+ * Offset in the symbol of a module of the mapping matrix, wrapped around its
+ * edges as in ISO 16022:2006 Annex F.
+ */
+int VersionTest::symbolOffset(Version& version, int row, int column) {
+  int numRows = numMappingRows(version);
+  int numColumns = numMappingColumns(version);
+  if (row < 0) {
+    row += numRows;
+    column += 4 - ((numRows + 4) % 8);
+  }
+  if (column < 0) {
+    column += numColumns;
+    row += 4 - ((numColumns + 4) % 8);
+  }
+  int regionRows = version.getDataRegionSizeRows();
+  int regionColumns = version.getDataRegionSizeColumns();
+  int symbolRow = row / regionRows * (regionRows + 2) + 1 + row % regionRows;
+  int symbolColumn = column / regionColumns * (regionColumns + 2) + 1 + column % regionColumns;
+  return symbolRow * version.getSymbolSizeColumns() + symbolColumn;
+}
+
+void VersionTest::testVersionForDimensions() {
+  CPPUNIT_ASSERT_EQUAL((size_t)30, Version::VERSIONS.size());
+  for (size_t i = 0; i < Version::VERSIONS.size(); i++) {
+    Ref<Version> version(Version::VERSIONS[i]);
+    FallibleRef<Version> found(Version::getVersionForDimensions(version->getSymbolSizeRows(),
+                                                                version->getSymbolSizeColumns()));
+    CPPUNIT_ASSERT(found);
+    CPPUNIT_ASSERT((*found).object_ == version.object_);
+  }
+  CPPUNIT_ASSERT(!Version::getVersionForDimensions(11, 11));
+  CPPUNIT_ASSERT(!Version::getVersionForDimensions(10, 12));
+}
+
+void VersionTest::testCodewordModulesSize() {
+  for (size_t i = 0; i < Version::VERSIONS.size(); i++) {
+    Version& version = *Version::VERSIONS[i];
+    vector<unsigned short> const& modules = version.getCodewordModules();
+    CPPUNIT_ASSERT_EQUAL((size_t)version.getTotalCodewords() * 8, modules.size());
+    // Every module of the mapping matrix holds a bit, except for the fixed
+    // 2x2 pattern in the lower right corner of the sizes that leave 4 over
+    int area = numMappingRows(version) * numMappingColumns(version);
+    CPPUNIT_ASSERT_EQUAL(area - area % 8, version.getTotalCodewords() * 8);
+    // Built once
+    CPPUNIT_ASSERT(&modules == &version.getCodewordModules());
+  }
+}
+
+void VersionTest::testCodewordModulesInDataRegions() {
+  for (size_t i = 0; i < Version::VERSIONS.size(); i++) {
+    Version& version = *Version::VERSIONS[i];
+    vector<unsigned short> modules(version.getCodewordModules());
+    int symbolColumns = version.getSymbolSizeColumns();
+    int regionRows = version.getDataRegionSizeRows() + 2;
+    int regionColumns = version.getDataRegionSizeColumns() + 2;
+    for (size_t k = 0; k < modules.size(); k++) {
+      int row = modules[k] / symbolColumns;
+      int column = modules[k] % symbolColumns;
+      CPPUNIT_ASSERT(row < version.getSymbolSizeRows());
+      // Not on the finder or alignment patterns around each data region
+      CPPUNIT_ASSERT(row % regionRows != 0 && row % regionRows != regionRows - 1);
+      CPPUNIT_ASSERT(column % regionColumns != 0 && column % regionColumns != regionColumns - 1);
+    }
+    std::sort(modules.begin(), modules.end());
+    CPPUNIT_ASSERT(std::adjacent_find(modules.begin(), modules.end()) == modules.end());
+  }
+}
+
+void VersionTest::testKnownPlacements() {
+  for (size_t i = 0; i < Version::VERSIONS.size(); i++) {
+    Version& version = *Version::VERSIONS[i];
+    vector<unsigned short> const& modules = version.getCodewordModules();
+    int numRows = numMappingRows(version);
+    int numColumns = numMappingColumns(version);
+
+    if (numRows == 6 && (numColumns & 0x07) == 4) {
+      // The walk starts at (4, 0), which is where the 6 row 8x32 symbol
+      // places the corner pattern for column counts of 8n + 4
+      CPPUNIT_ASSERT_EQUAL(symbolOffset(version, numRows - 3, 0), (int)modules[0]);
+      CPPUNIT_ASSERT_EQUAL(symbolOffset(version, numRows - 1, 0), (int)modules[2]);
+      CPPUNIT_ASSERT_EQUAL(symbolOffset(version, 0, numColumns - 2), (int)modules[3]);
+      CPPUNIT_ASSERT_EQUAL(symbolOffset(version, 3, numColumns - 1), (int)modules[7]);
+    } else {
+      // Otherwise the first codeword is the utah shape ending in mapping
+      // module (4, 0), its upper left bits wrapped around to the right edge
+      CPPUNIT_ASSERT_EQUAL(symbolOffset(version, 2, -2), (int)modules[0]);
+      CPPUNIT_ASSERT_EQUAL(symbolOffset(version, 2, -1), (int)modules[1]);
+      CPPUNIT_ASSERT_EQUAL(symbolOffset(version, 3, -2), (int)modules[2]);
+      CPPUNIT_ASSERT_EQUAL(symbolOffset(version, 3, -1), (int)modules[3]);
+      CPPUNIT_ASSERT_EQUAL(symbolOffset(version, 3, 0), (int)modules[4]);
+      CPPUNIT_ASSERT_EQUAL(symbolOffset(version, 4, -2), (int)modules[5]);
+      CPPUNIT_ASSERT_EQUAL(symbolOffset(version, 4, -1), (int)modules[6]);
+      CPPUNIT_ASSERT_EQUAL(symbolOffset(version, 4, 0), (int)modules[7]);
+    }
+    // The next ones follow up and to the right, at (2, 2) and (0, 4)
+    CPPUNIT_ASSERT_EQUAL(symbolOffset(version, 0, 0), (int)modules[8]);
+    CPPUNIT_ASSERT_EQUAL(symbolOffset(version, 2, 2), (int)modules[15]);
+    CPPUNIT_ASSERT_EQUAL(symbolOffset(version, -2, 2), (int)modules[16]);
+    CPPUNIT_ASSERT_EQUAL(symbolOffset(version, 0, 4), (int)modules[23]);
+
+    // The lower right module is a codeword bit unless the fixed pattern is there
+    int corner = symbolOffset(version, numRows - 1, numColumns - 1);
+    bool cornerPlaced = std::find(modules.begin(), modules.end(), corner) != modules.end();
+    CPPUNIT_ASSERT_EQUAL((numRows * numColumns) % 8 == 0, cornerPlaced);
+  }
+}
+
+}
+}
@@ -0,0 +1,115 @@
+/*
+ *  CoverageTest.cpp
+ *  zxing
+ *
+ *  Copyright 2011 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CoverageTest.h"
+#include <zxing/ResultPoint.h>
+#include <zxing/common/Array.h>
+#include <zxing/common/BitArray.h>
+#include <zxing/common/Str.h>
+#include <vector>
+
+namespace pping {
+namespace multi {
+using std::vector;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CoverageTest);
+
+/** A result with the count points in x, y pairs. */
+Ref<Result> CoverageTest::makeResult(float const* points, int count, BarcodeFormat format) {
+  vector<Ref<ResultPoint> > resultPoints;
+  for (int i = 0; i < count; i++) {
+    resultPoints.push_back(Ref<ResultPoint>(new ResultPoint(points[2 * i], points[2 * i + 1])));
+  }
+  return Ref<Result>(new Result(Ref<String>(new String("")), ArrayRef<unsigned char>(), resultPoints, format));
+}
+
+void CoverageTest::testEmpty() {
+  Coverage coverage(100, 80);
+  for (int y = 0; y < 80; y += 4) {
+    for (int x = 0; x < 100; x += 4) {
+      CPPUNIT_ASSERT(!coverage.covers((float)x, (float)y));
+    }
+  }
+  // Results without points cover nothing
+  coverage.add(*makeResult(NULL, 0, BarcodeFormat::CODE_128));
+  CPPUNIT_ASSERT(!coverage.covers(50.0f, 40.0f));
+}
+
+void CoverageTest::testAddMargin() {
+  Coverage coverage(100, 80);
+  float const corners[] = { 40.0f, 20.0f, 60.0f, 20.0f, 60.0f, 40.0f, 40.0f, 40.0f };
+  coverage.add(*makeResult(corners, 4, BarcodeFormat::DATA_MATRIX));
+  // A quarter of the size on each side, whole cells at a time
+  CPPUNIT_ASSERT(coverage.covers(50.0f, 30.0f));
+  CPPUNIT_ASSERT(coverage.covers(35.0f, 15.0f));
+  CPPUNIT_ASSERT(coverage.covers(64.0f, 44.0f));
+  CPPUNIT_ASSERT(coverage.covers(32.0f, 30.0f));
+  CPPUNIT_ASSERT(!coverage.covers(31.0f, 30.0f));
+  CPPUNIT_ASSERT(!coverage.covers(72.0f, 30.0f));
+  CPPUNIT_ASSERT(!coverage.covers(50.0f, 7.0f));
+  CPPUNIT_ASSERT(!coverage.covers(50.0f, 48.0f));
+
+  // Clipped to the image, which has nothing past its edges
+  float const edge[] = { 0.0f, 60.0f, 20.0f, 60.0f };
+  coverage.add(*makeResult(edge, 2, BarcodeFormat::EAN_8));
+  CPPUNIT_ASSERT(coverage.covers(0.0f, 60.0f));
+  CPPUNIT_ASSERT(!coverage.covers(-1.0f, 60.0f));
+  CPPUNIT_ASSERT(!coverage.covers(10.0f, 80.0f));
+}
+
+void CoverageTest::testAddQRCodeCorner() {
+  // Bottom left, top left and top right of a symbol turned by 45 degrees,
+  // whose bottom right corner at (50, 70) is below all three
+  float const points[] = { 20.0f, 40.0f, 50.0f, 10.0f, 80.0f, 40.0f };
+  Coverage qrCoverage(100, 100);
+  qrCoverage.add(*makeResult(points, 3, BarcodeFormat::QR_CODE));
+  CPPUNIT_ASSERT(qrCoverage.covers(50.0f, 40.0f));
+  CPPUNIT_ASSERT(qrCoverage.covers(50.0f, 70.0f));
+  CPPUNIT_ASSERT(qrCoverage.covers(50.0f, 85.0f));
+  CPPUNIT_ASSERT(!qrCoverage.covers(50.0f, 88.0f));
+
+  // The points of other formats are the corners already
+  Coverage coverage(100, 100);
+  coverage.add(*makeResult(points, 3, BarcodeFormat::DATA_MATRIX));
+  CPPUNIT_ASSERT(coverage.covers(50.0f, 40.0f));
+  CPPUNIT_ASSERT(!coverage.covers(50.0f, 70.0f));
+}
+
+void CoverageTest::testBlacken() {
+  const int width = 100;
+  Coverage coverage(width, 40);
+  // Covers the cells from x = 8 to 48 and from 88 to the end of the row, on
+  // the first two rows of cells
+  float const left[] = { 20.0f, 8.0f, 40.0f, 8.0f };
+  float const right[] = { 90.0f, 8.0f, 98.0f, 8.0f };
+  coverage.add(*makeResult(left, 2, BarcodeFormat::CODE_39));
+  coverage.add(*makeResult(right, 2, BarcodeFormat::CODE_39));
+
+  for (int y = 0; y < 40; y++) {
+    BitArray row(width);
+    coverage.blacken(y, row);
+    for (int x = 0; x < width; x++) {
+      bool covered = y < 2 * Coverage::CELL_SIZE && ((x >= 8 && x < 48) || x >= 88);
+      CPPUNIT_ASSERT_EQUAL(covered, *row.get(x));
+      CPPUNIT_ASSERT_EQUAL(covered, coverage.covers((float)x, (float)y));
+    }
+  }
+}
+}
+}
@@ -0,0 +1,52 @@
+#ifndef __COVERAGE_TEST_H__
+#define __COVERAGE_TEST_H__
+
+/*
+ *  CoverageTest.h
+ *  zxing
+ *
+ *  Copyright 2011 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <zxing/BarcodeFormat.h>
+#include <zxing/Result.h>
+#include <zxing/common/Counted.h>
+#include <zxing/multi/Coverage.h>
+
+namespace pping {
+namespace multi {
+class CoverageTest : public CPPUNIT_NS::TestFixture {
+  CPPUNIT_TEST_SUITE(CoverageTest);
+  CPPUNIT_TEST(testEmpty);
+  CPPUNIT_TEST(testAddMargin);
+  CPPUNIT_TEST(testAddQRCodeCorner);
+  CPPUNIT_TEST(testBlacken);
+  CPPUNIT_TEST_SUITE_END();
+
+protected:
+  void testEmpty();
+  void testAddMargin();
+  void testAddQRCodeCorner();
+  void testBlacken();
+
+private:
+  static Ref<Result> makeResult(float const* points, int count, BarcodeFormat format);
+};
+}
+}
+
+#endif // __COVERAGE_TEST_H__
@@ -0,0 +1,131 @@
+/*
+ *  LinearSymbolTest.cpp
+ *  zxing
+ *
+ *  Copyright 2011 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LinearSymbolTest.h"
+#include <zxing/ResultPoint.h>
+#include <zxing/common/Array.h>
+#include <zxing/common/Str.h>
+
+namespace pping {
+namespace multi {
+using std::string;
+using std::vector;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LinearSymbolTest);
+
+Ref<Result> LinearSymbolTest::makeResult(string const& text, BarcodeFormat format) {
+  return Ref<Result>(new Result(Ref<String>(new String(text)), ArrayRef<unsigned char>(),
+                                vector<Ref<ResultPoint> >(), format));
+}
+
+/** Adds a read of text on each of rows rows, one every 4 pixels from firstRow. */
+void LinearSymbolTest::addReads(LinearSymbol& symbol, string const& text, BarcodeFormat format, float left,
+                                float right, int firstRow, int rows, vector<Ref<Result> >* added) {
+  for (int i = 0; i < rows; i++) {
+    Ref<Result> result(makeResult(text, format));
+    if (added != NULL) {
+      added->push_back(result);
+    }
+    symbol.add(result, text, left, right, firstRow + 4 * i);
+  }
+}
+
+void LinearSymbolTest::testOverlaps() {
+  LinearSymbol symbol(100.0f, 200.0f, 10);
+  CPPUNIT_ASSERT(symbol.overlaps(150.0f, 250.0f, 20));
+  CPPUNIT_ASSERT(symbol.overlaps(50.0f, 100.0f, 20));
+  CPPUNIT_ASSERT(!symbol.overlaps(201.0f, 300.0f, 20));
+  // Read on rows at most as far below as the symbol is wide
+  CPPUNIT_ASSERT(!symbol.hasEnded(110));
+  CPPUNIT_ASSERT(symbol.hasEnded(111));
+  CPPUNIT_ASSERT(!symbol.overlaps(100.0f, 200.0f, 111));
+
+  // Each read moves the last row down and may widen the span
+  symbol.add(makeResult("123", BarcodeFormat::CODE_128), "123", 90.0f, 210.0f, 100);
+  CPPUNIT_ASSERT(symbol.overlaps(205.0f, 300.0f, 150));
+  CPPUNIT_ASSERT(!symbol.hasEnded(220));
+  CPPUNIT_ASSERT(symbol.hasEnded(221));
+}
+
+void LinearSymbolTest::testMergesRowReads() {
+  LinearSymbol symbol(100.0f, 200.0f, 10);
+  vector<Ref<Result> > added;
+  addReads(symbol, "0123456789", BarcodeFormat::CODE_128, 100.0f, 200.0f, 10, 5, &added);
+  addReads(symbol, "0123456789", BarcodeFormat::CODE_128, 101.0f, 199.0f, 30, 3);
+  vector<Ref<Result> > results;
+  symbol.getResults(results);
+  // Reported once, as the first row read it
+  CPPUNIT_ASSERT_EQUAL((size_t)1, results.size());
+  CPPUNIT_ASSERT(results[0].object_ == added[0].object_);
+}
+
+void LinearSymbolTest::testDropsSingleReads() {
+  LinearSymbol symbol(100.0f, 200.0f, 10);
+  addReads(symbol, "0123456789", BarcodeFormat::CODE_128, 100.0f, 200.0f, 10, 1);
+  vector<Ref<Result> > results;
+  symbol.getResults(results);
+  CPPUNIT_ASSERT(results.empty());
+
+  // The same text in another format is another read
+  addReads(symbol, "0123456789", BarcodeFormat::CODE_39, 100.0f, 200.0f, 14, 1);
+  symbol.getResults(results);
+  CPPUNIT_ASSERT(results.empty());
+
+  addReads(symbol, "0123456789", BarcodeFormat::CODE_128, 100.0f, 200.0f, 18, LinearSymbol::MIN_ROW_READS - 1);
+  symbol.getResults(results);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, results.size());
+  CPPUNIT_ASSERT(results[0]->getBarcodeFormat() == BarcodeFormat::CODE_128);
+}
+
+void LinearSymbolTest::testDropsMisreads() {
+  LinearSymbol symbol(100.0f, 200.0f, 10);
+  addReads(symbol, "5901234123457", BarcodeFormat::EAN_13, 100.0f, 200.0f, 10, 3);
+  addReads(symbol, "5901234123457", BarcodeFormat::EAN_13, 100.0f, 200.0f, 30, 4);
+  // Read on fewer than half as many rows
+  addReads(symbol, "5901234128457", BarcodeFormat::EAN_13, 100.0f, 200.0f, 22, 3);
+  vector<Ref<Result> > results;
+  symbol.getResults(results);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, results.size());
+  CPPUNIT_ASSERT_EQUAL(string("5901234123457"), results[0]->getText()->getText());
+}
+
+void LinearSymbolTest::testDropsPartialReads() {
+  LinearSymbol symbol(100.0f, 200.0f, 10);
+  addReads(symbol, "12345670", BarcodeFormat::ITF, 100.0f, 200.0f, 10, 4);
+  // As many rows, but on a part of the symbol only
+  addReads(symbol, "1234", BarcodeFormat::ITF, 100.0f, 170.0f, 26, 4);
+  vector<Ref<Result> > results;
+  symbol.getResults(results);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, results.size());
+  CPPUNIT_ASSERT_EQUAL(string("12345670"), results[0]->getText()->getText());
+}
+
+void LinearSymbolTest::testSplitsStackedSymbols() {
+  // Two symbols of about the same width, one right below the other
+  LinearSymbol symbol(100.0f, 200.0f, 10);
+  addReads(symbol, "ABC-123", BarcodeFormat::CODE_39, 100.0f, 200.0f, 10, 6);
+  addReads(symbol, "DEF-456", BarcodeFormat::CODE_39, 104.0f, 196.0f, 40, 4);
+  vector<Ref<Result> > results;
+  symbol.getResults(results);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, results.size());
+  CPPUNIT_ASSERT_EQUAL(string("ABC-123"), results[0]->getText()->getText());
+  CPPUNIT_ASSERT_EQUAL(string("DEF-456"), results[1]->getText()->getText());
+}
+}
+}
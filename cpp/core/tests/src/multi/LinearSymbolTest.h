@@ -0,0 +1,60 @@
+#ifndef __LINEAR_SYMBOL_TEST_H__
+#define __LINEAR_SYMBOL_TEST_H__
+
+/*
+ *  LinearSymbolTest.h
+ *  zxing
+ *
+ *  Copyright 2011 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <zxing/BarcodeFormat.h>
+#include <zxing/Result.h>
+#include <zxing/common/Counted.h>
+#include <zxing/multi/LinearSymbol.h>
+#include <string>
+#include <vector>
+
+namespace pping {
+namespace multi {
+class LinearSymbolTest : public CPPUNIT_NS::TestFixture {
+  CPPUNIT_TEST_SUITE(LinearSymbolTest);
+  CPPUNIT_TEST(testOverlaps);
+  CPPUNIT_TEST(testMergesRowReads);
+  CPPUNIT_TEST(testDropsSingleReads);
+  CPPUNIT_TEST(testDropsMisreads);
+  CPPUNIT_TEST(testDropsPartialReads);
+  CPPUNIT_TEST(testSplitsStackedSymbols);
+  CPPUNIT_TEST_SUITE_END();
+
+protected:
+  void testOverlaps();
+  void testMergesRowReads();
+  void testDropsSingleReads();
+  void testDropsMisreads();
+  void testDropsPartialReads();
+  void testSplitsStackedSymbols();
+
+private:
+  static Ref<Result> makeResult(std::string const& text, BarcodeFormat format);
+  static void addReads(LinearSymbol& symbol, std::string const& text, BarcodeFormat format, float left, float right,
+                       int firstRow, int rows, std::vector<Ref<Result> >* added = NULL);
+};
+}
+}
+
+#endif // __LINEAR_SYMBOL_TEST_H__
@@ -0,0 +1,95 @@
+/*
+ *  MultiFinderPatternFinderTest.cpp
+ *  zxing
+ *
+ *  Copyright 2011 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MultiFinderPatternFinderTest.h"
+#include <zxing/DecodeHints.h>
+#include <zxing/ResultPoint.h>
+#include <zxing/ResultPointCallback.h>
+#include <zxing/multi/qrcode/detector/MultiFinderPatternFinder.h>
+#include <zxing/qrcode/detector/ZXingQRCodeFinderPattern.h>
+#include <vector>
+
+namespace pping {
+namespace multi {
+using std::vector;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MultiFinderPatternFinderTest);
+
+/** Draws the 7 by 7 modules of a finder pattern centred on (x, y). */
+void MultiFinderPatternFinderTest::drawFinderPattern(BitMatrix& matrix, float x, float y, int moduleSize) {
+  int left = (int)(x - 3.5f * (float)moduleSize);
+  int top = (int)(y - 3.5f * (float)moduleSize);
+  for (int row = 0; row < 7; row++) {
+    for (int column = 0; column < 7; column++) {
+      // Black but for the ring between the border and the 3 by 3 centre
+      bool ring = (row == 1 || row == 5 || column == 1 || column == 5) &&
+                  row >= 1 && row <= 5 && column >= 1 && column <= 5;
+      if (!ring) {
+        CPPUNIT_ASSERT(matrix.setRegion(left + column * moduleSize, top + row * moduleSize, moduleSize, moduleSize));
+      }
+    }
+  }
+}
+
+/** Checks the bottom left, top left and top right centres against the x, y pairs in expected. */
+void MultiFinderPatternFinderTest::checkCenters(qrcode::FinderPatternInfo& info, float const* expected) {
+  Ref<qrcode::FinderPattern> centers[] = { info.getBottomLeft(), info.getTopLeft(), info.getTopRight() };
+  for (int i = 0; i < 3; i++) {
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[2 * i], centers[i]->getX(), 1.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[2 * i + 1], centers[i]->getY(), 1.0);
+  }
+}
+
+void MultiFinderPatternFinderTest::testOrdersOneSymbol() {
+  // Upside down, so the rows meet bottom left first and top left last
+  float const expected[] = { 150.0f, 50.0f, 150.0f, 150.0f, 50.0f, 150.0f };
+  Ref<BitMatrix> matrix(new BitMatrix(200, 200));
+  for (int i = 0; i < 3; i++) {
+    drawFinderPattern(*matrix, expected[2 * i], expected[2 * i + 1], 4);
+  }
+  MultiFinderPatternFinder finder(matrix, Ref<ResultPointCallback>());
+  auto const found(finder.findMulti(DecodeHints()));
+  CPPUNIT_ASSERT(found);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, (*found).size());
+  checkCenters(*(*found)[0], expected);
+}
+
+void MultiFinderPatternFinderTest::testOrdersEachSymbol() {
+  // Two symbols turned a quarter each way. Their module sizes differ, so the
+  // patterns of one do not make triples with those of the other.
+  float const first[] = { 60.5f, 60.5f, 140.5f, 60.5f, 140.5f, 140.5f };
+  float const second[] = { 370.5f, 230.5f, 270.5f, 230.5f, 270.5f, 130.5f };
+  Ref<BitMatrix> matrix(new BitMatrix(400, 300));
+  for (int i = 0; i < 3; i++) {
+    drawFinderPattern(*matrix, first[2 * i], first[2 * i + 1], 3);
+    drawFinderPattern(*matrix, second[2 * i], second[2 * i + 1], 5);
+  }
+  MultiFinderPatternFinder finder(matrix, Ref<ResultPointCallback>());
+  auto const found(finder.findMulti(DecodeHints()));
+  CPPUNIT_ASSERT(found);
+  vector<Ref<qrcode::FinderPatternInfo> > infos(*found);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, infos.size());
+  if (infos[0]->getTopLeft()->getEstimatedModuleSize() > infos[1]->getTopLeft()->getEstimatedModuleSize()) {
+    std::swap(infos[0], infos[1]);
+  }
+  checkCenters(*infos[0], first);
+  checkCenters(*infos[1], second);
+}
+}
+}
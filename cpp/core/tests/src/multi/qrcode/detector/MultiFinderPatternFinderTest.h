@@ -0,0 +1,48 @@
+#ifndef __MULTI_FINDER_PATTERN_FINDER_TEST_H__
+#define __MULTI_FINDER_PATTERN_FINDER_TEST_H__
+
+/*
+ *  MultiFinderPatternFinderTest.h
+ *  zxing
+ *
+ *  Copyright 2011 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <zxing/common/BitMatrix.h>
+#include <zxing/common/Counted.h>
+#include <zxing/qrcode/detector/FinderPatternInfo.h>
+
+namespace pping {
+namespace multi {
+class MultiFinderPatternFinderTest : public CPPUNIT_NS::TestFixture {
+  CPPUNIT_TEST_SUITE(MultiFinderPatternFinderTest);
+  CPPUNIT_TEST(testOrdersOneSymbol);
+  CPPUNIT_TEST(testOrdersEachSymbol);
+  CPPUNIT_TEST_SUITE_END();
+
+protected:
+  void testOrdersOneSymbol();
+  void testOrdersEachSymbol();
+
+private:
+  static void drawFinderPattern(BitMatrix& matrix, float x, float y, int moduleSize);
+  static void checkCenters(qrcode::FinderPatternInfo& info, float const* expected);
+};
+}
+}
+
+#endif // __MULTI_FINDER_PATTERN_FINDER_TEST_H__
@@ -0,0 +1,207 @@
+/*
+ *  RunLengthRowTest.cpp
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RunLengthRowTest.h"
+#include <zxing/oned/ZXingRunLengthRow.h>
+#include <stdlib.h>
+
+namespace pping {
+namespace oned {
+using std::string;
+using std::vector;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RunLengthRowTest);
+
+void RunLengthRowTest::setUp() {
+  // '#' is black. Rows starting either way, ending either way, and rows
+  // with runs across and along whole 32 bit words.
+  rows_.clear();
+  rows_.push_back("");
+  rows_.push_back(".");
+  rows_.push_back("#");
+  rows_.push_back("..##.#...###..#.");
+  rows_.push_back("#.##..###...#");
+  rows_.push_back(string(32, '#'));
+  rows_.push_back(string(70, '.'));
+  rows_.push_back(string(5, '.') + string(40, '#') + "..#.#" + string(33, '.') + "##" + string(36, '#') + "." + string(31, '.'));
+  rows_.push_back(string(64, '#') + "." + string(31, '#') + ".#.#" + string(28, '.') + "##");
+  string stripes;
+  for (int i = 0; i < 100; i++) {
+    stripes += string(1 + i % 4, i % 2 == 0 ? '#' : '.');
+  }
+  rows_.push_back(stripes);
+}
+
+Ref<BitArray> RunLengthRowTest::makeBitArray(string const& row) {
+  Ref<BitArray> bits(new BitArray(row.size()));
+  for (size_t x = 0; x < row.size(); x++) {
+    if (row[x] == '#') {
+      bits->set(x);
+    }
+  }
+  return bits;
+}
+
+// The pixel by pixel version the 1D readers ran on the BitArray
+bool RunLengthRowTest::recordPattern(Ref<BitArray> row, int start, int counters[], int countersCount) {
+  for (int i = 0; i < countersCount; i++) {
+    counters[i] = 0;
+  }
+  int end = (int)row->getSize();
+  if (start >= end) {
+    return false;
+  }
+  bool isWhite = !*row->get(start);
+  int counterPosition = 0;
+  int i = start;
+  while (i < end) {
+    if (*row->get(i) ^ isWhite) {
+      counters[counterPosition]++;
+    } else {
+      counterPosition++;
+      if (counterPosition == countersCount) {
+        break;
+      }
+      counters[counterPosition] = 1;
+      isWhite = !isWhite;
+    }
+    i++;
+  }
+  return counterPosition == countersCount || (counterPosition == countersCount - 1 && i == end);
+}
+
+void RunLengthRowTest::testGet() {
+  for (size_t r = 0; r < rows_.size(); r++) {
+    Ref<BitArray> bits(makeBitArray(rows_[r]));
+    RunLengthRow row(bits);
+    int size = (int)rows_[r].size();
+    CPPUNIT_ASSERT_EQUAL(size, row.getSize());
+    CPPUNIT_ASSERT_EQUAL(1, row.getScale());
+    CPPUNIT_ASSERT_EQUAL(0, row.getRunStart(0));
+    for (int x = 0; x < size; x++) {
+      CPPUNIT_ASSERT_EQUAL(*bits->get(x), row.get(x));
+      CPPUNIT_ASSERT_EQUAL(*bits->get(x), RunLengthRow::isBlackRun(row.getRun(x)));
+    }
+    CPPUNIT_ASSERT(!row.get(-1));
+    CPPUNIT_ASSERT(!row.get(size));
+    // Only run 0 may be empty
+    for (int run = 1; run < row.getRunCount(); run++) {
+      CPPUNIT_ASSERT(row.getRunWidth(run) > 0);
+    }
+  }
+}
+
+void RunLengthRowTest::testReversed() {
+  for (size_t r = 0; r < rows_.size(); r++) {
+    Ref<BitArray> bits(makeBitArray(rows_[r]));
+    Ref<RunLengthRow> reversed(RunLengthRow(bits).reversed());
+    bits->reverse();
+    RunLengthRow expected(bits);
+    CPPUNIT_ASSERT_EQUAL(expected.getSize(), reversed->getSize());
+    CPPUNIT_ASSERT_EQUAL(expected.getRunCount(), reversed->getRunCount());
+    for (int run = 0; run < expected.getRunCount(); run++) {
+      CPPUNIT_ASSERT_EQUAL(expected.getRunStart(run), reversed->getRunStart(run));
+      CPPUNIT_ASSERT_EQUAL(expected.getRunEnd(run), reversed->getRunEnd(run));
+    }
+  }
+}
+
+void RunLengthRowTest::testFromLuminances() {
+  for (size_t r = 0; r < rows_.size(); r++) {
+    int size = (int)rows_[r].size();
+    vector<unsigned char> luminances(size + 1);
+    for (int x = 0; x < size; x++) {
+      luminances[x] = rows_[r][x] == '#' ? 30 : 220;
+    }
+    Ref<RunLengthRow> row(RunLengthRow::fromLuminances(&luminances[0], size));
+    RunLengthRow expected(makeBitArray(rows_[r]));
+    if (expected.getRunCount() <= 2) {
+      // Without an edge there is nothing to tell black from white by
+      CPPUNIT_ASSERT_EQUAL(1, row->getRunCount());
+      continue;
+    }
+    // Sharp edges land on the pixel borders, give or take the pull of a
+    // neighbouring edge one pixel away on the fitted parabola
+    int scale = RunLengthRow::SUBPIXEL_SCALE;
+    CPPUNIT_ASSERT_EQUAL(scale, row->getScale());
+    CPPUNIT_ASSERT_EQUAL(expected.getSize() * scale, row->getSize());
+    CPPUNIT_ASSERT_EQUAL(expected.getRunCount(), row->getRunCount());
+    for (int run = 0; run < expected.getRunCount(); run++) {
+      CPPUNIT_ASSERT(abs(expected.getRunStart(run) * scale - row->getRunStart(run)) < scale / 2);
+    }
+  }
+}
+
+void RunLengthRowTest::testGetNext() {
+  for (size_t r = 0; r < rows_.size(); r++) {
+    Ref<BitArray> bits(makeBitArray(rows_[r]));
+    RunLengthRow row(bits);
+    int size = (int)rows_[r].size();
+    for (int x = 0; x <= size; x++) {
+      for (int value = 0; value < 2; value++) {
+        int next = x;
+        while (next < size && *bits->get(next) != (value == 1)) {
+          next++;
+        }
+        CPPUNIT_ASSERT_EQUAL(next, row.getNext(x, value == 1));
+      }
+    }
+  }
+}
+
+void RunLengthRowTest::testIsRange() {
+  for (size_t r = 0; r < rows_.size(); r++) {
+    Ref<BitArray> bits(makeBitArray(rows_[r]));
+    RunLengthRow row(bits);
+    int size = (int)rows_[r].size();
+    for (int start = 0; start <= size; start++) {
+      for (int end = start; end <= size; end++) {
+        CPPUNIT_ASSERT_EQUAL(*bits->isRange(start, end, true), row.isRange(start, end, true));
+        CPPUNIT_ASSERT_EQUAL(*bits->isRange(start, end, false), row.isRange(start, end, false));
+      }
+      // Past the end of the row is white
+      CPPUNIT_ASSERT_EQUAL(*bits->isRange(start, size, false), row.isRange(start, size + 5, false));
+      CPPUNIT_ASSERT(!row.isRange(start, size + 5, true));
+    }
+  }
+}
+
+void RunLengthRowTest::testRecordPattern() {
+  for (size_t r = 0; r < rows_.size(); r++) {
+    Ref<BitArray> bits(makeBitArray(rows_[r]));
+    RunLengthRow row(bits);
+    int size = (int)rows_[r].size();
+    for (int start = 0; start <= size; start++) {
+      for (int countersCount = 1; countersCount <= 9; countersCount++) {
+        int expected[9];
+        int counters[9];
+        bool expectedFound = recordPattern(bits, start, expected, countersCount);
+        CPPUNIT_ASSERT_EQUAL(expectedFound, row.recordPattern(start, counters, countersCount));
+        if (expectedFound) {
+          for (int i = 0; i < countersCount; i++) {
+            CPPUNIT_ASSERT_EQUAL(expected[i], counters[i]);
+          }
+        }
+      }
+    }
+  }
+}
+
+}
+}
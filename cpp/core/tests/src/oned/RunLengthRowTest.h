@@ -0,0 +1,61 @@
+#ifndef __RUN_LENGTH_ROW_TEST_H__
+#define __RUN_LENGTH_ROW_TEST_H__
+
+/*
+ *  RunLengthRowTest.h
+ *  zxing
+ *
+ *  Copyright 2010 ZXing authors All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <zxing/common/BitArray.h>
+#include <zxing/common/Counted.h>
+#include <string>
+#include <vector>
+
+namespace pping {
+namespace oned {
+class RunLengthRowTest : public CPPUNIT_NS::TestFixture {
+  CPPUNIT_TEST_SUITE(RunLengthRowTest);
+  CPPUNIT_TEST(testGet);
+  CPPUNIT_TEST(testReversed);
+  CPPUNIT_TEST(testFromLuminances);
+  CPPUNIT_TEST(testGetNext);
+  CPPUNIT_TEST(testIsRange);
+  CPPUNIT_TEST(testRecordPattern);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+
+protected:
+  void testGet();
+  void testReversed();
+  void testFromLuminances();
+  void testGetNext();
+  void testIsRange();
+  void testRecordPattern();
+
+private:
+  std::vector<std::string> rows_;
+  static Ref<BitArray> makeBitArray(std::string const& row);
+  static bool recordPattern(Ref<BitArray> row, int start, int counters[], int countersCount);
+};
+}
+}
+
+#endif // __RUN_LENGTH_ROW_TEST_H__